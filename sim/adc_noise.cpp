@@ -0,0 +1,139 @@
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "lib/misc/timer.h"
+
+#include "sensors/analog_sensor.h"
+#include "sys_constants.h"
+
+#include "commands.h"
+
+struct AdcNoiseOptions {
+    float level = 0.4321f;   // Constant input, fraction of full scale
+    float noise = 1.5f;      // RMS noise of conversions, LSB of 12 bit
+    uint32_t values = 4096;  // Values measured for each resolution and mode
+    uint8_t from = 9;
+    uint8_t to = 16;
+};
+
+struct AdcNoiseResult {
+    double rms = 0;          // LSB of measured resolution
+    double enob = 0;
+    double rate = 0;         // Values per second, continuous mode
+};
+
+// Same definition as used on the device: quantization noise of an ideal converter is 1/sqrt(12) LSB
+static double enob(double rms, uint8_t bits) {
+    if (rms <= 0) return bits;
+    return std::min<double>(bits, bits - std::log2(rms * std::sqrt(12.0)));
+}
+
+static AdcNoiseResult summarize(double sum, double sq_sum, uint32_t count, uint8_t bits) {
+    const double mean = sum / count;
+    const double rms = std::sqrt(std::max(0.0, sq_sum / count - mean * mean));
+
+    return {
+        .rms = rms,
+        .enob = enob(rms, bits),
+    };
+}
+
+static AdcNoiseResult measure_single(const AdcNoiseOptions &options, uint8_t bits) {
+    SimHal::reset();
+    SimHal::set_analog_source([&](auto) { return options.level; });
+    SimHal::set_analog_noise(options.noise);
+
+    Timer timer;
+    AnalogSensorConfig config{.resolution = bits};
+    AnalogSensor sensor(timer, (const uint8_t *) &config);
+    sensor.begin();
+
+    double sum = 0, sq_sum = 0;
+    for (uint32_t i = 0; i < options.values; ++i) {
+        const double value = (double) sensor.sample().value * (1u << bits);
+        sum += value;
+        sq_sum += value * value;
+    }
+
+    return summarize(sum, sq_sum, options.values, bits);
+}
+
+static AdcNoiseResult measure_continuous(const AdcNoiseOptions &options, uint8_t bits, AnalogNoiseStats &stats) {
+    SimHal::reset();
+    SimHal::set_analog_source([&](auto) { return options.level; });
+    SimHal::set_analog_noise(options.noise);
+
+    Timer timer;
+    AnalogSensorConfig config{.resolution = bits, .continuous = true};
+    AnalogSensor sensor(timer, (const uint8_t *) &config);
+
+    double sum = 0, sq_sum = 0;
+    uint32_t count = 0;
+    sensor.set_sample_callback([&](const SensorSample &sample) {
+        const double value = (double) sample.value * (1u << bits);
+        sum += value;
+        sq_sum += value * value;
+        count++;
+    });
+
+    sensor.begin();
+
+    const auto start_us = SimClock::now_us();
+    while (count < options.values) {
+        timer.handle_timers();
+        SimClock::advance_ms(ANALOG_DRAIN_INTERVAL);
+    }
+
+    const double elapsed = (double) (SimClock::now_us() - start_us) / 1e6;
+    if (const auto *noise = sensor.noise_stats()) stats = *noise;
+
+    auto result = summarize(sum, sq_sum, count, bits);
+    result.rate = count / elapsed;
+    return result;
+}
+
+/**
+ * Effective resolution of analog sensor against a steady noisy input: single conversions vs continuous mode,
+ * where blocks of DMA conversions are summed and decimated. Also shows what the on-device noise meter reports.
+ */
+int sim_adc_noise(int argc, char **argv) {
+    AdcNoiseOptions options;
+
+    for (int i = 0; i + 1 < argc; i += 2) {
+        const char *key = argv[i];
+        const char *value = argv[i + 1];
+
+        if (strcmp(key, "--level") == 0) options.level = strtof(value, nullptr);
+        else if (strcmp(key, "--noise") == 0) options.noise = strtof(value, nullptr);
+        else if (strcmp(key, "--values") == 0) options.values = std::max(16, atoi(value));
+        else if (strcmp(key, "--from") == 0) options.from = (uint8_t) atoi(value);
+        else if (strcmp(key, "--to") == 0) options.to = (uint8_t) atoi(value);
+        else {
+            fprintf(stderr, "Unknown option %s\n", key);
+            return 1;
+        }
+    }
+
+    options.from = std::clamp<uint8_t>(options.from, 1, 16);
+    options.to = std::clamp<uint8_t>(options.to, options.from, 16);
+
+    printf("Input %.4f of full scale, noise %.2f LSB rms at 12 bit, %u values per run\n\n",
+           options.level, options.noise, options.values);
+    printf("bits | single: rms LSB  ENOB | continuous: conv/value  rate Hz  rms LSB  ENOB | meter: ENOB raw -> value\n");
+
+    for (uint8_t bits = options.from; bits <= options.to; ++bits) {
+        AnalogNoiseStats stats{};
+        const auto single = measure_single(options, bits);
+        const auto continuous = measure_continuous(options, bits, stats);
+
+        printf("%4u | %14.3f %5.2f | %21u %8.0f %8.3f %5.2f | %10.2f -> %.2f\n", bits,
+               single.rms, single.enob,
+               stats.decimation, continuous.rate, continuous.rms, continuous.enob,
+               stats.raw_enob, stats.enob);
+    }
+
+    SimHal::reset();
+    return 0;
+}
@@ -0,0 +1,87 @@
+#include <cstdio>
+#include <cstring>
+
+#include "closed_loop.h"
+#include "commands.h"
+#include "options.h"
+
+static const TuningRule RULES[] = {
+    TuningRule::TUNING_ZIEGLER_NICHOLS,
+    TuningRule::TUNING_TYREUS_LUYBEN,
+    TuningRule::TUNING_SIMC,
+};
+
+static const char *RULE_NAMES[] = {"ziegler-nichols", "tyreus-luyben", "simc"};
+
+int sim_autotune(int argc, char **argv) {
+    ClosedLoopOptions options;
+    options.pid.target = 45;
+    options.pid.i_limit = IntegralLimitMode::I_SATURATE;
+    options.pid.engine = PidEngine::PID_SPECIALIZED;
+    options.duration = 4 * 3600;
+
+    AutotuneConfig autotune{};
+    float verify_duration = 3600;
+    const char *scenario_name = "fopdt";
+
+    for (int i = 0; i + 1 < argc; i += 2) {
+        const char *key = argv[i];
+        const char *value = argv[i + 1];
+
+        if (strcmp(key, "--scenario") == 0) scenario_name = value;
+        else if (strcmp(key, "--sensor") == 0) options.sensor = strcmp(value, "analog") == 0 ? SensorType::ANALOG_VALUE : SensorType::DSX18X;
+        else if (strcmp(key, "--amplitude") == 0) autotune.amplitude = strtof(value, nullptr);
+        else if (strcmp(key, "--hysteresis") == 0) autotune.hysteresis = strtof(value, nullptr);
+        else if (strcmp(key, "--cycles") == 0) autotune.cycles = (uint8_t) atoi(value);
+        else if (strcmp(key, "--verify") == 0) verify_duration = strtof(value, nullptr);
+        else if (!parse_pid_option(key, value, options.pid)) {
+            fprintf(stderr, "Unknown option %s\n", key);
+            return 1;
+        }
+    }
+
+    const auto *scenario = find_plant_scenario(scenario_name);
+    if (!scenario) {
+        fprintf(stderr, "Unknown scenario %s\n", scenario_name);
+        return 1;
+    }
+
+    auto result = run_autotune(scenario->plant, options, autotune);
+    if (result.state != AutotuneState::AUTOTUNE_DONE) {
+        printf("Autotune failed after %u cycles\n", result.cycles);
+        return 2;
+    }
+
+    printf("Scenario:         %s\n", scenario->name);
+    printf("Ultimate point:   Ku %.4f, Pu %.1f s, amplitude %.3f after %u cycles\n",
+           result.ultimate_gain, result.ultimate_period, result.amplitude, result.cycles);
+    printf("FOPDT model:      K %.2f, tau %.1f s, theta %.1f s\n",
+           result.model.gain, result.model.time_constant, result.model.dead_time);
+
+    // Verify proposed gains by a step from the initial plant temperature to the setpoint
+    options.duration = verify_duration;
+
+    printf("\n%-16s %10s %10s %10s %10s %10s %10s %10s\n",
+           "Rule", "kP", "kI", "kD", "IAE", "Overshoot", "Settling", "Final");
+
+    for (size_t i = 0; i < sizeof(RULES) / sizeof(RULES[0]); ++i) {
+        autotune_apply_rule(result, RULES[i], options.pid.k_mul);
+
+        auto verify_options = options;
+        verify_options.pid.p = result.p;
+        verify_options.pid.i = result.i;
+        verify_options.pid.d = result.d;
+
+        auto metrics = run_closed_loop(scenario->plant, verify_options);
+
+        char settling[16];
+        if (std::isnan(metrics.settling_time)) strcpy(settling, "-");
+        else snprintf(settling, sizeof(settling), "%.0f s", metrics.settling_time);
+
+        printf("%-16s %10.3f %10.4f %10.3f %10.1f %9.1f%% %10s %10.2f\n",
+               RULE_NAMES[i], result.p, result.i, result.d,
+               metrics.iae, metrics.overshoot, settling, metrics.final_value);
+    }
+
+    return 0;
+}
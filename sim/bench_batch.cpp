@@ -0,0 +1,190 @@
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include "pid/batch_pid.h"
+#include "pid/specialized_pid.h"
+
+#include "commands.h"
+#include "options.h"
+#include "plant.h"
+
+struct BatchRun {
+    std::vector<float> final_temperature;
+    std::vector<float> final_integral;
+    std::vector<uint64_t> output_hash; // FNV-1a of output bit patterns at every PID tick
+    std::vector<double> iae;
+
+    explicit BatchRun(size_t size) : final_temperature(size), final_integral(size), output_hash(size, 14695981039346656037ull),
+                                     iae(size) {}
+};
+
+static uint64_t hash_value(uint64_t hash, float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+
+    for (int i = 0; i < 4; ++i) {
+        hash ^= (bits >> (8 * i)) & 0xff;
+        hash *= 1099511628211ull;
+    }
+
+    return hash;
+}
+
+/**
+ * Candidate gains spread log-uniformly in x0.1..x10 of configured gains, kP and kI on a grid.
+ */
+static std::vector<PidConfig> make_candidates(const PidConfig &base, size_t count) {
+    const auto side = (size_t) std::ceil(std::sqrt((double) count));
+
+    std::vector<PidConfig> candidates(count, base);
+    for (size_t i = 0; i < count; ++i) {
+        const float kp = (float) (i % side) / (float) std::max<size_t>(1, side - 1);
+        const float ki = (float) (i / side) / (float) std::max<size_t>(1, side - 1);
+
+        candidates[i].p = base.p * std::pow(10.f, 2 * kp - 1);
+        candidates[i].i = base.i * std::pow(10.f, 2 * ki - 1);
+    }
+
+    return candidates;
+}
+
+static void run_scalar(const std::vector<PidConfig> &candidates, const ThermalPlantConfig &plant_config,
+                       float step, uint64_t total_steps, uint32_t steps_per_sample, BatchRun &run) {
+    for (size_t lane = 0; lane < candidates.size(); ++lane) {
+        SpecializedPid pid;
+        pid.configure(candidates[lane]);
+        pid.reset();
+
+        ThermalPlant plant(plant_config, step);
+        const float target = candidates[lane].target;
+
+        float output = 0;
+        double iae = 0;
+        for (uint64_t n = 0; n < total_steps; ++n) {
+            if (n % steps_per_sample == 0) {
+                output = pid.compute(plant.temperature(), PID_DT_NOMINAL);
+                run.output_hash[lane] = hash_value(run.output_hash[lane], output);
+            }
+
+            plant.step(output);
+            iae += std::abs(target - plant.temperature()) * step;
+        }
+
+        run.final_temperature[lane] = plant.temperature();
+        run.final_integral[lane] = pid.integral();
+        run.iae[lane] = iae;
+    }
+}
+
+static bool run_batch(const std::vector<PidConfig> &candidates, const ThermalPlantConfig &plant_config,
+                      float step, uint64_t total_steps, uint32_t steps_per_sample, BatchRun &run) {
+    const size_t size = candidates.size();
+
+    PidBatch pid(size);
+    for (size_t lane = 0; lane < size; ++lane) {
+        if (!pid.configure(lane, candidates[lane])) return false;
+    }
+    pid.reset();
+
+    ThermalPlantBatch plant(std::vector<ThermalPlantConfig>(size, plant_config), step);
+
+    std::vector<float> output(size, 0.f);
+    for (uint64_t n = 0; n < total_steps; ++n) {
+        if (n % steps_per_sample == 0) {
+            pid.compute(plant.temperature(), output.data());
+            for (size_t lane = 0; lane < size; ++lane) run.output_hash[lane] = hash_value(run.output_hash[lane], output[lane]);
+        }
+
+        plant.step(output.data());
+
+        const float *temperature = plant.temperature();
+        for (size_t lane = 0; lane < size; ++lane) {
+            run.iae[lane] += std::abs(candidates[lane].target - temperature[lane]) * step;
+        }
+    }
+
+    for (size_t lane = 0; lane < size; ++lane) {
+        run.final_temperature[lane] = plant.temperature()[lane];
+        run.final_integral[lane] = pid.integral()[lane];
+    }
+
+    return true;
+}
+
+int sim_bench_batch(int argc, char **argv) {
+    PidConfig config{};
+    config.target = 45;
+    config.p = 20;
+    config.i = 0.2;
+    config.i_limit = IntegralLimitMode::I_SATURATE;
+
+    ThermalPlantConfig plant{};
+    size_t lanes = 4096;
+    float duration = 3600;
+    uint32_t step_ms = 100;
+
+    for (int i = 0; i + 1 < argc; i += 2) {
+        const char *key = argv[i];
+        const char *value = argv[i + 1];
+
+        if (strcmp(key, "--lanes") == 0) lanes = std::max(1, atoi(value));
+        else if (strcmp(key, "--duration") == 0) duration = strtof(value, nullptr);
+        else if (strcmp(key, "--step") == 0) step_ms = std::max(1, atoi(value));
+        else if (strcmp(key, "--gain") == 0) plant.gain = strtof(value, nullptr);
+        else if (strcmp(key, "--tau") == 0) plant.time_constant = strtof(value, nullptr);
+        else if (strcmp(key, "--dead-time") == 0) plant.dead_time = strtof(value, nullptr);
+        else if (!parse_pid_option(key, value, config)) {
+            fprintf(stderr, "Unknown option %s\n", key);
+            return 1;
+        }
+    }
+
+    const float step = (float) step_ms / 1000.f;
+    const auto total_steps = (uint64_t) ((double) duration * 1000 / step_ms);
+    const uint32_t steps_per_sample = std::max<uint32_t>(1, config.interval / step_ms);
+
+    const auto candidates = make_candidates(config, lanes);
+
+    BatchRun scalar(lanes), batch(lanes);
+
+    auto start = std::chrono::steady_clock::now();
+    run_scalar(candidates, plant, step, total_steps, steps_per_sample, scalar);
+    std::chrono::duration<double> scalar_time = std::chrono::steady_clock::now() - start;
+
+    start = std::chrono::steady_clock::now();
+    if (!run_batch(candidates, plant, step, total_steps, steps_per_sample, batch)) {
+        fprintf(stderr, "Candidates have different PID modes\n");
+        return 1;
+    }
+    std::chrono::duration<double> batch_time = std::chrono::steady_clock::now() - start;
+
+    size_t mismatched = 0, best = 0;
+    for (size_t lane = 0; lane < lanes; ++lane) {
+        const bool same = scalar.output_hash[lane] == batch.output_hash[lane]
+                          && memcmp(&scalar.final_temperature[lane], &batch.final_temperature[lane], sizeof(float)) == 0
+                          && memcmp(&scalar.final_integral[lane], &batch.final_integral[lane], sizeof(float)) == 0
+                          && scalar.iae[lane] == batch.iae[lane];
+        if (!same) mismatched++;
+
+        if (batch.iae[lane] < batch.iae[best]) best = lane;
+    }
+
+    const double plant_steps = (double) total_steps * (double) lanes;
+
+    printf("Candidates:       %zu x %.0f s, plant step %u ms, PID interval %u ms\n",
+           lanes, duration, step_ms, config.interval);
+    printf("Best candidate:   kP %.3f, kI %.4f, IAE %.1f\n", candidates[best].p, candidates[best].i, batch.iae[best]);
+    printf("Mismatched lanes: %zu\n\n", mismatched);
+
+    printf("%-10s %12s %16s %16s\n", "Mode", "Wall time", "Candidates/s", "Steps/s");
+    printf("%-10s %10.3f s %16.1f %16.3e\n", "Scalar", scalar_time.count(),
+           (double) lanes / scalar_time.count(), plant_steps / scalar_time.count());
+    printf("%-10s %10.3f s %16.1f %16.3e\n", "Batch", batch_time.count(),
+           (double) lanes / batch_time.count(), plant_steps / batch_time.count());
+    printf("Speedup:          x%.2f\n", scalar_time.count() / batch_time.count());
+
+    return mismatched == 0 ? 0 : 2;
+}
@@ -0,0 +1,145 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include "lib/misc/timer.h"
+
+#include "app/channel_scheduler.h"
+#include "controls/pwm_control.h"
+#include "sensors/analog_sensor.h"
+#include "sys_constants.h"
+
+#include "commands.h"
+#include "options.h"
+#include "plant.h"
+
+static constexpr uint8_t BENCH_CHANNELS_MAX = SIM_PIN_COUNT / 2;
+
+struct BenchChannelsOptions {
+    PidConfig pid{.target = 0.45f, .interval = 100, .p = 50, .i = 0.5f}; // Target is a fraction of ADC full scale
+
+    uint8_t channels = REGULATOR_MAX_CHANNELS;
+    float seconds = 600;
+    bool stagger = true;
+    float analog_scale = 100;
+};
+
+/**
+ * Independent heaters regulated by one ChannelScheduler: analog sensor on pin `i`, PWM output on pin `i + 16`.
+ * Reports how many channels computed in one pass of the control loop, CPU cycles per computing iteration
+ * and the number of channels that fit in CHANNEL_LOAD_BUDGET of the interval on the host.
+ * The device reports the same statistics for its own channels in the Channels section.
+ */
+int sim_bench_channels(int argc, char **argv) {
+    BenchChannelsOptions options;
+
+    for (int i = 0; i + 1 < argc; i += 2) {
+        const char *key = argv[i];
+        const char *value = argv[i + 1];
+
+        if (parse_pid_option(key, value, options.pid)) continue;
+
+        if (strcmp(key, "--channels") == 0) options.channels = (uint8_t) std::clamp(atoi(value), 1, (int) BENCH_CHANNELS_MAX);
+        else if (strcmp(key, "--seconds") == 0) options.seconds = strtof(value, nullptr);
+        else if (strcmp(key, "--stagger") == 0) options.stagger = atoi(value) != 0;
+        else {
+            fprintf(stderr, "Unknown option %s\n", key);
+            return 1;
+        }
+    }
+
+    SimClock::reset();
+    SimHal::reset();
+
+    std::vector<RegulatorConfig> configs(options.channels);
+    std::vector<const RegulatorConfig *> config_ptrs;
+    std::vector<std::unique_ptr<ThermalPlant>> plants;
+
+    for (uint8_t i = 0; i < options.channels; ++i) {
+        auto &config = configs[i];
+        config.pid = options.pid;
+
+        config.sensor.type = SensorType::ANALOG_VALUE;
+        config.sensor.reset_data();
+        *(AnalogSensorConfig *) config.sensor.data = {.pin = i, .resolution = 12};
+
+        config.control.type = ControlType::PWM_VALUE;
+        config.control.reset_data();
+        ((PwmControlConfig *) config.control.data)->pin = i + BENCH_CHANNELS_MAX;
+
+        config_ptrs.push_back(&config);
+
+        // Slightly different heaters, so channels don't switch in lockstep
+        plants.push_back(std::make_unique<ThermalPlant>(ThermalPlantConfig{
+            .time_constant = 120.f + 10.f * i,
+            .dead_time = 2.f + 0.25f * i
+        }, 0.001f));
+    }
+
+    SimHal::set_analog_source([&](uint8_t pin) {
+        return pin < plants.size() ? plants[pin]->temperature() / options.analog_scale : 0.f;
+    });
+
+    Timer timer;
+    ChannelScheduler scheduler(timer, config_ptrs);
+    scheduler.begin();
+
+    for (uint8_t i = 0; i < scheduler.count(); ++i) {
+        scheduler.load(i, options.pid, true);
+
+        // After the first sample instants fall back to multiples of the interval, all channels on the same tick
+        if (!options.stagger) scheduler.channel(i).set_phase(0);
+    }
+
+    uint32_t passes = 0, busy_passes = 0, computes = 0;
+    uint8_t pass_max = 0;
+    double abs_error = 0;
+
+    timer.add_interval([&](auto) {
+        const auto computed = scheduler.update();
+        const auto count = (uint8_t) __builtin_popcount(computed);
+
+        passes++;
+        computes += count;
+        if (count > 0) busy_passes++;
+        pass_max = std::max(pass_max, count);
+    }, APP_SERVICE_LOOP_INTERVAL);
+
+    const auto total_steps = (uint64_t) ((double) options.seconds * 1000);
+    for (uint64_t step = 0; step < total_steps; ++step) {
+        for (uint8_t i = 0; i < options.channels; ++i) {
+            plants[i]->step(SimHal::pin_output(i + BENCH_CHANNELS_MAX));
+            abs_error += std::abs(options.pid.target * options.analog_scale - plants[i]->temperature());
+        }
+
+        timer.handle_timers();
+        SimClock::advance_ms(1);
+        SimHal::process_timers();
+    }
+
+    SimHal::set_analog_source(nullptr);
+
+    const auto &stats = scheduler.load_stats();
+    const auto host_mhz = ESP.getCpuFreqMHz();
+
+    printf("Channels: %u, interval %u ms, %s\n", options.channels, options.pid.interval,
+           options.stagger ? "staggered" : "aligned");
+    printf("Passes: %u, with computes: %u, computes: %u, most in one pass: %u\n", passes, busy_passes, computes, pass_max);
+    printf("Mean abs error: %.3f\n", abs_error / ((double) total_steps * options.channels));
+
+    if (stats.windows == 0) {
+        printf("No load window finished, run for at least %u ms\n", CHANNEL_LOAD_WINDOW);
+        return 0;
+    }
+
+    printf("Last window: %u computes, %.0f cycles/compute (max %u), longest pass %u cycles, most in one pass: %u\n",
+           stats.updates, stats.update_cycles, stats.update_cycles_max, stats.pass_cycles_max, stats.pass_updates_max);
+    printf("Host (%u MHz): %.2f us/compute, capacity %u channels\n",
+           host_mhz, host_mhz > 0 ? stats.update_cycles / host_mhz : 0.0, stats.capacity);
+
+    return 0;
+}
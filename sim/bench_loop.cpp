@@ -0,0 +1,165 @@
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "closed_loop.h"
+#include "commands.h"
+#include "options.h"
+
+struct LoopEngine {
+    const char *name;
+    PidEngine engine;
+};
+
+struct LoopResult {
+    std::string key;
+    ClosedLoopMetrics metrics;
+};
+
+static const LoopEngine ENGINES[] = {
+    {"float", PidEngine::PID_FLOAT},
+    {"fixed", PidEngine::PID_FIXED},
+    {"specialized", PidEngine::PID_SPECIALIZED},
+};
+
+static void write_csv(const char *path, const std::vector<LoopResult> &results) {
+    std::ofstream out(path);
+    out << "scenario,iae,ise,overshoot,settling_time,switches,ns_per_tick\n";
+    for (auto &result: results) {
+        auto &m = result.metrics;
+        out << result.key << ',' << m.iae << ',' << m.ise << ',' << m.overshoot << ','
+            << m.settling_time << ',' << m.switches << ',' << m.ns_per_tick << '\n';
+    }
+}
+
+static std::map<std::string, std::vector<double>> read_csv(const char *path) {
+    std::map<std::string, std::vector<double>> result;
+
+    std::ifstream in(path);
+    std::string line;
+    std::getline(in, line); // header
+
+    while (std::getline(in, line)) {
+        std::stringstream stream(line);
+        std::string key, cell;
+        std::getline(stream, key, ',');
+
+        auto &values = result[key];
+        while (std::getline(stream, cell, ',')) values.push_back(strtod(cell.c_str(), nullptr));
+    }
+
+    return result;
+}
+
+/**
+ * Control metrics may get worse by `control_tolerance`, CPU time by `cpu_tolerance` (relative).
+ * @return count of regressions
+ */
+static int compare_baseline(const char *path, const std::vector<LoopResult> &results, double control_tolerance, double cpu_tolerance) {
+    const auto baseline = read_csv(path);
+    if (baseline.empty()) {
+        fprintf(stderr, "Unable to read baseline %s\n", path);
+        return 1;
+    }
+
+    const char *names[] = {"iae", "ise", "overshoot", "settling_time", "switches", "ns_per_tick"};
+
+    int regressions = 0;
+    for (auto &result: results) {
+        auto it = baseline.find(result.key);
+        if (it == baseline.end() || it->second.size() < 6) continue;
+
+        auto &m = result.metrics;
+        const double current[] = {m.iae, m.ise, m.overshoot, m.settling_time, (double) m.switches, m.ns_per_tick};
+
+        for (int i = 0; i < 6; ++i) {
+            const double base = it->second[i];
+            const double value = current[i];
+            const double tolerance = i == 5 ? cpu_tolerance : control_tolerance;
+
+            bool regression;
+            if (std::isnan(value) || std::isnan(base)) regression = std::isnan(value) && !std::isnan(base);
+            else regression = value > base * (1 + tolerance) + 1e-6;
+
+            if (regression) {
+                printf("REGRESSION %s %s: %g -> %g\n", result.key.c_str(), names[i], base, value);
+                regressions++;
+            }
+        }
+    }
+
+    return regressions;
+}
+
+int sim_bench_loop(int argc, char **argv) {
+    ClosedLoopOptions options;
+    options.pid.target = 45;
+    options.pid.p = 20;
+    options.pid.i = 0.2;
+    options.pid.i_limit = IntegralLimitMode::I_SATURATE;
+
+    const char *scenario_filter = nullptr;
+    const char *csv_path = nullptr;
+    const char *baseline_path = nullptr;
+    double control_tolerance = 0.05;
+    double cpu_tolerance = 0.25;
+
+    for (int i = 0; i + 1 < argc; i += 2) {
+        const char *key = argv[i];
+        const char *value = argv[i + 1];
+
+        if (strcmp(key, "--duration") == 0) options.duration = strtof(value, nullptr);
+        else if (strcmp(key, "--scenario") == 0) scenario_filter = value;
+        else if (strcmp(key, "--sensor") == 0) options.sensor = strcmp(value, "analog") == 0 ? SensorType::ANALOG_VALUE : SensorType::DSX18X;
+        else if (strcmp(key, "--control") == 0) options.control = strcmp(value, "ledc") == 0 ? ControlType::LEDC_PWM : ControlType::PWM_VALUE;
+        else if (strcmp(key, "--csv") == 0) csv_path = value;
+        else if (strcmp(key, "--baseline") == 0) baseline_path = value;
+        else if (strcmp(key, "--tolerance") == 0) control_tolerance = strtod(value, nullptr);
+        else if (strcmp(key, "--cpu-tolerance") == 0) cpu_tolerance = strtod(value, nullptr);
+        else if (!parse_pid_option(key, value, options.pid)) {
+            fprintf(stderr, "Unknown option %s\n", key);
+            return 1;
+        }
+    }
+
+    printf("%-26s %10s %12s %10s %10s %9s %10s %10s %10s\n",
+           "Scenario", "IAE", "ISE", "Overshoot", "Settling", "Switches", "ns/tick", "cyc/tick", "Final");
+
+    std::vector<LoopResult> results;
+    for (auto &scenario: plant_scenarios()) {
+        if (scenario_filter && strcmp(scenario_filter, scenario.name) != 0) continue;
+
+        for (auto &engine: ENGINES) {
+            auto engine_options = options;
+            engine_options.pid.engine = engine.engine;
+
+            auto metrics = run_closed_loop(scenario.plant, engine_options);
+            auto key = std::string(scenario.name) + "/" + engine.name;
+
+            char settling[16];
+            if (std::isnan(metrics.settling_time)) strcpy(settling, "-");
+            else snprintf(settling, sizeof(settling), "%.0f s", metrics.settling_time);
+
+            printf("%-26s %10.1f %12.1f %9.1f%% %10s %9u %10.1f %10.0f %10.2f\n",
+                   key.c_str(), metrics.iae, metrics.ise, metrics.overshoot, settling,
+                   metrics.switches, metrics.ns_per_tick, metrics.cycles_per_tick, metrics.final_value);
+
+            results.push_back({key, metrics});
+        }
+    }
+
+    if (csv_path) write_csv(csv_path, results);
+
+    if (baseline_path) {
+        const int regressions = compare_baseline(baseline_path, results, control_tolerance, cpu_tolerance);
+        printf("%d regression(s) against %s\n", regressions, baseline_path);
+
+        if (regressions > 0) return 2;
+    }
+
+    return 0;
+}
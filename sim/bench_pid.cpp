@@ -0,0 +1,118 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+#include "pid/benchmark.h"
+#include "pid/fixed_pid.h"
+#include "pid/float_pid.h"
+#include "pid/specialized_pid.h"
+
+#include "commands.h"
+#include "options.h"
+
+struct EngineBenchmark {
+    const char *name;
+    PidBase &pid;
+
+    // Means are averaged over modes, variances of rounds are pooled
+    double cycles = 0, cycles_var = 0;
+    double ns = 0, ns_var = 0;
+    float deviation = 0;
+};
+
+static float max_output_deviation(PidBase &a, PidBase &b, const PidConfig &config, uint32_t iterations) {
+    a.configure(config);
+    a.reset();
+    b.configure(config);
+    b.reset();
+
+    float deviation = 0;
+    const float amplitude = std::max(1.f, std::abs(config.target) * 0.1f);
+    for (uint32_t i = 0; i < iterations; ++i) {
+        const float input = config.target + amplitude * std::sin((float) i * 0.01f);
+        deviation = std::max(deviation, std::abs(a.compute(input, PID_DT_NOMINAL) - b.compute(input, PID_DT_NOMINAL)));
+    }
+
+    return deviation;
+}
+
+static void apply_mode(PidConfig &config, uint8_t mode) {
+    config.p_mode = mode & KERNEL_P_INPUT ? ProportionalMode::P_INPUT : ProportionalMode::P_ERROR;
+    config.d_mode = mode & KERNEL_D_INPUT ? DifferentialMode::D_INPUT : DifferentialMode::D_ERROR;
+    config.direction = mode & KERNEL_REVERSE ? DirectionMode::PID_REVERSE : DirectionMode::PID_FORWARD;
+
+    uint8_t i_limit = 0;
+    if (mode & KERNEL_I_SATURATE) i_limit |= (uint8_t) IntegralLimitMode::I_SATURATE;
+    if (mode & KERNEL_I_BACK_CALC) i_limit |= (uint8_t) IntegralLimitMode::I_BACK_CALC;
+    if (mode & KERNEL_I_RESET) i_limit |= (uint8_t) IntegralLimitMode::I_RESET;
+    config.i_limit = (IntegralLimitMode) i_limit;
+}
+
+int sim_bench_pid(int argc, char **argv) {
+    PidConfig config{};
+    uint32_t iterations = 1000000;
+    uint32_t rounds = 5;
+    bool all_modes = false;
+
+    for (int i = 0; i + 1 < argc; i += 2) {
+        if (strcmp(argv[i], "--ticks") == 0) iterations = strtoul(argv[i + 1], nullptr, 10);
+        else if (strcmp(argv[i], "--rounds") == 0) rounds = std::max(1ul, strtoul(argv[i + 1], nullptr, 10));
+        else if (strcmp(argv[i], "--all-modes") == 0) all_modes = atoi(argv[i + 1]) != 0;
+        else if (!parse_pid_option(argv[i], argv[i + 1], config)) {
+            fprintf(stderr, "Unknown option %s\n", argv[i]);
+            return 1;
+        }
+    }
+
+    FloatPid float_pid;
+    KernelPid<FloatPidTraits, false> runtime_pid;
+    SpecializedPid specialized_pid;
+    FixedPid<> fixed_pid;
+
+    EngineBenchmark engines[] = {
+        {"uPID (float)", float_pid},
+        {"Runtime modes", runtime_pid},
+        {"Specialized", specialized_pid},
+        {"Fixed-point", fixed_pid},
+    };
+
+    // Either configured modes only or every combination (results are averaged)
+    const uint8_t mode_count = all_modes ? KERNEL_MODE_COUNT : 1;
+    for (uint8_t mode = 0; mode < mode_count; ++mode) {
+        if (all_modes) apply_mode(config, mode);
+
+        for (auto &engine: engines) {
+            PidBenchmarkStats cycles, ns;
+            for (uint32_t round = 0; round < rounds; ++round) {
+                auto start = std::chrono::steady_clock::now();
+                auto result = pid_benchmark(engine.pid, config, iterations);
+                std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+
+                cycles.add(result.cycles_per_tick);
+                ns.add(elapsed.count() / iterations);
+            }
+
+            engine.cycles += cycles.mean() / mode_count;
+            engine.cycles_var += cycles.stddev() * cycles.stddev() / mode_count;
+            engine.ns += ns.mean() / mode_count;
+            engine.ns_var += ns.stddev() * ns.stddev() / mode_count;
+
+            // Kernel engines must agree with each other, uPID is reported for reference only
+            if (&engine.pid != &runtime_pid) {
+                engine.deviation = std::max(engine.deviation, max_output_deviation(runtime_pid, engine.pid, config, iterations));
+            }
+        }
+    }
+
+    printf("Host %u MHz, %u rounds of %u ticks per mode, mean ± standard deviation of rounds\n",
+           ESP.getCpuFreqMHz(), rounds, iterations);
+    printf("%-16s %18s %16s %22s\n", "Engine", "cycles/tick", "ns/tick", "deviation vs runtime");
+    for (auto &engine: engines) {
+        printf("%-16s %10.1f ±%6.1f %9.1f ±%5.1f %22g\n", engine.name, engine.cycles, std::sqrt(engine.cycles_var),
+               engine.ns, std::sqrt(engine.ns_var), engine.deviation);
+    }
+
+    return 0;
+}
@@ -0,0 +1,206 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "lib/misc/timer.h"
+
+#include "app/channel_scheduler.h"
+#include "controls/cascade_control.h"
+#include "controls/ledc_control.h"
+#include "sensors/analog_sensor.h"
+#include "sys_constants.h"
+
+#include "commands.h"
+#include "plant.h"
+
+// Sensors read temperature / CASCADE_SCALE, so setpoints and output limits of loops are in these units
+static constexpr float CASCADE_SCALE = 100;
+
+static constexpr uint8_t CASCADE_VESSEL_PIN = 0;
+static constexpr uint8_t CASCADE_JACKET_PIN = 1;
+static constexpr uint8_t CASCADE_HEATER_PIN = 16;
+
+struct CascadeOptions {
+    float target = 0.45f;
+
+    // Single loop: vessel sensor drives the heater
+    PidConfig single{.interval = 1000, .p = 4, .i = 0.02f, .k_mul = 1,
+                     .i_limit = IntegralLimitMode::I_SATURATE, .engine = PidEngine::PID_SPECIALIZED};
+
+    // Outer: vessel sensor drives jacket setpoint, limited to the jacket's safe range
+    PidConfig outer{.interval = 2000, .p = 4, .i = 0.02f, .k_mul = 1, .out_max = 0.9f, .out_min = 0.2f,
+                    .i_limit = IntegralLimitMode::I_SATURATE, .engine = PidEngine::PID_SPECIALIZED};
+
+    // Inner: jacket sensor drives the heater
+    PidConfig inner{.interval = 200, .p = 10, .i = 0.5f, .k_mul = 1,
+                    .i_limit = IntegralLimitMode::I_SATURATE, .engine = PidEngine::PID_SPECIALIZED};
+
+    float seconds = 10800;
+    float disturbance_at = 5400;
+    float supply = 0.6f; // Heater power after the disturbance, fraction
+    float load = 0;      // Heat load after the disturbance, W
+};
+
+struct CascadeMetrics {
+    double iae = 0;             // Vessel, °C·s
+    double disturbance_iae = 0; // Vessel after the disturbance, °C·s
+    float overshoot = 0;        // °C above setpoint before the disturbance
+    float deviation = 0;        // Max |error| after the disturbance, °C
+    float jacket_max = 0;       // °C
+    double energy = 0;          // Heater energy, Wh
+    float final_value = NAN;
+};
+
+static RegulatorConfig make_config(const PidConfig &pid, uint8_t sensor_pin, ControlType control_type, uint8_t inner) {
+    RegulatorConfig config{};
+    config.pid = pid;
+
+    config.sensor.type = SensorType::ANALOG_VALUE;
+    config.sensor.reset_data();
+    *(AnalogSensorConfig *) config.sensor.data = {.pin = sensor_pin, .resolution = 12};
+
+    config.control.type = control_type;
+    config.control.reset_data();
+    if (control_type == ControlType::CASCADE) {
+        ((CascadeControlConfig *) config.control.data)->channel = inner;
+    } else {
+        ((LedcControlConfig *) config.control.data)->pin = CASCADE_HEATER_PIN;
+    }
+
+    return config;
+}
+
+static CascadeMetrics simulate(const CascadeOptions &options, bool cascade) {
+    SimClock::reset();
+    SimHal::reset();
+
+    const ThermalMassPlantConfig plant_config{};
+    ThermalMassPlant plant(plant_config, 0.001f);
+
+    SimHal::set_analog_source([&](uint8_t pin) {
+        return (pin == CASCADE_JACKET_PIN ? plant.element() : plant.temperature()) / CASCADE_SCALE;
+    });
+
+    std::vector<RegulatorConfig> configs;
+    if (cascade) {
+        configs.push_back(make_config(options.outer, CASCADE_VESSEL_PIN, ControlType::CASCADE, 1));
+        configs.push_back(make_config(options.inner, CASCADE_JACKET_PIN, ControlType::LEDC_PWM, 0));
+    } else {
+        configs.push_back(make_config(options.single, CASCADE_VESSEL_PIN, ControlType::LEDC_PWM, 0));
+    }
+
+    for (auto &config: configs) config.pid.target = options.target;
+
+    std::vector<const RegulatorConfig *> config_ptrs;
+    for (auto &config: configs) config_ptrs.push_back(&config);
+
+    CascadeMetrics metrics;
+    {
+        Timer timer;
+        ChannelScheduler scheduler(timer, config_ptrs);
+        scheduler.begin();
+        for (uint8_t i = 0; i < scheduler.count(); ++i) scheduler.load(i, configs[i].pid, true);
+
+        timer.add_interval([&](auto) { scheduler.update(); }, APP_SERVICE_LOOP_INTERVAL);
+
+        const float target = options.target * CASCADE_SCALE;
+        const float dt = 0.001f;
+        const auto total_steps = (uint64_t) ((double) options.seconds * 1000);
+        const auto disturbance_step = (uint64_t) ((double) options.disturbance_at * 1000);
+
+        for (uint64_t step = 0; step < total_steps; ++step) {
+            if (step == disturbance_step) {
+                plant.set_supply(options.supply);
+                plant.set_load(options.load);
+            }
+
+            const float output = SimHal::pin_output(CASCADE_HEATER_PIN);
+            plant.step(output);
+            metrics.energy += (double) plant_config.power * (step >= disturbance_step ? options.supply : 1) * output * dt / 3600;
+
+            const float error = plant.temperature() - target;
+            metrics.iae += std::abs(error) * dt;
+            metrics.jacket_max = std::max(metrics.jacket_max, plant.element());
+
+            if (step < disturbance_step) {
+                metrics.overshoot = std::max(metrics.overshoot, error);
+            } else {
+                metrics.disturbance_iae += std::abs(error) * dt;
+                metrics.deviation = std::max(metrics.deviation, std::abs(error));
+            }
+
+            timer.handle_timers();
+            SimClock::advance_ms(1);
+            SimHal::process_timers();
+        }
+
+        metrics.final_value = plant.temperature();
+    }
+
+    SimHal::set_analog_source(nullptr);
+    return metrics;
+}
+
+static bool parse_loop_option(const char *key, const char *prefix, const char *value, PidConfig &pid) {
+    const auto length = strlen(prefix);
+    if (strncmp(key, prefix, length) != 0) return false;
+
+    const char *name = key + length;
+    const float f_value = strtof(value, nullptr);
+
+    if (strcmp(name, "p") == 0) pid.p = f_value;
+    else if (strcmp(name, "i") == 0) pid.i = f_value;
+    else if (strcmp(name, "d") == 0) pid.d = f_value;
+    else if (strcmp(name, "interval") == 0) pid.interval = (uint16_t) f_value;
+    else if (strcmp(name, "engine") == 0) pid.engine = (PidEngine) atoi(value);
+    else if (strcmp(name, "i-limit") == 0) pid.i_limit = (IntegralLimitMode) atoi(value);
+    else if (strcmp(name, "out-min") == 0) pid.out_min = f_value;
+    else if (strcmp(name, "out-max") == 0) pid.out_max = f_value;
+    else return false;
+
+    return true;
+}
+
+/**
+ * Jacketed vessel (heater element coupled to a thermal mass) held at a setpoint by a single loop on the vessel sensor
+ * and by a cascade: outer loop on the vessel sets the jacket setpoint, inner loop on the jacket drives the heater.
+ * Halfway the heater loses part of its power (supply drop) and/or the vessel gets a heat load.
+ */
+int sim_cascade(int argc, char **argv) {
+    CascadeOptions options;
+
+    for (int i = 0; i + 1 < argc; i += 2) {
+        const char *key = argv[i];
+        const char *value = argv[i + 1];
+
+        if (parse_loop_option(key, "--single-", value, options.single)) continue;
+        if (parse_loop_option(key, "--outer-", value, options.outer)) continue;
+        if (parse_loop_option(key, "--inner-", value, options.inner)) continue;
+
+        if (strcmp(key, "--target") == 0) options.target = strtof(value, nullptr);
+        else if (strcmp(key, "--seconds") == 0) options.seconds = strtof(value, nullptr);
+        else if (strcmp(key, "--disturbance-at") == 0) options.disturbance_at = strtof(value, nullptr);
+        else if (strcmp(key, "--supply") == 0) options.supply = strtof(value, nullptr);
+        else if (strcmp(key, "--load") == 0) options.load = strtof(value, nullptr);
+        else {
+            fprintf(stderr, "Unknown option %s\n", key);
+            return 1;
+        }
+    }
+
+    printf("Target %.1f °C, at %.0f s: heater supply %.0f%%, heat load %.0f W\n",
+           options.target * CASCADE_SCALE, options.disturbance_at, options.supply * 100, options.load);
+    printf("%-8s %10s %14s %10s %10s %11s %10s %8s\n",
+           "Mode", "IAE", "IAE after", "Overshoot", "Max dev", "Jacket max", "Energy", "Final");
+
+    for (const bool cascade: {false, true}) {
+        const auto m = simulate(options, cascade);
+        printf("%-8s %10.1f %14.1f %9.2f° %9.2f° %10.1f° %7.1f Wh %7.2f°\n", cascade ? "cascade" : "single",
+               m.iae, m.disturbance_iae, m.overshoot, m.deviation, m.jacket_max, m.energy, m.final_value);
+    }
+
+    return 0;
+}
@@ -0,0 +1,203 @@
+#include "closed_loop.h"
+
+#include <chrono>
+#include <cstring>
+
+#include "lib/misc/timer.h"
+
+#include "app/regulator.h"
+#include "misc/sample_timer.h"
+#include "sensors/analog_sensor.h"
+
+const std::vector<PlantScenario> &plant_scenarios() {
+    static const std::vector<PlantScenario> scenarios = {
+        {"fopdt", [](float step) { return std::make_unique<ThermalPlant>(ThermalPlantConfig{}, step); }},
+        {"thermal-mass", [](float step) { return std::make_unique<ThermalMassPlant>(ThermalMassPlantConfig{}, step); }},
+        {"saturating", [](float step) {
+            return std::make_unique<SaturatingActuator>(
+                std::make_unique<ThermalPlant>(ThermalPlantConfig{}, step), SaturatingActuatorConfig{}, step);
+        }},
+    };
+
+    return scenarios;
+}
+
+const PlantScenario *find_plant_scenario(const char *name) {
+    for (auto &scenario: plant_scenarios()) {
+        if (strcmp(scenario.name, name) == 0) return &scenario;
+    }
+
+    return nullptr;
+}
+
+static RegulatorConfig make_regulator_config(const ClosedLoopOptions &options) {
+    RegulatorConfig config{};
+    config.pid = options.pid;
+    config.sensor.type = options.sensor;
+    config.sensor.reset_data();
+    if (options.sensor == SensorType::ANALOG_VALUE) {
+        ((AnalogSensorConfig *) config.sensor.data)->resolution = 12;
+    }
+
+    config.control.type = options.control;
+    config.control.reset_data();
+
+    return config;
+}
+
+ClosedLoopMetrics run_closed_loop(const PlantFactory &plant_factory, const ClosedLoopOptions &options) {
+    SimClock::reset();
+    SimHal::reset();
+
+    const auto config = make_regulator_config(options);
+
+    // Both control configs start with output pin
+    const uint8_t control_pin = config.control.data[0];
+
+    auto plant = plant_factory((float) options.step_ms / 1000.f);
+    SimHal::set_temperature_source([&](auto) { return plant->temperature(); });
+    SimHal::set_analog_source([&](auto) { return plant->temperature() / options.analog_scale; });
+
+    const float target = options.pid.target;
+    const float initial = plant->temperature();
+    const float step_size = std::max(1e-3f, std::abs(target - initial));
+    const float direction = target >= initial ? 1.f : -1.f;
+    const float band = std::max(options.settle_band_min, options.settle_band * step_size);
+
+    ClosedLoopMetrics metrics;
+    std::chrono::duration<double, std::nano> compute_time{};
+
+    {
+        Timer timer;
+        Regulator regulator(timer, config);
+
+        regulator.begin();
+        regulator.load(config.pid, true);
+        regulator.set_predictor(options.predictor);
+
+        timer.add_interval([&](auto) {
+            auto cycles_start = ESP.getCycleCount();
+            auto start = std::chrono::steady_clock::now();
+            bool computed = regulator.update();
+            std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+            auto cycles = ESP.getCycleCount() - cycles_start;
+
+            if (!computed) return;
+
+            metrics.computes++;
+            metrics.max_ns = std::max(metrics.max_ns, elapsed.count());
+            metrics.cycles_per_tick += cycles;
+            compute_time += elapsed;
+        }, APP_SERVICE_LOOP_INTERVAL);
+
+        const float dt = (float) options.step_ms / 1000.f;
+        const auto total_steps = (uint64_t) ((double) options.duration * 1000 / options.step_ms);
+
+        float last_outside = 0;
+        bool outside = true;
+        for (uint64_t i = 0; i < total_steps; ++i) {
+            plant->step(SimHal::pin_output(control_pin));
+
+            timer.handle_timers();
+            SimClock::advance_ms(options.step_ms);
+            SimHal::process_timers();
+
+            const float error = target - plant->temperature();
+            metrics.iae += std::abs(error) * dt;
+            metrics.ise += error * error * dt;
+            metrics.overshoot = std::max(metrics.overshoot, -error * direction);
+
+            outside = std::abs(error) > band;
+            if (outside) last_outside = (float) (i + 1) * dt;
+        }
+
+        metrics.final_value = plant->temperature();
+        metrics.overshoot = metrics.overshoot / step_size * 100;
+        if (!outside) metrics.settling_time = last_outside;
+
+        SampleTimer::end();
+    }
+
+    SimHal::set_temperature_source(nullptr);
+    SimHal::set_analog_source(nullptr);
+
+    metrics.switches = SimHal::pin_toggle_count(control_pin);
+    if (metrics.computes > 0) {
+        metrics.ns_per_tick = compute_time.count() / metrics.computes;
+        metrics.cycles_per_tick /= metrics.computes;
+    }
+
+    return metrics;
+}
+
+/**
+ * Run regulator against fresh plant after `start` replaced PID with an experiment, until it stops or duration elapses.
+ */
+static void run_experiment(const PlantFactory &plant_factory, const ClosedLoopOptions &options,
+                           const std::function<void(Regulator &)> &start,
+                           const std::function<bool(const Regulator &)> &running,
+                           const std::function<void(const Regulator &)> &finish) {
+    SimClock::reset();
+    SimHal::reset();
+
+    const auto config = make_regulator_config(options);
+    const uint8_t control_pin = config.control.data[0];
+
+    auto plant = plant_factory((float) options.step_ms / 1000.f);
+    SimHal::set_temperature_source([&](auto) { return plant->temperature(); });
+    SimHal::set_analog_source([&](auto) { return plant->temperature() / options.analog_scale; });
+
+    {
+        Timer timer;
+        Regulator regulator(timer, config);
+
+        regulator.begin();
+        regulator.load(config.pid, true);
+        start(regulator);
+
+        timer.add_interval([&](auto) { regulator.update(); }, APP_SERVICE_LOOP_INTERVAL);
+
+        const auto total_steps = (uint64_t) ((double) options.duration * 1000 / options.step_ms);
+        for (uint64_t i = 0; i < total_steps && running(regulator); ++i) {
+            plant->step(SimHal::pin_output(control_pin));
+
+            timer.handle_timers();
+            SimClock::advance_ms(options.step_ms);
+            SimHal::process_timers();
+        }
+
+        finish(regulator);
+        SampleTimer::end();
+    }
+
+    SimHal::set_temperature_source(nullptr);
+    SimHal::set_analog_source(nullptr);
+}
+
+AutotuneResult run_autotune(const PlantFactory &plant_factory, const ClosedLoopOptions &options, const AutotuneConfig &config) {
+    AutotuneResult result;
+    run_experiment(
+        plant_factory, options,
+        [&](Regulator &regulator) { regulator.set_autotune(true, config); },
+        [](const Regulator &regulator) { return regulator.autotune().state == AutotuneState::AUTOTUNE_RUNNING; },
+        [&](const Regulator &regulator) { result = regulator.autotune(); }
+    );
+
+    return result;
+}
+
+IdentificationResult run_identification(const PlantFactory &plant_factory, const ClosedLoopOptions &options,
+                                        const IdentificationConfig &config) {
+    IdentificationResult result;
+    run_experiment(
+        plant_factory, options,
+        [&](Regulator &regulator) { regulator.set_identification(true, config); },
+        [](const Regulator &regulator) {
+            const auto state = regulator.identification().state;
+            return state == IdentificationState::IDENT_BASELINE || state == IdentificationState::IDENT_STEP;
+        },
+        [&](const Regulator &regulator) { result = regulator.identification(); }
+    );
+
+    return result;
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "app/config.h"
+
+#include "plant.h"
+
+struct ClosedLoopOptions {
+    PidConfig pid{};
+    SmithPredictorConfig predictor{};
+
+    SensorType sensor = SensorType::DSX18X;
+    ControlType control = ControlType::PWM_VALUE;
+    float analog_scale = 100; // Temperature that corresponds to full-scale ADC reading
+
+    float duration = 3600;    // Simulated time, seconds
+    uint32_t step_ms = 1;
+
+    float settle_band = 0.02f; // Settling band relative to setpoint step
+    float settle_band_min = 0.2f;
+};
+
+/**
+ * Control quality is measured from the true plant temperature at every simulation step,
+ * CPU cost only for regulator iterations which computed PID.
+ */
+struct ClosedLoopMetrics {
+    double iae = 0;                // Integral of absolute error, °C·s
+    double ise = 0;                // Integral of squared error, °C²·s
+    float overshoot = 0;           // Max excursion beyond setpoint, % of setpoint step
+    float settling_time = NAN;     // Time to stay within settling band, seconds; NAN if never settled
+    float final_value = NAN;
+
+    uint32_t switches = 0;         // Control pin toggles
+    uint32_t computes = 0;
+
+    double ns_per_tick = 0;
+    double max_ns = 0;
+    double cycles_per_tick = 0;
+};
+
+using PlantFactory = std::function<std::unique_ptr<Plant>(float step)>;
+
+struct PlantScenario {
+    const char *name;
+    PlantFactory plant;
+};
+
+/**
+ * Plant models shared by simulation commands: FOPDT heater, heater with thermal mass, heater behind saturating actuator.
+ */
+const std::vector<PlantScenario> &plant_scenarios();
+
+/**
+ * @return nullptr if there is no scenario with such name
+ */
+const PlantScenario *find_plant_scenario(const char *name);
+
+/**
+ * Run regulator against fresh plant from the plant's initial temperature to `options.pid.target`.
+ * Resets virtual clock and fake HAL, so scenarios don't affect each other.
+ */
+ClosedLoopMetrics run_closed_loop(const PlantFactory &plant_factory, const ClosedLoopOptions &options);
+
+/**
+ * Run relay autotune experiment against fresh plant until it finishes or `options.duration` elapses.
+ */
+AutotuneResult run_autotune(const PlantFactory &plant_factory, const ClosedLoopOptions &options, const AutotuneConfig &config);
+
+/**
+ * Run open-loop step test against fresh plant until it finishes or `options.duration` elapses.
+ */
+IdentificationResult run_identification(const PlantFactory &plant_factory, const ClosedLoopOptions &options,
+                                        const IdentificationConfig &config);
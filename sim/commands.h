@@ -0,0 +1,17 @@
+#pragma once
+
+// Each command receives arguments following the command name
+
+int sim_run(int argc, char **argv);
+int sim_bench_pid(int argc, char **argv);
+int sim_bench_loop(int argc, char **argv);
+int sim_autotune(int argc, char **argv);
+int sim_identify(int argc, char **argv);
+int sim_optimize(int argc, char **argv);
+int sim_bench_batch(int argc, char **argv);
+int sim_replay(int argc, char **argv);
+int sim_adc_noise(int argc, char **argv);
+int sim_bench_channels(int argc, char **argv);
+int sim_cascade(int argc, char **argv);
+int sim_smith(int argc, char **argv);
+int sim_program(int argc, char **argv);
@@ -0,0 +1,186 @@
+#pragma once
+
+/**
+ * Host replacement of the Arduino core used by the `native` simulation environment.
+ * Time comes from SimClock, pins and analog inputs are routed through SimHal.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdarg>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <type_traits>
+
+#include "sim_clock.h"
+#include "sim_hal.h"
+
+#define LOW                                     (0x0)
+#define HIGH                                    (0x1)
+
+#define INPUT                                   (0x01)
+#define OUTPUT                                  (0x03)
+#define INPUT_PULLUP                            (0x05)
+
+#define PI                                      (3.1415926535897932384626433832795)
+
+#define IRAM_ATTR
+
+typedef bool boolean;
+typedef uint8_t byte;
+
+template<typename A, typename B>
+constexpr std::common_type_t<A, B> min(const A &a, const B &b) { return b < a ? b : a; }
+
+template<typename A, typename B>
+constexpr std::common_type_t<A, B> max(const A &a, const B &b) { return a < b ? b : a; }
+
+template<typename T, typename L, typename H>
+constexpr T constrain(const T &value, const L &low, const H &high) {
+    return value < low ? (T) low : value > high ? (T) high : value;
+}
+
+inline unsigned long millis() { return (unsigned long) SimClock::now_ms(); }
+inline unsigned long micros() { return (unsigned long) SimClock::now_us(); }
+
+inline void delay(unsigned long ms) { SimClock::advance_ms(ms); }
+inline void delayMicroseconds(unsigned int us) { SimClock::advance_us(us); }
+inline void yield() {}
+
+inline void pinMode(uint8_t, uint8_t) {}
+inline void digitalWrite(uint8_t pin, uint8_t value) { SimHal::write_pin(pin, value != LOW); }
+inline int digitalRead(uint8_t pin) { return SimHal::pin_state(pin) ? HIGH : LOW; }
+
+// Timer clock of LEDC peripheral limits frequency * 2^resolution, same as on ESP32-C3
+inline double ledcSetup(uint8_t channel, double freq, uint8_t resolution_bits) {
+    if (freq <= 0 || freq * (double) (1u << resolution_bits) > 80e6) return 0;
+    return SimHal::setup_ledc(channel, resolution_bits) ? freq : 0;
+}
+
+inline void ledcAttachPin(uint8_t pin, uint8_t channel) { SimHal::attach_ledc(pin, channel); }
+inline void ledcWrite(uint8_t channel, uint32_t duty) { SimHal::write_ledc(channel, duty); }
+
+inline hw_timer_t *timerBegin(uint8_t num, uint16_t divider, bool) {
+    auto timer = SimHal::hw_timer(num);
+    if (!timer) return nullptr;
+
+    *timer = {};
+    timer->used = true;
+    timer->divider = divider;
+    timer->start_us = SimClock::now_us();
+
+    return timer;
+}
+
+inline void timerEnd(hw_timer_t *timer) { *timer = {}; }
+
+inline void timerAttachInterrupt(hw_timer_t *timer, void (*fn)(), bool) { timer->isr = fn; }
+inline void timerDetachInterrupt(hw_timer_t *timer) { timer->isr = nullptr; }
+
+inline void timerAlarmWrite(hw_timer_t *timer, uint64_t alarm_value, bool auto_reload) {
+    timer->alarm = alarm_value;
+    timer->auto_reload = auto_reload;
+}
+
+inline void timerAlarmEnable(hw_timer_t *timer) {
+    timer->enabled = true;
+    timer->start_us = SimClock::now_us();
+}
+
+inline void timerAlarmDisable(hw_timer_t *timer) { timer->enabled = false; }
+
+inline void analogReadResolution(uint8_t bits) { SimHal::set_analog_resolution(bits); }
+inline uint16_t analogRead(uint8_t pin) { return SimHal::read_analog(pin); }
+
+// ESP32-C3: GPIO0..4 are ADC1 channels 0..4
+inline int8_t digitalPinToAnalogChannel(uint8_t pin) { return pin < 5 ? (int8_t) pin : -1; }
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+class EspClass {
+public:
+    // Host CPU cycles: TSC where available, otherwise nanoseconds
+    static uint32_t getCycleCount() {
+#if defined(__x86_64__) || defined(__i386__)
+        return (uint32_t) __rdtsc();
+#else
+        return (uint32_t) std::chrono::steady_clock::now().time_since_epoch().count();
+#endif
+    }
+
+    // Rate of `getCycleCount`: TSC is calibrated against steady clock once
+    static uint32_t getCpuFreqMHz() {
+#if defined(__x86_64__) || defined(__i386__)
+        static const uint32_t mhz = [] {
+            const auto start = std::chrono::steady_clock::now();
+            const auto start_cycles = __rdtsc();
+            while (std::chrono::steady_clock::now() - start < std::chrono::milliseconds(20)) {}
+
+            const std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+            return (uint32_t) std::lround((double) (__rdtsc() - start_cycles) / elapsed.count());
+        }();
+
+        return mhz;
+#else
+        return 1000;
+#endif
+    }
+    static uint32_t getFreeHeap() { return 0; }
+    static const char *getChipModel() { return "native"; }
+
+    static void restart() {}
+};
+
+inline EspClass ESP;
+
+class String : public std::string {
+public:
+    String() = default;
+    String(const char *str) : std::string(str ? str : "") {} // NOLINT(*-explicit-constructor)
+    String(std::string str) : std::string(std::move(str)) {} // NOLINT(*-explicit-constructor)
+
+    explicit String(int value) : std::string(std::to_string(value)) {}
+    explicit String(unsigned int value) : std::string(std::to_string(value)) {}
+    explicit String(long value) : std::string(std::to_string(value)) {}
+    explicit String(unsigned long value) : std::string(std::to_string(value)) {}
+    explicit String(float value, unsigned int decimals = 2) : String((double) value, decimals) {}
+    explicit String(double value, unsigned int decimals = 2) {
+        char buffer[32];
+        snprintf(buffer, sizeof(buffer), "%.*f", decimals, value);
+        assign(buffer);
+    }
+
+    [[nodiscard]] int toInt() const { return (int) strtol(c_str(), nullptr, 10); }
+    [[nodiscard]] float toFloat() const { return strtof(c_str(), nullptr); }
+};
+
+class HardwareSerial {
+public:
+    void begin(unsigned long) {}
+    void flush() { fflush(stdout); }
+
+    explicit operator bool() const { return true; }
+
+    size_t print(const char *str) { return fputs(str, stdout); }
+    size_t println(const char *str = "") { return printf("%s\n", str); }
+
+    size_t print(const String &str) { return print(str.c_str()); }
+    size_t println(const String &str) { return println(str.c_str()); }
+
+    size_t printf(const char *format, ...) __attribute__((format(printf, 2, 3))) {
+        va_list args;
+        va_start(args, format);
+        auto result = vprintf(format, args);
+        va_end(args);
+
+        return result;
+    }
+};
+
+inline HardwareSerial Serial;
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <cstdio>
+#include <memory>
+#include <string>
+
+#define FILE_READ                               "r"
+#define FILE_WRITE                              "w"
+#define FILE_APPEND                             "a"
+
+namespace fs {
+    enum SeekMode {
+        SeekSet = 0,
+        SeekCur = 1,
+        SeekEnd = 2
+    };
+
+    /**
+     * Host file handle with the subset of the Arduino File API used by the firmware.
+     */
+    class File {
+        std::shared_ptr<FILE> _file = nullptr;
+        std::string _path;
+
+    public:
+        File() = default;
+        File(FILE *file, std::string path) : _file(file, fclose), _path(std::move(path)) {}
+
+        explicit operator bool() const { return _file != nullptr; }
+
+        size_t write(uint8_t value) { return write(&value, 1); }
+        size_t write(const uint8_t *buffer, size_t size) { return _file ? fwrite(buffer, 1, size, _file.get()) : 0; }
+
+        int read() {
+            uint8_t value;
+            return read(&value, 1) == 1 ? value : -1;
+        }
+
+        size_t read(uint8_t *buffer, size_t size) { return _file ? fread(buffer, 1, size, _file.get()) : 0; }
+
+        bool seek(uint32_t pos, SeekMode mode = SeekSet) {
+            return _file && fseek(_file.get(), (long) pos, mode == SeekSet ? SEEK_SET : mode == SeekCur ? SEEK_CUR : SEEK_END) == 0;
+        }
+
+        [[nodiscard]] size_t position() const { return _file ? (size_t) ftell(_file.get()) : 0; }
+
+        [[nodiscard]] size_t size() const {
+            if (!_file) return 0;
+
+            auto pos = ftell(_file.get());
+            fseek(_file.get(), 0, SEEK_END);
+            auto result = ftell(_file.get());
+            fseek(_file.get(), pos, SEEK_SET);
+
+            return (size_t) result;
+        }
+
+        [[nodiscard]] int available() const { return (int) (size() - position()); }
+
+        void flush() { if (_file) fflush(_file.get()); }
+        void close() { _file = nullptr; }
+
+        [[nodiscard]] const char *path() const { return _path.c_str(); }
+        [[nodiscard]] const char *name() const {
+            auto pos = _path.find_last_of('/');
+            return pos == std::string::npos ? _path.c_str() : _path.c_str() + pos + 1;
+        }
+    };
+
+    /**
+     * File system rooted in a host directory.
+     */
+    class FS {
+        std::string _root;
+
+    public:
+        explicit FS(std::string root) : _root(std::move(root)) {}
+
+        bool begin(bool format_on_fail = false);
+        void end() {}
+
+        File open(const char *path, const char *mode = FILE_READ, bool create = false);
+
+        bool exists(const char *path);
+        bool remove(const char *path);
+        bool rename(const char *path_from, const char *path_to);
+
+        bool mkdir(const char *path);
+        bool rmdir(const char *path);
+
+    private:
+        [[nodiscard]] std::string _host_path(const char *path) const;
+    };
+}
+
+using fs::File;
+using fs::FS;
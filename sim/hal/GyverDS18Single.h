@@ -0,0 +1,59 @@
+#pragma once
+
+#include <Arduino.h>
+
+/**
+ * Simulated single DS18x20 probe.
+ * Conversion takes the real datasheet time on the virtual clock, temperature is provided by SimHal.
+ */
+class GyverDS18Single {
+    uint8_t _pin = 0;
+    uint8_t _resolution = 12;
+    bool _parasite = false;
+
+    bool _requested = false;
+    bool _converted = false;
+    unsigned long _request_time = 0;
+    float _scratchpad = 0;
+    float _temp = 0;
+
+public:
+    void setPin(uint8_t pin) { _pin = pin; }
+    void setResolution(uint8_t resolution) { _resolution = constrain(resolution, 9, 12); }
+    void setParasite(bool parasite) { _parasite = parasite; }
+
+    [[nodiscard]] uint16_t getConversionTime() const { return 750 >> (12 - _resolution); }
+
+    // Convert command is ignored by the probe while conversion is in progress
+    bool requestTemp() {
+        _latch_conversion();
+        if (_requested) return true;
+
+        _requested = true;
+        _request_time = millis();
+        return true;
+    }
+
+    // Like the real probe, scratchpad keeps the last finished conversion while a new one is in progress
+    bool readTemp() {
+        _latch_conversion();
+        if (!_converted) return false;
+
+        _temp = _scratchpad;
+        return true;
+    }
+
+    [[nodiscard]] float getTemp() const { return _temp; }
+
+private:
+    void _latch_conversion() {
+        if (!_requested || millis() - _request_time < getConversionTime()) return;
+
+        // Quantize the same way the probe does: 1/16 °C at 12 bit, 1/2 °C at 9 bit
+        const float step = 0.0625f * (float) (1 << (12 - _resolution));
+        _scratchpad = std::floor(SimHal::read_temperature(_pin) / step) * step;
+
+        _requested = false;
+        _converted = true;
+    }
+};
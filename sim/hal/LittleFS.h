@@ -0,0 +1,7 @@
+#pragma once
+
+#include "FS.h"
+
+#define SIM_FS_ROOT                             ".sim_fs"
+
+extern fs::FS LittleFS;
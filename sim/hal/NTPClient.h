@@ -0,0 +1,41 @@
+#pragma once
+
+#include <Arduino.h>
+#include <WiFiUdp.h>
+
+#define SIM_NTP_EPOCH_START                     (1735689600ul)          // 2025-01-01 00:00:00 UTC
+
+/**
+ * NTP client answering instantly with time derived from the virtual clock.
+ */
+class NTPClient {
+    long _time_offset = 0;
+    bool _time_set = false;
+
+public:
+    explicit NTPClient(UDP &) {}
+    NTPClient(UDP &, long time_offset) : _time_offset(time_offset) {}
+    NTPClient(UDP &, const char *, long time_offset = 0, unsigned long = 60000) : _time_offset(time_offset) {}
+
+    void begin(unsigned int = 1337) {}
+    void end() {}
+
+    bool update() { return forceUpdate(); }
+    bool forceUpdate() {
+        _time_set = true;
+        return true;
+    }
+
+    [[nodiscard]] bool isTimeSet() const { return _time_set; }
+
+    void setTimeOffset(long time_offset) { _time_offset = time_offset; }
+    void setUpdateInterval(unsigned long) {}
+    void setPoolServerName(const char *) {}
+
+    [[nodiscard]] unsigned long getEpochTime() const { return SIM_NTP_EPOCH_START + _time_offset + millis() / 1000; }
+
+    [[nodiscard]] int getDay() const { return (int) ((getEpochTime() / 86400L + 4) % 7); }
+    [[nodiscard]] int getHours() const { return (int) ((getEpochTime() % 86400L) / 3600); }
+    [[nodiscard]] int getMinutes() const { return (int) ((getEpochTime() % 3600) / 60); }
+    [[nodiscard]] int getSeconds() const { return (int) (getEpochTime() % 60); }
+};
@@ -0,0 +1,221 @@
+#pragma once
+
+#include <cmath>
+#include <vector>
+
+#include <Arduino.h>
+
+/**
+ * Simulated 1-Wire bus with `SimHal::one_wire_probes()` DS18B20 probes, implementing the subset of OneWire library API
+ * used by firmware on byte level. Conversion takes the real datasheet time on the virtual clock,
+ * temperatures are provided by SimHal. Timing of bus slots is not simulated.
+ */
+class OneWire {
+    enum class Mode : uint8_t {
+        IDLE,
+        ROM_COMMAND,
+        MATCH_ROM,
+        FUNCTION,
+        WRITE_SCRATCHPAD,
+        READ_SCRATCHPAD,
+    };
+
+    struct Probe {
+        uint8_t rom[8]{};
+        uint8_t scratchpad[9]{};
+
+        bool converting = false;
+        unsigned long convert_start = 0;
+    };
+
+    uint8_t _pin;
+    std::vector<Probe> _probes;
+    bool _initialized = false;
+
+    Mode _mode = Mode::IDLE;
+    int _selected = -1; // -1 addresses all probes
+    uint8_t _rom[8]{};
+    uint8_t _index = 0;
+    bool _corrupted = false;
+
+    size_t _search_next = 0;
+
+public:
+    explicit OneWire(uint8_t pin) : _pin(pin) {}
+
+    uint8_t reset() {
+        _init();
+        _latch_conversions();
+
+        _mode = Mode::ROM_COMMAND;
+        _selected = -1;
+        return !_probes.empty();
+    }
+
+    void skip() { write(0xCC); }
+
+    void select(const uint8_t rom[8]) {
+        write(0x55);
+        for (uint8_t i = 0; i < 8; ++i) write(rom[i]);
+    }
+
+    void write(uint8_t value, uint8_t = 0) {
+        switch (_mode) {
+            case Mode::ROM_COMMAND:
+                if (value == 0xCC) {
+                    _mode = Mode::FUNCTION;
+                } else if (value == 0x55) {
+                    _mode = Mode::MATCH_ROM;
+                    _index = 0;
+                } else {
+                    _mode = Mode::IDLE;
+                }
+                break;
+
+            case Mode::MATCH_ROM:
+                _rom[_index++] = value;
+                if (_index < 8) break;
+
+                _mode = Mode::FUNCTION;
+                _selected = -2; // Nobody answers unless ROM matches
+                for (size_t i = 0; i < _probes.size(); ++i) {
+                    if (memcmp(_probes[i].rom, _rom, 8) == 0) _selected = (int) i;
+                }
+                break;
+
+            case Mode::FUNCTION:
+                _function(value);
+                break;
+
+            case Mode::WRITE_SCRATCHPAD:
+                for (auto &probe: _addressed()) probe->scratchpad[2 + _index] = value;
+                if (++_index == 3) {
+                    for (auto &probe: _addressed()) _update_crc(*probe);
+                    _mode = Mode::IDLE;
+                }
+                break;
+
+            default:
+                break;
+        }
+    }
+
+    uint8_t read() {
+        if (_mode != Mode::READ_SCRATCHPAD || _selected < 0 || _index >= 9) return 0xFF;
+
+        // Disconnected probe doesn't pull the line: reads as all ones
+        if (std::isnan(SimHal::read_probe_temperature(_pin, _selected))) return 0xFF;
+
+        uint8_t value = _probes[_selected].scratchpad[_index++];
+        if (_corrupted && _index == 1) value ^= 0x10;
+
+        return value;
+    }
+
+    // Like the real probe, answers 0 while any conversion is in progress
+    uint8_t read_bit() {
+        _latch_conversions();
+        for (auto &probe: _probes) if (probe.converting) return 0;
+
+        return 1;
+    }
+
+    void depower() {}
+
+    void reset_search() { _search_next = 0; }
+
+    bool search(uint8_t *rom, bool = true) {
+        _init();
+        if (_search_next >= _probes.size()) return false;
+
+        memcpy(rom, _probes[_search_next++].rom, 8);
+        return true;
+    }
+
+    static uint8_t crc8(const uint8_t *data, uint8_t length) {
+        uint8_t crc = 0;
+        while (length--) {
+            uint8_t byte = *data++;
+            for (uint8_t i = 0; i < 8; ++i) {
+                const uint8_t mix = (crc ^ byte) & 0x01;
+                crc >>= 1;
+                if (mix) crc ^= 0x8C;
+                byte >>= 1;
+            }
+        }
+
+        return crc;
+    }
+
+private:
+    void _init() {
+        if (_initialized) return;
+        _initialized = true;
+
+        _probes.resize(SimHal::one_wire_probes());
+        for (size_t i = 0; i < _probes.size(); ++i) {
+            auto &probe = _probes[i];
+
+            // Descending serials, so search order differs from channel order
+            const uint8_t rom[7] = {0x28, (uint8_t) (0xF0 - i), _pin, 0x5A, 0x01, 0x00, 0x00};
+            memcpy(probe.rom, rom, 7);
+            probe.rom[7] = crc8(probe.rom, 7);
+
+            // Power-on scratchpad: 85 °C, 12 bit
+            const uint8_t scratchpad[8] = {0x50, 0x05, 0x4B, 0x46, 0x7F, 0xFF, 0x0C, 0x10};
+            memcpy(probe.scratchpad, scratchpad, 8);
+            _update_crc(probe);
+        }
+    }
+
+    std::vector<Probe *> _addressed() {
+        std::vector<Probe *> result;
+        if (_selected >= 0) result.push_back(&_probes[_selected]);
+        else if (_selected == -1) for (auto &probe: _probes) result.push_back(&probe);
+
+        return result;
+    }
+
+    void _function(uint8_t command) {
+        _index = 0;
+        _mode = Mode::IDLE;
+
+        if (command == 0x44) {
+            for (auto &probe: _addressed()) {
+                probe->converting = true;
+                probe->convert_start = millis();
+            }
+        } else if (command == 0x4E) {
+            _mode = Mode::WRITE_SCRATCHPAD;
+        } else if (command == 0xBE) {
+            _mode = Mode::READ_SCRATCHPAD;
+            _corrupted = SimHal::one_wire_error();
+        }
+    }
+
+    static uint8_t _resolution(const Probe &probe) { return 9 + ((probe.scratchpad[4] >> 5) & 0x03); }
+
+    void _latch_conversions() {
+        for (size_t i = 0; i < _probes.size(); ++i) {
+            auto &probe = _probes[i];
+            if (!probe.converting || millis() - probe.convert_start < (750u >> (12 - _resolution(probe)))) continue;
+
+            probe.converting = false;
+
+            // Probe source returns NAN for disconnected probe
+            const float temperature = SimHal::read_probe_temperature(_pin, i);
+            if (std::isnan(temperature)) continue;
+
+            // Undefined low bits of lower resolutions read as zero
+            const uint8_t shift = 12 - _resolution(probe);
+            const auto step = (int32_t) (1 << shift);
+            const auto raw = (int16_t) ((int32_t) std::floor(temperature * 16 / (float) step) * step);
+
+            probe.scratchpad[0] = (uint8_t) raw;
+            probe.scratchpad[1] = (uint8_t) (raw >> 8);
+            _update_crc(probe);
+        }
+    }
+
+    static void _update_crc(Probe &probe) { probe.scratchpad[8] = crc8(probe.scratchpad, 8); }
+};
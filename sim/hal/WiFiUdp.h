@@ -0,0 +1,8 @@
+#pragma once
+
+class UDP {
+public:
+    virtual ~UDP() = default;
+};
+
+class WiFiUDP : public UDP {};
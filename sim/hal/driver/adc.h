@@ -0,0 +1,180 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+#include "../sim_clock.h"
+#include "../sim_hal.h"
+
+/**
+ * Subset of ESP-IDF 4.4 continuous (DMA) ADC driver for ESP32-C3.
+ * Conversions are produced at the configured rate on the virtual clock and kept in a buffer
+ * of `max_store_buf_size` bytes; when it's full, new conversions are lost and the next read reports it.
+ */
+
+typedef int esp_err_t;
+
+#ifndef ESP_OK
+#define ESP_OK                                  (0)
+#define ESP_FAIL                                (-1)
+#define ESP_ERR_INVALID_ARG                     (0x102)
+#define ESP_ERR_INVALID_STATE                   (0x103)
+#define ESP_ERR_TIMEOUT                         (0x107)
+#endif
+
+#define SOC_ADC_DIGI_MAX_BITWIDTH               (12)
+#define SOC_ADC_DIGI_RESULT_BYTES               (4)
+#define SOC_ADC_CHANNEL_NUM(PERIPH_NUM)         ((PERIPH_NUM) == 0 ? 5 : 1)
+#define SOC_ADC_SAMPLE_FREQ_THRES_LOW           (611)
+#define SOC_ADC_SAMPLE_FREQ_THRES_HIGH          (83333)
+
+typedef enum {
+    ADC_UNIT_1 = 1,
+    ADC_UNIT_2 = 2,
+} adc_unit_t;
+
+typedef enum {
+    ADC_ATTEN_DB_0 = 0,
+    ADC_ATTEN_DB_2_5 = 1,
+    ADC_ATTEN_DB_6 = 2,
+    ADC_ATTEN_DB_11 = 3,
+} adc_atten_t;
+
+typedef enum {
+    ADC_CONV_SINGLE_UNIT_1 = 1,
+} adc_digi_convert_mode_t;
+
+typedef enum {
+    ADC_DIGI_OUTPUT_FORMAT_TYPE2 = 1,
+} adc_digi_output_format_t;
+
+typedef struct {
+    uint32_t max_store_buf_size;
+    uint32_t conv_num_each_intr;
+    uint32_t adc1_chan_mask;
+    uint32_t adc2_chan_mask;
+} adc_digi_init_config_t;
+
+typedef struct {
+    uint8_t atten;
+    uint8_t channel;
+    uint8_t unit;
+    uint8_t bit_width;
+} adc_digi_pattern_config_t;
+
+typedef struct {
+    bool conv_limit_en;
+    uint32_t conv_limit_num;
+    uint32_t pattern_num;
+    adc_digi_pattern_config_t *adc_pattern;
+    uint32_t sample_freq_hz;
+    adc_digi_convert_mode_t conv_mode;
+    adc_digi_output_format_t format;
+} adc_digi_configuration_t;
+
+typedef struct {
+    union {
+        struct {
+            uint32_t data: 12;
+            uint32_t reserved12: 1;
+            uint32_t channel: 3;
+            uint32_t unit: 1;
+            uint32_t reserved17_31: 15;
+        } type2;
+        uint32_t val;
+    };
+} adc_digi_output_data_t;
+
+struct SimAdcDigi {
+    static inline thread_local bool initialized = false;
+    static inline thread_local bool running = false;
+    static inline thread_local bool overflow = false;
+
+    static inline thread_local uint32_t buffer_size = 0; // Conversions
+    static inline thread_local uint32_t channel = 0;
+    static inline thread_local uint32_t sample_freq = 0;
+
+    static inline thread_local uint64_t produced = 0; // Conversions since start
+    static inline thread_local uint64_t consumed = 0;
+    static inline thread_local uint64_t start_us = 0;
+};
+
+inline esp_err_t adc_digi_initialize(const adc_digi_init_config_t *config) {
+    if (SimAdcDigi::initialized || config->adc1_chan_mask == 0) return ESP_ERR_INVALID_STATE;
+
+    SimAdcDigi::initialized = true;
+    SimAdcDigi::buffer_size = config->max_store_buf_size / SOC_ADC_DIGI_RESULT_BYTES;
+    return ESP_OK;
+}
+
+inline esp_err_t adc_digi_deinitialize() {
+    SimAdcDigi::initialized = false;
+    SimAdcDigi::running = false;
+    return ESP_OK;
+}
+
+inline esp_err_t adc_digi_controller_configure(const adc_digi_configuration_t *config) {
+    if (!SimAdcDigi::initialized || config->pattern_num != 1) return ESP_ERR_INVALID_ARG;
+    if (config->sample_freq_hz < SOC_ADC_SAMPLE_FREQ_THRES_LOW || config->sample_freq_hz > SOC_ADC_SAMPLE_FREQ_THRES_HIGH) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    SimAdcDigi::channel = config->adc_pattern[0].channel;
+    SimAdcDigi::sample_freq = config->sample_freq_hz;
+    return ESP_OK;
+}
+
+inline esp_err_t adc_digi_start() {
+    if (!SimAdcDigi::initialized) return ESP_ERR_INVALID_STATE;
+
+    SimAdcDigi::running = true;
+    SimAdcDigi::overflow = false;
+    SimAdcDigi::produced = 0;
+    SimAdcDigi::consumed = 0;
+    SimAdcDigi::start_us = SimClock::now_us();
+    return ESP_OK;
+}
+
+inline esp_err_t adc_digi_stop() {
+    SimAdcDigi::running = false;
+    return ESP_OK;
+}
+
+// Timeout is ignored: virtual time doesn't pass while waiting
+inline esp_err_t adc_digi_read_bytes(uint8_t *buf, uint32_t length_max, uint32_t *out_length, uint32_t) {
+    *out_length = 0;
+    if (!SimAdcDigi::running) return ESP_ERR_INVALID_STATE;
+
+    // Conversions that didn't fit in the buffer are lost
+    const auto due = (SimClock::now_us() - SimAdcDigi::start_us) * SimAdcDigi::sample_freq / 1000000;
+    if (due - SimAdcDigi::consumed > SimAdcDigi::buffer_size) {
+        SimAdcDigi::consumed = due - SimAdcDigi::buffer_size;
+        SimAdcDigi::overflow = true;
+    }
+
+    SimAdcDigi::produced = due;
+
+    const auto available = SimAdcDigi::produced - SimAdcDigi::consumed;
+    const auto count = std::min<uint64_t>(available, length_max / SOC_ADC_DIGI_RESULT_BYTES);
+    if (count == 0) return ESP_ERR_TIMEOUT;
+
+    for (uint64_t i = 0; i < count; ++i) {
+        adc_digi_output_data_t result{};
+        result.type2.data = SimHal::read_analog((uint8_t) SimAdcDigi::channel, SOC_ADC_DIGI_MAX_BITWIDTH);
+        result.type2.channel = SimAdcDigi::channel;
+        result.type2.unit = 0;
+
+        memcpy(buf + i * SOC_ADC_DIGI_RESULT_BYTES, &result, SOC_ADC_DIGI_RESULT_BYTES);
+    }
+
+    SimAdcDigi::consumed += count;
+    *out_length = (uint32_t) count * SOC_ADC_DIGI_RESULT_BYTES;
+
+    if (SimAdcDigi::overflow) {
+        SimAdcDigi::overflow = false;
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    return ESP_OK;
+}
@@ -0,0 +1,60 @@
+#include "LittleFS.h"
+
+#include <filesystem>
+
+namespace fs {
+    bool FS::begin(bool) {
+        std::error_code ec;
+        std::filesystem::create_directories(_root, ec);
+
+        return !ec;
+    }
+
+    File FS::open(const char *path, const char *mode, bool create) {
+        auto host_path = _host_path(path);
+
+        std::error_code ec;
+        if (create) std::filesystem::create_directories(std::filesystem::path(host_path).parent_path(), ec);
+
+        // Arduino "w" and "a" modes are binary and readable on ESP32 LittleFS
+        std::string host_mode = mode[0] == 'r' ? "rb" : mode[0] == 'a' ? "a+b" : "w+b";
+        auto file = fopen(host_path.c_str(), host_mode.c_str());
+        if (!file) return {};
+
+        return {file, path};
+    }
+
+    bool FS::exists(const char *path) {
+        return std::filesystem::exists(_host_path(path));
+    }
+
+    bool FS::remove(const char *path) {
+        std::error_code ec;
+        return std::filesystem::remove(_host_path(path), ec);
+    }
+
+    bool FS::rename(const char *path_from, const char *path_to) {
+        std::error_code ec;
+        std::filesystem::rename(_host_path(path_from), _host_path(path_to), ec);
+
+        return !ec;
+    }
+
+    bool FS::mkdir(const char *path) {
+        std::error_code ec;
+        std::filesystem::create_directories(_host_path(path), ec);
+
+        return !ec;
+    }
+
+    bool FS::rmdir(const char *path) {
+        std::error_code ec;
+        return std::filesystem::remove(_host_path(path), ec);
+    }
+
+    std::string FS::_host_path(const char *path) const {
+        return _root + (path[0] == '/' ? "" : "/") + path;
+    }
+}
+
+fs::FS LittleFS(SIM_FS_ROOT);
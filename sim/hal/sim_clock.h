@@ -0,0 +1,20 @@
+#pragma once
+
+#include <cstdint>
+
+/**
+ * Virtual clock driving every time source of the simulation build (millis, micros, NTP).
+ * Time moves only when the simulation loop advances it. Each thread has its own clock, so simulations can run in parallel.
+ */
+class SimClock {
+    static inline thread_local uint64_t _now_us = 0;
+
+public:
+    static uint64_t now_us() { return _now_us; }
+    static uint64_t now_ms() { return _now_us / 1000; }
+
+    static void advance_us(uint64_t us) { _now_us += us; }
+    static void advance_ms(uint64_t ms) { _now_us += ms * 1000; }
+
+    static void reset() { _now_us = 0; }
+};
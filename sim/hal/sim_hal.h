@@ -0,0 +1,190 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <functional>
+
+#define SIM_PIN_COUNT                           (32u)
+#define SIM_LEDC_CHANNEL_COUNT                  (6u)
+#define SIM_HW_TIMER_COUNT                      (2u)
+
+struct hw_timer_t {
+    bool used = false;
+    bool enabled = false;
+    bool auto_reload = false;
+
+    uint16_t divider = 1;
+    uint64_t alarm = 0;
+    uint64_t start_us = 0;
+
+    void (*isr)() = nullptr;
+};
+
+/**
+ * Hooks connecting the fake HAL to the simulated plant. State is per thread, like SimClock.
+ */
+class SimHal {
+    static inline thread_local bool _pin_state[SIM_PIN_COUNT]{};
+    static inline thread_local uint32_t _pin_toggle_count[SIM_PIN_COUNT]{};
+    static inline thread_local uint8_t _analog_resolution = 12;
+    static inline thread_local float _analog_noise = 0;
+    static inline thread_local uint32_t _analog_noise_state = 0x9e3779b9;
+
+    static inline thread_local int8_t _pin_ledc_channel[SIM_PIN_COUNT] = {
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    };
+    static inline thread_local uint8_t _ledc_resolution[SIM_LEDC_CHANNEL_COUNT]{};
+    static inline thread_local uint32_t _ledc_duty[SIM_LEDC_CHANNEL_COUNT]{};
+
+    static inline thread_local hw_timer_t _hw_timers[SIM_HW_TIMER_COUNT]{};
+
+    static inline thread_local std::function<float(uint8_t pin)> _analog_source = nullptr;
+    static inline thread_local std::function<float(uint8_t pin)> _temperature_source = nullptr;
+    static inline thread_local std::function<float(uint8_t pin, uint8_t probe)> _probe_source = nullptr;
+
+    static inline thread_local uint8_t _one_wire_probes = 1;
+    static inline thread_local float _one_wire_error_rate = 0;
+    static inline thread_local uint32_t _one_wire_noise = 0x2545f491;
+
+public:
+    static void set_analog_source(std::function<float(uint8_t pin)> fn) { _analog_source = std::move(fn); }
+    static void set_temperature_source(std::function<float(uint8_t pin)> fn) { _temperature_source = std::move(fn); }
+    static void set_probe_source(std::function<float(uint8_t pin, uint8_t probe)> fn) { _probe_source = std::move(fn); }
+
+    // Probes on every 1-Wire bus and probability of a corrupted scratchpad read
+    static void set_one_wire_probes(uint8_t count) { _one_wire_probes = count; }
+    static void set_one_wire_error_rate(float rate) { _one_wire_error_rate = rate; }
+    static uint8_t one_wire_probes() { return _one_wire_probes; }
+
+    static bool pin_state(uint8_t pin) { return pin < SIM_PIN_COUNT && _pin_state[pin]; }
+    static uint32_t pin_toggle_count(uint8_t pin) { return pin < SIM_PIN_COUNT ? _pin_toggle_count[pin] : 0; }
+
+    static void write_pin(uint8_t pin, bool state) {
+        if (pin >= SIM_PIN_COUNT) return;
+        if (_pin_state[pin] != state) _pin_toggle_count[pin]++;
+        _pin_state[pin] = state;
+    }
+
+    // Level seen by the plant: duty cycle for pins attached to LEDC, pin state otherwise
+    static float pin_output(uint8_t pin) {
+        if (pin >= SIM_PIN_COUNT) return 0;
+
+        const int8_t channel = _pin_ledc_channel[pin];
+        if (channel < 0) return _pin_state[pin] ? 1.f : 0.f;
+
+        return (float) _ledc_duty[channel] / (float) ((1u << _ledc_resolution[channel]) - 1);
+    }
+
+    static bool setup_ledc(uint8_t channel, uint8_t resolution) {
+        if (channel >= SIM_LEDC_CHANNEL_COUNT || resolution < 1 || resolution > 14) return false;
+
+        _ledc_resolution[channel] = resolution;
+        return true;
+    }
+
+    static void attach_ledc(uint8_t pin, uint8_t channel) {
+        if (pin < SIM_PIN_COUNT && channel < SIM_LEDC_CHANNEL_COUNT) _pin_ledc_channel[pin] = (int8_t) channel;
+    }
+
+    static void write_ledc(uint8_t channel, uint32_t duty) {
+        if (channel < SIM_LEDC_CHANNEL_COUNT) _ledc_duty[channel] = duty;
+    }
+
+    static hw_timer_t *hw_timer(uint8_t index) { return index < SIM_HW_TIMER_COUNT ? &_hw_timers[index] : nullptr; }
+
+    // Fire alarms of hardware timers, call after advancing SimClock. Timers count with 80 MHz APB clock
+    static void process_timers() {
+        for (auto &timer: _hw_timers) {
+            if (!timer.used || !timer.enabled || !timer.isr || timer.alarm == 0) continue;
+
+            const uint64_t period_us = timer.alarm * timer.divider / 80;
+            while (timer.enabled && SimClock::now_us() - timer.start_us >= period_us) {
+                timer.start_us += period_us;
+                if (!timer.auto_reload) timer.enabled = false;
+
+                timer.isr();
+            }
+        }
+    }
+
+    static void set_analog_resolution(uint8_t bits) { _analog_resolution = bits; }
+
+    // Gaussian noise added to every ADC conversion, RMS in LSB of 12 bit
+    static void set_analog_noise(float lsb) { _analog_noise = lsb; }
+
+    static uint16_t read_analog(uint8_t pin) { return read_analog(pin, _analog_resolution); }
+
+    // Analog source returns normalized value in range [0, 1].
+    // Converter has 12 bits: wider results are shifted, as Arduino core does
+    static uint16_t read_analog(uint8_t pin, uint8_t bits) {
+        const uint8_t shift = bits > 12 ? bits - 12 : 0;
+        const uint32_t max_value = (1u << (bits - shift)) - 1;
+
+        float value = _analog_source ? _analog_source(pin) : 0;
+        if (_analog_noise > 0) value += _gaussian() * _analog_noise / 4095.f;
+        value = value < 0 ? 0 : value > 1 ? 1 : value;
+
+        return (uint16_t) ((uint32_t) (value * (float) max_value + 0.5f) << shift);
+    }
+
+    static float read_temperature(uint8_t pin) {
+        return _temperature_source ? _temperature_source(pin) : 0;
+    }
+
+    // Temperature seen by one of the probes sharing a 1-Wire bus, same for all of them by default
+    static float read_probe_temperature(uint8_t pin, uint8_t probe) {
+        return _probe_source ? _probe_source(pin, probe) : read_temperature(pin);
+    }
+
+    // Box–Muller over deterministic xorshift, so noisy runs are reproducible
+    static float _gaussian() {
+        auto uniform = [] {
+            _analog_noise_state ^= _analog_noise_state << 13;
+            _analog_noise_state ^= _analog_noise_state >> 17;
+            _analog_noise_state ^= _analog_noise_state << 5;
+
+            return ((float) _analog_noise_state + 1.f) / 4294967296.f;
+        };
+
+        const float u1 = uniform(), u2 = uniform();
+        return std::sqrt(-2.f * std::log(u1)) * std::cos(6.2831853f * u2);
+    }
+
+    // Deterministic xorshift, so runs with errors are reproducible
+    static bool one_wire_error() {
+        if (_one_wire_error_rate <= 0) return false;
+
+        _one_wire_noise ^= _one_wire_noise << 13;
+        _one_wire_noise ^= _one_wire_noise >> 17;
+        _one_wire_noise ^= _one_wire_noise << 5;
+
+        return (float) _one_wire_noise / 4294967296.f < _one_wire_error_rate;
+    }
+
+    static void reset() {
+        for (uint8_t i = 0; i < SIM_PIN_COUNT; ++i) {
+            _pin_state[i] = false;
+            _pin_toggle_count[i] = 0;
+            _pin_ledc_channel[i] = -1;
+        }
+
+        for (auto &timer: _hw_timers) timer = {};
+
+        for (uint8_t i = 0; i < SIM_LEDC_CHANNEL_COUNT; ++i) {
+            _ledc_resolution[i] = 0;
+            _ledc_duty[i] = 0;
+        }
+
+        _analog_resolution = 12;
+        _analog_noise = 0;
+        _analog_noise_state = 0x9e3779b9;
+        _analog_source = nullptr;
+        _temperature_source = nullptr;
+        _probe_source = nullptr;
+
+        _one_wire_probes = 1;
+        _one_wire_error_rate = 0;
+        _one_wire_noise = 0x2545f491;
+    }
+};
@@ -0,0 +1,69 @@
+#include <cstdio>
+#include <cstring>
+
+#include "closed_loop.h"
+#include "commands.h"
+#include "options.h"
+
+int sim_identify(int argc, char **argv) {
+    ClosedLoopOptions options;
+    options.pid.target = 45;
+    options.pid.i_limit = IntegralLimitMode::I_SATURATE;
+    options.pid.engine = PidEngine::PID_SPECIALIZED;
+    options.duration = 4 * 3600;
+
+    IdentificationConfig identification{};
+    TuningRule rule = TuningRule::TUNING_SIMC;
+    float verify_duration = 3600;
+    const char *scenario_name = "fopdt";
+
+    for (int i = 0; i + 1 < argc; i += 2) {
+        const char *key = argv[i];
+        const char *value = argv[i + 1];
+
+        if (strcmp(key, "--scenario") == 0) scenario_name = value;
+        else if (strcmp(key, "--sensor") == 0) options.sensor = strcmp(value, "analog") == 0 ? SensorType::ANALOG_VALUE : SensorType::DSX18X;
+        else if (strcmp(key, "--from") == 0) identification.output_from = strtof(value, nullptr);
+        else if (strcmp(key, "--to") == 0) identification.output_to = strtof(value, nullptr);
+        else if (strcmp(key, "--settle-band") == 0) identification.settle_band = strtof(value, nullptr);
+        else if (strcmp(key, "--settle-time") == 0) identification.settle_time = (uint16_t) atoi(value);
+        else if (strcmp(key, "--rule") == 0) rule = (TuningRule) atoi(value);
+        else if (strcmp(key, "--verify") == 0) verify_duration = strtof(value, nullptr);
+        else if (!parse_pid_option(key, value, options.pid)) {
+            fprintf(stderr, "Unknown option %s\n", key);
+            return 1;
+        }
+    }
+
+    const auto *scenario = find_plant_scenario(scenario_name);
+    if (!scenario) {
+        fprintf(stderr, "Unknown scenario %s\n", scenario_name);
+        return 1;
+    }
+
+    auto result = run_identification(scenario->plant, options, identification);
+    if (result.state != IdentificationState::IDENT_DONE) {
+        printf("Identification failed at %s\n", __debug_enum_str(result.state));
+        return 2;
+    }
+
+    identification_apply_rule(result, rule, options.pid.k_mul);
+
+    printf("Scenario:         %s\n", scenario->name);
+    printf("Step response:    %.3f -> %.3f in %u s\n", result.initial_value, result.final_value, result.elapsed);
+    printf("FOPDT model:      K %.2f, tau %.1f s, theta %.1f s\n",
+           result.model.gain, result.model.time_constant, result.model.dead_time);
+    printf("Seeded gains:     kP %.3f, kI %.4f, kD %.3f\n", result.p, result.i, result.d);
+
+    // Verify seeded gains by a step from the initial plant temperature to the setpoint
+    options.duration = verify_duration;
+    options.pid.p = result.p;
+    options.pid.i = result.i;
+    options.pid.d = result.d;
+
+    auto metrics = run_closed_loop(scenario->plant, options);
+    printf("Closed loop:      IAE %.1f, overshoot %.1f%%, settling %.0f s, final %.2f\n",
+           metrics.iae, metrics.overshoot, metrics.settling_time, metrics.final_value);
+
+    return 0;
+}
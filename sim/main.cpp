@@ -0,0 +1,27 @@
+#include <cstdio>
+#include <cstring>
+
+#include "commands.h"
+
+int main(int argc, char **argv) {
+    // Command name is optional, default is `run`
+    if (argc < 2 || strncmp(argv[1], "--", 2) == 0) return sim_run(argc - 1, argv + 1);
+
+    const char *command = argv[1];
+    if (strcmp(command, "run") == 0) return sim_run(argc - 2, argv + 2);
+    if (strcmp(command, "bench-pid") == 0) return sim_bench_pid(argc - 2, argv + 2);
+    if (strcmp(command, "bench-loop") == 0) return sim_bench_loop(argc - 2, argv + 2);
+    if (strcmp(command, "bench-batch") == 0) return sim_bench_batch(argc - 2, argv + 2);
+    if (strcmp(command, "autotune") == 0) return sim_autotune(argc - 2, argv + 2);
+    if (strcmp(command, "identify") == 0) return sim_identify(argc - 2, argv + 2);
+    if (strcmp(command, "optimize") == 0) return sim_optimize(argc - 2, argv + 2);
+    if (strcmp(command, "replay") == 0) return sim_replay(argc - 2, argv + 2);
+    if (strcmp(command, "adc-noise") == 0) return sim_adc_noise(argc - 2, argv + 2);
+    if (strcmp(command, "bench-channels") == 0) return sim_bench_channels(argc - 2, argv + 2);
+    if (strcmp(command, "cascade") == 0) return sim_cascade(argc - 2, argv + 2);
+    if (strcmp(command, "smith") == 0) return sim_smith(argc - 2, argv + 2);
+    if (strcmp(command, "program") == 0) return sim_program(argc - 2, argv + 2);
+
+    fprintf(stderr, "Unknown command %s. Available: run, bench-pid, bench-loop, bench-batch, autotune, identify, optimize, replay, adc-noise, bench-channels, cascade, smith, program\n", command);
+    return 1;
+}
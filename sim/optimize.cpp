@@ -0,0 +1,410 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "cmd.h"
+#include "pid/tuning.h"
+
+#include "closed_loop.h"
+#include "commands.h"
+#include "options.h"
+#include "work_pool.h"
+
+struct OptimizeOptions {
+    size_t threads = 0;
+    uint32_t population = 64;
+    uint32_t generations = 12;
+    uint32_t elite = 8;
+    uint32_t seed = 1;
+
+    float overshoot_weight = 20; // Cost of 1% overshoot in IAE units, °C·s
+    float k_mul_range = 4;       // Output multiplier is searched in [k_mul / range, k_mul * range]
+};
+
+struct Candidate {
+    PidConfig pid{};
+    ClosedLoopMetrics metrics{};
+    double cost = INFINITY;
+};
+
+struct Trace {
+    float step = 0;
+    std::vector<float> sensor;
+    std::vector<float> control;
+};
+
+static double candidate_cost(const ClosedLoopMetrics &metrics, const OptimizeOptions &options) {
+    const double cost = metrics.iae + options.overshoot_weight * metrics.overshoot;
+    return std::isfinite(cost) ? cost : INFINITY;
+}
+
+/**
+ * Read `time,sensor,control` rows (seconds, sensor units, output fraction) and resample them to the median interval:
+ * sensor is interpolated linearly, control is held until the next row. Rows that don't parse (header) are skipped.
+ */
+static bool read_trace(const char *path, Trace &trace) {
+    std::ifstream in(path);
+    if (!in) return false;
+
+    std::vector<float> time, sensor, control;
+    std::string line;
+    while (std::getline(in, line)) {
+        float t, s, c;
+        if (sscanf(line.c_str(), "%f,%f,%f", &t, &s, &c) != 3) continue;
+        if (!time.empty() && t <= time.back()) continue;
+
+        time.push_back(t);
+        sensor.push_back(s);
+        control.push_back(c);
+    }
+
+    if (time.size() < 16) return false;
+
+    std::vector<float> intervals(time.size() - 1);
+    for (size_t i = 1; i < time.size(); ++i) intervals[i - 1] = time[i] - time[i - 1];
+    std::nth_element(intervals.begin(), intervals.begin() + intervals.size() / 2, intervals.end());
+    trace.step = intervals[intervals.size() / 2];
+
+    size_t row = 0;
+    for (float t = time.front(); t <= time.back(); t += trace.step) {
+        while (row + 2 < time.size() && time[row + 1] <= t) row++;
+
+        const float k = std::clamp((t - time[row]) / (time[row + 1] - time[row]), 0.f, 1.f);
+        trace.sensor.push_back(sensor[row] + (sensor[row + 1] - sensor[row]) * k);
+        trace.control.push_back(control[row]);
+    }
+
+    return true;
+}
+
+/**
+ * Least-squares FOPDT fit, assuming the process was settled at the first sample.
+ * Time constant and dead time are searched on a grid, gain is solved in closed form for each pair.
+ */
+static bool fit_trace_model(WorkPool &pool, const Trace &trace, FopdtModel &model, float &ambient, float &rmse) {
+    const size_t count = trace.sensor.size();
+    const float duration = (float) count * trace.step;
+    const float y0 = trace.sensor.front(), u0 = trace.control.front();
+
+    const size_t tau_count = 96;
+    const size_t delay_count = std::min<size_t>(count / 4, 200);
+    const float tau_min = trace.step, tau_max = duration;
+
+    struct Fit {
+        double sse = INFINITY;
+        float gain = NAN;
+        size_t delay = 0;
+    };
+
+    std::vector<Fit> fits(tau_count);
+    pool.parallel_for(tau_count, [&](size_t t) {
+        const float tau = tau_min * std::pow(tau_max / tau_min, (float) t / (float) (tau_count - 1));
+        const double alpha = 1 - std::exp(-trace.step / tau);
+
+        for (size_t delay = 0; delay < delay_count; ++delay) {
+            double x = 0, sxx = 0, sxy = 0, syy = 0;
+            for (size_t n = 0; n < count; ++n) {
+                const float u = n >= delay ? trace.control[n - delay] : u0;
+                x += alpha * (u - u0 - x);
+
+                const double y = trace.sensor[n] - y0;
+                sxx += x * x;
+                sxy += x * y;
+                syy += y * y;
+            }
+
+            if (!(sxx > 0)) continue;
+
+            const double sse = syy - sxy * sxy / sxx;
+            if (sse < fits[t].sse) fits[t] = {.sse = sse, .gain = (float) (sxy / sxx), .delay = delay};
+        }
+    });
+
+    size_t best = 0;
+    for (size_t t = 1; t < tau_count; ++t) if (fits[t].sse < fits[best].sse) best = t;
+    if (!std::isfinite(fits[best].sse)) return false;
+
+    model.gain = fits[best].gain;
+    model.time_constant = tau_min * std::pow(tau_max / tau_min, (float) best / (float) (tau_count - 1));
+    model.dead_time = (float) fits[best].delay * trace.step;
+
+    ambient = y0 - model.gain * u0;
+    rmse = (float) std::sqrt(std::max(0.0, fits[best].sse) / (double) count);
+    return true;
+}
+
+static float log_uniform(std::mt19937 &rng, float from, float to) {
+    std::uniform_real_distribution<float> dist(std::log(from), std::log(to));
+    return std::exp(dist(rng));
+}
+
+/**
+ * Random candidate around seed gains: gains within x10 of the seed, output multiplier in powers of two.
+ */
+static PidConfig random_candidate(std::mt19937 &rng, const PidConfig &base, const PidGains &seed,
+                                  const OptimizeOptions &options) {
+    PidConfig pid = base;
+    pid.k_mul = base.k_mul * log_uniform(rng, 1 / options.k_mul_range, options.k_mul_range);
+    pid.k_mul = std::exp2(std::round(std::log2(pid.k_mul)));
+
+    pid.p = log_uniform(rng, seed.p / 10, seed.p * 10) * pid.k_mul;
+    pid.i = log_uniform(rng, seed.i / 10, seed.i * 10) * pid.k_mul;
+    pid.d = rng() % 2 ? 0 : pid.p * log_uniform(rng, 0.1f, std::max(1.f, seed.p / seed.i / 4));
+
+    pid.i_limit = (IntegralLimitMode) (rng() % 8);
+    pid.kbc = std::uniform_real_distribution<float>(0, 1)(rng);
+
+    return pid;
+}
+
+/**
+ * Mutate parent: log-normal steps for gains, gaussian for kbc, random flip of one integral limit flag.
+ */
+static PidConfig mutate_candidate(std::mt19937 &rng, const PidConfig &parent, float sigma) {
+    std::normal_distribution<float> normal(0, sigma);
+    std::uniform_real_distribution<float> chance(0, 1);
+
+    PidConfig pid = parent;
+
+    // Changing multiplier keeps output scale, only fixed point resolution changes
+    if (chance(rng) < 0.1f) {
+        const float scale = rng() % 2 ? 2.f : 0.5f;
+        pid.k_mul *= scale;
+        pid.p *= scale;
+        pid.i *= scale;
+        pid.d *= scale;
+    }
+
+    pid.p *= std::exp(normal(rng));
+    pid.i *= std::exp(normal(rng));
+
+    if (pid.d > 0) pid.d = chance(rng) < 0.1f ? 0 : pid.d * std::exp(normal(rng));
+    else if (chance(rng) < 0.1f) pid.d = pid.p * 0.5f;
+
+    pid.kbc = std::clamp(pid.kbc + normal(rng) / 4, 0.f, 1.f);
+    if (chance(rng) < 0.15f) pid.i_limit = (IntegralLimitMode) ((uint8_t) pid.i_limit ^ (1u << (rng() % 3)));
+
+    return pid;
+}
+
+static bool is_dominated(const Candidate &a, const Candidate &b) {
+    return b.metrics.iae <= a.metrics.iae && b.metrics.overshoot <= a.metrics.overshoot
+           && (b.metrics.iae < a.metrics.iae || b.metrics.overshoot < a.metrics.overshoot);
+}
+
+static void print_candidate(const Candidate &c) {
+    char settling[16];
+    if (std::isnan(c.metrics.settling_time)) strcpy(settling, "-");
+    else snprintf(settling, sizeof(settling), "%.0f s", c.metrics.settling_time);
+
+    printf("%10.3f %10.4f %10.3f %6.2f %6u %8.0f %10.1f %9.1f%% %10s\n",
+           c.pid.p, c.pid.i, c.pid.d, c.pid.kbc, (unsigned) c.pid.i_limit, c.pid.k_mul,
+           c.metrics.iae, c.metrics.overshoot, settling);
+}
+
+template<typename T>
+static void print_packet(PacketType type, const T &value) {
+    const auto *bytes = (const uint8_t *) &value;
+
+    printf("%02X ", (unsigned) type);
+    for (size_t i = 0; i < sizeof(T); ++i) printf("%02x", bytes[i]);
+    printf("%*s # %s = %g\n", (int) (2 * (4 - sizeof(T)) + 2), "", __debug_enum_str(type), (double) value);
+}
+
+int sim_optimize(int argc, char **argv) {
+    ClosedLoopOptions options;
+    options.pid.target = 45;
+    options.pid.engine = PidEngine::PID_SPECIALIZED;
+    options.duration = 3600;
+    options.step_ms = 10;
+
+    OptimizeOptions optimize;
+    const char *scenario_name = "fopdt";
+    const char *trace_path = nullptr;
+
+    for (int i = 0; i + 1 < argc; i += 2) {
+        const char *key = argv[i];
+        const char *value = argv[i + 1];
+
+        if (strcmp(key, "--scenario") == 0) scenario_name = value;
+        else if (strcmp(key, "--trace") == 0) trace_path = value;
+        else if (strcmp(key, "--sensor") == 0) options.sensor = strcmp(value, "analog") == 0 ? SensorType::ANALOG_VALUE : SensorType::DSX18X;
+        else if (strcmp(key, "--duration") == 0) options.duration = strtof(value, nullptr);
+        else if (strcmp(key, "--step") == 0) options.step_ms = std::max<uint32_t>(1, (uint32_t) atoi(value));
+        else if (strcmp(key, "--threads") == 0) optimize.threads = (size_t) atoi(value);
+        else if (strcmp(key, "--population") == 0) optimize.population = std::max(2, atoi(value));
+        else if (strcmp(key, "--generations") == 0) optimize.generations = std::max(1, atoi(value));
+        else if (strcmp(key, "--elite") == 0) optimize.elite = std::max(1, atoi(value));
+        else if (strcmp(key, "--seed") == 0) optimize.seed = (uint32_t) atoi(value);
+        else if (strcmp(key, "--overshoot-weight") == 0) optimize.overshoot_weight = strtof(value, nullptr);
+        else if (!parse_pid_option(key, value, options.pid)) {
+            fprintf(stderr, "Unknown option %s\n", key);
+            return 1;
+        }
+    }
+
+    // Sample timer is shared by all threads, candidates are sampled by the regulator loop
+    options.pid.sampling = SamplingMode::SAMPLING_POLLED;
+    optimize.elite = std::min(optimize.elite, optimize.population);
+
+    WorkPool pool(optimize.threads);
+    FopdtModel model{};
+    PlantFactory plant_factory;
+
+    if (trace_path) {
+        Trace trace;
+        if (!read_trace(trace_path, trace)) {
+            fprintf(stderr, "Unable to read trace %s\n", trace_path);
+            return 1;
+        }
+
+        float ambient, rmse;
+        if (!fit_trace_model(pool, trace, model, ambient, rmse)) {
+            fprintf(stderr, "Trace has no control changes to fit model\n");
+            return 2;
+        }
+
+        printf("Trace:            %zu samples x %.2f s, fit RMSE %.3f\n", trace.sensor.size(), trace.step, rmse);
+
+        const ThermalPlantConfig plant{.ambient = ambient, .gain = model.gain,
+                                       .time_constant = model.time_constant, .dead_time = model.dead_time};
+        plant_factory = [plant](float step) { return std::make_unique<ThermalPlant>(plant, step); };
+        if (model.gain < 0) options.pid.direction = DirectionMode::PID_REVERSE;
+    } else {
+        const auto *scenario = find_plant_scenario(scenario_name);
+        if (!scenario) {
+            fprintf(stderr, "Unknown scenario %s\n", scenario_name);
+            return 1;
+        }
+
+        // Seed the search the way it is done on the device: step test first
+        auto identification_options = options;
+        identification_options.duration = 4 * 3600;
+        auto result = run_identification(scenario->plant, identification_options, IdentificationConfig{});
+        if (result.state == IdentificationState::IDENT_DONE) model = result.model;
+
+        printf("Scenario:         %s\n", scenario->name);
+        plant_factory = scenario->plant;
+    }
+
+    PidGains seed = tune_simc(model, model.dead_time);
+    if (std::isfinite(seed.p) && std::isfinite(seed.i) && seed.p > 0 && seed.i > 0) {
+        printf("FOPDT model:      K %.2f, tau %.1f s, theta %.1f s\n", model.gain, model.time_constant, model.dead_time);
+    } else {
+        seed = {.p = options.pid.p / options.pid.k_mul, .i = std::max(1e-6f, options.pid.i / options.pid.k_mul), .d = 0};
+        printf("FOPDT model:      unavailable, search around configured gains\n");
+    }
+
+    Candidate baseline{.pid = options.pid};
+    baseline.metrics = run_closed_loop(plant_factory, options);
+    baseline.cost = candidate_cost(baseline.metrics, optimize);
+
+    printf("Threads:          %zu\n", pool.size());
+    printf("Search:           %u generations x %u candidates, overshoot weight %.1f\n\n",
+           optimize.generations, optimize.population, optimize.overshoot_weight);
+
+    const auto wall_start = std::chrono::steady_clock::now();
+
+    std::vector<Candidate> population(optimize.population);
+    std::vector<Candidate> evaluated;
+    std::vector<Candidate> elite;
+
+    for (uint32_t generation = 0; generation < optimize.generations; ++generation) {
+        // Search narrows down from x1.6 to a few percent per step
+        const float sigma = 0.5f * std::pow(0.1f, (float) generation / (float) std::max(1u, optimize.generations - 1));
+
+        for (uint32_t i = 0; i < optimize.population; ++i) {
+            // Candidate depends only on its seed, not on scheduling, so results are reproducible
+            std::mt19937 rng(optimize.seed * 1000003u + generation * 10007u + i);
+
+            auto &pid = population[i].pid;
+            if (generation == 0) {
+                if (i == 0) pid = options.pid;
+                else if (i <= 8) {
+                    pid = options.pid;
+                    pid.p = seed.p * pid.k_mul;
+                    pid.i = seed.i * pid.k_mul;
+                    pid.d = seed.d * pid.k_mul;
+                    pid.i_limit = (IntegralLimitMode) (i - 1);
+                } else {
+                    pid = random_candidate(rng, options.pid, seed, optimize);
+                }
+            } else {
+                // Elite survive unchanged, others are children of elite ranked by cost
+                if (i < elite.size()) pid = elite[i].pid;
+                else pid = mutate_candidate(rng, elite[rng() % elite.size()].pid, sigma);
+            }
+
+            if (!((uint8_t) pid.i_limit & (uint8_t) IntegralLimitMode::I_BACK_CALC)) pid.kbc = 0;
+        }
+
+        pool.parallel_for(population.size(), [&](size_t index) {
+            auto candidate_options = options;
+            candidate_options.pid = population[index].pid;
+
+            population[index].metrics = run_closed_loop(plant_factory, candidate_options);
+            population[index].cost = candidate_cost(population[index].metrics, optimize);
+        });
+
+        evaluated.insert(evaluated.end(), population.begin(), population.end());
+
+        elite = population;
+        std::stable_sort(elite.begin(), elite.end(), [](auto &a, auto &b) { return a.cost < b.cost; });
+        elite.resize(optimize.elite);
+
+        printf("Generation %2u:    cost %10.1f, IAE %10.1f, overshoot %5.1f%%\n",
+               generation + 1, elite[0].cost, elite[0].metrics.iae, elite[0].metrics.overshoot);
+    }
+
+    std::chrono::duration<double> wall_time = std::chrono::steady_clock::now() - wall_start;
+    printf("\nEvaluated %zu candidates in %.1f s wall time\n", evaluated.size(), wall_time.count());
+
+    // Trade-off between IAE and overshoot among every evaluated candidate
+    std::vector<Candidate> front;
+    for (auto &candidate: evaluated) {
+        if (!std::isfinite(candidate.cost)) continue;
+
+        bool dominated = false;
+        for (auto &other: evaluated) {
+            if (std::isfinite(other.cost) && is_dominated(candidate, other)) {
+                dominated = true;
+                break;
+            }
+        }
+
+        const bool duplicate = std::any_of(front.begin(), front.end(), [&](auto &c) {
+            return c.metrics.iae == candidate.metrics.iae && c.metrics.overshoot == candidate.metrics.overshoot;
+        });
+        if (!dominated && !duplicate) front.push_back(candidate);
+    }
+
+    std::sort(front.begin(), front.end(), [](auto &a, auto &b) { return a.metrics.iae < b.metrics.iae; });
+
+    printf("\n%-10s %10s %10s %10s %6s %6s %8s %10s %10s %10s\n",
+           "", "kP", "kI", "kD", "kBC", "Limit", "kMul", "IAE", "Overshoot", "Settling");
+    printf("%-10s ", "Baseline");
+    print_candidate(baseline);
+    for (size_t i = 0; i < front.size(); ++i) {
+        printf("%-10s ", i == 0 ? "Front" : "");
+        print_candidate(front[i]);
+    }
+    printf("%-10s ", "Best");
+    print_candidate(elite[0]);
+
+    const auto &best = elite[0].pid;
+    printf("\nPackets (type, little-endian payload):\n");
+    print_packet(PacketType::PID_K_MUL, best.k_mul);
+    print_packet(PacketType::PID_P, best.p);
+    print_packet(PacketType::PID_I, best.i);
+    print_packet(PacketType::PID_D, best.d);
+    print_packet(PacketType::PID_KBC, best.kbc);
+    print_packet(PacketType::PID_I_LIMIT, (uint8_t) best.i_limit);
+    if (best.direction != DirectionMode::PID_FORWARD) print_packet(PacketType::PID_DIRECTION, (uint8_t) best.direction);
+
+    return 0;
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstdlib>
+#include <cstring>
+
+#include "app/config.h"
+
+inline SamplingMode parse_sampling_mode(const char *value) {
+    if (strcmp(value, "timer") == 0) return SamplingMode::SAMPLING_TIMER;
+    if (strcmp(value, "event") == 0) return SamplingMode::SAMPLING_EVENT;
+
+    return SamplingMode::SAMPLING_POLLED;
+}
+
+/**
+ * Parse PID related option shared by all commands.
+ * @return false if key is not a PID option
+ */
+inline bool parse_pid_option(const char *key, const char *value, PidConfig &pid) {
+    const float f_value = strtof(value, nullptr);
+
+    if (strcmp(key, "--target") == 0) pid.target = f_value;
+    else if (strcmp(key, "--interval") == 0) pid.interval = (uint16_t) f_value;
+    else if (strcmp(key, "--p") == 0) pid.p = f_value;
+    else if (strcmp(key, "--i") == 0) pid.i = f_value;
+    else if (strcmp(key, "--d") == 0) pid.d = f_value;
+    else if (strcmp(key, "--k-mul") == 0) pid.k_mul = f_value;
+    else if (strcmp(key, "--kbc") == 0) pid.kbc = f_value;
+    else if (strcmp(key, "--out-min") == 0) pid.out_min = f_value;
+    else if (strcmp(key, "--out-max") == 0) pid.out_max = f_value;
+    else if (strcmp(key, "--p-mode") == 0) pid.p_mode = (ProportionalMode) atoi(value);
+    else if (strcmp(key, "--i-mode") == 0) pid.i_mode = (IntegralMode) atoi(value);
+    else if (strcmp(key, "--i-limit") == 0) pid.i_limit = (IntegralLimitMode) atoi(value);
+    else if (strcmp(key, "--d-mode") == 0) pid.d_mode = (DifferentialMode) atoi(value);
+    else if (strcmp(key, "--direction") == 0) pid.direction = (DirectionMode) atoi(value);
+    else if (strcmp(key, "--engine") == 0) pid.engine = (PidEngine) atoi(value);
+    else if (strcmp(key, "--sampling") == 0) pid.sampling = parse_sampling_mode(value);
+    else return false;
+
+    return true;
+}
+
+/**
+ * Parse Smith predictor option: `--predictor 1` enables it, `--model-*` set its FOPDT model.
+ * @return false if key is not a predictor option
+ */
+inline bool parse_predictor_option(const char *key, const char *value, SmithPredictorConfig &predictor) {
+    const float f_value = strtof(value, nullptr);
+
+    if (strcmp(key, "--predictor") == 0) predictor.enabled = atoi(value) != 0;
+    else if (strcmp(key, "--model-gain") == 0) predictor.model.gain = f_value;
+    else if (strcmp(key, "--model-tau") == 0) predictor.model.time_constant = f_value;
+    else if (strcmp(key, "--model-dead-time") == 0) predictor.model.dead_time = f_value;
+    else return false;
+
+    return true;
+}
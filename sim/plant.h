@@ -0,0 +1,177 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+/**
+ * Simulated process driven by control output in range [0, 1]. Step size is fixed on construction.
+ */
+class Plant {
+public:
+    virtual ~Plant() = default;
+
+    [[nodiscard]] virtual float temperature() const = 0;
+    virtual void step(float input) = 0;
+};
+
+/**
+ * First-order-plus-dead-time heater: dT/dt = (gain * u(t - dead_time) - (T - ambient)) / time_constant
+ */
+struct ThermalPlantConfig {
+    float ambient = 20;        // Ambient temperature
+    float gain = 60;           // Steady-state temperature rise at full power
+    float time_constant = 120; // Time constant in seconds
+    float dead_time = 2;       // Transport delay in seconds
+};
+
+class ThermalPlant : public Plant {
+    ThermalPlantConfig _config;
+    float _step;
+
+    float _temperature;
+
+    std::vector<float> _delay_line;
+    size_t _delay_index = 0;
+
+public:
+    ThermalPlant(const ThermalPlantConfig &config, float step) :
+        _config(config), _step(step), _temperature(config.ambient),
+        _delay_line(std::max<size_t>(1, (size_t) (config.dead_time / step)), 0.f) {}
+
+    [[nodiscard]] float temperature() const override { return _temperature; }
+
+    void step(float input) override {
+        float delayed = _delay_line[_delay_index];
+        _delay_line[_delay_index] = input;
+        _delay_index = (_delay_index + 1) % _delay_line.size();
+
+        _temperature += (_config.gain * delayed - (_temperature - _config.ambient)) / _config.time_constant * _step;
+    }
+};
+
+/**
+ * Heating element coupled to a thermal mass which loses heat to ambient. Sensor measures the mass.
+ * Second-order lag: element heats up first, so the mass keeps warming after power is cut.
+ */
+struct ThermalMassPlantConfig {
+    float ambient = 20;
+    float power = 150;             // Heater power at full output, W
+    float element_capacity = 150;  // Heat capacity of heating element, J/K
+    float mass_capacity = 1500;    // Heat capacity of heated mass, J/K
+    float coupling = 8;            // Element to mass thermal conductance, W/K
+    float loss = 3;                // Mass to ambient thermal conductance, W/K
+};
+
+class ThermalMassPlant : public Plant {
+    ThermalMassPlantConfig _config;
+    float _step;
+
+    float _element;
+    float _mass;
+
+    float _supply = 1; // Fraction of heater power available
+    float _load = 0;   // Extra heat drawn from the mass, W
+
+public:
+    ThermalMassPlant(const ThermalMassPlantConfig &config, float step) :
+        _config(config), _step(step), _element(config.ambient), _mass(config.ambient) {}
+
+    [[nodiscard]] float temperature() const override { return _mass; }
+    [[nodiscard]] float element() const { return _element; }
+
+    // Disturbances: supply drop is seen by the element first, heat load by the mass
+    void set_supply(float supply) { _supply = supply; }
+    void set_load(float load) { _load = load; }
+
+    void step(float input) override {
+        const float flow = _config.coupling * (_element - _mass);
+
+        _element += (_config.power * _supply * input - flow) / _config.element_capacity * _step;
+        _mass += (flow - _load - _config.loss * (_mass - _config.ambient)) / _config.mass_capacity * _step;
+    }
+};
+
+/**
+ * Non-ideal actuator in front of another plant: output below `dead_zone` does nothing,
+ * output is limited to `max_output` and can't change faster than `slew_rate` per second.
+ */
+struct SaturatingActuatorConfig {
+    float dead_zone = 0.05;
+    float max_output = 0.7;
+    float slew_rate = 0.5;
+};
+
+class SaturatingActuator : public Plant {
+    std::unique_ptr<Plant> _plant;
+    SaturatingActuatorConfig _config;
+    float _step;
+
+    float _output = 0;
+
+public:
+    SaturatingActuator(std::unique_ptr<Plant> plant, const SaturatingActuatorConfig &config, float step) :
+        _plant(std::move(plant)), _config(config), _step(step) {}
+
+    [[nodiscard]] float temperature() const override { return _plant->temperature(); }
+
+    void step(float input) override {
+        float target = input < _config.dead_zone ? 0 : std::min(input, _config.max_output);
+
+        const float max_delta = _config.slew_rate * _step;
+        _output += std::clamp(target - _output, -max_delta, max_delta);
+
+        _plant->step(_output);
+    }
+};
+
+/**
+ * `ThermalPlant` lanes stored as structure of arrays and stepped together, same arithmetic per lane.
+ * Lanes may differ in gain, time constant and ambient; dead time is shared and taken from the first config.
+ */
+class ThermalPlantBatch {
+    size_t _size;
+    float _step;
+
+    std::vector<float> _gain, _time_constant, _ambient;
+    std::vector<float> _temperature;
+
+    std::vector<float> _delay_line; // Delay slots one after another, each holds a value per lane
+    size_t _delay_length;
+    size_t _delay_index = 0;
+
+public:
+    ThermalPlantBatch(const std::vector<ThermalPlantConfig> &configs, float step) :
+        _size(configs.size()), _step(step),
+        _delay_length(configs.empty() ? 1 : std::max<size_t>(1, (size_t) (configs[0].dead_time / step))) {
+        for (auto &config: configs) {
+            _gain.push_back(config.gain);
+            _time_constant.push_back(config.time_constant);
+            _ambient.push_back(config.ambient);
+            _temperature.push_back(config.ambient);
+        }
+
+        _delay_line.assign(_delay_length * _size, 0.f);
+    }
+
+    [[nodiscard]] size_t size() const { return _size; }
+    [[nodiscard]] const float *temperature() const { return _temperature.data(); }
+
+    void step(const float *__restrict input) {
+        float *__restrict slot = _delay_line.data() + _delay_index * _size;
+        float *__restrict temperature = _temperature.data();
+        const float *__restrict gain = _gain.data();
+        const float *__restrict time_constant = _time_constant.data();
+        const float *__restrict ambient = _ambient.data();
+
+        for (size_t i = 0; i < _size; ++i) {
+            const float delayed = slot[i];
+            slot[i] = input[i];
+
+            temperature[i] += (gain[i] * delayed - (temperature[i] - ambient[i])) / time_constant[i] * _step;
+        }
+
+        _delay_index = (_delay_index + 1) % _delay_length;
+    }
+};
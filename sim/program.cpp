@@ -0,0 +1,256 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include <LittleFS.h>
+
+#include "lib/misc/timer.h"
+
+#include "app/regulator.h"
+#include "misc/sample_timer.h"
+#include "misc/setpoint_program.h"
+#include "pid/tuning.h"
+
+#include "commands.h"
+#include "options.h"
+#include "plant.h"
+
+struct ProgramOptions {
+    ThermalPlantConfig plant{};
+    float sensor_delay = 1;      // Added to model dead time: conversion of the sensor and half of the interval, seconds
+    float closed_loop_time = 30; // τc of SIMC gains, seconds
+    float hold_band = 1.5f;      // Of every segment, °C; 0 never holds
+    float rate_scale = 1;        // Multiplier of ramp rates of the profile
+    uint8_t slot = 0;
+};
+
+struct ProgramMetrics {
+    double ramp_iae = 0;      // |setpoint - temperature| while ramping, °C·s
+    double soak_iae = 0;      // Same while soaking, °C·s
+    float ramp_error = 0;     // Max |error| while ramping, °C
+    float soak_overshoot = 0; // Max temperature beyond a soak setpoint in the direction of the preceding ramp, °C
+    float finished = NAN;     // Wall time when the program was done, seconds; NAN if it didn't finish
+    uint32_t held = 0;        // Program time lost on hold, seconds
+    uint32_t duration = 0;    // Program time, seconds
+};
+
+/**
+ * Cure cycle of an oven: ramp to the dwell, dwell, ramp to the cure temperature, cure, controlled cool-down.
+ */
+static SetpointProgram make_profile(const ProgramOptions &options) {
+    SetpointProgram program{};
+
+    const ProgramSegment segments[] = {
+        {.target = 40, .rate = 0.1f, .soak = 300},
+        {.target = 65, .rate = 0.05f, .soak = 600},
+        {.target = 30, .rate = 0.05f, .soak = 0},
+    };
+
+    for (const auto &segment: segments) {
+        auto &item = program.segments[program.count++];
+        item = segment;
+        item.rate *= options.rate_scale;
+        item.hold_band = options.hold_band;
+    }
+
+    return program;
+}
+
+static ProgramMetrics simulate(const ProgramOptions &options, const PidConfig &pid, const FopdtModel &model,
+                               const SetpointProgram &program) {
+    SimClock::reset();
+    SimHal::reset();
+
+    RegulatorConfig config{};
+    config.pid = pid;
+    config.sensor.type = SensorType::DSX18X;
+    config.sensor.reset_data();
+    config.control.type = ControlType::PWM_VALUE;
+    config.control.reset_data();
+
+    // Model is used for feed-forward only
+    config.predictor = {.enabled = false, .model = model, .model_valid = true};
+
+    const uint8_t control_pin = config.control.data[0];
+
+    const float dt = 0.001f;
+    ThermalPlant plant(options.plant, dt);
+    SimHal::set_temperature_source([&](auto) { return plant.temperature(); });
+
+    ProgramMetrics metrics;
+    {
+        Timer timer;
+        Regulator regulator(timer, config);
+
+        regulator.begin();
+        regulator.load(config.pid, true);
+        regulator.set_predictor(config.predictor);
+
+        // Program starts from the first measured value, as it does after PROGRAM_START
+        bool started = false;
+        timer.add_interval([&](auto) {
+            if (regulator.update() && !started) {
+                regulator.set_program(true, program);
+                started = true;
+            }
+        }, APP_SERVICE_LOOP_INTERVAL);
+
+        float previous_target = options.plant.ambient;
+        uint8_t segment = 0;
+
+        const auto max_steps = (uint64_t) (4 * 3600 * 1000);
+        for (uint64_t step = 0; step < max_steps; ++step) {
+            plant.step(SimHal::pin_output(control_pin));
+
+            timer.handle_timers();
+            SimClock::advance_ms(1);
+            SimHal::process_timers();
+
+            const auto &status = regulator.program();
+            if (!started) continue;
+
+            if (status.state == ProgramState::PROGRAM_DONE || status.state == ProgramState::PROGRAM_FAILED) {
+                metrics.finished = (float) (step + 1) * dt;
+                break;
+            }
+
+            if (status.segment != segment) {
+                previous_target = program.segments[segment].target;
+                segment = status.segment;
+            }
+
+            const float direction = program.segments[segment].target >= previous_target ? 1.f : -1.f;
+
+            const float error = status.setpoint - plant.temperature();
+            if (status.ramp) {
+                metrics.ramp_iae += std::abs(error) * dt;
+                metrics.ramp_error = std::max(metrics.ramp_error, std::abs(error));
+            } else {
+                metrics.soak_iae += std::abs(error) * dt;
+                metrics.soak_overshoot = std::max(metrics.soak_overshoot, -error * direction);
+            }
+        }
+
+        metrics.held = regulator.program().held;
+        metrics.duration = regulator.program().duration;
+
+        SampleTimer::end();
+    }
+
+    SimHal::set_temperature_source(nullptr);
+    return metrics;
+}
+
+/**
+ * Cost of a single `ProgramRunner::update` over the whole program, ns.
+ */
+static double bench_runner(const SetpointProgram &program, uint32_t ticks) {
+    ProgramRunner runner;
+    runner.begin(program, 20, 0);
+
+    const uint32_t step = std::max<uint32_t>(1, runner.status().duration * 1000 / ticks);
+
+    float sink = 0;
+    const auto start = std::chrono::steady_clock::now();
+    for (uint32_t i = 1; i <= ticks; ++i) {
+        runner.update(i * step, runner.setpoint());
+        sink += runner.setpoint();
+    }
+    const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+
+    if (!std::isfinite(sink)) printf("Unexpected setpoint\n");
+    return elapsed.count() / ticks;
+}
+
+static void print_row(const char *name, const ProgramMetrics &m) {
+    printf("%-16s %10.1f %10.2f° %10.1f %10.2f° %7u s %8.0f s %9u s\n", name,
+           m.ramp_iae, m.ramp_error, m.soak_iae, m.soak_overshoot, m.held, m.finished, m.duration);
+}
+
+/**
+ * FOPDT oven following a cure profile: feed-forward from the ramp slope off and on,
+ * with program time held while the oven lags behind the setpoint by more than the hold band.
+ * The profile goes through a program slot file, as it would when uploaded with PROGRAM_DATA.
+ */
+int sim_program(int argc, char **argv) {
+    ProgramOptions options;
+
+    PidConfig pid{};
+    pid.i_limit = IntegralLimitMode::I_SATURATE;
+    pid.engine = PidEngine::PID_SPECIALIZED;
+
+    bool custom_gains = false;
+    for (int i = 0; i + 1 < argc; i += 2) {
+        const char *key = argv[i];
+        const char *value = argv[i + 1];
+
+        if (parse_pid_option(key, value, pid)) {
+            custom_gains |= strcmp(key, "--p") == 0 || strcmp(key, "--i") == 0;
+            continue;
+        }
+
+        if (strcmp(key, "--gain") == 0) options.plant.gain = strtof(value, nullptr);
+        else if (strcmp(key, "--tau") == 0) options.plant.time_constant = strtof(value, nullptr);
+        else if (strcmp(key, "--dead-time") == 0) options.plant.dead_time = strtof(value, nullptr);
+        else if (strcmp(key, "--sensor-delay") == 0) options.sensor_delay = strtof(value, nullptr);
+        else if (strcmp(key, "--closed-loop-time") == 0) options.closed_loop_time = strtof(value, nullptr);
+        else if (strcmp(key, "--hold-band") == 0) options.hold_band = strtof(value, nullptr);
+        else if (strcmp(key, "--rate-scale") == 0) options.rate_scale = strtof(value, nullptr);
+        else if (strcmp(key, "--slot") == 0) options.slot = (uint8_t) atoi(value);
+        else {
+            fprintf(stderr, "Unknown option %s\n", key);
+            return 1;
+        }
+    }
+
+    const FopdtModel model{
+        .gain = options.plant.gain,
+        .time_constant = options.plant.time_constant,
+        .dead_time = options.plant.dead_time + options.sensor_delay
+    };
+
+    if (!custom_gains) {
+        const auto gains = tune_simc(model, options.closed_loop_time);
+        pid.p = gains.p * pid.k_mul;
+        pid.i = gains.i * pid.k_mul;
+        pid.d = 0;
+    }
+
+    LittleFS.begin();
+
+    SetpointProgram program{};
+    if (!program_save(LittleFS, options.slot, make_profile(options)) || !program_load(LittleFS, options.slot, program)) {
+        fprintf(stderr, "Unable to store program in slot %u\n", options.slot);
+        return 1;
+    }
+
+    printf("Plant: K %.1f, tau %.0f s, theta %.1f s; kP %.3f, kI %.5f; %u segments, %zu bytes in slot %u\n",
+           options.plant.gain, options.plant.time_constant, options.plant.dead_time, pid.p, pid.i,
+           program.count, program.size(), options.slot);
+    printf("%-16s %10s %11s %10s %11s %9s %10s %11s\n",
+           "Mode", "Ramp IAE", "Ramp max", "Soak IAE", "Overshoot", "Held", "Finished", "Program");
+
+    program.feed_forward = false;
+    print_row("pid", simulate(options, pid, model, program));
+
+    program.feed_forward = true;
+    print_row("feed-forward", simulate(options, pid, model, program));
+
+    // Longest program the index serves in the same number of steps as the shortest
+    SetpointProgram longest{};
+    for (uint8_t i = 0; i < PROGRAM_MAX_SEGMENTS; ++i) {
+        longest.segments[longest.count++] = {.target = (float) (i % 2 ? 30 : 60), .rate = 0.1f, .soak = 60};
+    }
+
+    SetpointProgram shortest{};
+    shortest.segments[shortest.count++] = {.target = 60, .rate = 0.1f, .soak = 60};
+
+    const uint32_t ticks = 1000000;
+    printf("Evaluation: %.1f ns/tick with %u segment, %.1f ns/tick with %u segments\n",
+           bench_runner(shortest, ticks), shortest.count, bench_runner(longest, ticks), longest.count);
+
+    return 0;
+}
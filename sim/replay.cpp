@@ -0,0 +1,159 @@
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <LittleFS.h>
+
+#include "misc/sensor_log.h"
+#include "pid/factory.h"
+
+#include "commands.h"
+#include "options.h"
+
+struct ReplayStats {
+    uint32_t snapshots = 0;
+    uint32_t samples = 0;
+    uint32_t computes = 0;
+
+    uint32_t mismatched = 0;
+    uint32_t first_mismatch = 0; // Sample index
+    double max_deviation = 0;
+    double recorded_sum = 0;
+    double replayed_sum = 0;
+};
+
+static bool read_file(const char *path, std::vector<uint8_t> &data) {
+    auto file = fopen(path, "rb");
+    if (!file) return false;
+
+    uint8_t buffer[4096];
+    size_t length;
+    while ((length = fread(buffer, 1, sizeof(buffer), file)) > 0) data.insert(data.end(), buffer, buffer + length);
+
+    fclose(file);
+    return true;
+}
+
+/**
+ * Recompute PID output for every sample of a sensor log, starting from regulator state stored in snapshots.
+ * Without overrides output must match the recorded one bit-exactly; with overrides shows how other settings
+ * would have reacted to the same input (open loop: the process doesn't respond to the new output).
+ */
+int sim_replay(int argc, char **argv) {
+    std::string path = std::string(SIM_FS_ROOT) + SENSOR_LOG_PATH;
+    std::vector<std::pair<const char *, const char *>> overrides;
+
+    for (int i = 0; i + 1 < argc; i += 2) {
+        const char *key = argv[i];
+        const char *value = argv[i + 1];
+
+        PidConfig probe{};
+        if (strcmp(key, "--log") == 0) path = value;
+        else if (parse_pid_option(key, value, probe)) overrides.emplace_back(key, value);
+        else {
+            fprintf(stderr, "Unknown option %s\n", key);
+            return 1;
+        }
+    }
+
+    std::vector<uint8_t> data;
+    if (!read_file(path.c_str(), data)) {
+        fprintf(stderr, "Unable to read %s\n", path.c_str());
+        return 1;
+    }
+
+    SensorLogHeader header;
+    if (!SensorLogDecoder::header(data.data(), data.size(), header)) {
+        fprintf(stderr, "%s is not a sensor log of version %u\n", path.c_str(), SENSOR_LOG_VERSION);
+        return 1;
+    }
+
+    SensorLogDecoder decoder;
+    SensorLogRecord record;
+    ReplayStats stats;
+
+    std::unique_ptr<PidBase> pid = nullptr;
+    PidConfig config{};
+    bool state_mismatch = false;
+
+    bool has_last_sample = false;
+    uint32_t last_sample_time = 0;
+
+    size_t offset = sizeof(SensorLogHeader);
+    while (offset < data.size()) {
+        const auto length = decoder.next(data.data() + offset, data.size() - offset, record);
+        if (length <= 0) {
+            fprintf(stderr, "Log is %s at byte %zu\n", length == 0 ? "truncated" : "corrupted", offset);
+            break;
+        }
+
+        offset += length;
+
+        if (record.type == SENSOR_LOG_SNAPSHOT) {
+            const auto &snapshot = record.snapshot;
+
+            config = snapshot.pid;
+            for (auto &[key, value]: overrides) parse_pid_option(key, value, config);
+
+            if (!pid || config.engine != snapshot.pid.engine) pid = make_pid(config.engine);
+            pid->configure(config);
+
+            // State of another engine can't be restored
+            if (!pid->load_state(snapshot.pid_state, snapshot.pid_state_size)) {
+                pid->reset();
+                state_mismatch = true;
+            }
+
+            has_last_sample = snapshot.has_last_sample;
+            last_sample_time = snapshot.last_sample_time;
+
+            stats.snapshots++;
+            continue;
+        }
+
+        const auto &sample = record.sample;
+        if (!pid) continue;
+
+        const auto dt_scale = has_last_sample ? pid_dt_scale(sample.time_us - last_sample_time, config.interval) : PID_DT_NOMINAL;
+
+        has_last_sample = true;
+        last_sample_time = sample.time_us;
+        stats.samples++;
+
+        // Autotune and step test outputs are not reproduced
+        if (!sample.pid) continue;
+
+        const float out = pid->compute(sample.sensor_value, dt_scale);
+        stats.computes++;
+
+        if (memcmp(&out, &sample.control_value, sizeof(out)) != 0) {
+            if (stats.mismatched == 0) stats.first_mismatch = stats.samples - 1;
+            stats.mismatched++;
+        }
+
+        stats.max_deviation = std::max(stats.max_deviation, (double) std::abs(out - sample.control_value));
+        stats.recorded_sum += sample.control_value;
+        stats.replayed_sum += out;
+    }
+
+    printf("Log:              %s, %zu bytes, sensor %s\n", path.c_str(), data.size(), __debug_enum_str(header.sensor));
+    printf("Records:          %u snapshots, %u samples, %u PID outputs\n", stats.snapshots, stats.samples, stats.computes);
+    if (state_mismatch) printf("Warning:          engine differs from recorded one, PID state reset at snapshots\n");
+
+    const double computes = std::max(1u, stats.computes);
+    printf("Mean output:      recorded %.4f, replayed %.4f\n", stats.recorded_sum / computes, stats.replayed_sum / computes);
+    printf("Max deviation:    %g\n", stats.max_deviation);
+
+    if (!overrides.empty()) return 0;
+
+    if (stats.mismatched > 0) {
+        printf("Mismatched:       %u outputs, first at sample %u\n", stats.mismatched, stats.first_mismatch);
+        return 2;
+    }
+
+    printf("Mismatched:       0 outputs, replay is bit-exact\n");
+    return 0;
+}
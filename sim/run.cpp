@@ -0,0 +1,355 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include <LittleFS.h>
+
+#include "lib/misc/ntp_time.h"
+#include "lib/misc/timer.h"
+
+#include "app/config.h"
+#include "app/regulator.h"
+#include "misc/history_archive.h"
+#include "misc/night_mode.h"
+#include "misc/sensor_log.h"
+#include "sensors/analog_sensor.h"
+
+#include "commands.h"
+#include "options.h"
+#include "plant.h"
+
+using SimDuration = std::chrono::duration<double, std::nano>;
+
+struct SimOptions {
+    float hours = 1;
+    uint32_t step_ms = 1;
+
+    SensorType sensor = SensorType::DSX18X;
+    ControlType control = ControlType::PWM_VALUE;
+    float analog_scale = 100; // Temperature that corresponds to full-scale ADC reading
+    bool continuous = false;  // Oversampled DMA conversions for analog sensor
+    uint8_t resolution = 12;  // Analog sensor resolution
+    float adc_noise = 0;      // RMS noise of conversions, LSB of 12 bit
+    bool archive = false;
+    bool record = false;
+
+    uint8_t probes = 1;       // DS18x20 probes on the bus, all see plant temperature
+    uint8_t channel = 0;      // Probe used by the bus sensor
+    float bus_errors = 0;     // Probability of corrupted scratchpad read
+
+    SensorFilterConfig filter{};
+    SmithPredictorConfig predictor{};
+
+    SensorVoting voting = SensorVoting::VOTING_MEDIAN; // Redundant probes of `group` sensor
+    int fault_probe = -1;     // Probe failing at `fault_at`
+    const char *fault = "drop";
+    float fault_at = 600;     // Seconds
+
+    PidConfig pid{};
+    ThermalPlantConfig plant{};
+};
+
+struct SimStats {
+    uint64_t timer_calls = 0;
+    SimDuration timer_time{};
+
+    uint64_t regulator_calls = 0;
+    uint64_t regulator_computes = 0;
+    SimDuration regulator_time{};
+    SimDuration regulator_max_time{};
+
+    double abs_error_sum = 0;
+    double control_change_sum = 0; // Output noise: sum of |Δcontrol| between computes
+    uint32_t max_compute_gap = 0;  // Longest time without control update after the first one, ms
+    uint32_t last_compute = 0;
+};
+
+static SensorType parse_sensor_type(const char *value) {
+    if (strcmp(value, "analog") == 0) return SensorType::ANALOG_VALUE;
+    if (strcmp(value, "replay") == 0) return SensorType::REPLAY;
+    if (strcmp(value, "bus") == 0) return SensorType::DSX18X_BUS;
+    if (strcmp(value, "group") == 0) return SensorType::DSX18X_GROUP;
+
+    return SensorType::DSX18X;
+}
+
+static bool parse_run_options(int argc, char **argv, SimOptions &options) {
+    for (int i = 0; i < argc; ++i) {
+        const char *key = argv[i];
+        if (i + 1 >= argc) {
+            fprintf(stderr, "Missing value for %s\n", key);
+            return false;
+        }
+
+        const char *value = argv[++i];
+        float f_value = strtof(value, nullptr);
+
+        if (strcmp(key, "--hours") == 0) options.hours = f_value;
+        else if (strcmp(key, "--step") == 0) options.step_ms = std::max<uint32_t>(1, (uint32_t) f_value);
+        else if (strcmp(key, "--sensor") == 0) options.sensor = parse_sensor_type(value);
+        else if (strcmp(key, "--control") == 0) options.control = strcmp(value, "ledc") == 0 ? ControlType::LEDC_PWM : ControlType::PWM_VALUE;
+        else if (strcmp(key, "--archive") == 0) options.archive = atoi(value) != 0;
+        else if (strcmp(key, "--record") == 0) options.record = atoi(value) != 0;
+        else if (strcmp(key, "--probes") == 0) options.probes = (uint8_t) atoi(value);
+        else if (strcmp(key, "--channel") == 0) options.channel = (uint8_t) atoi(value);
+        else if (strcmp(key, "--bus-errors") == 0) options.bus_errors = f_value;
+        else if (strcmp(key, "--voting") == 0) {
+            options.voting = strcmp(value, "weighted") == 0 ? SensorVoting::VOTING_WEIGHTED : SensorVoting::VOTING_MEDIAN;
+        } else if (strcmp(key, "--fault-probe") == 0) options.fault_probe = atoi(value);
+        else if (strcmp(key, "--fault") == 0) options.fault = value;
+        else if (strcmp(key, "--fault-at") == 0) options.fault_at = f_value;
+        else if (strcmp(key, "--continuous") == 0) options.continuous = atoi(value) != 0;
+        else if (strcmp(key, "--resolution") == 0) options.resolution = (uint8_t) atoi(value);
+        else if (strcmp(key, "--adc-noise") == 0) options.adc_noise = f_value;
+        else if (strcmp(key, "--median") == 0) {
+            options.filter.median = true;
+            options.filter.median_window = (uint8_t) atoi(value);
+        } else if (strcmp(key, "--ema") == 0) {
+            options.filter.ema = true;
+            options.filter.ema_time_constant = f_value;
+        } else if (strcmp(key, "--kalman") == 0) {
+            options.filter.kalman = true;
+            options.filter.kalman_measurement_noise = f_value;
+        } else if (strcmp(key, "--kalman-drift") == 0) options.filter.kalman_process_noise = f_value;
+        else if (strcmp(key, "--slew") == 0) {
+            options.filter.slew = true;
+            options.filter.slew_rate = f_value;
+        }
+        else if (parse_pid_option(key, value, options.pid)) continue;
+        else if (parse_predictor_option(key, value, options.predictor)) continue;
+        else if (strcmp(key, "--ambient") == 0) options.plant.ambient = f_value;
+        else if (strcmp(key, "--gain") == 0) options.plant.gain = f_value;
+        else if (strcmp(key, "--tau") == 0) options.plant.time_constant = f_value;
+        else if (strcmp(key, "--dead-time") == 0) options.plant.dead_time = f_value;
+        else {
+            fprintf(stderr, "Unknown option %s\n", key);
+            return false;
+        }
+    }
+
+    if (options.record && options.sensor == SensorType::REPLAY) {
+        fprintf(stderr, "Replay sensor reads the log that --record would overwrite\n");
+        return false;
+    }
+
+    return true;
+}
+
+int sim_run(int argc, char **argv) {
+    SimOptions options;
+    if (!parse_run_options(argc, argv, options)) return 1;
+
+    Config config{};
+    config.regulator.pid = options.pid;
+    config.regulator.filter = options.filter;
+    config.regulator.predictor = options.predictor;
+    config.regulator.sensor.type = options.sensor;
+    config.regulator.sensor.reset_data();
+    if (options.sensor == SensorType::ANALOG_VALUE) {
+        auto *analog = (AnalogSensorConfig *) config.regulator.sensor.data;
+        analog->resolution = options.resolution;
+        analog->continuous = options.continuous;
+    } else if (options.sensor == SensorType::DSX18X_BUS) {
+        ((DSx18BusSensorConfig *) config.regulator.sensor.data)->channel = options.channel;
+    } else if (options.sensor == SensorType::DSX18X_GROUP) {
+        auto *group = (DSx18GroupSensorConfig *) config.regulator.sensor.data;
+        group->count = options.probes;
+        group->group.voting = options.voting;
+    }
+
+    config.regulator.control.type = options.control;
+    config.regulator.control.reset_data();
+
+    // Both control configs start with output pin
+    const uint8_t control_pin = config.regulator.control.data[0];
+
+    ThermalPlant plant(options.plant, (float) options.step_ms / 1000.f);
+    SimHal::set_temperature_source([&](auto) { return plant.temperature(); });
+
+    // Probe fault: drop (stops answering), stuck (holds reading), spike (+50 for one second), bias (+3 from then on)
+    float stuck_value = NAN;
+    if (options.fault_probe >= 0) {
+        SimHal::set_probe_source([&](auto, uint8_t probe) {
+            const float value = plant.temperature();
+            const float t = (float) SimClock::now_ms() / 1000 - options.fault_at;
+            if (probe != options.fault_probe || t < 0) return value;
+
+            if (strcmp(options.fault, "stuck") == 0) {
+                if (std::isnan(stuck_value)) stuck_value = value;
+                return stuck_value;
+            }
+
+            if (strcmp(options.fault, "spike") == 0) return t < 1 ? value + 50 : value;
+            if (strcmp(options.fault, "bias") == 0) return value + 3;
+            return NAN;
+        });
+    }
+    SimHal::set_analog_source([&](auto) { return plant.temperature() / options.analog_scale; });
+    SimHal::set_analog_noise(options.adc_noise);
+    SimHal::set_one_wire_probes(options.probes);
+    SimHal::set_one_wire_error_rate(options.bus_errors);
+
+    // On the device regulator runs in ControlTask with its own timer; here it shares the only loop
+    Timer timer;
+
+    NtpTime ntp_time;
+    ntp_time.begin(TIME_ZONE);
+
+    if (options.archive || options.record || options.sensor == SensorType::REPLAY) LittleFS.begin();
+
+    std::unique_ptr<SensorLogFile> sensor_log = nullptr;
+    if (options.record) {
+        sensor_log = std::make_unique<SensorLogFile>(LittleFS);
+        sensor_log->start(options.sensor);
+    }
+
+    Regulator regulator(timer, config.regulator);
+    NightModeManager night_mode_manager(ntp_time, timer, config);
+
+    auto load = [&] {
+        regulator.load(config.regulator.pid, config.power && !night_mode_manager.active());
+        regulator.set_predictor(config.regulator.predictor);
+        if (sensor_log) sensor_log->add(regulator.snapshot());
+    };
+    night_mode_manager.event_night_mode().subscribe(&regulator, [&](auto, auto, auto) { load(); });
+
+    regulator.begin();
+    night_mode_manager.update();
+    load();
+
+    std::unique_ptr<HistoryArchive> archive = nullptr;
+    if (options.archive) {
+        archive = std::make_unique<HistoryArchive>(LittleFS);
+        archive->begin();
+
+        timer.add_interval([&](auto) { archive->flush(); }, ARCHIVE_FLUSH_INTERVAL);
+    }
+
+    SimStats stats;
+    float last_control = 0;
+    timer.add_interval([&](auto) {
+        regulator.prefetch_sensor();
+
+        auto start = std::chrono::steady_clock::now();
+        bool computed = regulator.update();
+        SimDuration elapsed = std::chrono::steady_clock::now() - start;
+
+        stats.regulator_calls++;
+        stats.regulator_time += elapsed;
+
+        if (computed) {
+            if (stats.regulator_computes > 0) stats.max_compute_gap = std::max(stats.max_compute_gap, (uint32_t) millis() - stats.last_compute);
+            stats.last_compute = millis();
+            stats.regulator_computes++;
+            stats.regulator_max_time = std::max(stats.regulator_max_time, elapsed);
+            const auto &sample = regulator.telemetry();
+            stats.abs_error_sum += std::abs(config.regulator.pid.target - sample.sensor_value);
+            if (stats.regulator_computes > 1) stats.control_change_sum += std::abs(sample.control_value - last_control);
+            last_control = sample.control_value;
+
+            if (sensor_log) sensor_log->add(sample);
+
+            if (archive) {
+                archive->add(ntp_time.epoch_tz(), {
+                    .sensor = sample.sensor_value,
+                    .control = sample.control_value,
+                    .integral = sample.integral
+                });
+            }
+        }
+    }, APP_SERVICE_LOOP_INTERVAL);
+
+    const auto total_steps = (uint64_t) ((double) options.hours * 3600 * 1000 / options.step_ms);
+    const auto wall_start = std::chrono::steady_clock::now();
+
+    for (uint64_t i = 0; i < total_steps; ++i) {
+        plant.step(SimHal::pin_output(control_pin));
+
+        auto start = std::chrono::steady_clock::now();
+        timer.handle_timers();
+        stats.timer_time += std::chrono::steady_clock::now() - start;
+        stats.timer_calls++;
+
+        SimClock::advance_ms(options.step_ms);
+        SimHal::process_timers();
+    }
+
+    const std::chrono::duration<double> wall_time = std::chrono::steady_clock::now() - wall_start;
+    const double sim_time = (double) SimClock::now_ms() / 1000;
+
+    printf("Simulated:        %.1f s in %.3f s wall time (x%.0f)\n", sim_time, wall_time.count(), sim_time / wall_time.count());
+    printf("Timer loop:       %llu calls, %.1f ns avg\n",
+           (unsigned long long) stats.timer_calls, stats.timer_time.count() / (double) std::max<uint64_t>(1, stats.timer_calls));
+    printf("Service loop:     %llu calls, %.1f ns avg\n",
+           (unsigned long long) stats.regulator_calls, stats.regulator_time.count() / (double) std::max<uint64_t>(1, stats.regulator_calls));
+    printf("PID compute:      %llu ticks, %.1f ns max, longest gap %u ms\n",
+           (unsigned long long) stats.regulator_computes, stats.regulator_max_time.count(), stats.max_compute_gap);
+    const auto &telemetry = regulator.telemetry();
+    const auto &sampling = regulator.sampling();
+    printf("Sampling:         %s, period %u..%u us, jitter %.1f us rms, latency %u us max, %u missed\n",
+           options.pid.sampling == SamplingMode::SAMPLING_TIMER ? "timer"
+           : options.pid.sampling == SamplingMode::SAMPLING_EVENT ? "event" : "polled",
+           sampling.period_min, sampling.period_max, sampling.jitter_rms, sampling.latency_max, sampling.missed);
+    printf("Sensor latency:   %.0f us avg, %u us max (measurement to control output)\n",
+           sampling.sensor_latency_avg, sampling.sensor_latency_max);
+    if (const auto *bus = regulator.sensor_bus()) {
+        printf("Sensor bus:       %u probes, %u scans, conversion %u ms, read %u ms\n",
+               bus->count, bus->scans, bus->conversion_time, bus->read_time);
+        for (uint8_t i = 0; i < bus->count; ++i) {
+            const auto &probe = bus->probes[i];
+            printf("                  #%u %02x%02x%02x%02x%02x%02x%02x%02x: %.4f, %u CRC errors\n", i,
+                   probe.rom[0], probe.rom[1], probe.rom[2], probe.rom[3],
+                   probe.rom[4], probe.rom[5], probe.rom[6], probe.rom[7], probe.value, probe.crc_errors);
+        }
+    }
+
+    if (const auto *group = regulator.sensor_group()) {
+        static const char *fault_names[] = {"ok", "lost", "range", "rate", "stuck"};
+        printf("Sensor group:     %u/%u healthy, %u fused values, %u faults\n", group->healthy, group->count, group->rounds, group->faults);
+        for (uint8_t i = 0; i < group->count; ++i) {
+            const auto &member = group->members[i];
+            printf("                  #%u %.4f %s, weight %.2f, %u faults\n",
+                   i, member.value, fault_names[(uint8_t) member.fault], member.weight, member.faults);
+        }
+    }
+
+    if (const auto *noise = regulator.sensor_noise()) {
+        printf("ADC noise:        %u conversions per value at %u Hz, %.2f -> %.2f LSB rms, ENOB %.2f -> %.2f, %u overruns\n",
+               noise->decimation, noise->sample_rate, noise->raw_rms, noise->value_rms, noise->raw_enob, noise->enob, noise->overruns);
+    }
+
+    printf("Control switches: %u\n", SimHal::pin_toggle_count(control_pin));
+    printf("Final value:      %.3f (target %.3f)\n", telemetry.sensor_value, config.regulator.pid.target);
+    printf("Mean abs error:   %.4f\n", stats.abs_error_sum / (double) std::max<uint64_t>(1, stats.regulator_computes));
+    printf("Output change:    %.5f mean |du| per compute\n",
+           stats.control_change_sum / (double) std::max<uint64_t>(1, stats.regulator_computes - 1));
+
+    if (sensor_log) {
+        sensor_log->stop();
+        printf("Sensor log:       %u samples, %u bytes (%.2f bytes/sample) in " SENSOR_LOG_PATH "\n",
+               sensor_log->samples(), sensor_log->size(), (double) sensor_log->size() / std::max(1u, sensor_log->samples()));
+    }
+
+    if (archive) {
+        archive->flush();
+        printf("Archive:          %u writes, %u bytes\n", archive->writes(), archive->bytes_written());
+
+        ArchiveQueryResult result;
+        const auto now = (uint32_t) ntp_time.epoch_tz();
+        for (uint32_t range: {600u, 3600u, 24u * 3600, 7u * 24 * 3600}) {
+            archive->query(now - std::min(now, range), now, result);
+
+            float sensor_min = INFINITY, sensor_max = -INFINITY;
+            for (uint16_t i = 0; i < result.header.count; ++i) {
+                sensor_min = std::min(sensor_min, result.records[i].min.sensor);
+                sensor_max = std::max(sensor_max, result.records[i].max.sensor);
+            }
+
+            printf("  last %7u s:   %3u points x %4u s, sensor %.2f..%.2f\n",
+                   range, result.header.count, result.header.period, sensor_min, sensor_max);
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,107 @@
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+
+#include "pid/tuning.h"
+
+#include "closed_loop.h"
+#include "commands.h"
+#include "options.h"
+
+struct SmithOptions {
+    ThermalPlantConfig plant{.time_constant = 120, .dead_time = 20};
+    float sensor_delay = 1;    // Added to model dead time: conversion of the sensor and half of the interval, seconds
+    float closed_loop_time = 0; // τc of fast gains, seconds; 0 for a quarter of the dead time
+    float model_error = 0;     // Relative error of model gain and dead time
+    float duration = 1800;
+};
+
+static void print_row(const char *name, const PidGains &gains, const ClosedLoopMetrics &m) {
+    printf("%-16s %8.2f %9.4f %10.1f %9.1f%% %9.0f s %7.2f\n",
+           name, gains.p, gains.i, m.iae, m.overshoot, m.settling_time, m.final_value);
+}
+
+/**
+ * FOPDT heater with long dead time read by DS18x20: SIMC gains for the whole dead time,
+ * fast gains tuned for the delay-free part without and with the Smith predictor, and with a wrong model.
+ */
+int sim_smith(int argc, char **argv) {
+    SmithOptions options;
+
+    ClosedLoopOptions loop;
+    loop.pid.target = 45;
+    loop.pid.i_limit = IntegralLimitMode::I_SATURATE;
+    loop.pid.engine = PidEngine::PID_SPECIALIZED;
+
+    for (int i = 0; i + 1 < argc; i += 2) {
+        const char *key = argv[i];
+        const char *value = argv[i + 1];
+
+        if (parse_pid_option(key, value, loop.pid)) continue;
+
+        if (strcmp(key, "--gain") == 0) options.plant.gain = strtof(value, nullptr);
+        else if (strcmp(key, "--tau") == 0) options.plant.time_constant = strtof(value, nullptr);
+        else if (strcmp(key, "--dead-time") == 0) options.plant.dead_time = strtof(value, nullptr);
+        else if (strcmp(key, "--sensor-delay") == 0) options.sensor_delay = strtof(value, nullptr);
+        else if (strcmp(key, "--closed-loop-time") == 0) options.closed_loop_time = strtof(value, nullptr);
+        else if (strcmp(key, "--model-error") == 0) options.model_error = strtof(value, nullptr);
+        else if (strcmp(key, "--duration") == 0) options.duration = strtof(value, nullptr);
+        else {
+            fprintf(stderr, "Unknown option %s\n", key);
+            return 1;
+        }
+    }
+
+    loop.duration = options.duration;
+
+    const auto plant_config = options.plant;
+    const PlantFactory plant = [plant_config](float step) { return std::make_unique<ThermalPlant>(plant_config, step); };
+
+    const FopdtModel model{
+        .gain = plant_config.gain,
+        .time_constant = plant_config.time_constant,
+        .dead_time = plant_config.dead_time + options.sensor_delay
+    };
+
+    const float closed_loop_time = options.closed_loop_time > 0 ? options.closed_loop_time : model.dead_time / 4;
+
+    auto scaled = [&](PidGains gains) {
+        gains.p *= loop.pid.k_mul;
+        gains.i *= loop.pid.k_mul;
+        gains.d *= loop.pid.k_mul;
+        return gains;
+    };
+
+    const auto robust = scaled(tune_simc(model, model.dead_time));
+    auto delay_free = model;
+    delay_free.dead_time = 0;
+    const auto fast = scaled(tune_simc(delay_free, closed_loop_time));
+
+    auto run = [&](const PidGains &gains, const SmithPredictorConfig &predictor) {
+        loop.pid.p = gains.p;
+        loop.pid.i = gains.i;
+        loop.pid.d = 0;
+        loop.predictor = predictor;
+        return run_closed_loop(plant, loop);
+    };
+
+    printf("Plant: K %.1f, tau %.0f s, theta %.1f s; model theta %.1f s; fast gains for tau_c %.1f s\n",
+           plant_config.gain, plant_config.time_constant, plant_config.dead_time, model.dead_time, closed_loop_time);
+    printf("%-16s %8s %9s %10s %10s %11s %7s\n", "Mode", "kP", "kI", "IAE", "Overshoot", "Settling", "Final");
+
+    print_row("pid", robust, run(robust, {}));
+    print_row("pid fast", fast, run(fast, {}));
+
+    SmithPredictorConfig predictor{.enabled = true, .model = model};
+    print_row("smith", fast, run(fast, predictor));
+
+    if (options.model_error != 0) {
+        predictor.model.gain = model.gain * (1 + options.model_error);
+        predictor.model.dead_time = model.dead_time * (1 + options.model_error);
+        print_row("smith, bad model", fast, run(fast, predictor));
+    }
+
+    return 0;
+}
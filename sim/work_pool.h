@@ -0,0 +1,139 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * Fixed set of worker threads with a deque per worker. Work is dealt out evenly; a worker takes from the back
+ * of its own deque and, once empty, steals from the front of others, so long simulations don't leave cores idle.
+ */
+class WorkPool {
+    struct Queue {
+        std::mutex mutex;
+        std::deque<size_t> items;
+    };
+
+    std::vector<std::unique_ptr<Queue>> _queues;
+    std::vector<std::thread> _threads;
+
+    std::mutex _mutex;
+    std::condition_variable _work_cv;
+    std::condition_variable _done_cv;
+
+    const std::function<void(size_t)> *_fn = nullptr;
+    std::atomic<size_t> _pending = 0;
+    uint64_t _generation = 0;
+    bool _stop = false;
+
+public:
+    /**
+     * @param threads worker count, 0 for every hardware thread
+     */
+    explicit WorkPool(size_t threads = 0) {
+        if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+
+        for (size_t i = 0; i < threads; ++i) _queues.push_back(std::make_unique<Queue>());
+        for (size_t i = 0; i < threads; ++i) _threads.emplace_back(&WorkPool::_loop, this, i);
+    }
+
+    ~WorkPool() {
+        {
+            std::lock_guard lock(_mutex);
+            _stop = true;
+        }
+
+        _work_cv.notify_all();
+        for (auto &thread: _threads) thread.join();
+    }
+
+    WorkPool(const WorkPool &) = delete;
+    WorkPool &operator=(const WorkPool &) = delete;
+
+    [[nodiscard]] size_t size() const { return _threads.size(); }
+
+    /**
+     * Call `fn(index)` for every index in [0, count) on worker threads, return once all calls finished.
+     * Not reentrant: `fn` must not call `parallel_for` of the same pool.
+     */
+    void parallel_for(size_t count, const std::function<void(size_t index)> &fn) {
+        if (count == 0) return;
+
+        std::unique_lock lock(_mutex);
+        _fn = &fn;
+        _pending = count;
+
+        // Contiguous ranges keep neighbouring items on one worker until it runs out of work
+        const size_t workers = _queues.size();
+        for (size_t w = 0; w < workers; ++w) {
+            std::lock_guard queue_lock(_queues[w]->mutex);
+            for (size_t index = count * w / workers; index < count * (w + 1) / workers; ++index) {
+                _queues[w]->items.push_back(index);
+            }
+        }
+
+        _generation++;
+        _work_cv.notify_all();
+
+        _done_cv.wait(lock, [this] { return _pending == 0; });
+        _fn = nullptr;
+    }
+
+private:
+    bool _take(size_t worker, size_t &index) {
+        {
+            auto &own = *_queues[worker];
+            std::lock_guard lock(own.mutex);
+            if (!own.items.empty()) {
+                index = own.items.back();
+                own.items.pop_back();
+                return true;
+            }
+        }
+
+        for (size_t i = 1; i < _queues.size(); ++i) {
+            auto &victim = *_queues[(worker + i) % _queues.size()];
+            std::lock_guard lock(victim.mutex);
+            if (!victim.items.empty()) {
+                index = victim.items.front();
+                victim.items.pop_front();
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    void _loop(size_t worker) {
+        uint64_t generation = 0;
+
+        while (true) {
+            {
+                std::unique_lock lock(_mutex);
+                _work_cv.wait(lock, [&] { return _stop || _generation != generation; });
+                if (_stop) return;
+
+                generation = _generation;
+            }
+
+            // Function is read after taking an item: a late worker may already take items of the next call
+            size_t index;
+            while (_take(worker, index)) {
+                (*_fn)(index);
+
+                if (--_pending == 0) {
+                    std::lock_guard lock(_mutex);
+                    _done_cv.notify_all();
+                }
+            }
+        }
+    }
+};
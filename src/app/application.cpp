@@ -32,28 +32,50 @@ void Application::begin() {
         _load();
     });
 
-    if (config().regulator.sensor.type == SensorType::DSX18X) {
-        _sensor = std::make_unique<DSx18Sensor>(_bootstrap->timer(), config().regulator.sensor.data);
-        _sensor_meta = std::make_unique<MetaHolder<DSx18SensorConfigMeta>>(
-            build_dsx18_sensor_metadata(*(DSx18SensorConfig *) config().regulator.sensor.data)
-        );
-    } else {
-        _sensor = std::make_unique<AnalogSensor>(_bootstrap->timer(), config().regulator.sensor.data);
-        _sensor_meta = std::make_unique<MetaHolder<AnalogSensorConfigMeta>>(
-            build_analog_sensor_metadata(*(AnalogSensorConfig *) config().regulator.sensor.data)
-        );
+    _archive_result = std::make_unique<ArchiveQueryResult>();
+    if (ARCHIVE_ENABLED) {
+        _archive = std::make_unique<HistoryArchive>(LittleFS);
+        _archive->begin();
+
+        _bootstrap->timer().add_interval([this](auto) { _archive->flush(); }, ARCHIVE_FLUSH_INTERVAL);
     }
 
-    _sensor->begin();
+    _sensor_log_file = std::make_unique<SensorLogFile>(LittleFS);
+    _sensor_log_stream = std::make_unique<SensorLogStream>([this](auto &) {
+        _bootstrap->ws_server()->send_notification(PacketType::SENSOR_LOG_DATA);
+    });
+    _sensor_log_chunk = std::make_unique<SensorLogChunk>();
+
+    _bootstrap->timer().add_interval([this](auto) { _sensor_log_file->flush(); }, SENSOR_LOG_FLUSH_INTERVAL);
+    _bootstrap->timer().add_interval([this](auto) { _sensor_log_stream->flush(); }, SENSOR_LOG_STREAM_INTERVAL);
+
+    _load_program();
+
+    std::vector<const RegulatorConfig *> channels;
+    for (uint8_t i = 0; i < config().channel_count(); ++i) channels.push_back(&config().channel(i));
+
+    _control_task = std::make_unique<ControlTask>(channels, config().channels.enabled);
+    _control_task->begin();
 
-    _control = std::make_unique<PwmControl>(_bootstrap->timer(), config().regulator.control.data);
-    _control_meta = std::make_unique<MetaHolder<PwmControlConfigMeta>>(
-        build_pwm_control_metadata(*(PwmControlConfig *) config().regulator.control.data)
+    _sensor_meta = make_sensor_metadata(config().regulator.sensor);
+    _control_meta = make_control_metadata(config().regulator.control);
+    _filter_meta = std::make_unique<MetaHolder<SensorFilterConfigMeta>>(
+        build_sensor_filter_metadata(config().regulator.filter)
     );
 
-    _control->begin();
+    for (uint8_t i = 1; i < config().channel_count(); ++i) {
+        auto &regulator = config().channel(i);
+        auto &meta = _channel_meta[i];
 
-    _pid = std::make_unique<uPID>();
+        meta.push_back(std::make_unique<MetaHolder<RegulatorConfigMeta>>(build_regulator_metadata(regulator)));
+        meta.push_back(make_sensor_metadata(regulator.sensor));
+        meta.push_back(make_control_metadata(regulator.control));
+        meta.push_back(std::make_unique<MetaHolder<SensorFilterConfigMeta>>(build_sensor_filter_metadata(regulator.filter)));
+
+        _channel_data_meta.push_back(std::make_unique<ChannelDataMeta>(
+            build_channel_metadata(_runtime_info.channels.channels[i])
+        ));
+    }
 
     _bootstrap->event_state_changed().subscribe(this, [this](auto sender, auto state, auto arg) {
         _bootstrap_state_changed(sender, state, arg);
@@ -100,70 +122,153 @@ void Application::_setup() {
         }
     };
 
-    _metadata = std::make_unique<ConfigMetadata>(build_metadata(config(), _runtime_info));
+    _metadata = std::make_unique<ConfigMetadata>(build_metadata(config(), _runtime_info, _history, *_archive_result,
+                                                                _sensor_log_stream->chunk(), *_sensor_log_chunk,
+                                                                _channel_history, _channel_parameters, _program));
     _metadata->visit(visit_fn);
 
     _sensor_meta->visit(visit_fn);
     _control_meta->visit(visit_fn);
+    _filter_meta->visit(visit_fn);
+
+    _setup_channels();
 
     ws_server->register_notification(PacketType::SENSOR_VALUE, _metadata->data.sensor_value);
     ws_server->register_notification(PacketType::CONTROL_VALUE, _metadata->data.control_value);
     ws_server->register_notification(PacketType::HISTORY_DATA, _metadata->data.history);
+    ws_server->register_notification(PacketType::HISTORY_APPEND, _metadata->data.history_append);
+    ws_server->register_notification(PacketType::SAMPLING_STATS, _metadata->data.sampling);
+    ws_server->register_notification(PacketType::SENSOR_BUS_STATS, _metadata->data.sensor_bus);
+    ws_server->register_notification(PacketType::SENSOR_NOISE_STATS, _metadata->data.sensor_noise);
+    ws_server->register_notification(PacketType::SENSOR_GROUP_STATS, _metadata->data.sensor_group);
+    ws_server->register_notification(PacketType::CHANNEL_STATE, _metadata->data.channels);
+    ws_server->register_data_request(PacketType::CHANNEL_STATE, _metadata->data.channels);
+    ws_server->register_data_request(PacketType::CHANNEL_HISTORY, _metadata->data.channel_history);
 
     ws_server->register_data_request(PacketType::GET_CONFIG, _metadata->data.config);
     ws_server->register_data_request(PacketType::GET_STATE, _metadata->data.state);
+    ws_server->register_data_request(PacketType::HISTORY_DATA, _metadata->data.history);
+
+    ws_server->register_notification(PacketType::HISTORY_ARCHIVE, _metadata->data.archive);
+
+    ws_server->register_command(PacketType::RESTART, [this] { restart(); });
+
+    ws_server->register_notification(PacketType::AUTOTUNE_RESULT, _metadata->data.autotune);
+    ws_server->register_data_request(PacketType::AUTOTUNE_RESULT, _metadata->data.autotune);
+    ws_server->register_command(PacketType::AUTOTUNE_START, [this] { _start_autotune(); });
+    ws_server->register_command(PacketType::AUTOTUNE_STOP, [this] { _stop_autotune(); });
+    ws_server->register_command(PacketType::AUTOTUNE_APPLY, [this] {
+        const auto &result = _runtime_info.autotune;
+        if (result.state == AutotuneState::AUTOTUNE_DONE) _apply_gains(result.p, result.i, result.d);
+    });
+
+    ws_server->register_notification(PacketType::IDENT_RESULT, _metadata->data.identification);
+    ws_server->register_data_request(PacketType::IDENT_RESULT, _metadata->data.identification);
+    ws_server->register_command(PacketType::IDENT_START, [this] { _start_identification(); });
+    ws_server->register_command(PacketType::IDENT_STOP, [this] { _stop_identification(); });
+    ws_server->register_command(PacketType::IDENT_APPLY, [this] {
+        const auto &result = _runtime_info.identification;
+        if (result.state != IdentificationState::IDENT_DONE) return;
 
-    ws_server->register_command(PacketType::RESTART, [this] { _bootstrap->restart(); });
+        _apply_model(result.model);
+        _apply_gains(result.p, result.i, result.d);
+    });
+
+    ws_server->register_data_request(PacketType::IDENT_MODEL_GAIN, _metadata->data.model_gain);
+    ws_server->register_data_request(PacketType::IDENT_MODEL_TIME_CONSTANT, _metadata->data.model_time_constant);
+    ws_server->register_data_request(PacketType::IDENT_MODEL_DEAD_TIME, _metadata->data.model_dead_time);
+
+    ws_server->register_notification(PacketType::PROGRAM_STATE, _metadata->data.program_state);
+    ws_server->register_data_request(PacketType::PROGRAM_STATE, _metadata->data.program_state);
+    ws_server->register_command(PacketType::PROGRAM_START, [this] { _start_program(); });
+    ws_server->register_command(PacketType::PROGRAM_STOP, [this] { _stop_program(); });
+
+    ws_server->register_notification(PacketType::SENSOR_LOG_STATE, _metadata->data.sensor_log);
+    ws_server->register_data_request(PacketType::SENSOR_LOG_STATE, _metadata->data.sensor_log);
+    ws_server->register_notification(PacketType::SENSOR_LOG_DATA, _metadata->data.sensor_log_data);
+    ws_server->register_data_request(PacketType::SENSOR_LOG_FILE, _metadata->data.sensor_log_file);
+    ws_server->register_command(PacketType::SENSOR_LOG_FETCH, [this] { _fetch_sensor_log(0); });
+    ws_server->register_command(PacketType::SENSOR_LOG_FETCH_NEXT, [this] {
+        const auto &header = _sensor_log_chunk->header;
+        _fetch_sensor_log(header.offset + header.length);
+    });
 
     mqtt_server->register_notification(MQTT_OUT_TOPIC_SENSOR, _metadata->data.sensor_value);
     mqtt_server->register_notification(MQTT_OUT_TOPIC_CONTROL, _metadata->data.control_value);
+    mqtt_server->register_notification(MQTT_OUT_TOPIC_MODEL_GAIN, _metadata->data.model_gain);
+    mqtt_server->register_notification(MQTT_OUT_TOPIC_MODEL_TIME_CONSTANT, _metadata->data.model_time_constant);
+    mqtt_server->register_notification(MQTT_OUT_TOPIC_MODEL_DEAD_TIME, _metadata->data.model_dead_time);
 }
 
-void Application::_load() {
-    bool active = config().power && !_night_mode_manager->active();
-    if (!active) _pid->integral = 0;
-
-    change_state(active ? AppState::ACTIVE : AppState::INACTIVE);
-
-    auto &pid_cfg = config().regulator.pid;
-    _pid->setpoint = pid_cfg.target;
+void Application::_setup_channels() {
+    auto add_parameters = [this](uint8_t channel) {
+        return [this, channel](AbstractPropertyMeta *meta) {
+            auto binary_protocol = (BinaryProtocolMeta<PacketType> *) meta->get_binary_protocol();
+            if (binary_protocol->packet_type.has_value()) {
+                _channel_parameters.add(channel, *binary_protocol->packet_type, meta->get_parameter());
+            }
+        };
+    };
 
-    _pid->setKp(pid_cfg.p);
-    _pid->setKi(pid_cfg.i);
-    _pid->setKd(pid_cfg.d);
-    _pid->setDt(pid_cfg.interval);
+    // Channel 0 is also addressable with CHANNEL_PARAMETER, its parameters have own packets as well
+    const auto main_fn = add_parameters(0);
+    _metadata->regulator.visit(main_fn);
+    _sensor_meta->visit(main_fn);
+    _control_meta->visit(main_fn);
+    _filter_meta->visit(main_fn);
 
-    // Set output limits
-    _pid->outMax = pid_cfg.out_max * pid_cfg.k_mul;
-    _pid->outMin = pid_cfg.out_min * pid_cfg.k_mul;
+    auto &mqtt_server = _bootstrap->mqtt_server();
+    for (uint8_t i = 1; i < config().channel_count(); ++i) {
+        const auto channel_fn = add_parameters(i);
+        for (auto &meta: _channel_meta[i]) meta->visit(channel_fn);
 
-    // Set back calculation coefficient
-    _pid->Kbc = pid_cfg.kbc;
+        const auto &topics = *_channel_topics.emplace_back(std::make_unique<ChannelMqttTopics>(i));
+        const auto &data_meta = *_channel_data_meta[i - 1];
 
-    // Configure PID modes
-    uint8_t cfg = 0;
-    if (pid_cfg.p_mode == ProportionalMode::P_INPUT) cfg |= P_INPUT;
-    else cfg |= P_ERROR;
+        mqtt_server->register_parameter(topics.target, topics.target_out, _channel_parameters.find(i, PacketType::PID_TARGET));
+        mqtt_server->register_notification(topics.sensor, data_meta.sensor_value);
+        mqtt_server->register_notification(topics.control, data_meta.control_value);
+    }
+}
 
-    if (pid_cfg.i_mode == IntegralMode::I_KI_INSIDE) cfg |= I_KI_INSIDE;
-    else cfg |= I_KI_OUTSIDE;
+void Application::_load() {
+    bool active = config().power && !_night_mode_manager->active();
+    if (!active) {
+        _autotune_requested = false;
+        _identification_requested = false;
+        _program_requested = false;
+    }
 
-    if ((uint8_t) pid_cfg.i_limit & (uint8_t) IntegralLimitMode::I_SATURATE) cfg |= I_SATURATE;
-    if ((uint8_t) pid_cfg.i_limit & (uint8_t) IntegralLimitMode::I_BACK_CALC) cfg |= I_BACK_CALC;
-    if ((uint8_t) pid_cfg.i_limit & (uint8_t) IntegralLimitMode::I_RESET) cfg |= I_RESET;
+    if (_autotune_requested) change_state(AppState::AUTOTUNE);
+    else if (_identification_requested) change_state(AppState::IDENTIFICATION);
+    else if (_program_requested) change_state(AppState::PROGRAM);
+    else change_state(active ? AppState::ACTIVE : AppState::INACTIVE);
 
-    if (pid_cfg.d_mode == DifferentialMode::D_INPUT) cfg |= D_INPUT;
-    else cfg |= D_ERROR;
+    _control_task->load(config().regulator.pid, config().regulator.predictor, active,
+                        _autotune_requested ? &config().autotune : nullptr,
+                        _identification_requested ? &config().identification : nullptr,
+                        _program_requested ? &_program : nullptr);
 
-    if (pid_cfg.direction == DirectionMode::PID_REVERSE) cfg |= PID_REVERSE;
-    else cfg |= PID_FORWARD;
+    for (uint8_t i = 1; i < _control_task->channel_count(); ++i) {
+        const bool channel_active = active && _control_task->channel_running(i);
+        _control_task->load_channel(i, config().channel(i).pid, config().channel(i).predictor, channel_active);
+        _runtime_info.channels.channels[i].active = channel_active;
+    }
 
-    _pid->setConfig(cfg);
+    _runtime_info.channels.channels[0].active = active;
 }
 
 void Application::_notify_periodic_status() {
+    _bootstrap->ws_server()->send_notification(PacketType::SAMPLING_STATS);
+    if (_runtime_info.sensor_log.record) _notify_sensor_log();
+
     _bootstrap->mqtt_server()->send_notification(MQTT_OUT_TOPIC_SENSOR);
     _bootstrap->mqtt_server()->send_notification(MQTT_OUT_TOPIC_CONTROL);
+
+    for (auto &topics: _channel_topics) {
+        _bootstrap->mqtt_server()->send_notification(topics->sensor);
+        _bootstrap->mqtt_server()->send_notification(topics->control);
+    }
 }
 
 void Application::_on_bootstrap_ready() {
@@ -185,11 +290,70 @@ void Application::event_loop() {
 
 void Application::_handle_property_change(const AbstractParameter *parameter) {
     auto it = _parameter_to_packet.find(parameter);
-    if (it == _parameter_to_packet.end()) return;
+    if (it == _parameter_to_packet.end()) {
+        // Parameters of channels 1.. changed over MQTT
+        if (_channel_parameters.channel_of(parameter) > 0) {
+            _load();
+            update();
+        }
 
-    _load();
+        return;
+    }
 
     auto type = it->second;
+    if (type == PacketType::CHANNEL_PARAMETER) {
+        _apply_channel_parameter();
+        return;
+    }
+
+    if (type == PacketType::HISTORY_ARCHIVE_RANGE) {
+        _send_archive();
+        return;
+    }
+
+    if (type == PacketType::SENSOR_LOG_RECORD || type == PacketType::SENSOR_LOG_STREAM) {
+        _update_sensor_log();
+        return;
+    }
+
+    // Running program keeps its copy, the new one is used by the next start
+    if (type == PacketType::PROGRAM_DATA) {
+        if (!program_save(LittleFS, config().program.slot, _program)) {
+            D_PRINTF("Program: unable to save slot %u\r\n", config().program.slot);
+        }
+
+        return;
+    }
+
+    if (type == PacketType::PROGRAM_SLOT) _load_program();
+
+    if (type >= PacketType::PREDICTOR_GAIN && type <= PacketType::PREDICTOR_DEAD_TIME) {
+        config().regulator.predictor.model_valid = true;
+    }
+
+    if (type == PacketType::AUTOTUNE_RULE) {
+        const auto rule = config().autotune.rule;
+        const auto k_mul = config().regulator.pid.k_mul;
+
+        if (_runtime_info.autotune.state == AutotuneState::AUTOTUNE_DONE) {
+            autotune_apply_rule(_runtime_info.autotune, rule, k_mul);
+            _bootstrap->ws_server()->send_notification(PacketType::AUTOTUNE_RESULT);
+        }
+
+        if (_runtime_info.identification.state == IdentificationState::IDENT_DONE) {
+            identification_apply_rule(_runtime_info.identification, rule, k_mul);
+            _bootstrap->ws_server()->send_notification(PacketType::IDENT_RESULT);
+        }
+    }
+
+    if (type == PacketType::SENSOR_TYPE) {
+        config().regulator.sensor.reset_data();
+    } else if (type == PacketType::CONTROL_TYPE) {
+        config().regulator.control.reset_data();
+    }
+
+    _load();
+
     if (type >= PacketType::NIGHT_MODE_ENABLED && type <= PacketType::NIGHT_MODE_END) {
         _night_mode_manager->update();
     }
@@ -197,6 +361,28 @@ void Application::_handle_property_change(const AbstractParameter *parameter) {
     update();
 }
 
+void Application::_apply_channel_parameter() {
+    const auto &request = _channel_parameters.last();
+    auto &regulator = config().channel(request.channel);
+
+    if (request.type == PacketType::SENSOR_TYPE) {
+        regulator.sensor.reset_data();
+    } else if (request.type == PacketType::CONTROL_TYPE) {
+        regulator.control.reset_data(request.channel);
+    } else if (request.type >= PacketType::PREDICTOR_GAIN && request.type <= PacketType::PREDICTOR_DEAD_TIME) {
+        regulator.predictor.model_valid = true;
+    }
+
+    _load();
+    update();
+}
+
+void Application::restart() {
+    if (_archive) _archive->flush();
+    if (_sensor_log_file->active()) _sensor_log_file->stop();
+
+    _bootstrap->restart();
+}
 
 void Application::update() {
     _bootstrap->save_changes();
@@ -209,42 +395,328 @@ void Application::change_state(AppState s) {
 }
 
 void Application::_service_loop() {
-    auto now = millis();
-    if (now - _last_pid_compute < config().regulator.pid.interval) return;
+    _control_task->prefetch_sensors();
 
-    _last_pid_compute = now;
-    if (!_sensor->has_value()) {
-        D_PRINT("Sensor is not ready!");
-        return;
+    if (_control_task->poll_autotune(_runtime_info.autotune)) {
+        const auto state = _runtime_info.autotune.state;
+        if (_autotune_requested && (state == AutotuneState::AUTOTUNE_DONE || state == AutotuneState::AUTOTUNE_FAILED)) {
+            _finish_autotune();
+        }
+
+        _bootstrap->ws_server()->send_notification(PacketType::AUTOTUNE_RESULT);
     }
 
-    auto value = _sensor->get_value();
-    _runtime_info.sensor_value = value;
+    if (_control_task->poll_sensor_bus(_runtime_info.sensor_bus)) {
+        _bootstrap->ws_server()->send_notification(PacketType::SENSOR_BUS_STATS);
+    }
 
-    float out = 0;
-    if (_state == AppState::ACTIVE) {
-        out = _pid->compute(value) / config().regulator.pid.k_mul;
+    if (_control_task->poll_sensor_noise(_runtime_info.sensor_noise)) {
+        _bootstrap->ws_server()->send_notification(PacketType::SENSOR_NOISE_STATS);
     }
 
-    _control->set_value(out);
-    _runtime_info.control_value = out;
+    if (_control_task->poll_sensor_group(_runtime_info.sensor_group)) {
+        _bootstrap->ws_server()->send_notification(PacketType::SENSOR_GROUP_STATS);
+    }
 
-    D_PRINTF("Sensor: %f; Control: %f\r\n", value, out);
+    if (_control_task->poll_identification(_runtime_info.identification)) {
+        const auto state = _runtime_info.identification.state;
+        if (_identification_requested && (state == IdentificationState::IDENT_DONE || state == IdentificationState::IDENT_FAILED)) {
+            _finish_identification();
+        }
 
-    _runtime_info.history.entries[_runtime_info.history.index] = {
-        .sensor = value,
-        .control = out,
-        .integral = _pid->integral / config().regulator.pid.k_mul * _pid->Ki
-    };
+        _bootstrap->ws_server()->send_notification(PacketType::IDENT_RESULT);
+    }
+
+    if (_control_task->poll_program(_runtime_info.program)) {
+        // Finished program keeps its final setpoint until stopped, failed one returns to the configured target
+        if (_program_requested && _runtime_info.program.state == ProgramState::PROGRAM_FAILED) _stop_program();
 
-    _runtime_info.history.sensor_min = std::min(_runtime_info.history.sensor_min, value);
-    _runtime_info.history.sensor_max = std::max(_runtime_info.history.sensor_max, value);
+        _bootstrap->ws_server()->send_notification(PacketType::PROGRAM_STATE);
+    }
 
-    _runtime_info.history.index = (_runtime_info.history.index + 1) % HISTORY_COUNT;
+    if (_control_task->poll_snapshot(_snapshot)) _snapshot_pending = true;
+
+    if (_control_task->poll_channel_load(_runtime_info.channels.load)) {
+        _bootstrap->ws_server()->send_notification(PacketType::CHANNEL_STATE);
+    }
+
+    // Every sample goes to history, notifications are sent once for the latest of drained samples
+    TelemetrySample sample, channel_sample;
+    uint32_t received = 0;
+    bool channels_changed = false;
+    while (_control_task->poll_sample(channel_sample)) {
+        auto &state = _runtime_info.channels.channels[channel_sample.channel];
+        state.sensor_value = channel_sample.sensor_value;
+        state.control_value = channel_sample.control_value;
+        state.computes++;
+
+        if (channel_sample.channel != 0) {
+            _append_channel_history(channel_sample);
+            channels_changed = true;
+            continue;
+        }
+
+        sample = channel_sample;
+        _append_history(sample);
+        _write_sensor_log(sample);
+        received++;
+    }
+
+    if (channels_changed) _bootstrap->ws_server()->send_notification(PacketType::CHANNEL_STATE);
+    if (received == 0) return;
+
+    _runtime_info.sensor_value = sample.sensor_value;
+    _runtime_info.control_value = sample.control_value;
+
+    _control_task->poll_sampling(_runtime_info.sampling);
+    _runtime_info.sampling.dropped = _control_task->dropped_samples();
 
     _bootstrap->ws_server()->send_notification(PacketType::SENSOR_VALUE);
     _bootstrap->ws_server()->send_notification(PacketType::CONTROL_VALUE);
-    _bootstrap->ws_server()->send_notification(PacketType::HISTORY_DATA);
+
+    // Chart shows archive instead of live history
+    if (_runtime_info.archive_range != 0) return;
+
+    // Clients apply single appended entry; if several entries were drained at once, they would see a gap anyway
+    if (received == 1) {
+        _bootstrap->ws_server()->send_notification(PacketType::HISTORY_APPEND);
+    } else {
+        _bootstrap->ws_server()->send_notification(PacketType::HISTORY_DATA);
+    }
+}
+
+void Application::_append_history(const TelemetrySample &sample) {
+    auto &history = _history;
+
+    const HistoryEntry entry = {
+        .sensor = sample.sensor_value,
+        .control = sample.control_value,
+        .integral = sample.integral
+    };
+
+    history.entries[history.index] = entry;
+
+    history.sensor_min = std::min(history.sensor_min, sample.sensor_value);
+    history.sensor_max = std::max(history.sensor_max, sample.sensor_value);
+
+    history.index = (history.index + 1) % HISTORY_COUNT;
+    history.seq++;
+
+    _runtime_info.history_append = {.seq = history.seq, .entry = entry};
+
+    // Archive needs wall-clock time to survive reboots
+    if (_archive && _ntp_time->available()) {
+        _archive->add(_ntp_time->epoch_tz(), entry);
+    }
+}
+
+void Application::_append_channel_history(const TelemetrySample &sample) {
+    auto &history = _channel_history.channels[sample.channel - 1];
+
+    history.entries[history.index] = {
+        .sensor = sample.sensor_value,
+        .control = sample.control_value,
+        .integral = sample.integral
+    };
+
+    history.index = (history.index + 1) % CHANNEL_HISTORY_COUNT;
+    history.seq++;
+}
+
+void Application::_send_archive() {
+    const auto range = _runtime_info.archive_range;
+    if (range == 0) {
+        _bootstrap->ws_server()->send_notification(PacketType::HISTORY_DATA);
+        return;
+    }
+
+    if (_archive && _ntp_time->available()) {
+        const auto now = (uint32_t) _ntp_time->epoch_tz();
+        _archive->query(now - std::min(now, range), now, *_archive_result);
+    } else {
+        _archive_result->header = {};
+    }
+
+    D_PRINTF("Archive: %u records for %u sec\r\n", _archive_result->header.count, range);
+    _bootstrap->ws_server()->send_notification(PacketType::HISTORY_ARCHIVE);
+}
+
+void Application::_update_sensor_log() {
+    auto &state = _runtime_info.sensor_log;
+    const auto sensor = config().regulator.sensor.type;
+
+    // Replay sensor reads the file that would be overwritten
+    if (state.record && sensor == SensorType::REPLAY) {
+        D_PRINT("Sensor log: unable to record while replaying");
+        state.record = false;
+    }
+
+    bool started = false;
+    if (state.record && !_sensor_log_file->active()) {
+        started = _sensor_log_file->start(sensor);
+    } else if (!state.record && _sensor_log_file->active()) {
+        _sensor_log_file->stop();
+    }
+
+    if (state.stream && !_sensor_log_stream->active()) {
+        started = _sensor_log_stream->start(sensor) || started;
+    } else if (!state.stream && _sensor_log_stream->active()) {
+        _sensor_log_stream->stop();
+    }
+
+    // Writers wait for a regulator snapshot; reloading the same config makes the control task take one
+    if (started) _load();
+
+    _notify_sensor_log();
+}
+
+void Application::_write_sensor_log(const TelemetrySample &sample) {
+    // Snapshot goes before the first sample taken after it, older samples may still be in the queue
+    if (_snapshot_pending && (int32_t) (sample.time_us - _snapshot.time_us) > 0) {
+        _snapshot_pending = false;
+
+        _sensor_log_file->add(_snapshot);
+        _sensor_log_stream->add(_snapshot);
+    }
+
+    _sensor_log_file->add(sample);
+    _sensor_log_stream->add(sample);
+}
+
+void Application::_fetch_sensor_log(uint32_t offset) {
+    _sensor_log_file->flush();
+
+    if (!_sensor_log_chunk->read(LittleFS, offset)) {
+        D_PRINT("Sensor log: nothing recorded");
+    }
+}
+
+void Application::_notify_sensor_log() {
+    auto &state = _runtime_info.sensor_log;
+
+    // Writers stop themselves when full or on write error
+    state.record = _sensor_log_file->active();
+    state.stream = _sensor_log_stream->active();
+    state.failed = _sensor_log_file->failed();
+    state.size = _sensor_log_file->size();
+    state.samples = _sensor_log_file->samples();
+
+    _bootstrap->ws_server()->send_notification(PacketType::SENSOR_LOG_STATE);
+}
+
+void Application::_start_autotune() {
+    if (_state != AppState::ACTIVE) {
+        D_PRINT("Autotune: regulator is not active");
+        return;
+    }
+
+    _autotune_requested = true;
+    _load();
+}
+
+void Application::_stop_autotune() {
+    if (!_autotune_requested) return;
+
+    _autotune_requested = false;
+    _load();
+}
+
+void Application::_finish_autotune() {
+    D_PRINTF("Autotune: %s\r\n", __debug_enum_str(_runtime_info.autotune.state));
+
+    // Regulator returns to PID with unchanged gains, proposed ones are applied on request
+    _autotune_requested = false;
+    _load();
+}
+
+void Application::_start_identification() {
+    if (_state != AppState::ACTIVE) {
+        D_PRINT("Identification: regulator is not active");
+        return;
+    }
+
+    _identification_requested = true;
+    _load();
+}
+
+void Application::_stop_identification() {
+    if (!_identification_requested) return;
+
+    _identification_requested = false;
+    _load();
+}
+
+void Application::_finish_identification() {
+    auto &result = _runtime_info.identification;
+    D_PRINTF("Identification: %s\r\n", __debug_enum_str(result.state));
+
+    if (result.state == IdentificationState::IDENT_DONE) {
+        identification_apply_rule(result, config().autotune.rule, config().regulator.pid.k_mul);
+
+        _bootstrap->mqtt_server()->send_notification(MQTT_OUT_TOPIC_MODEL_GAIN);
+        _bootstrap->mqtt_server()->send_notification(MQTT_OUT_TOPIC_MODEL_TIME_CONSTANT);
+        _bootstrap->mqtt_server()->send_notification(MQTT_OUT_TOPIC_MODEL_DEAD_TIME);
+    }
+
+    _identification_requested = false;
+    _load();
+}
+
+void Application::_load_program() {
+    const auto slot = config().program.slot;
+    if (!program_load(LittleFS, slot, _program)) _program = {};
+
+    D_PRINTF("Program: slot %u, %u segments\r\n", slot, _program.count);
+}
+
+void Application::_start_program() {
+    if (_state != AppState::ACTIVE) {
+        D_PRINT("Program: regulator is not active");
+        return;
+    }
+
+    if (_program.count == 0) {
+        D_PRINT("Program: slot is empty");
+        return;
+    }
+
+    if (_program.feed_forward && !config().regulator.predictor.model_valid) {
+        D_PRINT("Program: feed-forward needs an identified or entered process model");
+        return;
+    }
+
+    _program_requested = true;
+    _load();
+}
+
+void Application::_stop_program() {
+    if (!_program_requested) return;
+
+    _program_requested = false;
+    _load();
+}
+
+void Application::_apply_gains(float p, float i, float d) {
+    // Same parameters as PID_P/PID_I/PID_D packets, so the change is stored and reported the same way
+    auto &pid_meta = _metadata->regulator.pid;
+    pid_meta.p.set_value(&p, sizeof(p));
+    pid_meta.i.set_value(&i, sizeof(i));
+    pid_meta.d.set_value(&d, sizeof(d));
+
+    _load();
+    update();
+}
+
+void Application::_apply_model(const FopdtModel &model) {
+    // Identified model is kept for the Smith predictor whether or not it's enabled
+    const float gain = model.gain, time_constant = model.time_constant, dead_time = model.dead_time;
+
+    config().regulator.predictor.model_valid = true;
+
+    auto &predictor_meta = _metadata->regulator.predictor;
+    predictor_meta.gain.set_value(&gain, sizeof(gain));
+    predictor_meta.time_constant.set_value(&time_constant, sizeof(time_constant));
+    predictor_meta.dead_time.set_value(&dead_time, sizeof(dead_time));
 }
 
 void Application::_bootstrap_service_loop() {
@@ -2,8 +2,6 @@
 
 #include "sys_constants.h"
 
-#include <uPID.h>
-
 #include <lib/bootstrap.h>
 #include <lib/misc/button.h>
 #include <lib/misc/ntp_time.h>
@@ -13,11 +11,30 @@
 #include "metadata.h"
 #include "cmd.h"
 #include "poly_meta.h"
+#include "control_task.h"
+#include "misc/history_archive.h"
 #include "misc/night_mode.h"
+#include "misc/sensor_log.h"
 
+#include "controls/ledc_control.h"
 #include "controls/pwm_control.h"
 #include "sensors/analog_sensor.h"
 #include "sensors/dsx18_sensor.h"
+#include "sensors/replay_sensor.h"
+
+struct ChannelMqttTopics {
+    char target[MQTT_CHANNEL_TOPIC_SIZE]{};
+    char target_out[MQTT_CHANNEL_TOPIC_SIZE]{};
+    char sensor[MQTT_CHANNEL_TOPIC_SIZE]{};
+    char control[MQTT_CHANNEL_TOPIC_SIZE]{};
+
+    explicit ChannelMqttTopics(uint8_t channel) {
+        snprintf(target, sizeof(target), MQTT_TOPIC_CHANNEL "/target", channel);
+        snprintf(target_out, sizeof(target_out), MQTT_OUT_TOPIC_CHANNEL "/target", channel);
+        snprintf(sensor, sizeof(sensor), MQTT_OUT_TOPIC_CHANNEL "/sensor", channel);
+        snprintf(control, sizeof(control), MQTT_OUT_TOPIC_CHANNEL "/control", channel);
+    }
+};
 
 class Application {
     std::unique_ptr<Bootstrap<Config, PacketType>> _bootstrap = nullptr;
@@ -25,17 +42,38 @@ class Application {
     std::unique_ptr<NightModeManager> _night_mode_manager = nullptr;
     std::unique_ptr<NtpTime> _ntp_time = nullptr;
 
-    std::unique_ptr<SensorBase> _sensor = nullptr;
-    std::unique_ptr<ControlBase> _control = nullptr;
-    std::unique_ptr<uPID> _pid = nullptr;
+    std::unique_ptr<ControlTask> _control_task = nullptr;
 
     std::unique_ptr<AbstractMetaHolder> _sensor_meta = nullptr;
     std::unique_ptr<AbstractMetaHolder> _control_meta = nullptr;
+    std::unique_ptr<AbstractMetaHolder> _filter_meta = nullptr;
+
+    // Channels 1..: regulator, sensor, control and filter metadata, not registered as packets
+    std::vector<std::unique_ptr<AbstractMetaHolder>> _channel_meta[REGULATOR_MAX_CHANNELS];
+    std::vector<std::unique_ptr<ChannelDataMeta>> _channel_data_meta{};
+    std::vector<std::unique_ptr<ChannelMqttTopics>> _channel_topics{};
+    ChannelParameters _channel_parameters{};
+    ChannelHistories _channel_history{};
 
     RuntimeInfo _runtime_info{};
+    DataHistory _history{};
+
+    std::unique_ptr<HistoryArchive> _archive = nullptr;
+    std::unique_ptr<ArchiveQueryResult> _archive_result = nullptr;
+
+    std::unique_ptr<SensorLogFile> _sensor_log_file = nullptr;
+    std::unique_ptr<SensorLogStream> _sensor_log_stream = nullptr;
+    std::unique_ptr<SensorLogChunk> _sensor_log_chunk = nullptr;
+
+    RegulatorSnapshot _snapshot{};
+    bool _snapshot_pending = false;
+
+    SetpointProgram _program{}; // Program of the selected slot
 
     bool _initialized = false;
-    uint32_t _last_pid_compute = 0;
+    bool _autotune_requested = false;
+    bool _identification_requested = false;
+    bool _program_requested = false;
 
     unsigned long _state_change_time = 0;
     AppState _state = AppState::UNINITIALIZED;
@@ -51,7 +89,7 @@ public:
 
     void update();
 
-    void restart() { _bootstrap->restart(); }
+    void restart();
 
 protected:
     void change_state(AppState s);
@@ -66,6 +104,32 @@ private:
     void _bootstrap_state_changed(void *sender, BootstrapState state, void *arg);
 
     void _service_loop();
+    void _append_history(const TelemetrySample &sample);
+    void _append_channel_history(const TelemetrySample &sample);
+    void _setup_channels();
+    void _apply_channel_parameter();
+    void _send_archive();
+
+    void _update_sensor_log();
+    void _write_sensor_log(const TelemetrySample &sample);
+    void _fetch_sensor_log(uint32_t offset);
+    void _notify_sensor_log();
+
+    void _start_autotune();
+    void _stop_autotune();
+    void _finish_autotune();
+
+    void _start_identification();
+    void _stop_identification();
+    void _finish_identification();
+
+    void _load_program();
+    void _start_program();
+    void _stop_program();
+
+    void _apply_gains(float p, float i, float d);
+    void _apply_model(const FopdtModel &model);
+
     void _bootstrap_service_loop();
 
     void _handle_property_change(const AbstractParameter *param);
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+#include <map>
+
+#include <lib/base/parameter.h>
+
+#include "cmd.h"
+#include "sys_constants.h"
+
+struct __attribute ((packed)) ChannelParameterValue {
+    uint8_t channel = 0;
+    PacketType type{};  // Packet of the same parameter of channel 0, e.g. PID_TARGET
+    uint8_t value[CHANNEL_PARAMETER_MAX_SIZE]{};
+};
+
+/**
+ * Regulator parameters of every channel, by the packet type which addresses them in channel 0.
+ */
+class ChannelParameters {
+    std::map<PacketType, AbstractParameter *> _channels[REGULATOR_MAX_CHANNELS];
+
+    ChannelParameterValue _last{};
+    size_t _last_size = 0;
+
+public:
+    void add(uint8_t channel, PacketType type, AbstractParameter *parameter) {
+        if (channel < REGULATOR_MAX_CHANNELS) _channels[channel][type] = parameter;
+    }
+
+    [[nodiscard]] AbstractParameter *find(uint8_t channel, PacketType type) const {
+        if (channel >= REGULATOR_MAX_CHANNELS) return nullptr;
+
+        auto it = _channels[channel].find(type);
+        return it != _channels[channel].end() ? it->second : nullptr;
+    }
+
+    /**
+     * @return channel of a parameter; -1 if it isn't a regulator parameter
+     */
+    [[nodiscard]] int channel_of(const AbstractParameter *parameter) const {
+        for (uint8_t i = 0; i < REGULATOR_MAX_CHANNELS; ++i) {
+            for (auto &[type, value]: _channels[i]) if (value == parameter) return i;
+        }
+
+        return -1;
+    }
+
+    /**
+     * Set parameter from `ChannelParameterValue` with value of the parameter's size.
+     */
+    bool set(const void *data, size_t size) {
+        if (size <= offsetof(ChannelParameterValue, value) || size > sizeof(ChannelParameterValue)) return false;
+
+        ChannelParameterValue request;
+        memcpy(&request, data, size);
+
+        auto *parameter = find(request.channel, request.type);
+        if (!parameter || !parameter->set_value(request.value, size - offsetof(ChannelParameterValue, value))) return false;
+
+        _last = request;
+        _last_size = size;
+        return true;
+    }
+
+    [[nodiscard]] const ChannelParameterValue &last() const { return _last; }
+    [[nodiscard]] size_t last_size() const { return _last_size; }
+};
+
+/**
+ * Single packet addressing regulator parameters of any channel, see `ChannelParameterValue`.
+ * Reading returns the last accepted write.
+ */
+class ChannelParameter : public AbstractParameter {
+    ChannelParameters *_parameters;
+
+public:
+    explicit ChannelParameter(ChannelParameters *parameters) : _parameters(parameters) {}
+
+    bool set_value(const void *data, size_t size) override { return _parameters->set(data, size); }
+
+    [[nodiscard]] const void *get_value() const override { return &_parameters->last(); }
+
+    [[nodiscard]] size_t size() const override { return _parameters->last_size(); }
+};
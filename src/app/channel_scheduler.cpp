@@ -0,0 +1,155 @@
+#include "channel_scheduler.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "lib/debug.h"
+
+#include "controls/ledc_control.h"
+#include "controls/pwm_control.h"
+
+// Pin written by control; -1 if it doesn't drive one
+static int control_pin(const ControlConfig &control) {
+    if (control.type == ControlType::PWM_VALUE) return ((const PwmControlConfig *) control.data)->pin;
+    if (control.type == ControlType::LEDC_PWM) return ((const LedcControlConfig *) control.data)->pin;
+
+    return -1;
+}
+
+ChannelScheduler::ChannelScheduler(Timer &timer, const std::vector<const RegulatorConfig *> &configs, uint32_t enabled) :
+    _enabled(enabled | 1u) {
+    const auto count = std::min<size_t>(configs.size(), 32);
+
+    for (size_t i = 0; i < count; ++i) {
+        _configs.push_back(configs[i]);
+        _channels.push_back(std::make_unique<Regulator>(timer, *configs[i], (uint8_t) i));
+        _intervals.push_back(configs[i]->pid.interval);
+    }
+}
+
+void ChannelScheduler::begin() {
+    for (uint8_t i = 0; i < count(); ++i) {
+        if ((_enabled & (1u << i)) == 0 || _conflicts(i)) {
+            _intervals[i] = 0;
+            continue;
+        }
+
+        _running |= 1u << i;
+        _channels[i]->begin();
+    }
+
+    _setup_cascades();
+
+    D_PRINTF("Regulator channels: %u, running: %u, cascades: %u\r\n",
+             count(), __builtin_popcount(_running), (unsigned) _cascades.size());
+}
+
+// Channel 0 is checked first and never conflicts
+bool ChannelScheduler::_conflicts(uint8_t index) const {
+    const auto &control = _configs[index]->control;
+    const auto pin = control_pin(control);
+
+    for (uint8_t i = 0; i < index; ++i) {
+        if (!running(i)) continue;
+
+        const auto &other = _configs[i]->control;
+        if (pin >= 0 && pin == control_pin(other)) {
+            D_PRINTF("Channel %u: control pin %i is used by channel %u, channel disabled\r\n", index, pin, i);
+            return true;
+        }
+
+        if (control.type == ControlType::LEDC_PWM && other.type == ControlType::LEDC_PWM
+            && ((const LedcControlConfig *) control.data)->channel == ((const LedcControlConfig *) other.data)->channel) {
+            D_PRINTF("Channel %u: LEDC channel is used by channel %u, channel disabled\r\n", index, i);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+// Control types are read by `Regulator::begin` only, so links are fixed until restart as well
+void ChannelScheduler::_setup_cascades() {
+    std::vector<bool> inner(count(), false);
+
+    for (uint8_t i = 0; i < count(); ++i) {
+        const auto &control = _configs[i]->control;
+        if (!running(i) || control.type != ControlType::CASCADE) continue;
+
+        const auto target = ((const CascadeControlConfig *) control.data)->channel;
+        if (target >= count() || target == i || inner[target] || !running(target)) {
+            D_PRINTF("Channel %u: cascade to channel %u ignored\r\n", i, target);
+            continue;
+        }
+
+        if (_intervals[target] >= _intervals[i]) {
+            D_PRINTF("Channel %u: inner loop %u should be faster than outer\r\n", i, target);
+        }
+
+        _cascades.push_back({.outer = i, .inner = target});
+        inner[target] = true;
+    }
+
+    for (uint8_t i = 0; i < count(); ++i) if (running(i) && inner[i]) _order.push_back(i);
+    for (uint8_t i = 0; i < count(); ++i) if (running(i) && !inner[i]) _order.push_back(i);
+}
+
+void ChannelScheduler::load(uint8_t index, const PidConfig &pid_config, bool active) {
+    if (!running(index)) return;
+
+    _intervals[index] = pid_config.interval;
+
+    _interval = UINT16_MAX;
+    for (auto value: _intervals) if (value > 0) _interval = std::min(_interval, value);
+
+    auto &channel = *_channels[index];
+    channel.set_phase((uint16_t) ((uint32_t) pid_config.interval * index / count()));
+    channel.load(pid_config, active);
+
+    // Setpoint of an inner loop comes from its outer loop, not from config
+    for (auto &link: _cascades) {
+        const auto &outer = _channels[link.outer]->telemetry();
+        if (link.inner == index && outer.active) channel.set_target(outer.control_value);
+    }
+}
+
+void ChannelScheduler::_propagate(uint8_t index) {
+    for (auto &link: _cascades) {
+        auto &outer = *_channels[link.outer];
+        auto &inner = *_channels[link.inner];
+
+        if (link.outer == index) {
+            const auto &telemetry = outer.telemetry();
+            if (telemetry.active) inner.set_target(telemetry.control_value);
+        } else if (link.inner == index) {
+            const auto &telemetry = inner.telemetry();
+            const auto &config = inner.pid_config();
+
+            // Inner output at a limit: moving its setpoint further in that direction can't change anything
+            bool high = telemetry.pid && telemetry.control_value >= config.out_max;
+            bool low = telemetry.pid && telemetry.control_value <= config.out_min;
+            if (config.direction == DirectionMode::PID_REVERSE) std::swap(high, low);
+
+            outer.hold_output(high, low);
+        }
+    }
+}
+
+uint32_t ChannelScheduler::update() {
+    uint32_t computed = 0;
+
+    for (auto i: _order) {
+        const auto start = ESP.getCycleCount();
+        if (!_channels[i]->update()) continue;
+
+        if (!_cascades.empty()) _propagate(i);
+
+        _load.add(ESP.getCycleCount() - start);
+        computed |= 1u << i;
+    }
+
+    _load.end_pass();
+    _load.finish(millis(), count(), ESP.getCpuFreqMHz(), _interval);
+
+    return computed;
+}
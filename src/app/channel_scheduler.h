@@ -0,0 +1,79 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "lib/misc/timer.h"
+
+#include "config.h"
+#include "regulator.h"
+
+#include "misc/channel_load.h"
+
+/**
+ * Independent regulator channels sharing one timer and one task.
+ * Polled sample instants of channel `i` are shifted by `i / count` of its interval, so with equal intervals
+ * channels compute one at a time instead of all in the same pass. CPU cycles of computing iterations are metered.
+ *
+ * A channel with CASCADE control is the outer loop of a cascade: its output becomes the setpoint of the inner channel.
+ * Inner channels are updated first in every pass, and while an inner loop is saturated the outer output is held
+ * so the outer integral doesn't wind up.
+ * Channels 1.. run only if enabled and their control pin and LEDC channel aren't taken by a channel with lower index,
+ * others are never begun: they don't touch hardware and ignore `load`.
+ * Not thread-safe: after `begin` all methods must be called from the same task.
+ */
+class ChannelScheduler {
+    struct CascadeLink {
+        uint8_t outer;
+        uint8_t inner;
+    };
+
+    std::vector<const RegulatorConfig *> _configs;
+    std::vector<std::unique_ptr<Regulator>> _channels;
+    std::vector<uint16_t> _intervals;
+    uint32_t _enabled;
+    uint32_t _running = 0;
+    uint16_t _interval = UINT16_MAX; // Shortest of `_intervals`, ms
+
+    std::vector<CascadeLink> _cascades;
+    std::vector<uint8_t> _order; // Update order: inner loops first
+
+    ChannelLoadMeter _load{};
+
+public:
+    /**
+     * @param configs one per channel, channel 0 first; at most 32
+     * @param enabled bit mask of channels to run, channel 0 always runs
+     */
+    ChannelScheduler(Timer &timer, const std::vector<const RegulatorConfig *> &configs, uint32_t enabled = UINT32_MAX);
+
+    [[nodiscard]] uint8_t count() const { return _channels.size(); }
+
+    /**
+     * @return false if channel is disabled or conflicts with another one; valid after `begin`
+     */
+    [[nodiscard]] bool running(uint8_t index) const { return (_running & (1u << index)) != 0; }
+
+    [[nodiscard]] Regulator &channel(uint8_t index) { return *_channels[index]; }
+    [[nodiscard]] const Regulator &channel(uint8_t index) const { return *_channels[index]; }
+
+    [[nodiscard]] const ChannelLoadStats &load_stats() const { return _load.stats(); }
+
+    void begin();
+
+    /**
+     * Configure PID of a channel and move its sample instants to the channel's slot.
+     */
+    void load(uint8_t index, const PidConfig &pid_config, bool active);
+
+    /**
+     * Run one iteration of every channel.
+     * @return bit mask of channels which computed a new value
+     */
+    uint32_t update();
+
+private:
+    bool _conflicts(uint8_t index) const;
+    void _setup_cascades();
+    void _propagate(uint8_t index);
+};
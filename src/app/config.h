@@ -1,5 +1,6 @@
 #pragma once
 
+#include <algorithm>
 #include <memory>
 
 #include <lib/network/wifi.h>
@@ -8,9 +9,22 @@
 #include "constants.h"
 #include "enum.h"
 #include "controls/base.h"
+#include "controls/cascade_control.h"
+#include "controls/ledc_control.h"
 #include "controls/pwm_control.h"
+#include "misc/channel_load.h"
+#include "misc/jitter_stats.h"
+#include "misc/setpoint_program.h"
+#include "pid/relay_autotune.h"
+#include "pid/smith_predictor.h"
+#include "pid/step_identification.h"
 #include "sensors/base.h"
+#include "sensors/analog_sensor.h"
+#include "sensors/dsx18_bus.h"
 #include "sensors/dsx18_sensor.h"
+#include "sensors/filters.h"
+#include "sensors/replay_sensor.h"
+#include "sensors/sensor_group.h"
 
 
 typedef char ConfigString[CONFIG_STRING_SIZE];
@@ -46,8 +60,29 @@ struct __attribute ((packed)) SensorConfig {
     uint8_t data[1024];
 
     SensorConfig() : type(SensorType::DSX18X), data{} {
-        DSx18SensorConfig ds_config;
-        memcpy(data, &ds_config, sizeof(DSx18SensorConfig));
+        reset_data();
+    }
+
+    // Fill data with defaults of current type
+    void reset_data() {
+        memset(data, 0, sizeof(data));
+
+        if (type == SensorType::DSX18X) {
+            DSx18SensorConfig ds_config;
+            memcpy(data, &ds_config, sizeof(DSx18SensorConfig));
+        } else if (type == SensorType::DSX18X_BUS) {
+            DSx18BusSensorConfig bus_config;
+            memcpy(data, &bus_config, sizeof(DSx18BusSensorConfig));
+        } else if (type == SensorType::DSX18X_GROUP) {
+            DSx18GroupSensorConfig group_config;
+            memcpy(data, &group_config, sizeof(DSx18GroupSensorConfig));
+        } else if (type == SensorType::REPLAY) {
+            ReplaySensorConfig replay_config;
+            memcpy(data, &replay_config, sizeof(ReplaySensorConfig));
+        } else {
+            AnalogSensorConfig analog_config;
+            memcpy(data, &analog_config, sizeof(AnalogSensorConfig));
+        }
     }
 };
 
@@ -56,8 +91,24 @@ struct __attribute ((packed)) ControlConfig {
     uint8_t data[1024];
 
     ControlConfig() : type(ControlType::PWM_VALUE), data{} {
-        PwmControlConfig pwn_config;
-        memcpy(data, &pwn_config, sizeof(PwmControlConfig));
+        reset_data();
+    }
+
+    // Fill data with defaults of current type; LEDC channel defaults to the regulator channel, so they don't share one
+    void reset_data(uint8_t regulator_channel = 0) {
+        memset(data, 0, sizeof(data));
+
+        if (type == ControlType::LEDC_PWM) {
+            LedcControlConfig ledc_config;
+            ledc_config.channel = regulator_channel;
+            memcpy(data, &ledc_config, sizeof(LedcControlConfig));
+        } else if (type == ControlType::CASCADE) {
+            CascadeControlConfig cascade_config;
+            memcpy(data, &cascade_config, sizeof(CascadeControlConfig));
+        } else {
+            PwmControlConfig pwn_config;
+            memcpy(data, &pwn_config, sizeof(PwmControlConfig));
+        }
     }
 };
 
@@ -79,12 +130,29 @@ struct __attribute__((packed)) PidConfig {
     IntegralLimitMode i_limit = IntegralLimitMode::I_NONE; // Integral limit mode
     DifferentialMode d_mode = DifferentialMode::D_ERROR;   // Differential mode
     DirectionMode direction = DirectionMode::PID_FORWARD;  // Direction mode
+
+    PidEngine engine = PidEngine::PID_FLOAT;            // Computation engine
+    SamplingMode sampling = SamplingMode::SAMPLING_POLLED; // Sampling trigger
 };
 
 struct __attribute ((packed)) RegulatorConfig {
     SensorConfig sensor{};
     ControlConfig control{};
     PidConfig pid{};
+    SensorFilterConfig filter{};
+    SmithPredictorConfig predictor{};
+};
+
+struct __attribute ((packed)) ChannelsConfig {
+    uint8_t count = 1;    // Regulator channels including the main one, applied after restart
+    uint32_t enabled = 0; // Bit i: channel i runs, set once it's configured; channel 0 always runs. Applied after restart
+
+    // Channels 1..: addressed with CHANNEL_PARAMETER packets, main channel is `Config::regulator`
+    RegulatorConfig extra[REGULATOR_MAX_CHANNELS - 1]{};
+};
+
+struct __attribute ((packed)) ProgramConfig {
+    uint8_t slot = 0; // Setpoint program file started by PROGRAM_START and written by PROGRAM_DATA, up to PROGRAM_SLOTS - 1
 };
 
 struct __attribute ((packed)) Config {
@@ -92,8 +160,18 @@ struct __attribute ((packed)) Config {
 
     RegulatorConfig regulator{};
     NightModeConfig night_mode{};
+    AutotuneConfig autotune{};
+    IdentificationConfig identification{};
+    ChannelsConfig channels{};
+    ProgramConfig program{};
 
     SysConfig sys_config{};
+
+    [[nodiscard]] uint8_t channel_count() const {
+        return std::max<uint8_t>(1, std::min<uint8_t>(channels.count, REGULATOR_MAX_CHANNELS));
+    }
+
+    RegulatorConfig &channel(uint8_t index) { return index == 0 ? regulator : channels.extra[index - 1]; }
 };
 
 struct __attribute ((packed)) HistoryEntry {
@@ -109,12 +187,66 @@ struct __attribute ((packed)) DataHistory {
     float sensor_max = -INFINITY;
 
     uint16_t index = 0;
+    uint32_t seq = 0; // Sequence number of the latest entry
     HistoryEntry entries[HISTORY_COUNT]{};
 };
 
+struct __attribute ((packed)) HistoryAppend {
+    uint32_t seq = 0;
+    HistoryEntry entry{};
+};
+
+struct __attribute ((packed)) ChannelHistory {
+    uint16_t index = 0;
+    uint32_t seq = 0; // Sequence number of the latest entry
+    HistoryEntry entries[CHANNEL_HISTORY_COUNT]{};
+};
+
+struct __attribute ((packed)) ChannelHistories {
+    ChannelHistory channels[REGULATOR_MAX_CHANNELS - 1]{}; // Channels 1..
+};
+
+struct __attribute ((packed)) ChannelState {
+    float sensor_value = NAN;
+    float control_value = NAN;
+    bool active = false;
+    uint32_t computes = 0;
+};
+
+struct __attribute ((packed)) ChannelsState {
+    ChannelLoadStats load{};
+    ChannelState channels[REGULATOR_MAX_CHANNELS]{};
+};
+
+struct __attribute ((packed)) SensorLogState {
+    bool record = false; // Recording to SENSOR_LOG_PATH
+    bool stream = false; // Streaming over WebSocket
+    bool failed = false; // Recording stopped on write error, e.g. file system is full
+
+    uint32_t size = 0;    // Recorded file size, bytes
+    uint32_t samples = 0; // Recorded samples
+};
+
 struct __attribute ((packed)) RuntimeInfo {
     float sensor_value;
     float control_value;
 
-    DataHistory history;
+    SamplingStats sampling;
+
+    HistoryAppend history_append;
+
+    uint32_t archive_range; // Range of archive shown instead of live history, seconds; 0 for live history
+
+    AutotuneResult autotune;
+    IdentificationResult identification;
+
+    SensorLogState sensor_log;
+
+    DSx18BusStats sensor_bus;      // Filled for DSX18X_BUS and DSX18X_GROUP sensors
+    AnalogNoiseStats sensor_noise; // Filled for analog sensor in continuous mode
+    SensorGroupStats sensor_group; // Filled for DSX18X_GROUP sensor
+
+    ChannelsState channels;
+
+    ProgramStatus program;
 };
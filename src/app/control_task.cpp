@@ -0,0 +1,226 @@
+#include "control_task.h"
+
+#include "sys_constants.h"
+#include "lib/debug.h"
+
+#include "misc/sample_timer.h"
+
+ControlTask::ControlTask(const std::vector<const RegulatorConfig *> &configs, uint32_t enabled) :
+    _scheduler(_timer, configs, enabled), _regulator(_scheduler.channel(0)) {}
+
+void ControlTask::begin() {
+    _scheduler.begin();
+
+    auto result = xTaskCreatePinnedToCore(
+        &ControlTask::_task_fn, "control", CONTROL_TASK_STACK_SIZE, this,
+        CONTROL_TASK_PRIORITY, &_task, CONTROL_TASK_CORE
+    );
+
+    if (result != pdPASS) {
+        D_PRINT("Unable to start control task");
+        return;
+    }
+
+    SampleTimer::set_tick_handler(&ControlTask::_on_sample_tick);
+}
+
+void ControlTask::prefetch_sensors() {
+    for (uint8_t i = 0; i < _scheduler.count(); ++i) {
+        if (_scheduler.running(i)) _scheduler.channel(i).prefetch_sensor();
+    }
+}
+
+void ControlTask::load(const PidConfig &pid_config, const SmithPredictorConfig &predictor, bool active,
+                       const AutotuneConfig *autotune, const IdentificationConfig *identification,
+                       const SetpointProgram *program) {
+    auto &command = _commands[0].back();
+    command.pid = pid_config;
+    command.predictor = predictor;
+    command.active = active;
+
+    command.autotune = autotune != nullptr;
+    if (autotune) command.autotune_config = *autotune;
+
+    command.identification = identification != nullptr;
+    if (identification) command.identification_config = *identification;
+
+    command.program = program != nullptr;
+    if (program) command.program_config = *program;
+
+    _commands[0].publish();
+}
+
+void ControlTask::load_channel(uint8_t channel, const PidConfig &pid_config, const SmithPredictorConfig &predictor,
+                               bool active) {
+    if (channel == 0 || channel >= _scheduler.count()) return;
+
+    auto &command = _commands[channel].back();
+    command.pid = pid_config;
+    command.predictor = predictor;
+    command.active = active;
+
+    _commands[channel].publish();
+}
+
+bool ControlTask::poll_sampling(SamplingStats &stats) {
+    if (!_sampling.update()) return false;
+
+    stats = _sampling.front();
+    return true;
+}
+
+bool ControlTask::poll_autotune(AutotuneResult &result) {
+    if (!_autotune.update()) return false;
+
+    result = _autotune.front();
+    return true;
+}
+
+bool ControlTask::poll_identification(IdentificationResult &result) {
+    if (!_identification.update()) return false;
+
+    result = _identification.front();
+    return true;
+}
+
+bool ControlTask::poll_program(ProgramStatus &status) {
+    if (!_program.update()) return false;
+
+    status = _program.front();
+    return true;
+}
+
+bool ControlTask::poll_snapshot(RegulatorSnapshot &snapshot) {
+    if (!_snapshot.update()) return false;
+
+    snapshot = _snapshot.front();
+    return true;
+}
+
+bool ControlTask::poll_sensor_bus(DSx18BusStats &stats) {
+    if (!_sensor_bus.update()) return false;
+
+    stats = _sensor_bus.front();
+    return true;
+}
+
+bool ControlTask::poll_sensor_noise(AnalogNoiseStats &stats) {
+    if (!_sensor_noise.update()) return false;
+
+    stats = _sensor_noise.front();
+    return true;
+}
+
+bool ControlTask::poll_sensor_group(SensorGroupStats &stats) {
+    if (!_sensor_group.update()) return false;
+
+    stats = _sensor_group.front();
+    return true;
+}
+
+bool ControlTask::poll_channel_load(ChannelLoadStats &stats) {
+    if (!_channel_load.update()) return false;
+
+    stats = _channel_load.front();
+    return true;
+}
+
+void ControlTask::_task_fn(void *arg) {
+    ((ControlTask *) arg)->_loop();
+}
+
+void IRAM_ATTR ControlTask::_on_sample_tick() {
+    BaseType_t woken = pdFALSE;
+    vTaskNotifyGiveFromISR(_task, &woken);
+
+    if (woken) portYIELD_FROM_ISR();
+}
+
+void ControlTask::_loop() {
+    D_PRINTF("Control task started, priority %u\r\n", uxTaskPriorityGet(nullptr));
+
+    while (true) {
+        if (_commands[0].update()) {
+            const auto &command = _commands[0].front();
+
+            // Program goes first, so `load` applies its setpoint or, once it's stopped, the configured target
+            _regulator.set_program(command.program, command.program_config);
+            _scheduler.load(0, command.pid, command.active);
+            _regulator.set_predictor(command.predictor);
+            _regulator.set_autotune(command.autotune, command.autotune_config);
+            _regulator.set_identification(command.identification, command.identification_config);
+
+            _snapshot.write(_regulator.snapshot());
+        }
+
+        for (uint8_t i = 1; i < _scheduler.count(); ++i) {
+            if (!_scheduler.running(i) || !_commands[i].update()) continue;
+
+            const auto &command = _commands[i].front();
+            _scheduler.load(i, command.pid, command.active);
+            _scheduler.channel(i).set_predictor(command.predictor);
+        }
+
+        _timer.handle_timers();
+
+        const auto *sensor_bus = _regulator.sensor_bus();
+        if (sensor_bus && sensor_bus->scans != _sensor_bus_scans) {
+            _sensor_bus_scans = sensor_bus->scans;
+            _sensor_bus.write(*sensor_bus);
+        }
+
+        const auto *sensor_noise = _regulator.sensor_noise();
+        if (sensor_noise && sensor_noise->windows != _sensor_noise_windows) {
+            _sensor_noise_windows = sensor_noise->windows;
+            _sensor_noise.write(*sensor_noise);
+        }
+
+        const auto *sensor_group = _regulator.sensor_group();
+        if (sensor_group && sensor_group->rounds != _sensor_group_rounds) {
+            _sensor_group_rounds = sensor_group->rounds;
+            _sensor_group.write(*sensor_group);
+        }
+
+        const auto computed = _scheduler.update();
+        for (uint8_t i = 1; i < _scheduler.count(); ++i) {
+            if (computed & (1u << i)) _samples.push(_scheduler.channel(i).telemetry());
+        }
+
+        const auto &channel_load = _scheduler.load_stats();
+        if (channel_load.windows != _channel_load_windows) {
+            _channel_load_windows = channel_load.windows;
+            _channel_load.write(channel_load);
+        }
+
+        if (computed & 1u) {
+            _samples.push(_regulator.telemetry());
+            _sampling.write(_regulator.sampling());
+
+            // Progress is published while running, final state once
+            const auto &autotune = _regulator.autotune();
+            if (autotune.state == AutotuneState::AUTOTUNE_RUNNING || autotune.state != _autotune_state) {
+                _autotune_state = autotune.state;
+                _autotune.write(autotune);
+            }
+
+            const auto &identification = _regulator.identification();
+            const bool identifying = identification.state == IdentificationState::IDENT_BASELINE
+                                     || identification.state == IdentificationState::IDENT_STEP;
+            if (identifying || identification.state != _identification_state) {
+                _identification_state = identification.state;
+                _identification.write(identification);
+            }
+
+            const auto &program = _regulator.program();
+            const bool running = program.state == ProgramState::PROGRAM_RUNNING
+                                 || program.state == ProgramState::PROGRAM_HOLD;
+            if (running || program.state != _program_state) {
+                _program_state = program.state;
+                _program.write(program);
+            }
+        }
+
+        // Woken earlier by sample timer notification
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(CONTROL_TASK_TICK_INTERVAL));
+    }
+}
@@ -0,0 +1,171 @@
+#pragma once
+
+#include <Arduino.h>
+
+#include "lib/misc/timer.h"
+
+#include "channel_scheduler.h"
+#include "config.h"
+#include "regulator.h"
+
+#include "misc/spsc_ring.h"
+#include "misc/triple_buffer.h"
+
+struct RegulatorCommand {
+    PidConfig pid{};
+    SmithPredictorConfig predictor{};
+    bool active = false;
+
+    bool autotune = false;
+    AutotuneConfig autotune_config{};
+
+    bool identification = false;
+    IdentificationConfig identification_config{};
+
+    bool program = false;
+    SetpointProgram program_config{};
+};
+
+/**
+ * Runs regulator channels in a dedicated high-priority task with its own timer, so network handling can't delay control output.
+ * Configuration and telemetry are exchanged with the application task through lock-free structures:
+ * the control task never waits for the network side and vice versa.
+ * Autotune, step test, setpoint programs, snapshots and sensor statistics are available for channel 0 only.
+ */
+class ControlTask {
+    static inline TaskHandle_t _task = nullptr;
+
+    Timer _timer;
+    ChannelScheduler _scheduler;
+    Regulator &_regulator; // Channel 0
+
+    TripleBuffer<RegulatorCommand> _commands[REGULATOR_MAX_CHANNELS]{};
+    SpscRing<TelemetrySample, TELEMETRY_RING_SIZE> _samples{};
+    TripleBuffer<SamplingStats> _sampling{};
+    TripleBuffer<AutotuneResult> _autotune{};
+    AutotuneState _autotune_state = AutotuneState::AUTOTUNE_IDLE;
+    TripleBuffer<IdentificationResult> _identification{};
+    IdentificationState _identification_state = IdentificationState::IDENT_IDLE;
+    TripleBuffer<ProgramStatus> _program{};
+    ProgramState _program_state = ProgramState::PROGRAM_IDLE;
+    TripleBuffer<RegulatorSnapshot> _snapshot{};
+    TripleBuffer<DSx18BusStats> _sensor_bus{};
+    uint32_t _sensor_bus_scans = 0;
+    TripleBuffer<AnalogNoiseStats> _sensor_noise{};
+    uint32_t _sensor_noise_windows = 0;
+    TripleBuffer<SensorGroupStats> _sensor_group{};
+    uint32_t _sensor_group_rounds = 0;
+    TripleBuffer<ChannelLoadStats> _channel_load{};
+    uint32_t _channel_load_windows = 0;
+
+public:
+    /**
+     * @param configs one per channel, channel 0 first; at most REGULATOR_MAX_CHANNELS
+     * @param enabled bit mask of channels to run, see `ChannelScheduler`
+     */
+    ControlTask(const std::vector<const RegulatorConfig *> &configs, uint32_t enabled);
+
+    [[nodiscard]] uint8_t channel_count() const { return _scheduler.count(); }
+
+    /**
+     * @return false if channel is disabled or conflicts with another one; valid after `begin`
+     */
+    [[nodiscard]] bool channel_running(uint8_t channel) const { return _scheduler.running(channel); }
+
+    /**
+     * Create sensors and controls, then start the task. Sensor and control configs are read only here.
+     */
+    void begin();
+
+    /**
+     * Pass new PID configuration to the control task. Called from application task.
+     * @param autotune run relay experiment with this config instead of PID; nullptr to stop it
+     * @param identification run step test with this config instead of PID; nullptr to stop it
+     * @param program drive PID target by this program, started when first passed; nullptr to stop it
+     */
+    void load(const PidConfig &pid_config, const SmithPredictorConfig &predictor, bool active,
+              const AutotuneConfig *autotune = nullptr, const IdentificationConfig *identification = nullptr,
+              const SetpointProgram *program = nullptr);
+
+    /**
+     * Pass new PID configuration of channel 1.. to the control task. Called from application task.
+     */
+    void load_channel(uint8_t channel, const PidConfig &pid_config, const SmithPredictorConfig &predictor, bool active);
+
+    /**
+     * Let sensors of all channels read ahead, see `SensorBase::prefetch`. Called from application task.
+     */
+    void prefetch_sensors();
+
+    /**
+     * Take the oldest sample of any channel not yet consumed. Called from application task.
+     * @return false if there are no pending samples
+     */
+    bool poll_sample(TelemetrySample &sample) { return _samples.pop(sample); }
+
+    /**
+     * Take latest sampling statistics. Called from application task.
+     * @return false if statistics weren't updated since previous call
+     */
+    bool poll_sampling(SamplingStats &stats);
+
+    /**
+     * Take latest autotune progress. Called from application task.
+     * @return false if nothing changed since previous call
+     */
+    bool poll_autotune(AutotuneResult &result);
+
+    /**
+     * Take latest step test progress. Called from application task.
+     * @return false if nothing changed since previous call
+     */
+    bool poll_identification(IdentificationResult &result);
+
+    /**
+     * Take latest setpoint program progress. Called from application task.
+     * @return false if nothing changed since previous call
+     */
+    bool poll_program(ProgramStatus &status);
+
+    /**
+     * Take regulator state captured after the latest applied `load`. Called from application task.
+     * Samples older than the snapshot may still be pending: compare `time_us` to order them.
+     * @return false if no configuration was applied since previous call
+     */
+    bool poll_snapshot(RegulatorSnapshot &snapshot);
+
+    /**
+     * Take latest statistics of DS18x20 bus. Called from application task.
+     * @return false if sensor is not on a bus or no read cycle finished since previous call
+     */
+    bool poll_sensor_bus(DSx18BusStats &stats);
+
+    /**
+     * Take latest noise statistics of analog sensor. Called from application task.
+     * @return false if sensor is not in continuous mode or no noise window finished since previous call
+     */
+    bool poll_sensor_noise(AnalogNoiseStats &stats);
+
+    /**
+     * Take latest voting statistics of redundant sensors. Called from application task.
+     * @return false if sensor is not a group or no value was fused since previous call
+     */
+    bool poll_sensor_group(SensorGroupStats &stats);
+
+    /**
+     * Take CPU load statistics of regulator channels. Called from application task.
+     * @return false if no measurement window finished since previous call
+     */
+    bool poll_channel_load(ChannelLoadStats &stats);
+
+    /**
+     * Samples discarded because application task didn't drain them in time.
+     */
+    [[nodiscard]] uint32_t dropped_samples() const { return _samples.dropped(); }
+
+private:
+    [[noreturn]] static void _task_fn(void *arg);
+    static void IRAM_ATTR _on_sample_tick();
+
+    [[noreturn]] void _loop();
+};
@@ -7,6 +7,9 @@ MAKE_ENUM_AUTO(AppState, uint8_t,
     INITIALIZATION,
     ACTIVE,
     INACTIVE,
+    AUTOTUNE,
+    IDENTIFICATION,
+    PROGRAM,
 );
 
 MAKE_ENUM_AUTO(ProportionalMode, uint8_t,
@@ -39,3 +42,47 @@ MAKE_ENUM_AUTO(DirectionMode, uint8_t,
     PID_FORWARD, // Direct control (default)
     PID_REVERSE  // Reverse control
 );
+
+// PID computation engine
+MAKE_ENUM(PidEngine, uint8_t,
+    PID_FLOAT, 0,      // uPID, soft-float on targets without FPU (default)
+    PID_FIXED, 1,      // Integer-only fixed-point, kernel specialized for current modes
+    PID_SPECIALIZED, 2 // Float, kernel specialized for current modes
+);
+
+// PID sampling trigger
+MAKE_ENUM(SamplingMode, uint8_t,
+    SAMPLING_POLLED, 0, // Service loop checks elapsed interval (default)
+    SAMPLING_TIMER, 1,  // Hardware timer interrupt
+    SAMPLING_EVENT, 2   // New sensor sample, as soon as it's measured; polled for sensors measuring on request
+);
+
+// Rule for gains proposed by autotune
+MAKE_ENUM(TuningRule, uint8_t,
+    TUNING_ZIEGLER_NICHOLS, 0, // Classic Ziegler–Nichols PID: fast, ~25% overshoot (default)
+    TUNING_TYREUS_LUYBEN, 1,   // Tyreus–Luyben PID: slower, little overshoot
+    TUNING_SIMC, 2             // Skogestad SIMC PI from FOPDT model
+);
+
+MAKE_ENUM_AUTO(AutotuneState, uint8_t,
+    AUTOTUNE_IDLE,
+    AUTOTUNE_RUNNING,
+    AUTOTUNE_DONE,
+    AUTOTUNE_FAILED
+);
+
+MAKE_ENUM_AUTO(IdentificationState, uint8_t,
+    IDENT_IDLE,
+    IDENT_BASELINE, // Holding initial output until sensor settles
+    IDENT_STEP,     // Holding step output, integrating response
+    IDENT_DONE,
+    IDENT_FAILED
+);
+
+MAKE_ENUM_AUTO(ProgramState, uint8_t,
+    PROGRAM_IDLE,
+    PROGRAM_RUNNING, // Program time advancing
+    PROGRAM_HOLD,    // Sensor outside hold band, program time stands
+    PROGRAM_DONE,    // Keeping final setpoint until stopped
+    PROGRAM_FAILED   // Program empty, invalid or too long
+);
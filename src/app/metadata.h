@@ -3,8 +3,13 @@
 #include <lib/base/metadata.h>
 #include <lib/utils/metadata.h>
 
+#include "app/channel_parameter.h"
 #include "app/config.h"
 #include "cmd.h"
+#include "misc/history_archive.h"
+#include "misc/sensor_log.h"
+#include "misc/history_codec.h"
+#include "misc/setpoint_program.h"
 
 DECLARE_META_TYPE(AppMetaProperty, PacketType)
 
@@ -34,12 +39,23 @@ DECLARE_META(PidConfigMeta, AppMetaProperty,
     MEMBER(Parameter<uint8_t>, i_limit),
     MEMBER(Parameter<uint8_t>, d_mode),
     MEMBER(Parameter<uint8_t>, direction),
+
+    MEMBER(Parameter<uint8_t>, engine),
+    MEMBER(Parameter<uint8_t>, sampling),
+)
+
+DECLARE_META(SmithPredictorConfigMeta, AppMetaProperty,
+    MEMBER(Parameter<bool>, enabled),
+    MEMBER(Parameter<float>, gain),
+    MEMBER(Parameter<float>, time_constant),
+    MEMBER(Parameter<float>, dead_time)
 )
 
 DECLARE_META(RegulatorConfigMeta, AppMetaProperty,
     SUB_TYPE(SensorConfigMeta, sensor),
     SUB_TYPE(ControlConfigMeta, control),
-    SUB_TYPE(PidConfigMeta, pid)
+    SUB_TYPE(PidConfigMeta, pid),
+    SUB_TYPE(SmithPredictorConfigMeta, predictor)
 )
 
 DECLARE_META(NightModeConfigMeta, AppMetaProperty,
@@ -48,13 +64,66 @@ DECLARE_META(NightModeConfigMeta, AppMetaProperty,
     MEMBER(Parameter<uint32_t>, end_time)
 )
 
+DECLARE_META(AutotuneConfigMeta, AppMetaProperty,
+    MEMBER(Parameter<uint8_t>, rule),
+    MEMBER(Parameter<float>, amplitude),
+    MEMBER(Parameter<float>, hysteresis),
+    MEMBER(Parameter<uint8_t>, cycles),
+    MEMBER(Parameter<uint16_t>, timeout)
+)
+
+DECLARE_META(IdentificationConfigMeta, AppMetaProperty,
+    MEMBER(Parameter<float>, output_from),
+    MEMBER(Parameter<float>, output_to),
+    MEMBER(Parameter<float>, settle_band),
+    MEMBER(Parameter<uint16_t>, settle_time),
+    MEMBER(Parameter<uint16_t>, timeout)
+)
+
+DECLARE_META(ChannelsConfigMeta, AppMetaProperty,
+    MEMBER(Parameter<uint8_t>, count),
+    MEMBER(Parameter<uint32_t>, enabled)
+)
+
+DECLARE_META(ProgramConfigMeta, AppMetaProperty,
+    MEMBER(Parameter<uint8_t>, slot)
+)
+
+// Values of channel 1.. published to MQTT
+DECLARE_META(ChannelDataMeta, AppMetaProperty,
+    MEMBER(Parameter<float>, sensor_value),
+    MEMBER(Parameter<float>, control_value)
+)
+
 DECLARE_META(DataConfigMeta, AppMetaProperty,
     MEMBER(ComplexParameter<Config>, config),
     MEMBER(ComplexParameter<RuntimeInfo>, state),
 
     MEMBER(Parameter<float>, sensor_value),
     MEMBER(Parameter<float>, control_value),
-    MEMBER(ComplexParameter<DataHistory>, history),
+    MEMBER(EncodedHistoryParameter, history),
+    MEMBER(ComplexParameter<HistoryAppend>, history_append),
+    MEMBER(Parameter<uint32_t>, archive_range),
+    MEMBER(ArchiveQueryParameter, archive),
+    MEMBER(ComplexParameter<SamplingStats>, sampling),
+    MEMBER(ComplexParameter<DSx18BusStats>, sensor_bus),
+    MEMBER(ComplexParameter<AnalogNoiseStats>, sensor_noise),
+    MEMBER(ComplexParameter<SensorGroupStats>, sensor_group),
+    MEMBER(ComplexParameter<ChannelsState>, channels),
+    MEMBER(ComplexParameter<ChannelHistories>, channel_history),
+    MEMBER(ChannelParameter, channel_parameter),
+    MEMBER(ComplexParameter<AutotuneResult>, autotune),
+    MEMBER(ComplexParameter<IdentificationResult>, identification),
+    MEMBER(Parameter<float>, model_gain),
+    MEMBER(Parameter<float>, model_time_constant),
+    MEMBER(Parameter<float>, model_dead_time),
+    MEMBER(SetpointProgramParameter, program),
+    MEMBER(ComplexParameter<ProgramStatus>, program_state),
+    MEMBER(Parameter<bool>, sensor_log_record),
+    MEMBER(Parameter<bool>, sensor_log_stream),
+    MEMBER(ComplexParameter<SensorLogState>, sensor_log),
+    MEMBER(SensorLogChunkParameter, sensor_log_data),
+    MEMBER(SensorLogChunkParameter, sensor_log_file),
 )
 
 DECLARE_META(SysConfigMeta, AppMetaProperty,
@@ -76,89 +145,134 @@ DECLARE_META(ConfigMetadata, AppMetaProperty,
     MEMBER(Parameter<bool>, power),
     SUB_TYPE(RegulatorConfigMeta, regulator),
     SUB_TYPE(NightModeConfigMeta, night_mode),
+    SUB_TYPE(AutotuneConfigMeta, autotune),
+    SUB_TYPE(IdentificationConfigMeta, identification),
+    SUB_TYPE(ChannelsConfigMeta, channels),
+    SUB_TYPE(ProgramConfigMeta, program),
     SUB_TYPE(SysConfigMeta, sys_config),
     SUB_TYPE(DataConfigMeta, data)
 )
 
-inline ConfigMetadata build_metadata(Config &config, RuntimeInfo &runtime_info) {
+inline RegulatorConfigMeta build_regulator_metadata(RegulatorConfig &config) {
+    return {
+        .sensor = {
+            .type = {
+                PacketType::SENSOR_TYPE,
+                &config.sensor.type
+            },
+        },
+        .control = {
+            .type = {
+                PacketType::CONTROL_TYPE,
+                &config.control.type
+            },
+        },
+        .pid = {
+            .target = {
+                PacketType::PID_TARGET,
+                &config.pid.target
+            },
+            .interval = {
+                PacketType::PID_INTERVAL,
+                &config.pid.interval
+            },
+            .p = {
+                PacketType::PID_P,
+                &config.pid.p
+            },
+            .i = {
+                PacketType::PID_I,
+                &config.pid.i
+            },
+            .d = {
+                PacketType::PID_D,
+                &config.pid.d
+            },
+            .k_mul = {
+                PacketType::PID_K_MUL,
+                &config.pid.k_mul
+            },
+            .kbc = {
+                PacketType::PID_KBC,
+                &config.pid.kbc
+            },
+            .out_max = {
+                PacketType::PID_OUT_MAX,
+                &config.pid.out_max
+            },
+            .out_min = {
+                PacketType::PID_OUT_MIN,
+                &config.pid.out_min
+            },
+            .p_mode = {
+                PacketType::PID_P_MODE,
+                (uint8_t *) &config.pid.p_mode
+            },
+            .i_mode = {
+                PacketType::PID_I_MODE,
+                (uint8_t *) &config.pid.i_mode
+            },
+            .i_limit = {
+                PacketType::PID_I_LIMIT,
+                (uint8_t *) &config.pid.i_limit
+            },
+            .d_mode = {
+                PacketType::PID_D_MODE,
+                (uint8_t *) &config.pid.d_mode
+            },
+            .direction = {
+                PacketType::PID_DIRECTION,
+                (uint8_t *) &config.pid.direction
+            },
+            .engine = {
+                PacketType::PID_ENGINE,
+                (uint8_t *) &config.pid.engine
+            },
+            .sampling = {
+                PacketType::PID_SAMPLING,
+                (uint8_t *) &config.pid.sampling
+            }
+        },
+        .predictor = {
+            .enabled = {
+                PacketType::PREDICTOR_ENABLED,
+                &config.predictor.enabled
+            },
+            .gain = {
+                PacketType::PREDICTOR_GAIN,
+                &config.predictor.model.gain
+            },
+            .time_constant = {
+                PacketType::PREDICTOR_TIME_CONSTANT,
+                &config.predictor.model.time_constant
+            },
+            .dead_time = {
+                PacketType::PREDICTOR_DEAD_TIME,
+                &config.predictor.model.dead_time
+            }
+        }
+    };
+}
+
+inline ChannelDataMeta build_channel_metadata(ChannelState &state) {
+    return {
+        .sensor_value = Parameter(&state.sensor_value),
+        .control_value = Parameter(&state.control_value),
+    };
+}
+
+inline ConfigMetadata build_metadata(Config &config, RuntimeInfo &runtime_info,
+                                     DataHistory &history, ArchiveQueryResult &archive,
+                                     const SensorLogChunk &sensor_log_stream, const SensorLogChunk &sensor_log_file,
+                                     ChannelHistories &channel_history, ChannelParameters &channel_parameters,
+                                     SetpointProgram &program) {
     return {
         .power = {
             PacketType::POWER,
             MQTT_TOPIC_POWER, MQTT_OUT_TOPIC_POWER,
             &config.power
         },
-        .regulator = {
-            .sensor = {
-                .type = {
-                    PacketType::SENSOR_TYPE,
-                    &config.regulator.sensor.type
-                },
-            },
-            .control = {
-                .type = {
-                    PacketType::CONTROL_TYPE,
-                    &config.regulator.control.type
-                },
-            },
-            .pid = {
-                .target = {
-                    PacketType::PID_TARGET,
-                    &config.regulator.pid.target
-                },
-                .interval = {
-                    PacketType::PID_INTERVAL,
-                    &config.regulator.pid.interval
-                },
-                .p = {
-                    PacketType::PID_P,
-                    &config.regulator.pid.p
-                },
-                .i = {
-                    PacketType::PID_I,
-                    &config.regulator.pid.i
-                },
-                .d = {
-                    PacketType::PID_D,
-                    &config.regulator.pid.d
-                },
-                .k_mul = {
-                    PacketType::PID_K_MUL,
-                    &config.regulator.pid.k_mul
-                },
-                .kbc = {
-                    PacketType::PID_KBC,
-                    &config.regulator.pid.kbc
-                },
-                .out_max = {
-                    PacketType::PID_OUT_MAX,
-                    &config.regulator.pid.out_max
-                },
-                .out_min = {
-                    PacketType::PID_OUT_MIN,
-                    &config.regulator.pid.out_min
-                },
-                .p_mode = {
-                    PacketType::PID_P_MODE,
-                    (uint8_t *) &config.regulator.pid.p_mode
-                },
-                .i_mode = {
-                    PacketType::PID_I_MODE,
-                    (uint8_t *) &config.regulator.pid.i_mode
-                },
-                .i_limit = {
-                    PacketType::PID_I_LIMIT,
-                    (uint8_t *) &config.regulator.pid.i_limit
-                },
-                .d_mode = {
-                    PacketType::PID_D_MODE,
-                    (uint8_t *) &config.regulator.pid.d_mode
-                },
-                .direction = {
-                    PacketType::PID_DIRECTION,
-                    (uint8_t *) &config.regulator.pid.direction
-                }
-            }
-        },
+        .regulator = build_regulator_metadata(config.regulator),
         .night_mode = {
             .enabled = {
                 PacketType::NIGHT_MODE_ENABLED,
@@ -174,6 +288,66 @@ inline ConfigMetadata build_metadata(Config &config, RuntimeInfo &runtime_info)
                 &config.night_mode.end_time
             }
         },
+        .autotune = {
+            .rule = {
+                PacketType::AUTOTUNE_RULE,
+                (uint8_t *) &config.autotune.rule
+            },
+            .amplitude = {
+                PacketType::AUTOTUNE_AMPLITUDE,
+                &config.autotune.amplitude
+            },
+            .hysteresis = {
+                PacketType::AUTOTUNE_HYSTERESIS,
+                &config.autotune.hysteresis
+            },
+            .cycles = {
+                PacketType::AUTOTUNE_CYCLES,
+                &config.autotune.cycles
+            },
+            .timeout = {
+                PacketType::AUTOTUNE_TIMEOUT,
+                &config.autotune.timeout
+            }
+        },
+        .identification = {
+            .output_from = {
+                PacketType::IDENT_OUTPUT_FROM,
+                &config.identification.output_from
+            },
+            .output_to = {
+                PacketType::IDENT_OUTPUT_TO,
+                &config.identification.output_to
+            },
+            .settle_band = {
+                PacketType::IDENT_SETTLE_BAND,
+                &config.identification.settle_band
+            },
+            .settle_time = {
+                PacketType::IDENT_SETTLE_TIME,
+                &config.identification.settle_time
+            },
+            .timeout = {
+                PacketType::IDENT_TIMEOUT,
+                &config.identification.timeout
+            }
+        },
+        .channels = {
+            .count = {
+                PacketType::CHANNEL_COUNT,
+                &config.channels.count
+            },
+            .enabled = {
+                PacketType::CHANNEL_ENABLED,
+                &config.channels.enabled
+            }
+        },
+        .program = {
+            .slot = {
+                PacketType::PROGRAM_SLOT,
+                &config.program.slot
+            }
+        },
         .sys_config = {
             .mdns_name = {
                 PacketType::SYS_CONFIG_MDNS_NAME,
@@ -230,7 +404,48 @@ inline ConfigMetadata build_metadata(Config &config, RuntimeInfo &runtime_info)
 
             .sensor_value = Parameter(&runtime_info.sensor_value),
             .control_value = Parameter(&runtime_info.control_value),
-            .history = ComplexParameter(&runtime_info.history),
+            .history = EncodedHistoryParameter(&history),
+            .history_append = ComplexParameter(&runtime_info.history_append),
+            .archive_range = {
+                PacketType::HISTORY_ARCHIVE_RANGE,
+                &runtime_info.archive_range
+            },
+            .archive = ArchiveQueryParameter(&archive),
+            .sampling = ComplexParameter(&runtime_info.sampling),
+            .sensor_bus = ComplexParameter(&runtime_info.sensor_bus),
+            .sensor_noise = ComplexParameter(&runtime_info.sensor_noise),
+            .sensor_group = ComplexParameter(&runtime_info.sensor_group),
+            .channels = ComplexParameter(&runtime_info.channels),
+            .channel_history = ComplexParameter(&channel_history),
+            .channel_parameter = {
+                PacketType::CHANNEL_PARAMETER,
+                &channel_parameters
+            },
+            .autotune = ComplexParameter(&runtime_info.autotune),
+            .identification = ComplexParameter(&runtime_info.identification),
+
+            // Read-only: reported, but not registered as writable parameters
+            .model_gain = Parameter(&runtime_info.identification.model.gain),
+            .model_time_constant = Parameter(&runtime_info.identification.model.time_constant),
+            .model_dead_time = Parameter(&runtime_info.identification.model.dead_time),
+
+            .program = {
+                PacketType::PROGRAM_DATA,
+                &program
+            },
+            .program_state = ComplexParameter(&runtime_info.program),
+
+            .sensor_log_record = {
+                PacketType::SENSOR_LOG_RECORD,
+                &runtime_info.sensor_log.record
+            },
+            .sensor_log_stream = {
+                PacketType::SENSOR_LOG_STREAM,
+                &runtime_info.sensor_log.stream
+            },
+            .sensor_log = ComplexParameter(&runtime_info.sensor_log),
+            .sensor_log_data = SensorLogChunkParameter(&sensor_log_stream),
+            .sensor_log_file = SensorLogChunkParameter(&sensor_log_file),
         }
     };
 }
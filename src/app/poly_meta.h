@@ -1,10 +1,18 @@
 #pragma once
 
+#include <memory>
+
 #include "app/metadata.h"
 
+#include "controls/cascade_control.h"
+#include "controls/ledc_control.h"
 #include "controls/pwm_control.h"
 #include "sensors/analog_sensor.h"
+#include "sensors/dsx18_bus.h"
 #include "sensors/dsx18_sensor.h"
+#include "sensors/filters.h"
+#include "sensors/replay_sensor.h"
+#include "sensors/sensor_group.h"
 
 class AbstractMetaHolder {
 public:
@@ -28,9 +36,21 @@ DECLARE_META(PwmControlConfigMeta, AppMetaProperty,
     MEMBER(Parameter<uint16_t>, period)
 )
 
+DECLARE_META(LedcControlConfigMeta, AppMetaProperty,
+    MEMBER(Parameter<uint8_t>, pin),
+    MEMBER(Parameter<uint8_t>, channel),
+    MEMBER(Parameter<uint32_t>, frequency),
+    MEMBER(Parameter<uint8_t>, resolution)
+)
+
+DECLARE_META(CascadeControlConfigMeta, AppMetaProperty,
+    MEMBER(Parameter<uint8_t>, channel)
+)
+
 DECLARE_META(AnalogSensorConfigMeta, AppMetaProperty,
     MEMBER(Parameter<uint8_t>, pin),
     MEMBER(Parameter<uint8_t>, resolution),
+    MEMBER(Parameter<bool>, continuous),
 )
 
 DECLARE_META(DSx18SensorConfigMeta, AppMetaProperty,
@@ -39,6 +59,42 @@ DECLARE_META(DSx18SensorConfigMeta, AppMetaProperty,
     MEMBER(Parameter<bool>, parasite)
 )
 
+DECLARE_META(DSx18BusSensorConfigMeta, AppMetaProperty,
+    MEMBER(Parameter<uint8_t>, pin),
+    MEMBER(Parameter<uint8_t>, resolution),
+    MEMBER(Parameter<bool>, parasite),
+    MEMBER(Parameter<uint8_t>, channel)
+)
+
+DECLARE_META(DSx18GroupSensorConfigMeta, AppMetaProperty,
+    MEMBER(Parameter<uint8_t>, pin),
+    MEMBER(Parameter<uint8_t>, resolution),
+    MEMBER(Parameter<bool>, parasite),
+    MEMBER(Parameter<uint8_t>, count),
+    MEMBER(Parameter<uint8_t>, voting),
+    MEMBER(Parameter<float>, min_value),
+    MEMBER(Parameter<float>, max_value),
+    MEMBER(Parameter<float>, max_rate),
+    MEMBER(Parameter<uint16_t>, stuck_time),
+    MEMBER(Parameter<uint16_t>, timeout)
+)
+
+DECLARE_META(ReplaySensorConfigMeta, AppMetaProperty,
+    MEMBER(Parameter<bool>, loop)
+)
+
+DECLARE_META(SensorFilterConfigMeta, AppMetaProperty,
+    MEMBER(Parameter<bool>, median),
+    MEMBER(Parameter<uint8_t>, median_window),
+    MEMBER(Parameter<bool>, ema),
+    MEMBER(Parameter<float>, ema_time_constant),
+    MEMBER(Parameter<bool>, kalman),
+    MEMBER(Parameter<float>, kalman_process_noise),
+    MEMBER(Parameter<float>, kalman_measurement_noise),
+    MEMBER(Parameter<bool>, slew),
+    MEMBER(Parameter<float>, slew_rate)
+)
+
 inline MetaHolder<PwmControlConfigMeta> build_pwm_control_metadata(PwmControlConfig &config) {
     return MetaHolder(PwmControlConfigMeta{
         .pin = {
@@ -52,6 +108,36 @@ inline MetaHolder<PwmControlConfigMeta> build_pwm_control_metadata(PwmControlCon
     });
 }
 
+inline MetaHolder<LedcControlConfigMeta> build_ledc_control_metadata(LedcControlConfig &config) {
+    return MetaHolder(LedcControlConfigMeta{
+        .pin = {
+            PacketType::LEDC_CONTROL_PIN,
+            &config.pin
+        },
+        .channel = {
+            PacketType::LEDC_CONTROL_CHANNEL,
+            &config.channel
+        },
+        .frequency = {
+            PacketType::LEDC_CONTROL_FREQUENCY,
+            &config.frequency
+        },
+        .resolution = {
+            PacketType::LEDC_CONTROL_RESOLUTION,
+            &config.resolution
+        }
+    });
+}
+
+inline MetaHolder<CascadeControlConfigMeta> build_cascade_control_metadata(CascadeControlConfig &config) {
+    return MetaHolder(CascadeControlConfigMeta{
+        .channel = {
+            PacketType::CASCADE_CONTROL_CHANNEL,
+            &config.channel
+        }
+    });
+}
+
 inline MetaHolder<AnalogSensorConfigMeta> build_analog_sensor_metadata(AnalogSensorConfig &config) {
     return MetaHolder(AnalogSensorConfigMeta{
         .pin = {
@@ -61,6 +147,10 @@ inline MetaHolder<AnalogSensorConfigMeta> build_analog_sensor_metadata(AnalogSen
         .resolution = {
             PacketType::ANALOG_SENSOR_RESOLUTION,
             &config.resolution
+        },
+        .continuous = {
+            PacketType::ANALOG_SENSOR_CONTINUOUS,
+            &config.continuous
         }
     });
 }
@@ -81,3 +171,159 @@ inline MetaHolder<DSx18SensorConfigMeta> build_dsx18_sensor_metadata(DSx18Sensor
         }
     });
 }
+
+inline MetaHolder<DSx18BusSensorConfigMeta> build_dsx18_bus_sensor_metadata(DSx18BusSensorConfig &config) {
+    return MetaHolder(DSx18BusSensorConfigMeta{
+        .pin = {
+            PacketType::DSX18_BUS_SENSOR_PIN,
+            &config.pin
+        },
+        .resolution = {
+            PacketType::DSX18_BUS_SENSOR_RESOLUTION,
+            &config.resolution
+        },
+        .parasite = {
+            PacketType::DSX18_BUS_SENSOR_PARASITE,
+            &config.parasite
+        },
+        .channel = {
+            PacketType::DSX18_BUS_SENSOR_CHANNEL,
+            &config.channel
+        }
+    });
+}
+
+inline MetaHolder<DSx18GroupSensorConfigMeta> build_dsx18_group_sensor_metadata(DSx18GroupSensorConfig &config) {
+    return MetaHolder(DSx18GroupSensorConfigMeta{
+        .pin = {
+            PacketType::DSX18_GROUP_SENSOR_PIN,
+            &config.pin
+        },
+        .resolution = {
+            PacketType::DSX18_GROUP_SENSOR_RESOLUTION,
+            &config.resolution
+        },
+        .parasite = {
+            PacketType::DSX18_GROUP_SENSOR_PARASITE,
+            &config.parasite
+        },
+        .count = {
+            PacketType::DSX18_GROUP_SENSOR_COUNT,
+            &config.count
+        },
+        .voting = {
+            PacketType::DSX18_GROUP_SENSOR_VOTING,
+            (uint8_t *) &config.group.voting
+        },
+        .min_value = {
+            PacketType::DSX18_GROUP_SENSOR_MIN_VALUE,
+            &config.group.min_value
+        },
+        .max_value = {
+            PacketType::DSX18_GROUP_SENSOR_MAX_VALUE,
+            &config.group.max_value
+        },
+        .max_rate = {
+            PacketType::DSX18_GROUP_SENSOR_MAX_RATE,
+            &config.group.max_rate
+        },
+        .stuck_time = {
+            PacketType::DSX18_GROUP_SENSOR_STUCK_TIME,
+            &config.group.stuck_time
+        },
+        .timeout = {
+            PacketType::DSX18_GROUP_SENSOR_TIMEOUT,
+            &config.group.timeout
+        }
+    });
+}
+
+inline MetaHolder<ReplaySensorConfigMeta> build_replay_sensor_metadata(ReplaySensorConfig &config) {
+    return MetaHolder(ReplaySensorConfigMeta{
+        .loop = {
+            PacketType::REPLAY_SENSOR_LOOP,
+            &config.loop
+        }
+    });
+}
+
+inline MetaHolder<SensorFilterConfigMeta> build_sensor_filter_metadata(SensorFilterConfig &config) {
+    return MetaHolder(SensorFilterConfigMeta{
+        .median = {
+            PacketType::SENSOR_FILTER_MEDIAN,
+            &config.median
+        },
+        .median_window = {
+            PacketType::SENSOR_FILTER_MEDIAN_WINDOW,
+            &config.median_window
+        },
+        .ema = {
+            PacketType::SENSOR_FILTER_EMA,
+            &config.ema
+        },
+        .ema_time_constant = {
+            PacketType::SENSOR_FILTER_EMA_TIME_CONSTANT,
+            &config.ema_time_constant
+        },
+        .kalman = {
+            PacketType::SENSOR_FILTER_KALMAN,
+            &config.kalman
+        },
+        .kalman_process_noise = {
+            PacketType::SENSOR_FILTER_KALMAN_PROCESS_NOISE,
+            &config.kalman_process_noise
+        },
+        .kalman_measurement_noise = {
+            PacketType::SENSOR_FILTER_KALMAN_MEASUREMENT_NOISE,
+            &config.kalman_measurement_noise
+        },
+        .slew = {
+            PacketType::SENSOR_FILTER_SLEW,
+            &config.slew
+        },
+        .slew_rate = {
+            PacketType::SENSOR_FILTER_SLEW_RATE,
+            &config.slew_rate
+        }
+    });
+}
+
+inline std::unique_ptr<AbstractMetaHolder> make_sensor_metadata(SensorConfig &config) {
+    if (config.type == SensorType::DSX18X) {
+        return std::make_unique<MetaHolder<DSx18SensorConfigMeta>>(
+            build_dsx18_sensor_metadata(*(DSx18SensorConfig *) config.data)
+        );
+    } else if (config.type == SensorType::DSX18X_BUS) {
+        return std::make_unique<MetaHolder<DSx18BusSensorConfigMeta>>(
+            build_dsx18_bus_sensor_metadata(*(DSx18BusSensorConfig *) config.data)
+        );
+    } else if (config.type == SensorType::DSX18X_GROUP) {
+        return std::make_unique<MetaHolder<DSx18GroupSensorConfigMeta>>(
+            build_dsx18_group_sensor_metadata(*(DSx18GroupSensorConfig *) config.data)
+        );
+    } else if (config.type == SensorType::REPLAY) {
+        return std::make_unique<MetaHolder<ReplaySensorConfigMeta>>(
+            build_replay_sensor_metadata(*(ReplaySensorConfig *) config.data)
+        );
+    } else {
+        return std::make_unique<MetaHolder<AnalogSensorConfigMeta>>(
+            build_analog_sensor_metadata(*(AnalogSensorConfig *) config.data)
+        );
+    }
+}
+
+inline std::unique_ptr<AbstractMetaHolder> make_control_metadata(ControlConfig &config) {
+    if (config.type == ControlType::LEDC_PWM) {
+        return std::make_unique<MetaHolder<LedcControlConfigMeta>>(
+            build_ledc_control_metadata(*(LedcControlConfig *) config.data)
+        );
+    } else if (config.type == ControlType::CASCADE) {
+        return std::make_unique<MetaHolder<CascadeControlConfigMeta>>(
+            build_cascade_control_metadata(*(CascadeControlConfig *) config.data)
+        );
+    } else {
+        return std::make_unique<MetaHolder<PwmControlConfigMeta>>(
+            build_pwm_control_metadata(*(PwmControlConfig *) config.data)
+        );
+    }
+}
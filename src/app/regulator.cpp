@@ -0,0 +1,356 @@
+#include "regulator.h"
+
+#include "lib/debug.h"
+
+#include "misc/sample_timer.h"
+
+#include "controls/cascade_control.h"
+#include "controls/ledc_control.h"
+#include "controls/pwm_control.h"
+#include "pid/benchmark.h"
+#include "pid/factory.h"
+#include "sensors/analog_sensor.h"
+#include "sensors/dsx18_bus.h"
+#include "sensors/dsx18_sensor.h"
+#include "sensors/filters.h"
+#include "sensors/replay_sensor.h"
+#include "sensors/sensor_group.h"
+
+Regulator::Regulator(Timer &timer, const RegulatorConfig &config, uint8_t channel) :
+    _timer(timer), _config(config), _channel(channel), _pid_config(config.pid) {}
+
+void Regulator::begin() {
+    if (_config.sensor.type == SensorType::DSX18X) {
+        _sensor = std::make_unique<DSx18Sensor>(_timer, _config.sensor.data);
+    } else if (_config.sensor.type == SensorType::DSX18X_BUS) {
+        _sensor = std::make_unique<DSx18BusSensor>(_timer, _config.sensor.data);
+    } else if (_config.sensor.type == SensorType::DSX18X_GROUP) {
+        _sensor = std::make_unique<DSx18GroupSensor>(_timer, _config.sensor.data);
+    } else if (_config.sensor.type == SensorType::REPLAY) {
+        _sensor = std::make_unique<ReplaySensor>(_timer, _config.sensor.data);
+    } else {
+        _sensor = std::make_unique<AnalogSensor>(_timer, _config.sensor.data);
+    }
+
+    _source = _sensor.get();
+    _sensor = make_filtered_sensor(std::move(_sensor), _config.filter);
+
+    _sensor->set_sample_callback([this](const SensorSample &sample) {
+        _pushed_sample = sample;
+        _sample_pending = true;
+    });
+
+    _sensor->begin();
+
+    if (_config.control.type == ControlType::LEDC_PWM) {
+        _control = std::make_unique<LedcControl>(_timer, _config.control.data);
+    } else if (_config.control.type == ControlType::CASCADE) {
+        _control = std::make_unique<CascadeControl>(_timer, _config.control.data);
+    } else {
+        _control = std::make_unique<PwmControl>(_timer, _config.control.data);
+    }
+
+    _control->begin();
+
+    _create_pid();
+
+#ifdef DEBUG
+    if (_channel == 0) _print_pid_benchmark();
+#endif
+}
+
+void Regulator::load(const PidConfig &pid_config, bool active) {
+    _pid_config = pid_config;
+    if (!_pid || _pid_engine != _pid_config.engine) _create_pid();
+
+    _active = active;
+    if (!active) _pid->reset();
+
+    // Configured target is replaced by the program one until the program is stopped
+    if (_program.active()) _pid_config.target = _program.setpoint();
+
+    _configure_pid();
+    _setup_sampling();
+
+    // Model is discretized with the PID interval
+    _predictor.configure(_predictor.config(), _pid_config.interval);
+}
+
+void Regulator::set_target(float target) {
+    if (target == _pid_config.target) return;
+
+    _pid_config.target = target;
+    _pid->set_target(target);
+}
+
+void Regulator::set_predictor(const SmithPredictorConfig &config) {
+    _predictor.configure(config, _pid_config.interval);
+}
+
+void Regulator::hold_output(bool high, bool low) {
+    if (high == _hold_high && low == _hold_low) return;
+
+    _hold_high = high;
+    _hold_low = low;
+    _configure_pid();
+}
+
+void Regulator::_configure_pid() {
+    _feed_forward = 0;
+
+    if (!_hold_high && !_hold_low) {
+        _out_min = _pid_config.out_min;
+        _out_max = _pid_config.out_max;
+        _pid->configure(_pid_config);
+        return;
+    }
+
+    // Before the first compute the last output is NAN and limits stay as configured
+    auto config = _pid_config;
+    const float last = _telemetry.control_value;
+    if (_hold_high) config.out_max = std::max(config.out_min, std::min(config.out_max, last));
+    if (_hold_low) config.out_min = std::min(config.out_max, std::max(config.out_min, last));
+
+    config.i_limit = (IntegralLimitMode) ((uint8_t) config.i_limit | (uint8_t) IntegralLimitMode::I_SATURATE);
+    _out_min = config.out_min;
+    _out_max = config.out_max;
+    _pid->configure(config);
+}
+
+void Regulator::set_autotune(bool enabled, const AutotuneConfig &config) {
+    if (enabled == _autotune_requested) return;
+    _autotune_requested = enabled;
+
+    if (enabled) {
+        _pid->reset();
+        _autotune.begin(config, _pid_config, millis());
+    } else {
+        _autotune.stop();
+    }
+}
+
+void Regulator::set_identification(bool enabled, const IdentificationConfig &config) {
+    if (enabled == _identification_requested) return;
+    _identification_requested = enabled;
+
+    if (enabled) {
+        _pid->reset();
+        _identification.begin(config, millis());
+    } else {
+        _identification.stop();
+    }
+}
+
+void Regulator::set_program(bool enabled, const SetpointProgram &program) {
+    if (enabled == _program_requested) return;
+    _program_requested = enabled;
+
+    if (enabled) {
+        _program.begin(program, _telemetry.sensor_value, millis());
+    } else {
+        _program.stop();
+    }
+}
+
+bool Regulator::update() {
+    uint32_t latency = 0, missed = 0;
+    if (!_sample_due(latency, missed)) return false;
+
+    SensorSample sample;
+    if (!_take_sample(sample)) {
+        D_PRINT("Sensor is not ready!");
+        return false;
+    }
+
+    const auto value = sample.value;
+
+    // Feed actual elapsed time since previous sample to PID instead of nominal interval.
+    // Event-triggered samples are spaced by measurement time, others by compute time
+    const auto now_us = _sampling_mode == SamplingMode::SAMPLING_EVENT ? sample.time_us : (uint32_t) micros();
+    const uint32_t nominal = _pid_config.interval * 1000u;
+
+    // Sample measured at or before the previous one has no period to integrate over
+    if (_has_last_sample && (int32_t) (now_us - _last_sample_time) <= 0) return false;
+
+    auto dt_scale = PID_DT_NOMINAL;
+    if (_has_last_sample && nominal > 0) {
+        const uint32_t period = now_us - _last_sample_time;
+        _jitter.add(period, nominal, latency, missed);
+
+        dt_scale = pid_dt_scale(period, _pid_config.interval);
+    }
+
+    _has_last_sample = true;
+    _last_sample_time = now_us;
+
+    float out = 0;
+    bool pid = false;
+    if (_autotune.running()) {
+        out = _autotune.update(millis(), value);
+    } else if (_identification.running()) {
+        out = _identification.update(millis(), value);
+    } else if (_active) {
+        if (_program.active()) {
+            _program.update(millis(), value);
+            set_target(_program.setpoint());
+        }
+
+        // PID limits are shifted by the feed-forward, so anti-windup sees the limits of the sum
+        // Feed-forward scaled by a placeholder model would be arbitrary
+        const auto &predictor = _predictor.config();
+        const float feed_forward = predictor.model_valid ? _program.feed_forward(predictor.model) : 0;
+        if (feed_forward != _feed_forward) {
+            _feed_forward = feed_forward;
+            _pid->set_output_limits(_out_min - feed_forward, _out_max - feed_forward);
+        }
+
+        out = _pid->compute(_predictor.feedback(value), dt_scale);
+        pid = true;
+
+        if (feed_forward != 0) out = std::clamp(out + feed_forward, _out_min, _out_max);
+    }
+
+    // Model follows whatever drives the process, so it's in place when PID takes over from autotune or step test
+    _predictor.update(out);
+
+    _control->set_value(out);
+    _jitter.add_sensor_latency((uint32_t) micros() - sample.time_us);
+
+    _telemetry = {
+        .timestamp = (uint32_t) millis(),
+        .time_us = now_us,
+        .sensor_value = value,
+        .control_value = out,
+        .integral = _pid->integral(),
+        .active = _active || _autotune.running() || _identification.running(),
+        .pid = pid,
+        .channel = _channel
+    };
+
+    D_PRINTF("Channel %u: Sensor: %f; Control: %f\r\n", _channel, value, out);
+    return true;
+}
+
+// Configured sensor type may have changed since the sensor was built, so ask the sensor itself
+const DSx18BusStats *Regulator::sensor_bus() const {
+    return _source->bus_stats();
+}
+
+const AnalogNoiseStats *Regulator::sensor_noise() const {
+    return _source->noise_stats();
+}
+
+const SensorGroupStats *Regulator::sensor_group() const {
+    return _source->group_stats();
+}
+
+RegulatorSnapshot Regulator::snapshot() const {
+    RegulatorSnapshot result;
+    result.time_us = micros();
+    result.pid = _pid_config;
+    result.active = _active;
+    result.has_last_sample = _has_last_sample;
+    result.last_sample_time = _last_sample_time;
+    result.pid_state_size = (uint8_t) _pid->save_state(result.pid_state);
+
+    return result;
+}
+
+void Regulator::_setup_sampling() {
+    const auto &pid_cfg = _pid_config;
+
+    // There is a single hardware sample timer, other channels are polled
+    auto mode = pid_cfg.sampling;
+    if (mode == SamplingMode::SAMPLING_TIMER && _channel != 0) mode = SamplingMode::SAMPLING_POLLED;
+
+    if (mode == _sampling_mode && pid_cfg.interval == _sampling_interval && _phase == _sampling_phase) return;
+
+    _sampling_mode = mode;
+    _sampling_interval = pid_cfg.interval;
+    _sampling_phase = _phase;
+
+    if (_channel == 0) {
+        if (_sampling_mode == SamplingMode::SAMPLING_TIMER) {
+            SampleTimer::begin(_sampling_interval);
+        } else {
+            SampleTimer::end();
+        }
+    }
+
+    // Next polled sample is taken at the next instant of the phase grid
+    if (_sampling_interval > 0) {
+        _last_compute = _grid_instant(millis(), _sampling_interval);
+    }
+
+    _sensor->set_event_driven(_sampling_mode == SamplingMode::SAMPLING_EVENT);
+
+    _jitter.reset();
+    _has_last_sample = false;
+}
+
+uint32_t Regulator::_grid_instant(uint32_t now, uint16_t interval) const {
+    // Not `(now - _phase) % interval`: it's wrong while `now < _phase`, since 2^32 isn't a multiple of interval
+    const uint32_t offset = (now % interval + interval - _phase % interval) % interval;
+    return now - offset;
+}
+
+bool Regulator::_sample_due(uint32_t &latency, uint32_t &missed) {
+    if (_sampling_mode == SamplingMode::SAMPLING_EVENT && !_sensor->on_demand()) {
+        if (!_sample_pending) return false;
+
+        latency = micros() - _pushed_sample.time_us;
+        return true;
+    }
+
+    if (_sampling_mode == SamplingMode::SAMPLING_TIMER) {
+        uint32_t tick_time;
+        if (!SampleTimer::take(tick_time, missed)) return false;
+
+        latency = micros() - tick_time;
+        return true;
+    }
+
+    const uint32_t now = millis(); // Grid instants may be "before" zero, compare in 32 bits as on the device
+    if (now - _last_compute < _pid_config.interval) return false;
+
+    // Instants stay on the phase grid: a late iteration delays one sample, not the following ones
+    _last_compute = _pid_config.interval > 0 ? _grid_instant(now, _pid_config.interval) : now;
+    return true;
+}
+
+bool Regulator::_take_sample(SensorSample &sample) {
+    if (_sensor->on_demand()) {
+        sample = _sensor->sample();
+    } else {
+        // Each pushed sample is used once: PID faster than sensor skips ticks instead of repeating a value
+        if (!_sample_pending) return false;
+
+        sample = _pushed_sample;
+        _sample_pending = false;
+    }
+
+    return sample.quality == SampleQuality::SAMPLE_GOOD;
+}
+
+void Regulator::_create_pid() {
+    _pid_engine = _pid_config.engine;
+    _pid = make_pid(_pid_engine);
+
+    D_PRINTF("PID engine: %s\r\n", __debug_enum_str(_pid_engine));
+}
+
+void Regulator::_print_pid_benchmark() {
+    FloatPid float_pid;
+    FixedPid<> fixed_pid;
+    SpecializedPid specialized_pid;
+
+    const auto float_result = pid_benchmark_rounds(float_pid, _config.pid, PID_BENCHMARK_ITERATIONS, PID_BENCHMARK_ROUNDS);
+    const auto fixed_result = pid_benchmark_rounds(fixed_pid, _config.pid, PID_BENCHMARK_ITERATIONS, PID_BENCHMARK_ROUNDS);
+    const auto specialized_result = pid_benchmark_rounds(specialized_pid, _config.pid, PID_BENCHMARK_ITERATIONS,
+                                                         PID_BENCHMARK_ROUNDS);
+
+    D_PRINTF("PID benchmark (%s @ %lu MHz, %u rounds): float %.1f ±%.1f, fixed %.1f ±%.1f, specialized %.1f ±%.1f cycles/tick\r\n",
+             ESP.getChipModel(), (unsigned long) ESP.getCpuFreqMHz(), PID_BENCHMARK_ROUNDS,
+             float_result.mean(), float_result.stddev(), fixed_result.mean(), fixed_result.stddev(),
+             specialized_result.mean(), specialized_result.stddev());
+}
@@ -0,0 +1,203 @@
+#pragma once
+
+#include <memory>
+
+#include "lib/misc/timer.h"
+
+#include "config.h"
+
+#include "controls/base.h"
+#include "misc/jitter_stats.h"
+#include "misc/setpoint_program.h"
+#include "pid/base.h"
+#include "pid/relay_autotune.h"
+#include "pid/smith_predictor.h"
+#include "pid/step_identification.h"
+#include "sensors/base.h"
+#include "sensors/dsx18_bus.h"
+#include "sensors/sensor_group.h"
+
+struct TelemetrySample {
+    uint32_t timestamp = 0; // millis() of the sample
+    uint32_t time_us = 0;   // micros() of the sample, PID period is measured from it
+
+    float sensor_value = NAN;
+    float control_value = NAN;
+    float integral = NAN;
+
+    bool active = false;    // PID was running, otherwise control is forced to zero
+    bool pid = false;       // Control was computed by PID, not by autotune or step test
+
+    uint8_t channel = 0;    // Regulator channel which produced the sample
+};
+
+/**
+ * Regulator state between two samples: with it and the sensor values that followed,
+ * PID output can be recomputed bit-exactly (see `misc/sensor_log.h`).
+ */
+struct __attribute ((packed)) RegulatorSnapshot {
+    uint32_t time_us = 0; // micros() when taken, following samples are newer
+
+    PidConfig pid{};
+    bool active = false;
+
+    bool has_last_sample = false;
+    uint32_t last_sample_time = 0; // micros() of previous sample, first period is measured from it
+
+    uint8_t pid_state_size = 0;
+    uint8_t pid_state[PID_STATE_MAX_SIZE]{};
+};
+
+/**
+ * Sensor, PID and control of a single loop.
+ * Not thread-safe: after `begin` all methods must be called from the same task.
+ */
+class Regulator {
+    Timer &_timer;
+    const RegulatorConfig &_config;
+    uint8_t _channel;
+
+    PidConfig _pid_config{};
+    TelemetrySample _telemetry{};
+
+    std::unique_ptr<SensorBase> _sensor = nullptr; // Wrapped in filters
+    SensorBase *_source = nullptr;                 // Unfiltered sensor, for type-specific statistics and prefetch
+    std::unique_ptr<ControlBase> _control = nullptr;
+    std::unique_ptr<PidBase> _pid = nullptr;
+    PidEngine _pid_engine = PidEngine::PID_FLOAT;
+    SmithPredictor _predictor{};
+
+    bool _active = false;
+    uint32_t _last_compute = 0;
+
+    bool _hold_high = false; // Output may not rise above the last one, see `hold_output`
+    bool _hold_low = false;
+
+    RelayAutotune _autotune{};
+    bool _autotune_requested = false;
+
+    StepIdentification _identification{};
+    bool _identification_requested = false;
+
+    ProgramRunner _program{};
+    bool _program_requested = false;
+
+    float _out_min = 0;       // Output limits applied by `_configure_pid`, hold included
+    float _out_max = 0;
+    float _feed_forward = 0;  // Program feed-forward the PID limits are currently shifted by
+
+    SamplingMode _sampling_mode = SamplingMode::SAMPLING_POLLED;
+    uint16_t _sampling_interval = 0;
+    uint16_t _phase = 0;
+    uint16_t _sampling_phase = 0;
+
+    JitterStats _jitter{};
+    bool _has_last_sample = false;
+    uint32_t _last_sample_time = 0;
+
+    SensorSample _pushed_sample{};
+    bool _sample_pending = false; // Pushed sample is not consumed yet
+
+public:
+    /**
+     * @param channel index among regulators sharing the timer; only channel 0 may use the hardware sample timer
+     */
+    Regulator(Timer &timer, const RegulatorConfig &config, uint8_t channel = 0);
+
+    [[nodiscard]] const SensorBase &sensor() const { return *_sensor; }
+    [[nodiscard]] const ControlBase &control() const { return *_control; }
+    [[nodiscard]] const TelemetrySample &telemetry() const { return _telemetry; }
+    [[nodiscard]] const PidConfig &pid_config() const { return _pid_config; }
+    [[nodiscard]] const SamplingStats &sampling() const { return _jitter.stats(); }
+    [[nodiscard]] const SmithPredictor &predictor() const { return _predictor; }
+    [[nodiscard]] const AutotuneResult &autotune() const { return _autotune.result(); }
+    [[nodiscard]] const IdentificationResult &identification() const { return _identification.result(); }
+    [[nodiscard]] const ProgramStatus &program() const { return _program.status(); }
+
+    /**
+     * Let sensor read ahead outside of the control task, see `SensorBase::prefetch`. Called from application task.
+     */
+    void prefetch_sensor() { _source->prefetch(); }
+
+    /**
+     * @return statistics of DS18x20 bus the sensor is attached to; nullptr for other sensor types
+     */
+    [[nodiscard]] const DSx18BusStats *sensor_bus() const;
+
+    /**
+     * @return noise statistics of analog sensor in continuous mode; nullptr otherwise
+     */
+    [[nodiscard]] const AnalogNoiseStats *sensor_noise() const;
+
+    /**
+     * @return voting and fault statistics of redundant sensors; nullptr for other sensor types
+     */
+    [[nodiscard]] const SensorGroupStats *sensor_group() const;
+
+    /**
+     * Capture state to continue from, taken after `load` and before the next `update`.
+     */
+    [[nodiscard]] RegulatorSnapshot snapshot() const;
+
+    /**
+     * Create sensor and control from config. Sensor and control configs are read only here.
+     */
+    void begin();
+    void load(const PidConfig &pid_config, bool active);
+
+    /**
+     * Offset of polled sample instants from multiples of PID interval, ms.
+     * Applied when sampling is configured by `load`, so regulators can spread their computes.
+     */
+    void set_phase(uint16_t phase) { _phase = phase; }
+
+    /**
+     * Change setpoint only, keeping PID state and measured sampling period, e.g. when it's the output of an outer loop.
+     */
+    void set_target(float target);
+
+    /**
+     * Correct PID feedback with dead-time model, see `SmithPredictor`. Model state is reset when config changes.
+     */
+    void set_predictor(const SmithPredictorConfig &config);
+
+    /**
+     * Keep output from moving further up (`high`) or down (`low`) from the last computed one, while the loop it drives
+     * is saturated in that direction. Output limits are narrowed and integral is frozen against them (I_SATURATE).
+     */
+    void hold_output(bool high, bool low);
+
+    /**
+     * Start relay experiment when `enabled` becomes set, stop it when cleared.
+     * While experiment is running it drives control output instead of PID.
+     */
+    void set_autotune(bool enabled, const AutotuneConfig &config);
+
+    /**
+     * Start open-loop step test when `enabled` becomes set, stop it when cleared.
+     * While test is running it drives control output instead of PID.
+     */
+    void set_identification(bool enabled, const IdentificationConfig &config);
+
+    /**
+     * Start setpoint program from the current sensor value when `enabled` becomes set, stop it when cleared.
+     * While program is active it sets PID target every compute and adds model feed-forward to the output,
+     * using the Smith predictor model whether or not the predictor is enabled. Configured target is restored by `load`.
+     */
+    void set_program(bool enabled, const SetpointProgram &program);
+
+    /**
+     * Run regulator iteration if PID interval elapsed, or in event sampling mode if sensor pushed a new sample.
+     * @return true if new value was computed
+     */
+    bool update();
+
+private:
+    void _create_pid();
+    void _configure_pid();
+    void _setup_sampling();
+    bool _sample_due(uint32_t &latency, uint32_t &missed);
+    [[nodiscard]] uint32_t _grid_instant(uint32_t now, uint16_t interval) const; // Latest `phase + k * interval` not after `now`
+    bool _take_sample(SensorSample &sample);
+    void _print_pid_benchmark();
+};
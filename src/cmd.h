@@ -8,17 +8,57 @@ MAKE_ENUM(PacketType, uint8_t,
     SENSOR_VALUE, 0x10,
     CONTROL_VALUE, 0x11,
     HISTORY_DATA, 0x12,
+    SAMPLING_STATS, 0x13,
+    HISTORY_APPEND, 0x14,
+    HISTORY_ARCHIVE_RANGE, 0x15,
+    HISTORY_ARCHIVE, 0x16,
+
+    SENSOR_LOG_RECORD, 0x17,
+    SENSOR_LOG_STREAM, 0x18,
+    SENSOR_LOG_STATE, 0x19,
+    SENSOR_LOG_DATA, 0x1A,
+    SENSOR_LOG_FILE, 0x1B,
+    SENSOR_LOG_FETCH, 0x1C,
+    SENSOR_LOG_FETCH_NEXT, 0x1D,
+
+    SENSOR_BUS_STATS, 0x1E,
+    SENSOR_NOISE_STATS, 0x1F,
 
     NIGHT_MODE_ENABLED, 0x20,
     NIGHT_MODE_START, 0x21,
     NIGHT_MODE_END, 0x22,
 
+    SENSOR_GROUP_STATS, 0x23,
+
+    CHANNEL_COUNT, 0x24,
+    CHANNEL_PARAMETER, 0x25,
+    CHANNEL_STATE, 0x26,
+    CHANNEL_HISTORY, 0x27,
+
+    PROGRAM_SLOT, 0x28,
+    PROGRAM_DATA, 0x29,
+    PROGRAM_START, 0x2A,
+    PROGRAM_STOP, 0x2B,
+    PROGRAM_STATE, 0x2C,
+
+    CHANNEL_ENABLED, 0x2D,
+
     SENSOR_TYPE, 0x30,
     SENSOR_DATA, 0x31,
 
     CONTROL_TYPE, 0x32,
     CONTROL_DATA, 0x33,
 
+    SENSOR_FILTER_MEDIAN, 0x34,
+    SENSOR_FILTER_MEDIAN_WINDOW, 0x35,
+    SENSOR_FILTER_EMA, 0x36,
+    SENSOR_FILTER_EMA_TIME_CONSTANT, 0x37,
+    SENSOR_FILTER_KALMAN, 0x38,
+    SENSOR_FILTER_KALMAN_PROCESS_NOISE, 0x39,
+    SENSOR_FILTER_KALMAN_MEASUREMENT_NOISE, 0x3A,
+    SENSOR_FILTER_SLEW, 0x3B,
+    SENSOR_FILTER_SLEW_RATE, 0x3C,
+
     PID_TARGET, 0x40,
     PID_P, 0x41,
     PID_I, 0x42,
@@ -34,6 +74,23 @@ MAKE_ENUM(PacketType, uint8_t,
     PID_D_MODE, 0x4C,
     PID_DIRECTION, 0x4D,
     PID_K_MUL, 0x4E,
+    PID_ENGINE, 0x4F,
+    PID_SAMPLING, 0x50,
+
+    PREDICTOR_ENABLED, 0x51,
+    PREDICTOR_GAIN, 0x52,
+    PREDICTOR_TIME_CONSTANT, 0x53,
+    PREDICTOR_DEAD_TIME, 0x54,
+
+    AUTOTUNE_START, 0x57,
+    AUTOTUNE_STOP, 0x58,
+    AUTOTUNE_APPLY, 0x59,
+    AUTOTUNE_RESULT, 0x5A,
+    AUTOTUNE_RULE, 0x5B,
+    AUTOTUNE_AMPLITUDE, 0x5C,
+    AUTOTUNE_HYSTERESIS, 0x5D,
+    AUTOTUNE_CYCLES, 0x5E,
+    AUTOTUNE_TIMEOUT, 0x5F,
 
     SYS_CONFIG_MDNS_NAME, 0x60,
 
@@ -61,6 +118,19 @@ MAKE_ENUM(PacketType, uint8_t,
     SYS_CONFIG_ENDSTOP_PIN, 0x81,
     SYS_CONFIG_ENDSTOP_HIGH_STATE, 0x82,
 
+    IDENT_START, 0x90,
+    IDENT_STOP, 0x91,
+    IDENT_APPLY, 0x92,
+    IDENT_RESULT, 0x93,
+    IDENT_OUTPUT_FROM, 0x94,
+    IDENT_OUTPUT_TO, 0x95,
+    IDENT_SETTLE_BAND, 0x96,
+    IDENT_SETTLE_TIME, 0x97,
+    IDENT_TIMEOUT, 0x98,
+    IDENT_MODEL_GAIN, 0x99,
+    IDENT_MODEL_TIME_CONSTANT, 0x9A,
+    IDENT_MODEL_DEAD_TIME, 0x9B,
+
     GET_CONFIG, 0xa0,
     GET_STATE, 0xa1,
     RESTART, 0xb0,
@@ -70,6 +140,13 @@ MAKE_ENUM(PacketType, uint8_t,
     PWM_CONTROL_PIN, 0xc0,
     PWM_CONTROL_PERIOD, 0xc1,
 
+    LEDC_CONTROL_PIN, 0xc2,
+    LEDC_CONTROL_CHANNEL, 0xc3,
+    LEDC_CONTROL_FREQUENCY, 0xc4,
+    LEDC_CONTROL_RESOLUTION, 0xc5,
+
+    CASCADE_CONTROL_CHANNEL, 0xc6,
+
     // Sensors
 
     ANALOG_SENSOR_PIN, 0xe0,
@@ -78,4 +155,24 @@ MAKE_ENUM(PacketType, uint8_t,
     DSX18_SENSOR_PIN, 0xe2,
     DSX18_SENSOR_RESOLUTION, 0xe3,
     DSX18_SENSOR_PARASITE, 0xe4,
+
+    REPLAY_SENSOR_LOOP, 0xe5,
+
+    DSX18_BUS_SENSOR_PIN, 0xe6,
+    DSX18_BUS_SENSOR_RESOLUTION, 0xe7,
+    DSX18_BUS_SENSOR_PARASITE, 0xe8,
+    DSX18_BUS_SENSOR_CHANNEL, 0xe9,
+
+    ANALOG_SENSOR_CONTINUOUS, 0xea,
+
+    DSX18_GROUP_SENSOR_PIN, 0xeb,
+    DSX18_GROUP_SENSOR_RESOLUTION, 0xec,
+    DSX18_GROUP_SENSOR_PARASITE, 0xed,
+    DSX18_GROUP_SENSOR_COUNT, 0xee,
+    DSX18_GROUP_SENSOR_VOTING, 0xef,
+    DSX18_GROUP_SENSOR_MIN_VALUE, 0xf0,
+    DSX18_GROUP_SENSOR_MAX_VALUE, 0xf1,
+    DSX18_GROUP_SENSOR_MAX_RATE, 0xf2,
+    DSX18_GROUP_SENSOR_STUCK_TIME, 0xf3,
+    DSX18_GROUP_SENSOR_TIMEOUT, 0xf4,
 )
@@ -19,7 +19,30 @@
 #define PWM_PIN                                 (0u)
 
 #define PID_CONTROL_K                           (255.f)
+#define PID_FIXED_FRAC_BITS                     (16u)                   // Fixed-point PID signal format: Q15.16
+#define PID_FIXED_GAIN_FRAC_BITS                (20u)                   // Fixed-point PID coefficient format: Q11.20
 #define HISTORY_COUNT                           (128u)
+#define CHANNEL_HISTORY_COUNT                   (64u)                   // Live history of channels other than the main one
+#define HISTORY_SENSOR_STEP                     (0.01f)                 // Sensor quantization of encoded history
+#define HISTORY_VALUE_STEP                      (0.001f)                // Control and integral quantization of encoded history
+
+#define AUTOTUNE_AMPLITUDE                      (0.5f)                  // Relay swing around bias, fraction of full output
+#define AUTOTUNE_HYSTERESIS                     (0.2f)                  // Relay noise band, sensor units
+#define AUTOTUNE_CYCLES                         (4u)                    // Consistent periods required to finish
+#define AUTOTUNE_TIMEOUT                        (120u)                  // Minutes
+
+#define IDENT_OUTPUT_FROM                       (0.f)                   // Step test output before step, fraction of full output
+#define IDENT_OUTPUT_TO                         (0.5f)                  // Step test output after step
+#define IDENT_SETTLE_BAND                       (0.1f)                  // Max change over settle time for steady state, sensor units
+#define IDENT_SETTLE_TIME                       (300u)                  // Seconds; should be comparable to process time constant
+#define IDENT_TIMEOUT                           (240u)                  // Minutes
+
+#define ARCHIVE_ENABLED                         (1)                     // Keep history archive on flash (requires NTP time)
+#define ARCHIVE_RAW_SEGMENTS                    (16u)                   // 1 s averages, 4 KiB segments: ~68 minutes
+#define ARCHIVE_MINUTE_SEGMENTS                 (32u)                   // 1 min min/avg/max: ~54 hours
+#define ARCHIVE_HOUR_SEGMENTS                   (24u)                   // 1 h min/avg/max: ~100 days
+
+#define SENSOR_LOG_MAX_SIZE                     (256ul * 1024)          // Recording stops at this size: ~8 bytes per sample, ~9 hours at 1 s interval
 
 #define MQTT                                    (0)                     // Enable MQTT server
 
@@ -31,11 +54,16 @@
 #define MQTT_PREFIX                             ""
 #define MQTT_TOPIC_POWER                        MQTT_PREFIX "/power"
 #define MQTT_TOPIC_NIGHT_MODE                   MQTT_PREFIX "/night_mode"
+#define MQTT_TOPIC_CHANNEL                      MQTT_PREFIX "/channel/%u" // Topics of regulator channels 1.., channel 0 uses the ones above
 
 #define MQTT_OUT_PREFIX                         MQTT_PREFIX "/out"
 #define MQTT_OUT_TOPIC_POWER                    MQTT_OUT_PREFIX "/power"
 #define MQTT_OUT_TOPIC_SENSOR                   MQTT_OUT_PREFIX "/sensor"
 #define MQTT_OUT_TOPIC_CONTROL                  MQTT_OUT_PREFIX "/control"
 #define MQTT_OUT_TOPIC_NIGHT_MODE               MQTT_OUT_PREFIX "/night_mode"
+#define MQTT_OUT_TOPIC_MODEL_GAIN               MQTT_OUT_PREFIX "/model/gain"
+#define MQTT_OUT_TOPIC_MODEL_TIME_CONSTANT      MQTT_OUT_PREFIX "/model/time_constant"
+#define MQTT_OUT_TOPIC_MODEL_DEAD_TIME          MQTT_OUT_PREFIX "/model/dead_time"
+#define MQTT_OUT_TOPIC_CHANNEL                  MQTT_OUT_PREFIX "/channel/%u"
 
 #include "./_override/credentials.h"
\ No newline at end of file
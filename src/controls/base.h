@@ -4,6 +4,8 @@
 
 MAKE_ENUM(ControlType, uint8_t,
     PWM_VALUE, 0,
+    LEDC_PWM, 1,
+    CASCADE, 2,
 );
 
 class ControlBase {
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cmath>
+#include <cstring>
+
+#include "lib/misc/timer.h"
+
+#include "./base.h"
+
+struct __attribute ((packed)) CascadeControlConfig {
+    uint8_t channel = 1; // Regulator channel whose setpoint is driven
+};
+
+/**
+ * Output of an outer loop in cascade: the value is the setpoint of the inner loop's channel, in its sensor units.
+ * No hardware is driven, ChannelScheduler passes the value to the inner channel.
+ */
+class CascadeControl : public ControlBase {
+    CascadeControlConfig _config;
+
+    float _value = NAN;
+
+public:
+    CascadeControl(Timer &, const uint8_t *data) { memcpy(&_config, data, sizeof(_config)); }
+    void begin() override {}
+
+    [[nodiscard]] const CascadeControlConfig &config() const { return _config; }
+
+    [[nodiscard]] float get_value() const override { return _value; }
+    void set_value(float value) override { _value = value; }
+};
@@ -0,0 +1,37 @@
+#include "ledc_control.h"
+
+#include <Arduino.h>
+
+#include "lib/debug.h"
+
+LedcControl::LedcControl(Timer &, const uint8_t *data) {
+    memcpy(&_config, data, sizeof(_config));
+}
+
+void LedcControl::begin() {
+    auto frequency = ledcSetup(_config.channel, _config.frequency, _config.resolution);
+    if (frequency == 0) {
+        D_PRINTF("LEDC (%u): Unable to setup %u Hz with %u bit resolution\r\n",
+                 _config.pin, _config.frequency, _config.resolution);
+        return;
+    }
+
+    D_PRINTF("LEDC (%u): Channel %u, %u Hz, %u bit\r\n",
+             _config.pin, _config.channel, (uint32_t) frequency, _config.resolution);
+
+    _max_duty = (1ul << _config.resolution) - 1;
+    ledcAttachPin(_config.pin, _config.channel);
+    ledcWrite(_config.channel, 0);
+    _ready = true;
+}
+
+void LedcControl::set_value(float value) {
+    // Channel wasn't set up: nothing is attached to the pin
+    if (!_ready) return;
+
+    value = std::max(0.0f, std::min(value, 1.0f));
+    if (value == _value) return;
+
+    _value = value;
+    ledcWrite(_config.channel, (uint32_t) lroundf(value * (float) _max_duty));
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include "lib/misc/timer.h"
+
+#include "./base.h"
+#include "constants.h"
+
+struct __attribute ((packed)) LedcControlConfig {
+    uint8_t pin = PWM_PIN;
+    uint8_t channel = 0;
+    uint32_t frequency = 1000;
+    uint8_t resolution = 10;
+};
+
+/**
+ * Hardware PWM on LEDC peripheral: CPU is involved only when duty changes.
+ * Frequency and resolution are bound by the timer clock: frequency * 2^resolution <= 80 MHz.
+ */
+class LedcControl : public ControlBase {
+    LedcControlConfig _config;
+
+    float _value = 0.0;
+    uint32_t _max_duty = 0;
+    bool _ready = false;
+
+public:
+    LedcControl(Timer &, const uint8_t *data);
+    void begin() override;
+
+    [[nodiscard]] float get_value() const override { return _value; }
+    void set_value(float value) override;
+};
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+
+#include "sys_constants.h"
+
+struct __attribute ((packed)) ChannelLoadStats {
+    uint8_t channels = 0;
+    uint32_t windows = 0;            // Finished measurement windows
+    uint32_t updates = 0;            // Regulator iterations which computed during the last window
+    float update_cycles = 0;         // Average CPU cycles per computing iteration
+    uint32_t update_cycles_max = 0;
+    uint32_t pass_cycles_max = 0;    // Most cycles spent in one pass over all channels
+    uint8_t pass_updates_max = 0;    // Most channels computed in one pass: 1 while sample instants are staggered
+    float load = 0;                  // Fraction of CPU time spent in computing iterations
+    uint16_t capacity = 0;           // Channels sustainable at the shortest interval within CHANNEL_LOAD_BUDGET
+};
+
+/**
+ * CPU time spent by regulator channels, measured in fixed windows.
+ * Cycles of each computing iteration are added during a pass over channels, `end_pass` closes the pass.
+ */
+class ChannelLoadMeter {
+    ChannelLoadStats _stats{};
+
+    uint32_t _window_start = 0;
+    uint32_t _updates = 0;
+    uint64_t _cycles = 0;
+    uint32_t _update_cycles_max = 0;
+    uint32_t _pass_cycles_max = 0;
+    uint8_t _pass_updates_max = 0;
+
+    uint32_t _pass_cycles = 0;
+    uint8_t _pass_updates = 0;
+
+public:
+    [[nodiscard]] const ChannelLoadStats &stats() const { return _stats; }
+
+    void add(uint32_t cycles) {
+        _pass_cycles += cycles;
+        _pass_updates++;
+
+        _updates++;
+        _cycles += cycles;
+        _update_cycles_max = std::max(_update_cycles_max, cycles);
+    }
+
+    void end_pass() {
+        _pass_cycles_max = std::max(_pass_cycles_max, _pass_cycles);
+        _pass_updates_max = std::max(_pass_updates_max, _pass_updates);
+
+        _pass_cycles = 0;
+        _pass_updates = 0;
+    }
+
+    /**
+     * Publish statistics if the window elapsed.
+     * @param cpu_mhz clock of cycle counter; 0 if unknown, load and capacity are not estimated then
+     * @param interval shortest PID interval of channels, ms
+     * @return true if a window finished
+     */
+    bool finish(uint32_t now, uint8_t channels, uint32_t cpu_mhz, uint16_t interval) {
+        if (now - _window_start < CHANNEL_LOAD_WINDOW) return false;
+
+        const double window_cycles = (double) (now - _window_start) * 1000.0 * cpu_mhz;
+        const double update_cycles = _updates > 0 ? (double) _cycles / _updates : 0;
+        const double budget_cycles = (double) interval * 1000.0 * cpu_mhz * CHANNEL_LOAD_BUDGET;
+
+        _stats = {
+            .channels = channels,
+            .windows = _stats.windows + 1,
+            .updates = _updates,
+            .update_cycles = (float) update_cycles,
+            .update_cycles_max = _update_cycles_max,
+            .pass_cycles_max = _pass_cycles_max,
+            .pass_updates_max = _pass_updates_max,
+            .load = window_cycles > 0 ? (float) (_cycles / window_cycles) : 0,
+            .capacity = (uint16_t) (update_cycles > 0 ? std::min(65535.0, budget_cycles / update_cycles) : 0),
+        };
+
+        _window_start = now;
+        _updates = 0;
+        _cycles = 0;
+        _update_cycles_max = 0;
+        _pass_cycles_max = 0;
+        _pass_updates_max = 0;
+
+        return true;
+    }
+};
@@ -0,0 +1,260 @@
+#include "history_archive.h"
+
+#include <cmath>
+#include <cstdio>
+
+#include "lib/debug.h"
+
+struct __attribute ((packed)) ArchiveCompactRecord {
+    uint32_t time = 0;
+    HistoryEntry avg{};
+};
+
+static constexpr ArchiveTierConfig ARCHIVE_TIERS[] = {
+    {.period = 1, .segments = ARCHIVE_RAW_SEGMENTS, .compact = true},
+    {.period = 60, .segments = ARCHIVE_MINUTE_SEGMENTS, .compact = false},
+    {.period = 3600, .segments = ARCHIVE_HOUR_SEGMENTS, .compact = false},
+};
+
+static_assert(ARCHIVE_RAW_SEGMENTS <= ARCHIVE_MAX_SEGMENTS
+              && ARCHIVE_MINUTE_SEGMENTS <= ARCHIVE_MAX_SEGMENTS
+              && ARCHIVE_HOUR_SEGMENTS <= ARCHIVE_MAX_SEGMENTS, "Too many archive segments");
+
+static void entry_min(HistoryEntry &acc, const HistoryEntry &value) {
+    acc.sensor = std::min(acc.sensor, value.sensor);
+    acc.control = std::min(acc.control, value.control);
+    acc.integral = std::min(acc.integral, value.integral);
+}
+
+static void entry_max(HistoryEntry &acc, const HistoryEntry &value) {
+    acc.sensor = std::max(acc.sensor, value.sensor);
+    acc.control = std::max(acc.control, value.control);
+    acc.integral = std::max(acc.integral, value.integral);
+}
+
+static void entry_add(HistoryEntry &acc, const HistoryEntry &value, float weight = 1) {
+    acc.sensor += value.sensor * weight;
+    acc.control += value.control * weight;
+    acc.integral += value.integral * weight;
+}
+
+static HistoryEntry entry_scale(const HistoryEntry &value, float k) {
+    return {.sensor = value.sensor * k, .control = value.control * k, .integral = value.integral * k};
+}
+
+ArchiveTier::ArchiveTier(FS &fs, uint8_t index, const ArchiveTierConfig &config) :
+    _fs(fs), _index(index), _config(config),
+    _record_size(config.compact ? sizeof(ArchiveCompactRecord) : sizeof(ArchiveRecord)),
+    _segment_capacity(ARCHIVE_SEGMENT_SIZE / _record_size) {}
+
+void ArchiveTier::begin() {
+    char path[48];
+    uint32_t newest_time = 0;
+
+    for (uint8_t i = 0; i < _config.segments; ++i) {
+        _path(i, path, sizeof(path));
+        _first_time[i] = 0;
+
+        if (!_fs.exists(path)) continue;
+
+        auto file = _fs.open(path, FILE_READ);
+        uint32_t time;
+        if (!file || file.read((uint8_t *) &time, sizeof(time)) != sizeof(time)) continue;
+
+        _first_time[i] = time;
+        if (time >= newest_time) {
+            newest_time = time;
+            _segment = i;
+            _segment_count = std::min<size_t>(_segment_capacity, file.size() / _record_size);
+        }
+    }
+
+    D_PRINTF("Archive tier %u: segment %u, %u records\r\n", _index, _segment, _segment_count);
+}
+
+uint32_t ArchiveTier::oldest_time() const {
+    uint32_t result = 0;
+    for (uint8_t i = 0; i < _config.segments; ++i) {
+        if (_first_time[i] != 0 && (result == 0 || _first_time[i] < result)) result = _first_time[i];
+    }
+
+    return result;
+}
+
+void ArchiveTier::add(uint32_t time, const HistoryEntry &entry) {
+    const uint32_t bucket = time / _config.period * _config.period;
+    if (_bucket_samples > 0 && bucket != _bucket_time) _close_bucket();
+
+    if (_bucket_samples == 0) {
+        _bucket_time = bucket;
+        _bucket_min = _bucket_max = entry;
+        _bucket_sum = {0, 0, 0};
+    }
+
+    entry_min(_bucket_min, entry);
+    entry_max(_bucket_max, entry);
+    entry_add(_bucket_sum, entry);
+    _bucket_samples++;
+}
+
+void ArchiveTier::_close_bucket() {
+    _write_record({
+        .time = _bucket_time,
+        .min = _bucket_min,
+        .avg = entry_scale(_bucket_sum, 1.f / (float) _bucket_samples),
+        .max = _bucket_max,
+    });
+
+    _bucket_samples = 0;
+}
+
+void ArchiveTier::_write_record(const ArchiveRecord &record) {
+    if (_config.compact) {
+        ArchiveCompactRecord compact{.time = record.time, .avg = record.avg};
+        memcpy(_page + _page_size, &compact, sizeof(compact));
+    } else {
+        memcpy(_page + _page_size, &record, sizeof(record));
+    }
+
+    _page_size += _record_size;
+    if (_page_size + _record_size > sizeof(_page)) flush();
+}
+
+void ArchiveTier::flush() {
+    char path[48];
+
+    uint16_t offset = 0;
+    while (offset < _page_size) {
+        if (_segment_count >= _segment_capacity) {
+            _segment = (_segment + 1) % _config.segments;
+            _segment_count = 0;
+        }
+
+        const uint16_t records = std::min<uint16_t>((_page_size - offset) / _record_size, _segment_capacity - _segment_count);
+        const uint16_t size = records * _record_size;
+
+        _path(_segment, path, sizeof(path));
+
+        // Reused segment is truncated, so its first record is always the oldest one
+        auto file = _fs.open(path, _segment_count == 0 ? FILE_WRITE : FILE_APPEND, true);
+        if (!file) {
+            D_PRINTF("Archive: unable to open %s\r\n", path);
+            break;
+        }
+
+        if (_segment_count == 0) memcpy(&_first_time[_segment], _page + offset, sizeof(uint32_t));
+
+        _bytes_written += file.write(_page + offset, size);
+        _writes++;
+        file.close();
+
+        _segment_count += records;
+        offset += size;
+    }
+
+    _page_size = 0;
+}
+
+void ArchiveTier::_path(uint8_t segment, char *out, size_t size) const {
+    snprintf(out, size, "%s" ARCHIVE_DIR "%u_%02u.bin", STORAGE_PATH, _index, segment);
+}
+
+void ArchiveTier::_read_record(const uint8_t *data, ArchiveRecord &record) const {
+    if (_config.compact) {
+        ArchiveCompactRecord compact;
+        memcpy(&compact, data, sizeof(compact));
+
+        record = {.time = compact.time, .min = compact.avg, .avg = compact.avg, .max = compact.avg};
+    } else {
+        memcpy(&record, data, sizeof(record));
+    }
+}
+
+HistoryArchive::HistoryArchive(FS &fs) :
+    _tiers{
+        ArchiveTier(fs, 0, ARCHIVE_TIERS[0]),
+        ArchiveTier(fs, 1, ARCHIVE_TIERS[1]),
+        ArchiveTier(fs, 2, ARCHIVE_TIERS[2]),
+    } {}
+
+void HistoryArchive::begin() {
+    for (auto &tier: _tiers) tier.begin();
+}
+
+void HistoryArchive::add(uint32_t time, const HistoryEntry &entry) {
+    for (auto &tier: _tiers) tier.add(time, entry);
+}
+
+void HistoryArchive::flush() {
+    for (auto &tier: _tiers) tier.flush();
+}
+
+void HistoryArchive::query(uint32_t from, uint32_t to, ArchiveQueryResult &result) {
+    result.header = {.from = from, .period = 0, .count = 0};
+    if (to <= from) return;
+
+    const uint32_t range = to - from;
+
+    // Finest tier with few enough records which still keeps the beginning of the range.
+    // If none keeps it (e.g. archive is younger than the range), the finest one with few enough records
+    ArchiveTier *tier = nullptr;
+    for (auto &t: _tiers) {
+        if (range / t.config().period > ARCHIVE_QUERY_MAX_RECORDS) continue;
+        if (!tier) tier = &t;
+
+        const auto oldest = t.oldest_time();
+        if (oldest != 0 && oldest <= from) {
+            tier = &t;
+            break;
+        }
+    }
+
+    if (!tier) tier = &_tiers[2];
+
+    const uint32_t period = std::max(tier->config().period, (range + ARCHIVE_QUERY_MAX_POINTS - 1) / ARCHIVE_QUERY_MAX_POINTS);
+    result.header.period = period;
+
+    // Merge source records into result buckets, `weights` keep count of merged records
+    uint16_t weights[ARCHIVE_QUERY_MAX_POINTS]{};
+    int32_t current = -1;
+
+    tier->read(from, to, [&](const ArchiveRecord &record) {
+        const auto index = (int32_t) std::min<uint32_t>((record.time - from) / period, ARCHIVE_QUERY_MAX_POINTS - 1);
+        if (index != current) {
+            if (current >= 0 && index < current) return; // Out of order record, e.g. after clock correction
+            if (result.header.count == ARCHIVE_QUERY_MAX_POINTS) return;
+
+            current = index;
+            result.records[result.header.count++] = {
+                .time = from + index * period,
+                .min = record.min, .avg = {0, 0, 0}, .max = record.max
+            };
+        }
+
+        auto &out = result.records[result.header.count - 1];
+        auto &weight = weights[result.header.count - 1];
+
+        entry_min(out.min, record.min);
+        entry_max(out.max, record.max);
+        entry_add(out.avg, record.avg);
+        weight++;
+    });
+
+    for (uint16_t i = 0; i < result.header.count; ++i) {
+        result.records[i].avg = entry_scale(result.records[i].avg, 1.f / (float) weights[i]);
+    }
+}
+
+uint32_t HistoryArchive::writes() const {
+    uint32_t result = 0;
+    for (auto &tier: _tiers) result += tier.writes();
+
+    return result;
+}
+
+uint32_t HistoryArchive::bytes_written() const {
+    uint32_t result = 0;
+    for (auto &tier: _tiers) result += tier.bytes_written();
+
+    return result;
+}
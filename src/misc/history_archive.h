@@ -0,0 +1,179 @@
+#pragma once
+
+#include <FS.h>
+
+#include <lib/base/parameter.h>
+
+#include "app/config.h"
+#include "sys_constants.h"
+
+struct __attribute ((packed)) ArchiveRecord {
+    uint32_t time = 0; // Start of the period, epoch seconds
+    HistoryEntry min{};
+    HistoryEntry avg{};
+    HistoryEntry max{};
+};
+
+struct ArchiveTierConfig {
+    uint32_t period;   // Aggregation period, seconds
+    uint8_t segments;  // Segment files in rotation
+    bool compact;      // Store averages only
+};
+
+/**
+ * Round-robin series of fixed-period records stored in segment files.
+ *
+ * Each segment is an append-only file of one flash block. Records are collected in a page-sized buffer
+ * and appended in batches; when the current segment is full, the oldest one is truncated and reused.
+ * Order of segments is restored on start from the time of their first records.
+ */
+class ArchiveTier {
+    FS &_fs;
+    uint8_t _index;
+    ArchiveTierConfig _config;
+
+    uint8_t _record_size;
+    uint16_t _segment_capacity;
+
+    uint8_t _segment = 0;
+    uint16_t _segment_count = 0;
+    uint32_t _first_time[ARCHIVE_MAX_SEGMENTS]{};
+
+    uint32_t _bucket_time = 0;
+    uint32_t _bucket_samples = 0;
+    HistoryEntry _bucket_min{}, _bucket_sum{}, _bucket_max{};
+
+    uint8_t _page[ARCHIVE_PAGE_SIZE]{};
+    uint16_t _page_size = 0;
+
+    uint32_t _writes = 0;
+    uint32_t _bytes_written = 0;
+
+public:
+    ArchiveTier(FS &fs, uint8_t index, const ArchiveTierConfig &config);
+
+    [[nodiscard]] const ArchiveTierConfig &config() const { return _config; }
+    [[nodiscard]] uint32_t writes() const { return _writes; }
+    [[nodiscard]] uint32_t bytes_written() const { return _bytes_written; }
+    [[nodiscard]] uint32_t oldest_time() const;
+
+    void begin();
+
+    void add(uint32_t time, const HistoryEntry &entry);
+    void flush();
+
+    /**
+     * Call `fn` for every completed record in [from, to), oldest first.
+     */
+    template<typename Fn>
+    void read(uint32_t from, uint32_t to, Fn &&fn);
+
+private:
+    void _path(uint8_t segment, char *out, size_t size) const;
+
+    void _close_bucket();
+    void _write_record(const ArchiveRecord &record);
+    void _read_record(const uint8_t *data, ArchiveRecord &record) const;
+};
+
+struct __attribute ((packed)) ArchiveQueryHeader {
+    uint32_t from = 0;
+    uint32_t period = 0; // Width of the result bucket, seconds
+    uint16_t count = 0;
+};
+
+struct __attribute ((packed)) ArchiveQueryResult {
+    ArchiveQueryHeader header{};
+    ArchiveRecord records[ARCHIVE_QUERY_MAX_POINTS]{};
+};
+
+/**
+ * Multi-resolution history on flash: 1 s averages, 1 min and 1 h min/avg/max.
+ */
+class HistoryArchive {
+    ArchiveTier _tiers[3];
+
+public:
+    explicit HistoryArchive(FS &fs);
+
+    void begin();
+
+    void add(uint32_t time, const HistoryEntry &entry);
+    void flush();
+
+    /**
+     * Fill `result` with at most ARCHIVE_QUERY_MAX_POINTS records covering [from, to).
+     * Uses the finest tier which fits the range, neighbour records are merged if there are still too many.
+     */
+    void query(uint32_t from, uint32_t to, ArchiveQueryResult &result);
+
+    [[nodiscard]] uint32_t writes() const;
+    [[nodiscard]] uint32_t bytes_written() const;
+};
+
+/**
+ * Read-only parameter with variable size: query header followed by `count` records.
+ */
+class ArchiveQueryParameter : public AbstractParameter {
+    const ArchiveQueryResult *_result;
+
+public:
+    explicit ArchiveQueryParameter(const ArchiveQueryResult *result) : _result(result) {}
+
+    bool set_value(const void *, size_t) override { return false; }
+
+    [[nodiscard]] const void *get_value() const override { return _result; }
+
+    [[nodiscard]] size_t size() const override {
+        return sizeof(ArchiveQueryHeader) + _result->header.count * sizeof(ArchiveRecord);
+    }
+};
+
+template<typename Fn>
+void ArchiveTier::read(uint32_t from, uint32_t to, Fn &&fn) {
+    // Segments ordered by first record time, empty ones have zero time
+    uint8_t order[ARCHIVE_MAX_SEGMENTS];
+    uint8_t count = 0;
+    for (uint8_t i = 0; i < _config.segments; ++i) {
+        if (_first_time[i] == 0) continue;
+
+        uint8_t pos = count++;
+        while (pos > 0 && _first_time[order[pos - 1]] > _first_time[i]) {
+            order[pos] = order[pos - 1];
+            pos--;
+        }
+
+        order[pos] = i;
+    }
+
+    ArchiveRecord record;
+    uint8_t buffer[ARCHIVE_PAGE_SIZE];
+    char path[48];
+
+    for (uint8_t i = 0; i < count; ++i) {
+        const uint8_t segment = order[i];
+
+        // Skip segments which end before the range: next segment starts after it
+        if (i + 1 < count && _first_time[order[i + 1]] <= from) continue;
+        if (_first_time[segment] >= to) break;
+
+        _path(segment, path, sizeof(path));
+        auto file = _fs.open(path, FILE_READ);
+        if (!file) continue;
+
+        const size_t chunk = sizeof(buffer) / _record_size * _record_size;
+        size_t size;
+        while ((size = file.read(buffer, chunk)) >= _record_size) {
+            for (size_t offset = 0; offset + _record_size <= size; offset += _record_size) {
+                _read_record(buffer + offset, record);
+                if (record.time >= from && record.time < to) fn(record);
+            }
+        }
+    }
+
+    // Records not yet written to flash
+    for (size_t offset = 0; offset + _record_size <= _page_size; offset += _record_size) {
+        _read_record(_page + offset, record);
+        if (record.time >= from && record.time < to) fn(record);
+    }
+}
@@ -0,0 +1,81 @@
+#include "history_codec.h"
+
+#include <cmath>
+#include <cstring>
+
+#include "./varint.h"
+
+// Keep quantized values in 30 bits, so delta of any two of them fits in int32
+static constexpr int32_t QUANTIZED_LIMIT = (1 << 30) - 1;
+
+static int32_t quantize(float value, float step) {
+    const float q = std::round(value / step);
+    if (q >= (float) QUANTIZED_LIMIT) return QUANTIZED_LIMIT;
+    if (q <= (float) -QUANTIZED_LIMIT) return -QUANTIZED_LIMIT;
+
+    return (int32_t) q;
+}
+
+template<typename Fn>
+static uint8_t *write_column(uint8_t *out, size_t length, Fn &&value_at) {
+    int32_t prev = 0;
+    for (size_t i = 0; i < length;) {
+        const int32_t value = value_at(i);
+        if (value != prev) {
+            out = write_varint(out, zigzag(value - prev));
+            prev = value;
+            i++;
+            continue;
+        }
+
+        size_t run = 1;
+        while (i + run < length && value_at(i + run) == prev) run++;
+
+        out = write_varint(out, 0);
+        out = write_varint(out, run - 1);
+        i += run;
+    }
+
+    return out;
+}
+
+size_t history_encode(const DataHistory &history, uint8_t *out) {
+    EncodedHistoryHeader header;
+    header.count = history.count;
+    header.seq = history.seq;
+    header.sensor_min = history.sensor_min;
+    header.sensor_max = history.sensor_max;
+
+    // Positions of filled entries, oldest first
+    uint8_t order[HISTORY_COUNT];
+    static_assert(HISTORY_COUNT <= 256, "Entry position must fit in uint8_t");
+
+    uint16_t length = 0;
+    for (uint16_t i = 0; i < HISTORY_COUNT; ++i) {
+        const uint16_t pos = (history.index + i) % HISTORY_COUNT;
+        const auto &entry = history.entries[pos];
+        if (std::isnan(entry.sensor) || std::isnan(entry.control) || std::isnan(entry.integral)) continue;
+
+        order[length++] = pos;
+    }
+
+    header.length = length;
+    memcpy(out, &header, sizeof(header));
+
+    const auto *entries = history.entries;
+    uint8_t *ptr = out + sizeof(header);
+
+    ptr = write_column(ptr, length, [&](size_t i) { return quantize(entries[order[i]].sensor, header.sensor_step); });
+    ptr = write_column(ptr, length, [&](size_t i) { return quantize(entries[order[i]].control, header.value_step); });
+    ptr = write_column(ptr, length, [&](size_t i) { return quantize(entries[order[i]].integral, header.value_step); });
+
+    return ptr - out;
+}
+
+void EncodedHistoryParameter::_encode() const {
+    if (_encoded && _encoded_seq == _history->seq) return;
+
+    _size = history_encode(*_history, _buffer);
+    _encoded_seq = _history->seq;
+    _encoded = true;
+}
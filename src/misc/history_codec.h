@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <lib/base/parameter.h>
+
+#include "app/config.h"
+
+#define HISTORY_FORMAT_DELTA_VARINT             ((uint8_t) 1)
+
+struct __attribute ((packed)) EncodedHistoryHeader {
+    uint8_t format = HISTORY_FORMAT_DELTA_VARINT;
+
+    uint16_t count = 0;  // History capacity
+    uint16_t length = 0; // Encoded entries, oldest first
+    uint32_t seq = 0;    // Sequence number of the latest entry
+
+    float sensor_min = INFINITY;
+    float sensor_max = -INFINITY;
+
+    float sensor_step = HISTORY_SENSOR_STEP;
+    float value_step = HISTORY_VALUE_STEP;
+};
+
+// Each of 3 columns takes up to 5 bytes per entry: varint of 32-bit zigzag delta
+#define HISTORY_ENCODED_MAX_SIZE                (sizeof(EncodedHistoryHeader) + HISTORY_COUNT * 3 * 5)
+
+/**
+ * Compact encoding of DataHistory for bulk transfers.
+ *
+ * Entries are quantized (sensor with `HISTORY_SENSOR_STEP`, control and integral with `HISTORY_VALUE_STEP`)
+ * and stored column by column as zigzag varint deltas from the previous entry.
+ * Repeated values are stored as zero delta followed by varint count of extra repeats,
+ * so flat and saturated segments take two bytes regardless of length.
+ * Entries without values (not yet filled) are skipped.
+ *
+ * @return encoded size, never exceeds HISTORY_ENCODED_MAX_SIZE
+ */
+size_t history_encode(const DataHistory &history, uint8_t *out);
+
+/**
+ * Read-only parameter serializing DataHistory with `history_encode`.
+ * Encoding is cached and redone only when history sequence changes.
+ */
+class EncodedHistoryParameter : public AbstractParameter {
+    const DataHistory *_history;
+
+    mutable uint8_t _buffer[HISTORY_ENCODED_MAX_SIZE]{};
+    mutable size_t _size = 0;
+    mutable uint32_t _encoded_seq = 0;
+    mutable bool _encoded = false;
+
+public:
+    explicit EncodedHistoryParameter(const DataHistory *history) : _history(history) {}
+
+    bool set_value(const void *, size_t) override { return false; }
+
+    [[nodiscard]] const void *get_value() const override {
+        _encode();
+        return _buffer;
+    }
+
+    [[nodiscard]] size_t size() const override {
+        _encode();
+        return _size;
+    }
+
+private:
+    void _encode() const;
+};
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+
+struct __attribute ((packed)) SamplingStats {
+    uint32_t count = 0;               // Computed ticks
+    uint32_t missed = 0;              // Timer ticks not processed in time
+    uint32_t period_min = 0;          // Shortest measured period, µs
+    uint32_t period_max = 0;          // Longest measured period, µs
+    float jitter_rms = 0;             // RMS deviation of period from nominal, µs
+    uint32_t latency_max = 0;         // Longest delay between trigger (timer tick, sensor sample) and compute, µs
+    uint32_t dropped = 0;             // Telemetry samples lost because publishers fell behind
+    float sensor_latency_avg = 0;     // Average delay between sensor measurement and control output, µs
+    uint32_t sensor_latency_max = 0;  // Longest delay between sensor measurement and control output, µs
+};
+
+/**
+ * Running statistics of sampling period deviation from nominal interval.
+ */
+class JitterStats {
+    SamplingStats _stats{};
+    uint64_t _jitter_sq_sum = 0;
+
+    uint64_t _sensor_latency_sum = 0;
+    uint32_t _sensor_latency_count = 0;
+
+public:
+    [[nodiscard]] const SamplingStats &stats() const { return _stats; }
+
+    void reset() {
+        _stats = {};
+        _jitter_sq_sum = 0;
+
+        _sensor_latency_sum = 0;
+        _sensor_latency_count = 0;
+    }
+
+    void add(uint32_t period, uint32_t nominal, uint32_t latency, uint32_t missed) {
+        const int64_t jitter = (int64_t) period - nominal;
+        _jitter_sq_sum += (uint64_t) (jitter * jitter);
+
+        if (_stats.count == 0 || period < _stats.period_min) _stats.period_min = period;
+        if (period > _stats.period_max) _stats.period_max = period;
+        if (latency > _stats.latency_max) _stats.latency_max = latency;
+
+        _stats.missed += missed;
+        _stats.count++;
+
+        _stats.jitter_rms = std::sqrt((float) _jitter_sq_sum / (float) _stats.count);
+    }
+
+    void add_sensor_latency(uint32_t latency) {
+        _sensor_latency_sum += latency;
+        _sensor_latency_count++;
+
+        if (latency > _stats.sensor_latency_max) _stats.sensor_latency_max = latency;
+        _stats.sensor_latency_avg = (float) _sensor_latency_sum / (float) _sensor_latency_count;
+    }
+};
@@ -0,0 +1,51 @@
+#include "sample_timer.h"
+
+#include "sys_constants.h"
+#include "lib/debug.h"
+
+void SampleTimer::begin(uint32_t interval_ms) {
+    end();
+
+    // 80 MHz APB clock divided to 1 µs ticks
+    _timer = timerBegin(SAMPLE_TIMER_INDEX, 80, true);
+    timerAttachInterrupt(_timer, &SampleTimer::_on_timer, true);
+    timerAlarmWrite(_timer, interval_ms * 1000ull, true);
+
+    _consumed_ticks = _ticks;
+    timerAlarmEnable(_timer);
+
+    D_PRINTF("Sample timer: %u ms\r\n", interval_ms);
+}
+
+void SampleTimer::end() {
+    if (!_timer) return;
+
+    timerAlarmDisable(_timer);
+    timerDetachInterrupt(_timer);
+    timerEnd(_timer);
+
+    _timer = nullptr;
+}
+
+bool SampleTimer::take(uint32_t &tick_time, uint32_t &missed) {
+    // Interrupt may fire between the two reads: retry until the time belongs to the counted tick
+    uint32_t ticks;
+    do {
+        ticks = _ticks;
+        tick_time = _tick_time;
+    } while (ticks != _ticks);
+
+    if (ticks == _consumed_ticks) return false;
+
+    missed = ticks - _consumed_ticks - 1;
+
+    _consumed_ticks = ticks;
+    return true;
+}
+
+void IRAM_ATTR SampleTimer::_on_timer() {
+    _tick_time = micros();
+    _ticks = _ticks + 1;
+
+    if (_tick_handler) _tick_handler();
+}
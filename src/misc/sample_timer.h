@@ -0,0 +1,41 @@
+#pragma once
+
+#include <Arduino.h>
+
+/**
+ * Hardware timer generating PID sampling instants.
+ * Interrupt only stores trigger time and increments tick counter, regulator consumes ticks from the loop.
+ */
+class SampleTimer {
+    static inline hw_timer_t *_timer = nullptr;
+
+    static inline volatile uint32_t _ticks = 0;
+    static inline volatile uint32_t _tick_time = 0;
+
+    static inline uint32_t _consumed_ticks = 0;
+
+    static inline void (*_tick_handler)() = nullptr;
+
+public:
+    static void begin(uint32_t interval_ms);
+    static void end();
+
+    [[nodiscard]] static bool active() { return _timer != nullptr; }
+
+    /**
+     * Set function called from the interrupt after each tick, e.g. to wake up consumer task.
+     * Handler must be placed in IRAM.
+     */
+    static void set_tick_handler(void (*handler)()) { _tick_handler = handler; }
+
+    /**
+     * Take pending tick.
+     * @param tick_time trigger time (micros) of the latest tick
+     * @param missed count of ticks that were overwritten before being taken
+     * @return false if there is no pending tick
+     */
+    static bool take(uint32_t &tick_time, uint32_t &missed);
+
+private:
+    static void IRAM_ATTR _on_timer();
+};
@@ -0,0 +1,302 @@
+#include "sensor_log.h"
+
+#include <cstring>
+
+#include "lib/debug.h"
+
+#include "./varint.h"
+
+static uint32_t float_bits(float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+static float bits_float(uint32_t bits) {
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+size_t SensorLogEncoder::header(SensorType sensor, uint8_t *out) {
+    SensorLogHeader header;
+    header.sensor = sensor;
+
+    memcpy(out, &header, sizeof(header));
+    return sizeof(header);
+}
+
+size_t SensorLogEncoder::snapshot(const RegulatorSnapshot &snapshot, uint8_t *out) {
+    _time_us = snapshot.time_us;
+    _sensor_bits = 0;
+    _control_bits = 0;
+
+    out[0] = SENSOR_LOG_SNAPSHOT;
+    memcpy(out + 1, &snapshot, sizeof(snapshot));
+    return 1 + sizeof(snapshot);
+}
+
+size_t SensorLogEncoder::sample(const TelemetrySample &sample, uint8_t *out) {
+    uint8_t tag = SENSOR_LOG_SAMPLE;
+    if (sample.active) tag |= SENSOR_LOG_SAMPLE_ACTIVE;
+    if (sample.pid) tag |= SENSOR_LOG_SAMPLE_PID;
+
+    const uint32_t sensor_bits = float_bits(sample.sensor_value);
+    const uint32_t control_bits = float_bits(sample.control_value);
+
+    uint8_t *ptr = out;
+    *ptr++ = tag;
+    ptr = write_varint(ptr, sample.time_us - _time_us);
+    ptr = write_varint(ptr, zigzag((int32_t) (sensor_bits - _sensor_bits)));
+    ptr = write_varint(ptr, zigzag((int32_t) (control_bits - _control_bits)));
+
+    _time_us = sample.time_us;
+    _sensor_bits = sensor_bits;
+    _control_bits = control_bits;
+
+    return ptr - out;
+}
+
+bool SensorLogDecoder::header(const uint8_t *data, size_t size, SensorLogHeader &header) {
+    if (size < sizeof(header)) return false;
+
+    memcpy(&header, data, sizeof(header));
+    return header.magic == SENSOR_LOG_MAGIC
+           && header.version == SENSOR_LOG_VERSION
+           && header.snapshot_size == sizeof(RegulatorSnapshot);
+}
+
+int32_t SensorLogDecoder::next(const uint8_t *data, size_t size, SensorLogRecord &record) {
+    if (size == 0) return 0;
+
+    const uint8_t tag = data[0];
+    if (tag == SENSOR_LOG_SNAPSHOT) {
+        if (size < 1 + sizeof(RegulatorSnapshot)) return 0;
+
+        record.type = SENSOR_LOG_SNAPSHOT;
+        memcpy(&record.snapshot, data + 1, sizeof(RegulatorSnapshot));
+        if (record.snapshot.pid_state_size > PID_STATE_MAX_SIZE) return -1;
+
+        _time_us = record.snapshot.time_us;
+        _sensor_bits = 0;
+        _control_bits = 0;
+
+        return 1 + sizeof(RegulatorSnapshot);
+    }
+
+    if ((tag & SENSOR_LOG_SAMPLE) == 0) return -1;
+
+    uint32_t values[3];
+    size_t offset = 1;
+    for (auto &value: values) {
+        const size_t length = read_varint(data + offset, size - offset, value);
+        if (length == 0) return size - offset >= 5 ? -1 : 0;
+
+        offset += length;
+    }
+
+    _time_us += values[0];
+    _sensor_bits += (uint32_t) unzigzag(values[1]);
+    _control_bits += (uint32_t) unzigzag(values[2]);
+
+    record.type = SENSOR_LOG_SAMPLE;
+    record.sample = {
+        .timestamp = _time_us / 1000,
+        .time_us = _time_us,
+        .sensor_value = bits_float(_sensor_bits),
+        .control_value = bits_float(_control_bits),
+        .integral = NAN,
+        .active = (tag & SENSOR_LOG_SAMPLE_ACTIVE) != 0,
+        .pid = (tag & SENSOR_LOG_SAMPLE_PID) != 0
+    };
+
+    return (int32_t) offset;
+}
+
+bool SensorLogWriter::start(SensorType sensor) {
+    _active = true;
+    _synced = false;
+    _failed = false;
+    _size = 0;
+    _samples = 0;
+
+    uint8_t buffer[sizeof(SensorLogHeader)];
+    _append(buffer, SensorLogEncoder::header(sensor, buffer));
+
+    return _active;
+}
+
+void SensorLogWriter::stop() {
+    _active = false;
+}
+
+void SensorLogWriter::add(const RegulatorSnapshot &snapshot) {
+    if (!_active) return;
+
+    uint8_t buffer[SENSOR_LOG_RECORD_MAX_SIZE];
+    _append(buffer, _encoder.snapshot(snapshot, buffer));
+
+    _synced = true;
+}
+
+void SensorLogWriter::add(const TelemetrySample &sample) {
+    if (!_active || !_synced) return;
+
+    uint8_t buffer[SENSOR_LOG_SAMPLE_MAX_SIZE];
+    _append(buffer, _encoder.sample(sample, buffer));
+
+    _samples++;
+}
+
+void SensorLogWriter::_append(const uint8_t *data, size_t size) {
+    // Record that doesn't fit is dropped with all following ones: log stays decodable
+    if (_size + size > _limit) {
+        D_PRINTF("Sensor log: stopped at %u bytes\r\n", _size);
+        stop();
+        return;
+    }
+
+    if (!_write(data, size)) {
+        _fail();
+        return;
+    }
+
+    _size += size;
+}
+
+void SensorLogWriter::_fail() {
+    D_PRINTF("Sensor log: write failed at %u bytes\r\n", _size);
+
+    _failed = true;
+    stop();
+}
+
+bool SensorLogFile::start(SensorType sensor) {
+    _file = _fs.open(SENSOR_LOG_PATH, FILE_WRITE, true);
+    if (!_file) {
+        D_PRINT("Sensor log: unable to create file");
+        return false;
+    }
+
+    _page_size = 0;
+    return SensorLogWriter::start(sensor);
+}
+
+void SensorLogFile::stop() {
+    flush();
+    _file.close();
+
+    SensorLogWriter::stop();
+}
+
+void SensorLogFile::flush() {
+    if (!_file || _page_size == 0) return;
+
+    const bool written = _file.write(_page, _page_size) == _page_size;
+    _file.flush();
+
+    _page_size = 0;
+    if (!written) _fail();
+}
+
+bool SensorLogFile::_write(const uint8_t *data, size_t size) {
+    if (!_file) return false;
+
+    while (size > 0) {
+        const size_t length = std::min(size, sizeof(_page) - _page_size);
+        memcpy(_page + _page_size, data, length);
+
+        _page_size += length;
+        data += length;
+        size -= length;
+
+        if (_page_size == sizeof(_page)) {
+            const bool written = _file.write(_page, _page_size) == _page_size;
+            _page_size = 0;
+
+            if (!written) return false;
+        }
+    }
+
+    return true;
+}
+
+bool SensorLogChunk::read(FS &fs, uint32_t offset) {
+    header = {};
+
+    auto file = fs.open(SENSOR_LOG_PATH, FILE_READ);
+    if (!file) return false;
+
+    header.total = file.size();
+    header.offset = std::min(offset, header.total);
+
+    file.seek(header.offset);
+    header.length = file.read(data, sizeof(data));
+
+    return true;
+}
+
+void SensorLogStream::stop() {
+    flush();
+    SensorLogWriter::stop();
+}
+
+void SensorLogStream::flush() {
+    if (_chunk.header.length == 0) return;
+
+    _send(_chunk);
+
+    _chunk.header.offset += _chunk.header.length;
+    _chunk.header.length = 0;
+}
+
+bool SensorLogStream::_write(const uint8_t *data, size_t size) {
+    // Chunks are sent from the start of a fresh log
+    if (SensorLogWriter::size() == 0) _chunk.header = {};
+
+    if (_chunk.header.length + size > sizeof(_chunk.data)) flush();
+
+    memcpy(_chunk.data + _chunk.header.length, data, size);
+    _chunk.header.length += size;
+
+    return true;
+}
+
+bool SensorLogReader::open(FS &fs, const char *path) {
+    _file = fs.open(path, FILE_READ);
+    if (!_file) return false;
+
+    _decoder = {};
+    _position = 0;
+    _length = 0;
+
+    _fill();
+    if (!SensorLogDecoder::header(_buffer + _position, _length - _position, _header)) {
+        _file.close();
+        return false;
+    }
+
+    _position += sizeof(SensorLogHeader);
+    return true;
+}
+
+bool SensorLogReader::next(SensorLogRecord &record) {
+    if (!_file) return false;
+
+    auto result = _decoder.next(_buffer + _position, _length - _position, record);
+    if (result == 0 && _fill()) result = _decoder.next(_buffer + _position, _length - _position, record);
+    if (result <= 0) return false;
+
+    _position += result;
+    return true;
+}
+
+bool SensorLogReader::_fill() {
+    const size_t remaining = _length - _position;
+    memmove(_buffer, _buffer + _position, remaining);
+
+    _position = 0;
+    _length = remaining + _file.read(_buffer + remaining, sizeof(_buffer) - remaining);
+
+    return _length > remaining;
+}
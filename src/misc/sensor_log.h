@@ -0,0 +1,242 @@
+#pragma once
+
+#include <functional>
+
+#include <FS.h>
+
+#include <lib/base/parameter.h>
+
+#include "app/regulator.h"
+#include "sys_constants.h"
+
+#define SENSOR_LOG_MAGIC                        ((uint32_t) 0x474f4c53) // "SLOG"
+#define SENSOR_LOG_VERSION                      ((uint8_t) 1)
+
+struct __attribute ((packed)) SensorLogHeader {
+    uint32_t magic = SENSOR_LOG_MAGIC;
+    uint8_t version = SENSOR_LOG_VERSION;
+    uint8_t snapshot_size = sizeof(RegulatorSnapshot); // Guards against PidConfig layout changes
+
+    SensorType sensor = SensorType::ANALOG_VALUE;
+};
+
+enum SensorLogRecordType : uint8_t {
+    SENSOR_LOG_SNAPSHOT = 0x01,
+    SENSOR_LOG_SAMPLE = 0x80, // Low bits hold sample flags
+};
+
+#define SENSOR_LOG_SAMPLE_ACTIVE                ((uint8_t) 0x01)
+#define SENSOR_LOG_SAMPLE_PID                   ((uint8_t) 0x02)
+
+// Tag and three varints of up to 5 bytes
+#define SENSOR_LOG_SAMPLE_MAX_SIZE              (1 + 3 * 5)
+#define SENSOR_LOG_RECORD_MAX_SIZE              (1 + sizeof(RegulatorSnapshot))
+
+struct SensorLogRecord {
+    SensorLogRecordType type = SENSOR_LOG_SAMPLE;
+
+    RegulatorSnapshot snapshot{}; // SENSOR_LOG_SNAPSHOT
+    TelemetrySample sample{};     // SENSOR_LOG_SAMPLE: time_us, sensor_value, control_value, active and pid
+};
+
+/**
+ * Compact lossless encoding of regulator input and output.
+ *
+ * Log is a header followed by records. Snapshot record stores RegulatorSnapshot as is and restarts delta coding.
+ * Sample record is a tag with flags, varint of microseconds since previous sample (or snapshot)
+ * and zigzag varint deltas of sensor and control float bit patterns, so values are reproduced exactly:
+ * a slowly changing reading takes 1-3 bytes, a repeated one takes a single byte.
+ */
+class SensorLogEncoder {
+    uint32_t _time_us = 0;
+    uint32_t _sensor_bits = 0;
+    uint32_t _control_bits = 0;
+
+public:
+    static size_t header(SensorType sensor, uint8_t *out);
+
+    /**
+     * @param out buffer of SENSOR_LOG_RECORD_MAX_SIZE bytes
+     */
+    size_t snapshot(const RegulatorSnapshot &snapshot, uint8_t *out);
+
+    /**
+     * @param out buffer of SENSOR_LOG_SAMPLE_MAX_SIZE bytes
+     */
+    size_t sample(const TelemetrySample &sample, uint8_t *out);
+};
+
+class SensorLogDecoder {
+    uint32_t _time_us = 0;
+    uint32_t _sensor_bits = 0;
+    uint32_t _control_bits = 0;
+
+public:
+    /**
+     * @return false if data doesn't start with a header of supported version
+     */
+    static bool header(const uint8_t *data, size_t size, SensorLogHeader &header);
+
+    /**
+     * Decode record at the start of `data`.
+     * @return consumed bytes; 0 if record is incomplete; -1 if data is corrupted
+     */
+    int32_t next(const uint8_t *data, size_t size, SensorLogRecord &record);
+};
+
+/**
+ * Destination of encoded log. Records are accepted after `start` and the first snapshot,
+ * so every log can be replayed from its beginning.
+ */
+class SensorLogWriter {
+    SensorLogEncoder _encoder{};
+    uint32_t _limit;
+
+    bool _active = false;
+    bool _synced = false;
+    bool _failed = false;
+
+    uint32_t _size = 0;
+    uint32_t _samples = 0;
+
+public:
+    explicit SensorLogWriter(uint32_t limit) : _limit(limit) {}
+    virtual ~SensorLogWriter() = default;
+
+    [[nodiscard]] bool active() const { return _active; }
+    [[nodiscard]] bool failed() const { return _failed; } // Last recording stopped on write error
+    [[nodiscard]] uint32_t size() const { return _size; }
+    [[nodiscard]] uint32_t samples() const { return _samples; }
+
+    virtual bool start(SensorType sensor);
+    virtual void stop();
+
+    void add(const RegulatorSnapshot &snapshot);
+
+    /**
+     * Writer stops itself when size limit is reached or sink fails.
+     */
+    void add(const TelemetrySample &sample);
+
+protected:
+    virtual bool _write(const uint8_t *data, size_t size) = 0;
+
+    /**
+     * Stop recording after sink failed to store data.
+     */
+    void _fail();
+
+private:
+    void _append(const uint8_t *data, size_t size);
+};
+
+/**
+ * Log recorded to a file, written in page-sized batches. Recording stops at SENSOR_LOG_MAX_SIZE or on short write.
+ */
+class SensorLogFile : public SensorLogWriter {
+    FS &_fs;
+    File _file;
+
+    uint8_t _page[SENSOR_LOG_PAGE_SIZE]{};
+    size_t _page_size = 0;
+
+public:
+    explicit SensorLogFile(FS &fs) : SensorLogWriter(SENSOR_LOG_MAX_SIZE), _fs(fs) {}
+
+    bool start(SensorType sensor) override;
+    void stop() override;
+
+    void flush();
+
+protected:
+    bool _write(const uint8_t *data, size_t size) override;
+};
+
+struct __attribute ((packed)) SensorLogChunkHeader {
+    uint32_t offset = 0; // Position of the first byte in the log
+    uint32_t total = 0;  // Log size for downloads; 0 for live stream
+    uint16_t length = 0;
+};
+
+struct __attribute ((packed)) SensorLogChunk {
+    SensorLogChunkHeader header{};
+    uint8_t data[SENSOR_LOG_CHUNK_SIZE]{};
+
+    /**
+     * Read chunk of log file at `offset`.
+     * @return false if file is missing
+     */
+    bool read(FS &fs, uint32_t offset);
+};
+
+/**
+ * Log streamed in chunks. Records are not split, concatenated chunks form a valid log.
+ */
+class SensorLogStream : public SensorLogWriter {
+    SensorLogChunk _chunk{};
+    std::function<void(const SensorLogChunk &)> _send;
+
+public:
+    explicit SensorLogStream(std::function<void(const SensorLogChunk &)> send) :
+        SensorLogWriter(UINT32_MAX), _send(std::move(send)) {}
+
+    [[nodiscard]] const SensorLogChunk &chunk() const { return _chunk; }
+
+    void stop() override;
+
+    /**
+     * Send partially filled chunk.
+     */
+    void flush();
+
+protected:
+    bool _write(const uint8_t *data, size_t size) override;
+};
+
+/**
+ * Sequential reader of log file.
+ */
+class SensorLogReader {
+    File _file;
+    SensorLogHeader _header{};
+    SensorLogDecoder _decoder{};
+
+    uint8_t _buffer[SENSOR_LOG_PAGE_SIZE]{};
+    size_t _position = 0;
+    size_t _length = 0;
+
+    static_assert(SENSOR_LOG_RECORD_MAX_SIZE <= SENSOR_LOG_PAGE_SIZE, "Record must fit in read buffer");
+
+public:
+    [[nodiscard]] const SensorLogHeader &header() const { return _header; }
+
+    /**
+     * @return false if file is missing or has unsupported format
+     */
+    bool open(FS &fs, const char *path);
+    void close() { _file.close(); }
+
+    /**
+     * @return false at the end of log or on corrupted record
+     */
+    bool next(SensorLogRecord &record);
+
+private:
+    bool _fill();
+};
+
+/**
+ * Read-only parameter with a chunk of log, sized to its payload.
+ */
+class SensorLogChunkParameter : public AbstractParameter {
+    const SensorLogChunk *_chunk;
+
+public:
+    explicit SensorLogChunkParameter(const SensorLogChunk *chunk) : _chunk(chunk) {}
+
+    bool set_value(const void *, size_t) override { return false; }
+
+    [[nodiscard]] const void *get_value() const override { return _chunk; }
+
+    [[nodiscard]] size_t size() const override { return sizeof(SensorLogChunkHeader) + _chunk->header.length; }
+};
@@ -0,0 +1,226 @@
+#include "setpoint_program.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+#include "lib/debug.h"
+
+bool SetpointProgram::valid() const {
+    if (count > PROGRAM_MAX_SEGMENTS) return false;
+
+    for (uint8_t i = 0; i < count; ++i) {
+        const auto &segment = segments[i];
+        if (!std::isfinite(segment.target)) return false;
+        if (!std::isfinite(segment.rate) || segment.rate < 0) return false;
+        if (segment.rate > 0 && segment.rate < PROGRAM_MIN_RATE) return false;
+        if (!std::isfinite(segment.hold_band) || segment.hold_band < 0) return false;
+    }
+
+    return true;
+}
+
+float ProgramRunner::feed_forward(const FopdtModel &model) const {
+    if (!_feed_forward || !active()) return 0;
+    if (!std::isfinite(model.gain) || model.gain == 0 || !(model.time_constant > 0)) return 0;
+
+    // Slope is zero on hold and after the end
+    return (_status.slope * model.time_constant + _status.setpoint - _origin) / model.gain;
+}
+
+void ProgramRunner::begin(const SetpointProgram &program, float start_value, uint32_t now) {
+    _count = 0;
+    _clock = 0;
+    _held = 0;
+    _piece = 0;
+    _last_time = now;
+    _status = {};
+
+    if (program.count == 0 || !program.valid()) {
+        D_PRINT("Program: empty or invalid");
+        _status.state = ProgramState::PROGRAM_FAILED;
+        return;
+    }
+
+    float previous = std::isfinite(start_value) ? start_value : program.segments[0].target;
+    uint64_t time = 0;
+
+    for (uint8_t i = 0; i < program.count; ++i) {
+        const auto &segment = program.segments[i];
+        const float delta = segment.target - previous;
+
+        if (segment.rate > 0 && delta != 0) {
+            // Clamped before the cast: a ramp that doesn't fit fails the length check below
+            const double length_ms = std::round(std::abs((double) segment.target - previous) / segment.rate * 1000);
+            const auto length = (uint64_t) std::clamp(length_ms, 1.0, (double) UINT32_MAX + 1);
+            _add_piece(time, previous, delta / (float) length, segment, i, true);
+            time += length;
+        }
+
+        if (segment.soak > 0) {
+            _add_piece(time, segment.target, 0, segment, i, false);
+            time += (uint64_t) segment.soak * 1000;
+        }
+
+        previous = segment.target;
+    }
+
+    if (time > UINT32_MAX) {
+        D_PRINT("Program: too long");
+        _count = 0;
+        _status.state = ProgramState::PROGRAM_FAILED;
+        return;
+    }
+
+    _duration = (uint32_t) time;
+    _origin = std::isfinite(start_value) ? start_value : program.segments[0].target;
+    _final = previous;
+    _feed_forward = program.feed_forward;
+    _build_index();
+
+    _status.state = ProgramState::PROGRAM_RUNNING;
+    _status.count = program.count;
+    _status.duration = (_duration + 999) / 1000;
+    _evaluate();
+
+    D_PRINTF("Program: %u segments, %u pieces, %lu s\r\n", program.count, _count, (unsigned long) _status.duration);
+}
+
+void ProgramRunner::stop() {
+    _count = 0;
+
+    // Failure stays reported until the next start
+    if (_status.state != ProgramState::PROGRAM_FAILED) _status = {};
+}
+
+void ProgramRunner::update(uint32_t now, float value) {
+    if (!running()) return;
+
+    const uint32_t elapsed = now - _last_time;
+    _last_time = now;
+
+    // Band of the piece the previous setpoint was evaluated on
+    const auto &piece = _pieces[_piece];
+    const bool hold = piece.hold_band > 0 && std::isfinite(value)
+                      && std::abs(value - _status.setpoint) > piece.hold_band;
+
+    if (hold) {
+        _held += elapsed;
+    } else {
+        _clock = (uint32_t) std::min<uint64_t>((uint64_t) _clock + elapsed, _duration);
+    }
+
+    _status.state = hold ? ProgramState::PROGRAM_HOLD : ProgramState::PROGRAM_RUNNING;
+    _evaluate();
+}
+
+void ProgramRunner::_add_piece(uint32_t start, float from, float slope, const ProgramSegment &segment,
+                               uint8_t index, bool ramp) {
+    _pieces[_count++] = {
+        .start = start,
+        .from = from,
+        .slope = slope,
+        .hold_band = segment.hold_band,
+        .segment = index,
+        .ramp = ramp
+    };
+}
+
+void ProgramRunner::_build_index() {
+    _bucket = std::max<uint32_t>(1, _duration / PROGRAM_INDEX_SIZE + (_duration % PROGRAM_INDEX_SIZE != 0));
+
+    uint8_t piece = 0;
+    for (size_t i = 0; i < PROGRAM_INDEX_SIZE; ++i) {
+        const uint64_t time = (uint64_t) i * _bucket;
+        while (piece + 1 < _count && _pieces[piece + 1].start <= time) ++piece;
+
+        _index[i] = piece;
+    }
+}
+
+uint8_t ProgramRunner::_find(uint32_t time) const {
+    // Bucket holds at most a few piece boundaries unless the program has many short pieces
+    uint8_t piece = _index[std::min<uint32_t>(time / _bucket, PROGRAM_INDEX_SIZE - 1)];
+    while (piece + 1 < _count && _pieces[piece + 1].start <= time) ++piece;
+
+    return piece;
+}
+
+void ProgramRunner::_evaluate() {
+    _status.elapsed = _clock / 1000;
+    _status.held = _held / 1000;
+
+    if (_clock >= _duration) {
+        _status.state = ProgramState::PROGRAM_DONE;
+        _status.segment = _status.count - 1;
+        _status.ramp = false;
+        _status.setpoint = _final;
+        _status.slope = 0;
+        return;
+    }
+
+    _piece = _find(_clock);
+    const auto &piece = _pieces[_piece];
+
+    _status.segment = piece.segment;
+    _status.ramp = piece.ramp;
+    _status.setpoint = piece.from + piece.slope * (float) (_clock - piece.start);
+    _status.slope = _status.state == ProgramState::PROGRAM_HOLD ? 0 : piece.slope * 1000;
+}
+
+static void program_path(uint8_t slot, char *out, size_t size) {
+    snprintf(out, size, "%s" PROGRAM_FILE, STORAGE_PATH, slot);
+}
+
+bool program_load(FS &fs, uint8_t slot, SetpointProgram &program) {
+    if (slot >= PROGRAM_SLOTS) return false;
+
+    char path[48];
+    program_path(slot, path, sizeof(path));
+    if (!fs.exists(path)) return false;
+
+    auto file = fs.open(path, FILE_READ);
+    if (!file) return false;
+
+    SetpointProgram loaded{};
+    const auto size = file.read((uint8_t *) &loaded, sizeof(loaded));
+    file.close();
+
+    if (size < offsetof(SetpointProgram, segments) || !loaded.valid() || size != loaded.size()) {
+        D_PRINTF("Program: invalid file %s\r\n", path);
+        return false;
+    }
+
+    program = loaded;
+    return true;
+}
+
+bool program_save(FS &fs, uint8_t slot, const SetpointProgram &program) {
+    if (slot >= PROGRAM_SLOTS || !program.valid()) return false;
+
+    char path[48];
+    program_path(slot, path, sizeof(path));
+
+    auto file = fs.open(path, FILE_WRITE, true);
+    if (!file) {
+        D_PRINTF("Program: unable to open %s\r\n", path);
+        return false;
+    }
+
+    const auto size = program.size();
+    const bool result = file.write((const uint8_t *) &program, size) == size;
+    file.close();
+
+    return result;
+}
+
+bool SetpointProgramParameter::set_value(const void *data, size_t size) {
+    if (size < offsetof(SetpointProgram, segments) || size > sizeof(SetpointProgram)) return false;
+
+    SetpointProgram program{};
+    memcpy(&program, data, size);
+    if (!program.valid() || size != program.size()) return false;
+
+    *_program = program;
+    return true;
+}
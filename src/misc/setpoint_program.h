@@ -0,0 +1,156 @@
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+#include <FS.h>
+
+#include <lib/base/parameter.h>
+
+#include "app/enum.h"
+#include "pid/tuning.h"
+#include "sys_constants.h"
+
+/**
+ * Ramp from the previous setpoint to `target`, then soak at it.
+ * The first segment ramps from the sensor value at program start.
+ */
+struct __attribute ((packed)) ProgramSegment {
+    float target = 0;     // Sensor units
+    float rate = 0;       // Ramp rate, units per second, at least PROGRAM_MIN_RATE; 0 steps to target at once
+    uint32_t soak = 0;    // Time at target after the ramp, seconds
+    float hold_band = 0;  // Program time stops while sensor is farther from setpoint, units; 0 never holds
+};
+
+struct __attribute ((packed)) SetpointProgram {
+    uint8_t count = 0;         // Used segments, up to PROGRAM_MAX_SEGMENTS
+    bool feed_forward = true;  // Add output the setpoint change needs per process model, see `ProgramRunner::feed_forward`
+    ProgramSegment segments[PROGRAM_MAX_SEGMENTS]{};
+
+    /**
+     * Bytes of used segments: programs are stored and transferred without unused ones.
+     */
+    [[nodiscard]] size_t size() const { return offsetof(SetpointProgram, segments) + count * sizeof(ProgramSegment); }
+
+    /**
+     * Segment count in range, finite targets, rates of 0 or at least PROGRAM_MIN_RATE, non-negative hold bands.
+     */
+    [[nodiscard]] bool valid() const;
+};
+
+struct __attribute ((packed)) ProgramStatus {
+    ProgramState state = ProgramState::PROGRAM_IDLE;
+    uint8_t count = 0;      // Segments of the running program
+    uint8_t segment = 0;    // Current segment
+    bool ramp = false;      // Ramping to segment target, soaking otherwise
+
+    uint32_t elapsed = 0;   // Program time, seconds; stands while on hold
+    uint32_t duration = 0;  // Program time of the whole program, seconds
+    uint32_t held = 0;      // Time spent on hold, seconds
+
+    float setpoint = NAN;
+    float slope = 0;        // Setpoint change, units per second
+};
+
+/**
+ * Program as a piecewise-linear setpoint over program time. Ramps and soaks are laid out once at start
+ * and an index of PROGRAM_INDEX_SIZE equal time buckets points to the piece each bucket begins in,
+ * so every tick finds its piece without scanning the program.
+ * Program time advances with wall time except while the sensor is outside the hold band of the current segment.
+ * After the last segment the final setpoint is kept until the program is stopped.
+ */
+class ProgramRunner {
+    struct Piece {
+        uint32_t start = 0;  // Program time, ms
+        float from = 0;      // Setpoint at start
+        float slope = 0;     // Units per ms
+        float hold_band = 0;
+        uint8_t segment = 0;
+        bool ramp = false;
+    };
+
+    std::array<Piece, PROGRAM_MAX_SEGMENTS * 2> _pieces{};
+    uint8_t _count = 0;
+    std::array<uint8_t, PROGRAM_INDEX_SIZE> _index{}; // First piece of each bucket
+    uint32_t _bucket = 1;                             // Bucket length, ms
+
+    uint32_t _duration = 0; // ms
+    float _origin = NAN;    // Setpoint at start
+    float _final = NAN;
+    bool _feed_forward = false;
+
+    uint32_t _clock = 0;    // Program time, ms
+    uint32_t _held = 0;     // ms
+    uint32_t _last_time = 0;
+    uint8_t _piece = 0;     // Piece at `_clock`
+
+    ProgramStatus _status{};
+
+public:
+    [[nodiscard]] const ProgramStatus &status() const { return _status; }
+
+    /**
+     * Program time is advancing or on hold.
+     */
+    [[nodiscard]] bool running() const {
+        return _status.state == ProgramState::PROGRAM_RUNNING || _status.state == ProgramState::PROGRAM_HOLD;
+    }
+
+    /**
+     * Program drives the setpoint: running, or finished and keeping its final setpoint.
+     */
+    [[nodiscard]] bool active() const { return running() || _status.state == ProgramState::PROGRAM_DONE; }
+
+    [[nodiscard]] float setpoint() const { return _status.setpoint; }
+
+    /**
+     * Output a first-order process needs on top of the one it had at program start to follow the setpoint:
+     * (τ · slope + setpoint - start setpoint) / K. PID integral keeps the output of the start and corrects model error.
+     * @return 0 if disabled by the program, program is not active or model is unusable
+     */
+    [[nodiscard]] float feed_forward(const FopdtModel &model) const;
+
+    /**
+     * @param start_value sensor value the first ramp starts from; NAN to start at the first target
+     * @param now ms
+     */
+    void begin(const SetpointProgram &program, float start_value, uint32_t now);
+    void stop();
+
+    /**
+     * Advance program time to `now` unless the sensor `value` is outside the hold band, and evaluate setpoint.
+     */
+    void update(uint32_t now, float value);
+
+private:
+    void _add_piece(uint32_t start, float from, float slope, const ProgramSegment &segment, uint8_t index, bool ramp);
+    void _build_index();
+    [[nodiscard]] uint8_t _find(uint32_t time) const;
+    void _evaluate();
+};
+
+/**
+ * Stored programs: one file per slot in LittleFS, holding used segments only.
+ * @return false if slot is empty or its file is not a valid program
+ */
+bool program_load(FS &fs, uint8_t slot, SetpointProgram &program);
+bool program_save(FS &fs, uint8_t slot, const SetpointProgram &program);
+
+/**
+ * Program of the selected slot, written as `SetpointProgram` with used segments only.
+ * Invalid programs are rejected; accepted ones are saved by the application.
+ */
+class SetpointProgramParameter : public AbstractParameter {
+    SetpointProgram *_program;
+
+public:
+    explicit SetpointProgramParameter(SetpointProgram *program) : _program(program) {}
+
+    bool set_value(const void *data, size_t size) override;
+
+    [[nodiscard]] const void *get_value() const override { return _program; }
+
+    [[nodiscard]] size_t size() const override { return _program->size(); }
+};
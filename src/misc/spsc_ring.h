@@ -0,0 +1,52 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Lock-free bounded queue for exactly one producer task and one consumer task.
+ *
+ * Producer never blocks or allocates: when the consumer falls behind and the ring is full,
+ * new item is discarded and counted in `dropped()`.
+ */
+template<typename T, size_t Capacity>
+class SpscRing {
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+    T _items[Capacity]{};
+
+    std::atomic<uint32_t> _head{0};    // Written by producer only
+    std::atomic<uint32_t> _tail{0};    // Written by consumer only
+    std::atomic<uint32_t> _dropped{0}; // Written by producer only
+
+public:
+    bool push(const T &item) {
+        const auto head = _head.load(std::memory_order_relaxed);
+        if (head - _tail.load(std::memory_order_acquire) == Capacity) {
+            _dropped.store(_dropped.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            return false;
+        }
+
+        _items[head & (Capacity - 1)] = item;
+        _head.store(head + 1, std::memory_order_release);
+
+        return true;
+    }
+
+    bool pop(T &item) {
+        const auto tail = _tail.load(std::memory_order_relaxed);
+        if (tail == _head.load(std::memory_order_acquire)) return false;
+
+        item = _items[tail & (Capacity - 1)];
+        _tail.store(tail + 1, std::memory_order_release);
+
+        return true;
+    }
+
+    [[nodiscard]] size_t size() const {
+        return _head.load(std::memory_order_acquire) - _tail.load(std::memory_order_acquire);
+    }
+
+    [[nodiscard]] uint32_t dropped() const { return _dropped.load(std::memory_order_relaxed); }
+};
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+/**
+ * Lock-free exchange of the latest value between one writer and one reader running in different tasks.
+ *
+ * Writer fills `back()` and publishes it, reader picks up the most recent published value with `update()`.
+ * Neither side blocks or waits for the other; values published between two reads are overwritten.
+ */
+template<typename T>
+class TripleBuffer {
+    static constexpr uint32_t DIRTY = 0x4;
+
+    T _buffers[3]{};
+
+    std::atomic<uint32_t> _middle{1}; // Buffer index exchanged between sides, DIRTY if not yet read
+    uint32_t _back = 0;               // Owned by writer
+    uint32_t _front = 2;              // Owned by reader
+
+public:
+    T &back() { return _buffers[_back]; }
+
+    void publish() {
+        _back = _middle.exchange(_back | DIRTY, std::memory_order_acq_rel) & ~DIRTY;
+    }
+
+    void write(const T &value) {
+        back() = value;
+        publish();
+    }
+
+    /**
+     * Swap in the latest published value.
+     * @return false if nothing was published since previous call
+     */
+    bool update() {
+        if ((_middle.load(std::memory_order_relaxed) & DIRTY) == 0) return false;
+
+        _front = _middle.exchange(_front, std::memory_order_acq_rel) & ~DIRTY;
+        return true;
+    }
+
+    [[nodiscard]] const T &front() const { return _buffers[_front]; }
+};
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+inline uint8_t *write_varint(uint8_t *out, uint32_t value) {
+    while (value >= 0x80) {
+        *out++ = (uint8_t) (value | 0x80);
+        value >>= 7;
+    }
+
+    *out++ = (uint8_t) value;
+    return out;
+}
+
+/**
+ * @return bytes consumed; 0 if `size` ends inside the value or it doesn't fit in 32 bits
+ */
+inline size_t read_varint(const uint8_t *data, size_t size, uint32_t &value) {
+    value = 0;
+    for (size_t i = 0; i < size && i < 5; ++i) {
+        value |= (uint32_t) (data[i] & 0x7f) << (7 * i);
+        if ((data[i] & 0x80) == 0) return i + 1;
+    }
+
+    return 0;
+}
+
+inline uint32_t zigzag(int32_t value) {
+    return ((uint32_t) value << 1) ^ (uint32_t) (value >> 31);
+}
+
+inline int32_t unzigzag(uint32_t value) {
+    return (int32_t) (value >> 1) ^ -(int32_t) (value & 1);
+}
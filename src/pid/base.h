@@ -0,0 +1,78 @@
+#pragma once
+
+#include <algorithm>
+
+#include "sys_constants.h"
+
+#include "app/config.h"
+
+#include "./fixed.h"
+
+/**
+ * Measured sampling period relative to nominal `interval`, Q(PID_DT_SCALE_BITS).
+ * Kept in fixed point so engines without FPU rescale coefficients with integer math only.
+ */
+using PidDtScale = Fixed<PID_DT_SCALE_BITS>;
+
+inline constexpr PidDtScale PID_DT_NOMINAL = PidDtScale::from_raw(PidDtScale::ONE);
+
+class PidBase {
+public:
+    /**
+     * Apply coefficients, limits and modes. Accumulated state is preserved.
+     */
+    virtual void configure(const PidConfig &config) = 0;
+
+    /**
+     * Change setpoint only, e.g. on every tick of a setpoint program or from an outer cascade loop.
+     * Unlike `configure` it keeps coefficients and measured sampling period.
+     */
+    virtual void set_target(float target) = 0;
+
+    /**
+     * Change output limits only, e.g. to leave room for a feed-forward added to the output.
+     * Limits set by the next `configure` replace them.
+     */
+    virtual void set_output_limits(float out_min, float out_max) = 0;
+
+    virtual void reset() = 0;
+
+    /**
+     * @param dt_scale actual sampling period relative to configured `interval`
+     * @return control output in range [out_min, out_max]
+     */
+    virtual float compute(float input, PidDtScale dt_scale) = 0;
+
+    /**
+     * @return integral term contribution to the last output
+     */
+    [[nodiscard]] virtual float integral() const = 0;
+
+    /**
+     * Copy accumulated state (integral, previous input and error) as opaque bytes.
+     * Engine configured the same way continues bit-exactly after `load_state`, e.g. when a sensor log is replayed.
+     * @param out buffer of PID_STATE_MAX_SIZE bytes
+     * @return state size
+     */
+    virtual size_t save_state(uint8_t *out) const = 0;
+
+    /**
+     * Replace accumulated state, coefficients applied by `configure` are kept.
+     * @return false if state was saved by a different engine
+     */
+    virtual bool load_state(const uint8_t *data, size_t size) = 0;
+
+    virtual ~PidBase() = default;
+};
+
+/**
+ * Measured sampling period relative to nominal `interval`, as passed to `PidBase::compute`.
+ */
+inline PidDtScale pid_dt_scale(uint32_t period_us, uint16_t interval) {
+    const uint32_t nominal = interval * 1000u;
+    if (nominal == 0) return PID_DT_NOMINAL;
+
+    // At least one raw unit: engines divide gains by the scale
+    const uint64_t ratio = ((uint64_t) period_us << PID_DT_SCALE_BITS) / nominal;
+    return PidDtScale::from_raw((int32_t) std::clamp<uint64_t>(ratio, 1, (uint64_t) PID_DT_SCALE_MAX << PID_DT_SCALE_BITS));
+}
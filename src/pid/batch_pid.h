@@ -0,0 +1,182 @@
+#pragma once
+
+#include <vector>
+
+#include "./specialized_pid.h"
+
+/**
+ * Structure-of-arrays state of float PID lanes: one array per coefficient and state variable.
+ */
+struct PidBatchLanes {
+    std::vector<float> kp, ki, kd, kbc;
+    std::vector<float> setpoint, out_min, out_max;
+
+    std::vector<float> integral, p_sum, prev_error, prev_input;
+
+    void resize(size_t size) {
+        for (auto *array: {&kp, &ki, &kd, &kbc, &setpoint, &out_min, &out_max,
+                           &integral, &p_sum, &prev_error, &prev_input}) {
+            array->assign(size, 0.f);
+        }
+    }
+};
+
+/**
+ * `pid_kernel<FloatPidTraits, Mode>` over every lane at once. Each lane performs the same operations in the same order
+ * as the scalar kernel, branches are replaced by selects, so the loop vectorizes and results are bit-identical
+ * (as long as floating point contraction is disabled). Sampling period is nominal, `dt_scale` is always 1.
+ */
+template<uint8_t Mode, bool Initialized>
+void pid_batch_lanes(PidBatchLanes &lanes, size_t size, const float *__restrict input, float *__restrict output) {
+    const float *__restrict kp = lanes.kp.data();
+    const float *__restrict ki = lanes.ki.data();
+    const float *__restrict kd = lanes.kd.data();
+    const float *__restrict kbc = lanes.kbc.data();
+    const float *__restrict setpoint = lanes.setpoint.data();
+    const float *__restrict out_min = lanes.out_min.data();
+    const float *__restrict out_max = lanes.out_max.data();
+
+    float *__restrict integral = lanes.integral.data();
+    float *__restrict p_sum = lanes.p_sum.data();
+    float *__restrict prev_error = lanes.prev_error.data();
+    float *__restrict prev_input = lanes.prev_input.data();
+
+    // Arrays of different lanes never overlap
+#pragma GCC ivdep
+    for (size_t i = 0; i < size; ++i) {
+        // Loads are unconditional, otherwise selects below turn into branches
+        const float x = input[i];
+        const float lo = out_min[i], hi = out_max[i];
+        const float last_input = prev_input[i], last_integral = integral[i];
+
+        float error = setpoint[i] - x;
+        float delta_input = Initialized ? x - last_input : 0.f;
+        if constexpr ((Mode & KERNEL_REVERSE) != 0) {
+            error = -error;
+            delta_input = -delta_input;
+        }
+
+        const float stored_error = prev_error[i];
+        const float last_error = Initialized ? stored_error : error;
+
+        float p;
+        if constexpr ((Mode & KERNEL_P_INPUT) != 0) {
+            const float sum = p_sum[i] - kp[i] * delta_input;
+            p = sum > hi ? hi : sum < lo ? lo : sum;
+            p_sum[i] = p;
+        } else {
+            p = kp[i] * error;
+        }
+
+        float d;
+        if constexpr ((Mode & KERNEL_D_INPUT) != 0) d = -(kd[i] * delta_input);
+        else d = kd[i] * (error - last_error);
+
+        float acc = last_integral + ki[i] * error;
+
+        float out = p + acc + d;
+
+        if constexpr ((Mode & KERNEL_I_SATURATE) != 0) {
+            const bool saturated = ((out > hi) & (error > 0.f)) | ((out < lo) & (error < 0.f));
+            const float frozen = p + last_integral + d;
+
+            acc = saturated ? last_integral : acc;
+            out = saturated ? frozen : out;
+        }
+
+        const float limited = out > hi ? hi : out < lo ? lo : out;
+        if constexpr ((Mode & KERNEL_I_BACK_CALC) != 0) {
+            acc += kbc[i] * (limited - out);
+        }
+
+        if constexpr ((Mode & KERNEL_I_RESET) != 0) {
+            const bool crossed = ((error > 0.f) & (last_error < 0.f)) | ((error < 0.f) & (last_error > 0.f));
+            acc = crossed ? 0.f : acc;
+        }
+
+        integral[i] = acc;
+        prev_error[i] = error;
+        prev_input[i] = x;
+
+        output[i] = limited;
+    }
+}
+
+template<uint8_t Mode>
+void pid_batch_kernel(PidBatchLanes &lanes, size_t size, bool initialized, const float *input, float *output) {
+    if (initialized) pid_batch_lanes<Mode, true>(lanes, size, input, output);
+    else pid_batch_lanes<Mode, false>(lanes, size, input, output);
+}
+
+using PidBatchKernelFn = void (*)(PidBatchLanes &, size_t, bool, const float *, float *);
+
+template<size_t... Modes>
+constexpr auto make_pid_batch_kernel_table(std::index_sequence<Modes...>) {
+    return std::array<PidBatchKernelFn, sizeof...(Modes)>{&pid_batch_kernel<(uint8_t) Modes>...};
+}
+
+inline constexpr auto PID_BATCH_KERNEL_TABLE = make_pid_batch_kernel_table(std::make_index_sequence<KERNEL_MODE_COUNT>{});
+
+/**
+ * Many independent float PIDs advanced in lockstep, e.g. candidate gain sets of a tuning sweep.
+ * Lanes may differ in coefficients, setpoint and limits; modes are shared and taken from the first configured lane.
+ */
+class PidBatch {
+    PidBatchLanes _lanes;
+    size_t _size;
+
+    bool _has_mode = false;
+    uint8_t _mode = 0;
+    bool _initialized = false;
+
+    PidBatchKernelFn _kernel = &pid_batch_kernel<0>;
+
+public:
+    explicit PidBatch(size_t size) : _size(size) { _lanes.resize(size); }
+
+    [[nodiscard]] size_t size() const { return _size; }
+    [[nodiscard]] uint8_t mode() const { return _mode; }
+
+    /**
+     * Set lane coefficients. Unlike `KernelPid::configure` accumulated integral is not rescaled: configure before run.
+     * @return false if lane modes differ from the batch modes
+     */
+    bool configure(size_t lane, const PidConfig &config) {
+        const auto params = pid_kernel_params<FloatPidTraits>(config);
+        if (lane >= _size || (_has_mode && params.mode != _mode)) return false;
+
+        if (!_has_mode) {
+            _has_mode = true;
+            _mode = params.mode;
+            _kernel = PID_BATCH_KERNEL_TABLE[_mode];
+        }
+
+        _lanes.kp[lane] = params.kp;
+        _lanes.ki[lane] = params.ki;
+        _lanes.kd[lane] = params.kd;
+        _lanes.kbc[lane] = params.kbc;
+        _lanes.setpoint[lane] = params.setpoint;
+        _lanes.out_min[lane] = params.out_min;
+        _lanes.out_max[lane] = params.out_max;
+
+        return true;
+    }
+
+    void reset() {
+        for (auto *array: {&_lanes.integral, &_lanes.p_sum, &_lanes.prev_error, &_lanes.prev_input}) {
+            array->assign(_size, 0.f);
+        }
+
+        _initialized = false;
+    }
+
+    /**
+     * Compute output of every lane from its input. Arrays must hold `size()` values and must not overlap.
+     */
+    void compute(const float *input, float *output) {
+        _kernel(_lanes, _size, _initialized, input, output);
+        _initialized = true;
+    }
+
+    [[nodiscard]] const float *integral() const { return _lanes.integral.data(); }
+};
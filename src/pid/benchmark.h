@@ -0,0 +1,78 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+
+#include <Arduino.h>
+
+#include "./base.h"
+
+struct PidBenchmarkResult {
+    uint32_t iterations;
+    uint32_t total_cycles;
+    float cycles_per_tick;
+    float checksum; // Sum of outputs, keeps compute from being optimized out and allows comparing engines
+};
+
+/**
+ * Mean and sample standard deviation of repeated benchmark rounds.
+ */
+struct PidBenchmarkStats {
+    uint32_t rounds = 0;
+    double sum = 0;
+    double sum_sq = 0;
+
+    void add(double value) {
+        ++rounds;
+        sum += value;
+        sum_sq += value * value;
+    }
+
+    [[nodiscard]] double mean() const { return rounds ? sum / rounds : 0; }
+    [[nodiscard]] double stddev() const {
+        if (rounds < 2) return 0;
+        return std::sqrt(std::max(0., (sum_sq - sum * sum / rounds) / (rounds - 1)));
+    }
+};
+
+/**
+ * Run engine against synthetic input sweeping around setpoint and count CPU cycles per iteration.
+ * Loop is timed as a whole, so input generation is included but counter read overhead is not.
+ */
+inline PidBenchmarkResult pid_benchmark(PidBase &pid, const PidConfig &config, uint32_t iterations) {
+    pid.configure(config);
+    pid.reset();
+
+    const float amplitude = std::max(1.f, std::abs(config.target) * 0.1f);
+
+    float checksum = 0;
+    const auto start = ESP.getCycleCount();
+    for (uint32_t i = 0; i < iterations; ++i) {
+        // Triangle wave: exercises both signs of error and output saturation
+        const float phase = (float) (i % 256) / 128.f;
+        const float input = config.target + amplitude * (phase < 1 ? phase * 2 - 1 : 3 - phase * 2);
+
+        checksum += pid.compute(input, PID_DT_NOMINAL);
+    }
+
+    const uint32_t total_cycles = ESP.getCycleCount() - start;
+
+    return {
+        .iterations = iterations,
+        .total_cycles = total_cycles,
+        .cycles_per_tick = (float) total_cycles / (float) iterations,
+        .checksum = checksum,
+    };
+}
+
+/**
+ * Repeat `pid_benchmark`: a single round is easily skewed by an interrupt or cache state,
+ * so engines should only be compared when the difference exceeds the spread.
+ */
+inline PidBenchmarkStats pid_benchmark_rounds(PidBase &pid, const PidConfig &config, uint32_t iterations,
+                                              uint32_t rounds) {
+    PidBenchmarkStats stats;
+    for (uint32_t i = 0; i < rounds; ++i) stats.add(pid_benchmark(pid, config, iterations).cycles_per_tick);
+
+    return stats;
+}
@@ -0,0 +1,14 @@
+#pragma once
+
+#include <memory>
+
+#include "./fixed_pid.h"
+#include "./float_pid.h"
+#include "./specialized_pid.h"
+
+inline std::unique_ptr<PidBase> make_pid(PidEngine engine) {
+    if (engine == PidEngine::PID_FIXED) return std::make_unique<FixedPid<>>();
+    if (engine == PidEngine::PID_SPECIALIZED) return std::make_unique<SpecializedPid>();
+
+    return std::make_unique<FloatPid>();
+}
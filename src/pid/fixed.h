@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
+/**
+ * Signed 32-bit fixed-point value with `FracBits` fractional bits (Q(31-FracBits).FracBits).
+ * Arithmetic saturates instead of wrapping; products and sums use 64-bit intermediates.
+ */
+template<uint8_t FracBits>
+struct Fixed {
+    static_assert(FracBits > 0 && FracBits < 31, "FracBits must be in range [1, 30]");
+
+    static constexpr uint8_t FRAC_BITS = FracBits;
+    static constexpr int32_t ONE = (int32_t) 1 << FracBits;
+
+    static constexpr int32_t RAW_MAX = std::numeric_limits<int32_t>::max();
+    static constexpr int32_t RAW_MIN = std::numeric_limits<int32_t>::min();
+
+    int32_t raw = 0;
+
+    static constexpr Fixed from_raw(int32_t raw) { return Fixed{raw}; }
+    static constexpr Fixed saturate(int64_t raw) {
+        return Fixed{raw > RAW_MAX ? RAW_MAX : raw < RAW_MIN ? RAW_MIN : (int32_t) raw};
+    }
+
+    static Fixed from_float(float value) {
+        const float scaled = value * ONE;
+        if (std::isnan(scaled)) return {};
+        if (scaled >= (float) RAW_MAX) return from_raw(RAW_MAX);
+        if (scaled <= (float) RAW_MIN) return from_raw(RAW_MIN);
+
+        return from_raw((int32_t) lrintf(scaled));
+    }
+
+    [[nodiscard]] float to_float() const { return (float) raw / ONE; }
+
+    constexpr Fixed operator-() const { return saturate(-(int64_t) raw); }
+    constexpr Fixed operator+(Fixed other) const { return saturate((int64_t) raw + other.raw); }
+    constexpr Fixed operator-(Fixed other) const { return saturate((int64_t) raw - other.raw); }
+
+    Fixed &operator+=(Fixed other) { return *this = *this + other; }
+    Fixed &operator-=(Fixed other) { return *this = *this - other; }
+
+    constexpr bool operator<(Fixed other) const { return raw < other.raw; }
+    constexpr bool operator>(Fixed other) const { return raw > other.raw; }
+    constexpr bool operator==(Fixed other) const { return raw == other.raw; }
+    constexpr bool operator!=(Fixed other) const { return raw != other.raw; }
+};
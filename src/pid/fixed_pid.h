@@ -0,0 +1,40 @@
+#pragma once
+
+#include "./fixed.h"
+#include "./kernel.h"
+
+/**
+ * Integer-only kernel representation for targets without FPU.
+ *
+ * Signals use Q(31-FracBits).FracBits, coefficients use Q(31-GainBits).GainBits.
+ * `k_mul` and sampling period are folded into coefficients on `configure`, measured period is rescaled in Q-format,
+ * so `compute` has only two float conversions: input and output.
+ *
+ * Integral and proportional-on-input accumulators are kept at full product precision (FracBits + GainBits),
+ * so small errors multiplied by small coefficients are not lost to rounding.
+ */
+template<uint8_t FracBits, uint8_t GainBits>
+struct FixedPidTraits {
+    static_assert(FracBits + GainBits <= 48, "Accumulator requires at least 15 integer bits");
+
+    using Value = int64_t; // Q(FracBits), widened to keep differences of int32 values exact
+    using Gain = int32_t;  // Q(GainBits)
+    using Acc = int64_t;   // Q(FracBits + GainBits)
+
+    static Value value_from_float(float value) { return Fixed<FracBits>::from_float(value).raw; }
+    static float value_to_float(Value value) { return (float) value / (float) Fixed<FracBits>::ONE; }
+    static Gain gain_from_float(float value) { return Fixed<GainBits>::from_float(value).raw; }
+    static Gain gain_scale(Gain gain, PidDtScale scale) {
+        return Fixed<GainBits>::saturate(((int64_t) gain * scale.raw) >> PidDtScale::FRAC_BITS).raw;
+    }
+    static Gain gain_unscale(Gain gain, PidDtScale scale) {
+        return Fixed<GainBits>::saturate(((int64_t) gain << PidDtScale::FRAC_BITS) / scale.raw).raw;
+    }
+
+    static Acc mul(Gain gain, Value value) { return (Acc) gain * value; }
+    static Value to_value(Acc acc) { return acc >> GainBits; }
+    static Acc to_acc(Value value) { return value * ((Acc) 1 << GainBits); }
+};
+
+template<uint8_t FracBits = PID_FIXED_FRAC_BITS, uint8_t GainBits = PID_FIXED_GAIN_FRAC_BITS>
+using FixedPid = KernelPid<FixedPidTraits<FracBits, GainBits>>;
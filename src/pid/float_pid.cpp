@@ -0,0 +1,94 @@
+#include "float_pid.h"
+
+#include <cstring>
+#include <type_traits>
+
+void FloatPid::configure(const PidConfig &config) {
+    _config = config;
+    _k_mul = config.k_mul;
+    _interval = config.interval;
+    _dt = config.interval;
+
+    _pid.setpoint = config.target;
+
+    _pid.setKp(config.p);
+    _pid.setKi(config.i);
+    _pid.setKd(config.d);
+    _pid.setDt(config.interval);
+
+    // Set output limits
+    _pid.outMax = config.out_max * config.k_mul;
+    _pid.outMin = config.out_min * config.k_mul;
+
+    // Set back calculation coefficient
+    _pid.Kbc = config.kbc;
+
+    // Configure PID modes
+    uint8_t cfg = 0;
+    if (config.p_mode == ProportionalMode::P_INPUT) cfg |= P_INPUT;
+    else cfg |= P_ERROR;
+
+    if (config.i_mode == IntegralMode::I_KI_INSIDE) cfg |= I_KI_INSIDE;
+    else cfg |= I_KI_OUTSIDE;
+
+    if ((uint8_t) config.i_limit & (uint8_t) IntegralLimitMode::I_SATURATE) cfg |= I_SATURATE;
+    if ((uint8_t) config.i_limit & (uint8_t) IntegralLimitMode::I_BACK_CALC) cfg |= I_BACK_CALC;
+    if ((uint8_t) config.i_limit & (uint8_t) IntegralLimitMode::I_RESET) cfg |= I_RESET;
+
+    if (config.d_mode == DifferentialMode::D_INPUT) cfg |= D_INPUT;
+    else cfg |= D_ERROR;
+
+    if (config.direction == DirectionMode::PID_REVERSE) cfg |= PID_REVERSE;
+    else cfg |= PID_FORWARD;
+
+    _pid.setConfig(cfg);
+}
+
+void FloatPid::set_target(float target) {
+    _config.target = target;
+    _pid.setpoint = target;
+}
+
+void FloatPid::set_output_limits(float out_min, float out_max) {
+    _pid.outMax = out_max * _k_mul;
+    _pid.outMin = out_min * _k_mul;
+}
+
+float FloatPid::compute(float input, PidDtScale dt_scale) {
+    // uPID derives Ki and Kd scaling from dt, so update it only when measured period differs
+    const int64_t scaled = ((int64_t) _interval * dt_scale.raw + PidDtScale::ONE / 2) >> PidDtScale::FRAC_BITS;
+    auto dt = (uint16_t) std::max<int64_t>(1, scaled);
+    if (dt != _dt) {
+        _dt = dt;
+        _pid.setDt(dt);
+    }
+
+    return _pid.compute(input) / _k_mul;
+}
+
+// uPID keeps previous input and error in private members, so the whole object is copied along with current dt
+size_t FloatPid::save_state(uint8_t *out) const {
+    static_assert(std::is_trivially_copyable_v<uPID>);
+    static_assert(sizeof(_pid) + sizeof(_dt) <= PID_STATE_MAX_SIZE);
+
+    memcpy(out, &_pid, sizeof(_pid));
+    memcpy(out + sizeof(_pid), &_dt, sizeof(_dt));
+    return sizeof(_pid) + sizeof(_dt);
+}
+
+bool FloatPid::load_state(const uint8_t *data, size_t size) {
+    if (size != sizeof(_pid) + sizeof(_dt)) return false;
+
+    uint16_t dt;
+    memcpy(&_pid, data, sizeof(_pid));
+    memcpy(&dt, data + sizeof(_pid), sizeof(dt));
+
+    // Copied object carries coefficients of the saved engine: apply current ones back, then saved dt
+    configure(_config);
+    if (dt != _dt) {
+        _dt = dt;
+        _pid.setDt(dt);
+    }
+
+    return true;
+}
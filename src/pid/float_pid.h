@@ -0,0 +1,30 @@
+#pragma once
+
+#include <uPID.h>
+
+#include "./base.h"
+
+/**
+ * Soft-float engine backed by uPID. Output is computed in `k_mul` scaled units and divided back.
+ */
+class FloatPid : public PidBase {
+    uPID _pid;
+    PidConfig _config{};
+    float _k_mul = 1;
+
+    uint16_t _interval = 0;
+    uint16_t _dt = 0;
+
+public:
+    void configure(const PidConfig &config) override;
+    void set_target(float target) override;
+    void set_output_limits(float out_min, float out_max) override;
+    void reset() override { _pid.integral = 0; }
+
+    float compute(float input, PidDtScale dt_scale) override;
+
+    [[nodiscard]] float integral() const override { return _pid.integral / _k_mul * _pid.Ki; }
+
+    size_t save_state(uint8_t *out) const override;
+    bool load_state(const uint8_t *data, size_t size) override;
+};
@@ -0,0 +1,236 @@
+#pragma once
+
+#include <array>
+#include <cstring>
+#include <utility>
+
+#include "./base.h"
+
+/**
+ * Mode bits of PID kernel. Integral mode (Ki inside/outside) doesn't affect the kernel:
+ * integral is accumulated in output units and rescaled on configuration change instead.
+ */
+enum PidKernelMode : uint8_t {
+    KERNEL_P_INPUT = 1 << 0,
+    KERNEL_D_INPUT = 1 << 1,
+    KERNEL_REVERSE = 1 << 2,
+    KERNEL_I_SATURATE = 1 << 3,
+    KERNEL_I_BACK_CALC = 1 << 4,
+    KERNEL_I_RESET = 1 << 5,
+
+    KERNEL_MODE_COUNT = 1 << 6,
+
+    // Not a real mode: makes kernel read mode bits from parameters at runtime
+    KERNEL_RUNTIME_MODE = 1 << 7,
+};
+
+/**
+ * Numeric traits define representation used by the kernel:
+ *  - Value: signals (input, error, output)
+ *  - Gain: coefficients
+ *  - Acc: products of Gain and Value, integral accumulator
+ *
+ * Traits also provide conversions and `gain_scale`/`gain_unscale`, used only when measured sampling period differs from nominal.
+ */
+template<typename Traits>
+struct PidKernelParams {
+    typename Traits::Gain kp{}, ki{}, kd{}, kbc{};
+    typename Traits::Value setpoint{}, out_min{}, out_max{};
+    typename Traits::Acc acc_min{}, acc_max{};
+
+    uint8_t mode = 0;
+};
+
+template<typename Traits>
+struct PidKernelState {
+    typename Traits::Acc integral{}; // Integral term in output units
+    typename Traits::Acc p_sum{};    // Proportional-on-input accumulator
+
+    bool initialized = false;
+    typename Traits::Value prev_error{};
+    typename Traits::Value prev_input{};
+};
+
+template<uint8_t Mode, uint8_t Flag>
+inline bool pid_kernel_has(uint8_t runtime_mode) {
+    if constexpr ((Mode & KERNEL_RUNTIME_MODE) != 0) return (runtime_mode & Flag) != 0;
+    else return (Mode & Flag) != 0;
+}
+
+/**
+ * Single PID step. Every `if` on mode folds to a constant unless Mode contains KERNEL_RUNTIME_MODE.
+ * `dt_scale` is actual sampling period relative to nominal, it rescales integral and derivative coefficients.
+ */
+template<typename Traits, uint8_t Mode>
+float pid_kernel(PidKernelState<Traits> &s, const PidKernelParams<Traits> &k, float input, PidDtScale dt_scale) {
+    using Value = typename Traits::Value;
+    using Acc = typename Traits::Acc;
+
+    const Value x = Traits::value_from_float(input);
+
+    auto ki = k.ki;
+    auto kd = k.kd;
+    if (dt_scale != PID_DT_NOMINAL) {
+        ki = Traits::gain_scale(ki, dt_scale);
+        kd = Traits::gain_unscale(kd, dt_scale);
+    }
+
+    Value error = k.setpoint - x;
+    Value delta_input = s.initialized ? x - s.prev_input : Value{};
+    if (pid_kernel_has<Mode, KERNEL_REVERSE>(k.mode)) {
+        error = -error;
+        delta_input = -delta_input;
+    }
+
+    if (!s.initialized) {
+        s.prev_error = error;
+        s.initialized = true;
+    }
+
+    Value p;
+    if (pid_kernel_has<Mode, KERNEL_P_INPUT>(k.mode)) {
+        const Acc p_sum = s.p_sum - Traits::mul(k.kp, delta_input);
+        s.p_sum = p_sum > k.acc_max ? k.acc_max : p_sum < k.acc_min ? k.acc_min : p_sum;
+        p = Traits::to_value(s.p_sum);
+    } else {
+        p = Traits::to_value(Traits::mul(k.kp, error));
+    }
+
+    Value d;
+    if (pid_kernel_has<Mode, KERNEL_D_INPUT>(k.mode)) d = -Traits::to_value(Traits::mul(kd, delta_input));
+    else d = Traits::to_value(Traits::mul(kd, error - s.prev_error));
+
+    const Acc prev_integral = s.integral;
+    s.integral += Traits::mul(ki, error);
+
+    Value out = p + Traits::to_value(s.integral) + d;
+
+    // Conditional integration: freeze integral while output is saturated in the direction of error
+    if (pid_kernel_has<Mode, KERNEL_I_SATURATE>(k.mode)
+        && ((out > k.out_max && error > Value{}) || (out < k.out_min && error < Value{}))) {
+        s.integral = prev_integral;
+        out = p + Traits::to_value(s.integral) + d;
+    }
+
+    const Value limited = out > k.out_max ? k.out_max : out < k.out_min ? k.out_min : out;
+    if (pid_kernel_has<Mode, KERNEL_I_BACK_CALC>(k.mode)) {
+        s.integral += Traits::mul(k.kbc, limited - out);
+    }
+
+    // Reset integral when error changes sign, i.e. setpoint is reached
+    if (pid_kernel_has<Mode, KERNEL_I_RESET>(k.mode)
+        && ((error > Value{} && s.prev_error < Value{}) || (error < Value{} && s.prev_error > Value{}))) {
+        s.integral = Acc{};
+    }
+
+    s.prev_error = error;
+    s.prev_input = x;
+
+    return Traits::value_to_float(limited);
+}
+
+template<typename Traits>
+using PidKernelFn = float (*)(PidKernelState<Traits> &, const PidKernelParams<Traits> &, float, PidDtScale);
+
+template<typename Traits, size_t... Modes>
+constexpr auto make_pid_kernel_table(std::index_sequence<Modes...>) {
+    return std::array<PidKernelFn<Traits>, sizeof...(Modes)>{&pid_kernel<Traits, (uint8_t) Modes>...};
+}
+
+/**
+ * Kernel instantiation for every mode combination, indexed by PidKernelMode bits.
+ */
+template<typename Traits>
+inline constexpr auto PID_KERNEL_TABLE = make_pid_kernel_table<Traits>(std::make_index_sequence<KERNEL_MODE_COUNT>{});
+
+/**
+ * Kernel coefficients and mode bits for config: gains are prescaled by `k_mul` and nominal sampling period.
+ */
+template<typename Traits>
+PidKernelParams<Traits> pid_kernel_params(const PidConfig &config) {
+    const float dt = (float) config.interval / 1000.f;
+    const float k_out = 1.f / config.k_mul;
+
+    PidKernelParams<Traits> params;
+    params.kp = Traits::gain_from_float(config.p * k_out);
+    params.ki = Traits::gain_from_float(config.i * dt * k_out);
+    params.kd = Traits::gain_from_float(dt > 0 ? config.d / dt * k_out : 0);
+    params.kbc = Traits::gain_from_float(config.kbc);
+
+    params.setpoint = Traits::value_from_float(config.target);
+    params.out_min = Traits::value_from_float(config.out_min);
+    params.out_max = Traits::value_from_float(config.out_max);
+    params.acc_min = Traits::to_acc(params.out_min);
+    params.acc_max = Traits::to_acc(params.out_max);
+
+    const auto i_limit = (uint8_t) config.i_limit;
+
+    uint8_t mode = 0;
+    if (config.p_mode == ProportionalMode::P_INPUT) mode |= KERNEL_P_INPUT;
+    if (config.d_mode == DifferentialMode::D_INPUT) mode |= KERNEL_D_INPUT;
+    if (config.direction == DirectionMode::PID_REVERSE) mode |= KERNEL_REVERSE;
+    if (i_limit & (uint8_t) IntegralLimitMode::I_SATURATE) mode |= KERNEL_I_SATURATE;
+    if (i_limit & (uint8_t) IntegralLimitMode::I_BACK_CALC) mode |= KERNEL_I_BACK_CALC;
+    if (i_limit & (uint8_t) IntegralLimitMode::I_RESET) mode |= KERNEL_I_RESET;
+
+    params.mode = mode;
+    return params;
+}
+
+/**
+ * PID engine running kernel specialized for current modes. Kernel is picked once per `configure`.
+ * With `Specialized = false` it uses single kernel with runtime mode checks (for benchmarking).
+ */
+template<typename Traits, bool Specialized = true>
+class KernelPid : public PidBase {
+    PidKernelParams<Traits> _params{};
+    PidKernelState<Traits> _state{};
+
+    PidKernelFn<Traits> _kernel = &pid_kernel<Traits, 0>;
+
+public:
+    void configure(const PidConfig &config) override {
+        const auto params = pid_kernel_params<Traits>(config);
+
+        // With Ki outside of the integral the whole accumulated error is scaled by the new coefficient
+        if (config.i_mode == IntegralMode::I_KI_OUTSIDE && _params.ki != 0 && params.ki != _params.ki) {
+            _state.integral = (typename Traits::Acc) ((double) _state.integral * (double) params.ki / (double) _params.ki);
+        }
+
+        _params = params;
+
+        if constexpr (Specialized) _kernel = PID_KERNEL_TABLE<Traits>[_params.mode];
+        else _kernel = &pid_kernel<Traits, KERNEL_RUNTIME_MODE>;
+    }
+
+    void set_target(float target) override { _params.setpoint = Traits::value_from_float(target); }
+
+    void set_output_limits(float out_min, float out_max) override {
+        _params.out_min = Traits::value_from_float(out_min);
+        _params.out_max = Traits::value_from_float(out_max);
+        _params.acc_min = Traits::to_acc(_params.out_min);
+        _params.acc_max = Traits::to_acc(_params.out_max);
+    }
+
+    void reset() override { _state = {}; }
+
+    float compute(float input, PidDtScale dt_scale) override { return _kernel(_state, _params, input, dt_scale); }
+
+    [[nodiscard]] float integral() const override {
+        return Traits::value_to_float(Traits::to_value(_state.integral));
+    }
+
+    size_t save_state(uint8_t *out) const override {
+        static_assert(sizeof(_state) <= PID_STATE_MAX_SIZE);
+
+        memcpy(out, &_state, sizeof(_state));
+        return sizeof(_state);
+    }
+
+    bool load_state(const uint8_t *data, size_t size) override {
+        if (size != sizeof(_state)) return false;
+
+        memcpy(&_state, data, sizeof(_state));
+        return true;
+    }
+};
@@ -0,0 +1,198 @@
+#include "relay_autotune.h"
+
+#include <algorithm>
+
+#include "lib/debug.h"
+
+#include "app/config.h"
+
+void autotune_apply_rule(AutotuneResult &result, TuningRule rule, float k_mul) {
+    const auto gains = tune_pid(rule, result.ultimate_gain, result.ultimate_period, result.model);
+
+    result.p = gains.p * k_mul;
+    result.i = gains.i * k_mul;
+    result.d = gains.d * k_mul;
+}
+
+void RelayAutotune::begin(const AutotuneConfig &config, const PidConfig &pid_config, uint32_t now) {
+    _config = config;
+    _config.cycles = std::clamp<uint8_t>(_config.cycles, 2, AUTOTUNE_MAX_CYCLES - 1);
+
+    _result = {.state = AutotuneState::AUTOTUNE_RUNNING};
+
+    _k_mul = pid_config.k_mul;
+    _sign = pid_config.direction == DirectionMode::PID_REVERSE ? -1 : 1;
+    _target = _sign * pid_config.target;
+    _out_min = pid_config.out_min;
+    _out_max = pid_config.out_max;
+
+    _bias = (_out_min + _out_max) / 2;
+    _update_relay_levels();
+
+    _start_time = now;
+    _has_rise = false;
+    _cycle_count = 0;
+
+    _relay_high = true;
+    _peak_first = _peak_last = now;
+    _peak = INFINITY;
+
+    D_PRINTF("Autotune: started, relay %.2f..%.2f\r\n", _low, _high);
+}
+
+void RelayAutotune::stop() {
+    if (!running()) return;
+
+    _result.state = AutotuneState::AUTOTUNE_IDLE;
+    D_PRINT("Autotune: stopped");
+}
+
+float RelayAutotune::update(uint32_t now, float value) {
+    if (!running()) return 0;
+
+    if (now - _start_time > (uint32_t) _config.timeout * 60 * 1000) {
+        _fail("timeout");
+        return 0;
+    }
+
+    const float x = _sign * value;
+
+    // Track trough while heating and crest while cooling
+    if (_relay_high ? x < _peak : x > _peak) {
+        _peak = x;
+        _peak_first = _peak_last = now;
+    } else if (x == _peak) {
+        _peak_last = now;
+    }
+
+    if (_relay_high && x > _target + _config.hysteresis) {
+        _switch_relay(false, now, x);
+    } else if (!_relay_high && x < _target - _config.hysteresis) {
+        _switch_relay(true, now, x);
+    }
+
+    if (!running()) return 0;
+    return _relay_high ? _high : _low;
+}
+
+void RelayAutotune::_switch_relay(bool high, uint32_t now, float x) {
+    const uint32_t peak_time = _peak_first + (_peak_last - _peak_first) / 2;
+
+    if (high) {
+        if (_has_rise) _complete_cycle(now, _peak, peak_time - _fall_time);
+
+        _has_rise = true;
+        _rise_time = now;
+    } else {
+        _trough = _peak;
+        _trough_delay = peak_time - _rise_time;
+        _fall_time = now;
+    }
+
+    _relay_high = high;
+    _peak = x;
+    _peak_first = _peak_last = now;
+}
+
+void RelayAutotune::_update_relay_levels() {
+    _high = std::min(_out_max, _bias + _config.amplitude);
+    _low = std::max(_out_min, _bias - _config.amplitude);
+}
+
+void RelayAutotune::_complete_cycle(uint32_t now, float crest, uint32_t crest_delay) {
+    const auto period = (float) (now - _rise_time);
+    const auto high_time = (float) (_fall_time - _rise_time);
+    const auto low_time = (float) (now - _fall_time);
+
+    const float relay = (_high - _low) / 2;
+    _cycles[_cycle_count++] = {
+        .period = period,
+        .amplitude = (crest - _trough) / 2,
+        .relay = relay,
+        .delay = (float) (_trough_delay + crest_delay) / 2,
+    };
+
+    _result.cycles = _cycle_count;
+
+    D_PRINTF("Autotune: cycle %u, period %.1f s, amplitude %.3f, duty %.2f\r\n",
+             _cycle_count, period / 1000, (crest - _trough) / 2, high_time / period);
+
+    // Longer heating than cooling means bias is too low
+    _bias = std::clamp(_bias + relay * (high_time - low_time) / period, _out_min, _out_max);
+    _update_relay_levels();
+
+    if (_try_finish()) return;
+    if (_cycle_count >= AUTOTUNE_MAX_CYCLES) _fail("oscillation is not stable");
+}
+
+bool RelayAutotune::_try_finish() {
+    // First period starts from arbitrary state and is never used
+    if (_cycle_count < _config.cycles + 1) return false;
+
+    Cycle mean{};
+    float period_min = INFINITY, period_max = 0;
+    float amplitude_min = INFINITY, amplitude_max = 0;
+
+    for (uint8_t i = _cycle_count - _config.cycles; i < _cycle_count; ++i) {
+        const auto &cycle = _cycles[i];
+
+        mean.period += cycle.period;
+        mean.amplitude += cycle.amplitude;
+        mean.relay += cycle.relay;
+        mean.delay += cycle.delay;
+
+        period_min = std::min(period_min, cycle.period);
+        period_max = std::max(period_max, cycle.period);
+        amplitude_min = std::min(amplitude_min, cycle.amplitude);
+        amplitude_max = std::max(amplitude_max, cycle.amplitude);
+    }
+
+    const auto n = (float) _config.cycles;
+    mean = {mean.period / n, mean.amplitude / n, mean.relay / n, mean.delay / n};
+
+    if (period_max - period_min > AUTOTUNE_CONSISTENCY * mean.period) return false;
+    if (amplitude_max - amplitude_min > AUTOTUNE_CONSISTENCY * mean.amplitude) return false;
+
+    _finish(mean);
+    return true;
+}
+
+void RelayAutotune::_finish(const Cycle &mean) {
+    const float a = mean.amplitude;
+    const float h = _config.hysteresis;
+
+    if (a <= h) {
+        _fail("oscillation is within hysteresis");
+        return;
+    }
+
+    const float ku = 4 * mean.relay / ((float) M_PI * std::sqrt(a * a - h * h));
+    const float pu = mean.period / 1000;
+    const float omega = 2 * (float) M_PI / pu;
+
+    // Process phase at oscillation frequency is -π + asin(ε/a) (relay with hysteresis lags by asin(ε/a))
+    const float dead_time = mean.delay / 1000;
+    const float lag_phase = (float) M_PI - std::asin(h / a) - omega * dead_time;
+    const float phase = std::clamp(lag_phase, AUTOTUNE_MIN_PHASE, (float) M_PI_2 - AUTOTUNE_MIN_PHASE);
+    const float time_constant = std::tan(phase) / omega;
+
+    _result.state = AutotuneState::AUTOTUNE_DONE;
+    _result.ultimate_gain = ku;
+    _result.ultimate_period = pu;
+    _result.amplitude = a;
+    _result.model = {
+        .gain = std::sqrt(1 + omega * omega * time_constant * time_constant) * (float) M_PI * a / (4 * mean.relay),
+        .time_constant = time_constant,
+        .dead_time = dead_time,
+    };
+
+    autotune_apply_rule(_result, _config.rule, _k_mul);
+
+    D_PRINTF("Autotune: Ku %.4f, Pu %.1f s; K %.2f, tau %.1f s, theta %.1f s; kP %.4f, kI %.4f, kD %.4f\r\n",
+             ku, pu, _result.model.gain, time_constant, dead_time, _result.p, _result.i, _result.d);
+}
+
+void RelayAutotune::_fail(const char *reason) {
+    _result.state = AutotuneState::AUTOTUNE_FAILED;
+    D_PRINTF("Autotune: failed, %s\r\n", reason);
+}
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+
+#include "app/enum.h"
+#include "constants.h"
+#include "sys_constants.h"
+
+#include "./tuning.h"
+
+struct PidConfig;
+
+struct __attribute ((packed)) AutotuneConfig {
+    TuningRule rule = TuningRule::TUNING_ZIEGLER_NICHOLS;
+
+    float amplitude = AUTOTUNE_AMPLITUDE;   // Relay output swing around bias, fraction of full output
+    float hysteresis = AUTOTUNE_HYSTERESIS; // Relay switches at target ± hysteresis, sensor units
+    uint8_t cycles = AUTOTUNE_CYCLES;       // Consistent oscillation periods required
+    uint16_t timeout = AUTOTUNE_TIMEOUT;    // Minutes
+};
+
+struct __attribute ((packed)) AutotuneResult {
+    AutotuneState state = AutotuneState::AUTOTUNE_IDLE;
+    uint8_t cycles = 0;           // Completed oscillation periods
+
+    float ultimate_gain = NAN;    // Ku, full output per sensor unit
+    float ultimate_period = NAN;  // Pu, seconds
+    float amplitude = NAN;        // Process oscillation amplitude, sensor units
+
+    FopdtModel model{};           // Approximated from ultimate point and delay of process peaks
+
+    float p = NAN;                // Proposed gains for configured rule, in PidConfig units
+    float i = NAN;
+    float d = NAN;
+};
+
+/**
+ * Fill proposed gains of `result` using `rule`. Gains are scaled by output multiplier `k_mul`.
+ */
+void autotune_apply_rule(AutotuneResult &result, TuningRule rule, float k_mul);
+
+/**
+ * Åström–Hägglund relay feedback experiment.
+ *
+ * Output switches between bias ± amplitude whenever the error changes sign beyond hysteresis, which makes the process
+ * oscillate at its ultimate frequency. Bias is adjusted after every period to equalize both half-periods, so the
+ * oscillation is centered around the setpoint. When the last `cycles` periods agree, ultimate gain is
+ * Ku = 4d / (π √(a² - ε²)) for relay amplitude d, process amplitude a and hysteresis ε.
+ *
+ * FOPDT model is fitted to the ultimate point: dead time is the delay between a relay switch and the following
+ * process peak, time constant and gain follow from the phase and magnitude conditions at ω = 2π / Pu.
+ */
+class RelayAutotune {
+    AutotuneConfig _config{};
+    AutotuneResult _result{};
+
+    float _k_mul = 1;
+    float _sign = 1;   // -1 for reverse direction: all tracking is done on sign * value
+    float _target = 0;
+    float _out_min = 0, _out_max = 1;
+
+    float _bias = 0;
+    float _high = 0, _low = 0;
+    bool _relay_high = false;
+
+    uint32_t _start_time = 0;
+    bool _has_rise = false;
+    uint32_t _rise_time = 0;
+    uint32_t _fall_time = 0;
+
+    // Extremum of the current half-period: first and last time it was seen, for quantized sensors
+    float _peak = 0;
+    uint32_t _peak_first = 0, _peak_last = 0;
+
+    // Minimum of the last high half-period and its delay after the rising switch
+    float _trough = 0;
+    uint32_t _trough_delay = 0;
+
+    struct Cycle {
+        float period;    // ms
+        float amplitude;
+        float relay;     // Relay amplitude d
+        float delay;     // ms
+    };
+
+    Cycle _cycles[AUTOTUNE_MAX_CYCLES]{};
+    uint8_t _cycle_count = 0;
+
+public:
+    [[nodiscard]] const AutotuneResult &result() const { return _result; }
+    [[nodiscard]] bool running() const { return _result.state == AutotuneState::AUTOTUNE_RUNNING; }
+
+    void begin(const AutotuneConfig &config, const PidConfig &pid_config, uint32_t now);
+    void stop();
+
+    /**
+     * @param now time of the sample, ms
+     * @return control output
+     */
+    float update(uint32_t now, float value);
+
+private:
+    void _switch_relay(bool high, uint32_t now, float x);
+    void _update_relay_levels();
+    void _complete_cycle(uint32_t now, float crest, uint32_t crest_delay);
+    bool _try_finish();
+    void _finish(const Cycle &mean);
+    void _fail(const char *reason);
+};
@@ -0,0 +1,48 @@
+#include "smith_predictor.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include "lib/debug.h"
+
+void SmithPredictor::configure(const SmithPredictorConfig &config, uint16_t interval) {
+    if (interval == _interval && memcmp(&config, &_config, sizeof(config)) == 0) return;
+
+    _config = config;
+    _interval = interval;
+
+    const auto &model = _config.model;
+    _active = _config.enabled && _interval > 0 && std::isfinite(model.gain)
+              && model.time_constant > 0 && model.dead_time >= 0;
+
+    if (_active) {
+        const float dt = (float) _interval / 1000;
+        _decay = std::exp(-dt / model.time_constant);
+        _step_gain = model.gain * (1 - _decay);
+
+        const long delay = std::lround(model.dead_time / dt);
+        _delay = (uint16_t) std::min<long>(delay, HISTORY_MASK);
+
+        if (delay > HISTORY_MASK) {
+            D_PRINTF("Smith predictor: dead time limited to %u intervals\r\n", HISTORY_MASK);
+        }
+    }
+
+    reset();
+}
+
+void SmithPredictor::reset() {
+    _model = 0;
+    _history.fill(0);
+    _head = 0;
+}
+
+void SmithPredictor::update(float output) {
+    if (!_active || !std::isfinite(output)) return;
+
+    _model = _decay * _model + _step_gain * output;
+
+    _head = (_head + 1) & HISTORY_MASK;
+    _history[_head] = _model;
+}
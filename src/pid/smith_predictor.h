@@ -0,0 +1,72 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+#include "sys_constants.h"
+
+#include "./tuning.h"
+
+struct __attribute ((packed)) SmithPredictorConfig {
+    bool enabled = false;
+    FopdtModel model{.gain = 1, .time_constant = 60, .dead_time = 0}; // Process from control output to sensor
+    bool model_valid = false; // Model was identified or entered, default one is only a placeholder
+};
+
+/**
+ * Dead-time compensation around PID. PID gets the measurement corrected by an internal FOPDT model,
+ * y + ym(t) - ym(t - θ): with an exact model the correction cancels the delayed response and adds the undelayed one,
+ * so PID controls the process as if it had no dead time and may be tuned for its time constant only.
+ * Model error and disturbances still reach PID through the measurement, so the loop keeps integral action.
+ *
+ * The model advances one nominal PID interval per sample; dead time is held in a fixed ring of model outputs,
+ * up to SMITH_PREDICTOR_HISTORY - 1 intervals.
+ */
+class SmithPredictor {
+    static_assert((SMITH_PREDICTOR_HISTORY & (SMITH_PREDICTOR_HISTORY - 1)) == 0, "History size must be a power of two");
+    static constexpr uint16_t HISTORY_MASK = SMITH_PREDICTOR_HISTORY - 1;
+
+    SmithPredictorConfig _config{};
+    uint16_t _interval = 0;
+
+    bool _active = false;
+    float _decay = 0;      // Model output kept over one interval, exp(-dt / τ)
+    float _step_gain = 0;  // K (1 - decay)
+    uint16_t _delay = 0;   // Dead time, intervals
+
+    float _model = 0;      // Undelayed model output, relative to the state at reset
+    std::array<float, SMITH_PREDICTOR_HISTORY> _history{}; // Undelayed model outputs of recent samples
+    uint16_t _head = 0;
+
+public:
+    [[nodiscard]] const SmithPredictorConfig &config() const { return _config; }
+
+    /**
+     * Enabled and model is usable: finite gain, positive time constant, non-negative dead time.
+     */
+    [[nodiscard]] bool active() const { return _active; }
+
+    /**
+     * Dead time in PID intervals, after rounding and limiting to the history size.
+     */
+    [[nodiscard]] uint16_t delay() const { return _delay; }
+
+    /**
+     * Apply model and PID interval. Model state is reset if anything changed.
+     */
+    void configure(const SmithPredictorConfig &config, uint16_t interval);
+
+    void reset();
+
+    /**
+     * @return value for PID: measured one plus correction of the model; measured one if not active
+     */
+    [[nodiscard]] float feedback(float value) const {
+        return _active ? value + _model - _history[(_head - _delay) & HISTORY_MASK] : value;
+    }
+
+    /**
+     * Advance model by one interval with control output applied to the process.
+     */
+    void update(float output);
+};
@@ -0,0 +1,24 @@
+#pragma once
+
+#include "./kernel.h"
+
+/**
+ * Float kernel representation. Same math as fixed-point engine, coefficients are prescaled by `k_mul` and dt.
+ */
+struct FloatPidTraits {
+    using Value = float;
+    using Gain = float;
+    using Acc = float;
+
+    static Value value_from_float(float value) { return value; }
+    static float value_to_float(Value value) { return value; }
+    static Gain gain_from_float(float value) { return value; }
+    static Gain gain_scale(Gain gain, PidDtScale scale) { return gain * scale.to_float(); }
+    static Gain gain_unscale(Gain gain, PidDtScale scale) { return gain / scale.to_float(); }
+
+    static Acc mul(Gain gain, Value value) { return gain * value; }
+    static Value to_value(Acc acc) { return acc; }
+    static Acc to_acc(Value value) { return value; }
+};
+
+using SpecializedPid = KernelPid<FloatPidTraits>;
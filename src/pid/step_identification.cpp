@@ -0,0 +1,148 @@
+#include "step_identification.h"
+
+#include <algorithm>
+
+#include "lib/debug.h"
+
+#include "sys_constants.h"
+
+void identification_apply_rule(IdentificationResult &result, TuningRule rule, float k_mul) {
+    float ultimate_gain = NAN, ultimate_period = NAN;
+    fopdt_ultimate_point(result.model, ultimate_gain, ultimate_period);
+
+    const auto gains = tune_pid(rule, ultimate_gain, ultimate_period, result.model);
+
+    result.p = gains.p * k_mul;
+    result.i = gains.i * k_mul;
+    result.d = gains.d * k_mul;
+}
+
+void StepIdentification::begin(const IdentificationConfig &config, uint32_t now) {
+    _config = config;
+    _result = {};
+    _filtered = NAN;
+    _start_time = now;
+
+    _start_phase(IdentificationState::IDENT_BASELINE, now);
+
+    D_PRINTF("Identification: started, step %.2f -> %.2f\r\n", _config.output_from, _config.output_to);
+}
+
+void StepIdentification::stop() {
+    if (!running()) return;
+
+    _result.state = IdentificationState::IDENT_IDLE;
+    D_PRINT("Identification: stopped");
+}
+
+float StepIdentification::update(uint32_t now, float value) {
+    if (!running()) return 0;
+
+    const float dt = (float) (now - _last_time) / 1000;
+    _last_time = now;
+
+    // Low-pass filtered value is used only to detect steady state, model is fitted from raw samples
+    const float filter_time = (float) _config.settle_time / IDENT_FILTER_DIVIDER;
+    if (std::isnan(_filtered)) _filtered = value;
+    else _filtered += (value - _filtered) * std::min(1.f, dt / std::max(filter_time, 1e-3f));
+
+    _result.elapsed = (now - _phase_start) / 1000;
+    _result.final_value = _filtered;
+
+    if (now - _start_time > (uint32_t) _config.timeout * 60 * 1000) {
+        _fail("timeout");
+        return 0;
+    }
+
+    if (_result.state == IdentificationState::IDENT_BASELINE) {
+        if (_settled(now)) {
+            _result.initial_value = _filtered;
+            _start_phase(IdentificationState::IDENT_STEP, now);
+
+            D_PRINTF("Identification: baseline %.3f, step applied\r\n", _result.initial_value);
+            return _config.output_to;
+        }
+
+        return _config.output_from;
+    }
+
+    // Trapezoidal integration of the deviation from baseline
+    const float y = value - _result.initial_value;
+    const float t = (float) (now - _phase_start) / 1000;
+
+    _sum_y += (double) (y + _last_y) / 2 * dt;
+    _last_y = y;
+
+    if (std::isnan(_response_time) && std::abs(y) >= _config.settle_band) _response_time = t;
+
+    // With long dead time the sensor doesn't move at first, which must not be taken for steady state
+    if (!std::isnan(_response_time) && _settled(now)) {
+        _finish();
+        return 0;
+    }
+
+    return _config.output_to;
+}
+
+bool StepIdentification::_settled(uint32_t now) {
+    if (now - _window_start < (uint32_t) _config.settle_time * 1000) return false;
+
+    if (std::abs(_filtered - _window_value) < _config.settle_band) return true;
+
+    _window_start = now;
+    _window_value = _filtered;
+    return false;
+}
+
+void StepIdentification::_start_phase(IdentificationState state, uint32_t now) {
+    _result.state = state;
+    _result.elapsed = 0;
+
+    _phase_start = now;
+    _last_time = now;
+
+    _window_start = now;
+    _window_value = _filtered;
+
+    _sum_y = 0;
+    _last_y = 0;
+    _response_time = NAN;
+}
+
+void StepIdentification::_finish() {
+    const float duration = _result.elapsed;
+    const double delta = (double) _result.final_value - _result.initial_value;
+    const float step = _config.output_to - _config.output_from;
+
+    if (std::abs(delta) < _config.settle_band || std::abs(step) < 1e-3f) {
+        _fail("no response to step");
+        return;
+    }
+
+    // Area above the response: θ + τ
+    const double m0 = duration - _sum_y / delta;
+
+    // Response leaves the band at θ + τ r, where r = -ln(1 - band / |Δy|)
+    const double r = -std::log(1 - _config.settle_band / std::abs(delta));
+    const double time_constant = (m0 - _response_time) / (1 - r);
+
+    if (!(m0 > 0) || !(time_constant > 0)) {
+        _fail("response doesn't fit first-order model");
+        return;
+    }
+
+    _result.state = IdentificationState::IDENT_DONE;
+    _result.model = {
+        .gain = (float) (delta / step),
+        .time_constant = (float) std::min(time_constant, m0),
+        .dead_time = (float) std::max(0.0, m0 - time_constant),
+    };
+
+    D_PRINTF("Identification: K %.3f, tau %.1f s, theta %.1f s\r\n",
+             _result.model.gain, _result.model.time_constant, _result.model.dead_time);
+}
+
+void StepIdentification::_fail(const char *reason) {
+    _result.state = IdentificationState::IDENT_FAILED;
+    D_PRINTF("Identification: failed, %s\r\n", reason);
+}
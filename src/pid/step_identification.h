@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+
+#include "app/enum.h"
+#include "constants.h"
+
+#include "./tuning.h"
+
+struct __attribute ((packed)) IdentificationConfig {
+    float output_from = IDENT_OUTPUT_FROM;  // Output held until sensor settles, fraction of full output
+    float output_to = IDENT_OUTPUT_TO;      // Step output, fraction of full output
+    float settle_band = IDENT_SETTLE_BAND;  // Sensor is settled if filtered value moves less over settle time, sensor units
+    uint16_t settle_time = IDENT_SETTLE_TIME; // Seconds
+    uint16_t timeout = IDENT_TIMEOUT;       // Minutes
+};
+
+struct __attribute ((packed)) IdentificationResult {
+    IdentificationState state = IdentificationState::IDENT_IDLE;
+    uint32_t elapsed = 0;          // Seconds since start of current phase
+
+    float initial_value = NAN;     // Settled sensor value before step
+    float final_value = NAN;       // Settled sensor value after step, latest filtered value while running
+
+    FopdtModel model{};
+
+    float p = NAN;                 // Gains seeded from model by configured rule, in PidConfig units
+    float i = NAN;
+    float d = NAN;
+};
+
+/**
+ * Fill seeded gains of `result` from its model using `rule`. Gains are scaled by output multiplier `k_mul`.
+ */
+void identification_apply_rule(IdentificationResult &result, TuningRule rule, float k_mul);
+
+/**
+ * Open-loop step test with FOPDT fit by the area method.
+ *
+ * For a step response Y(t) of K e^(-θs) / (τs + 1) with final value Y∞, the area above the response is
+ * ∫ (Y∞ - Y) dt = Y∞ (θ + τ). Over [0, T] it equals Y∞ T - ∫ Y dt, so a single running sum is kept
+ * and Y∞ is needed only at the end. Dead time is separated from the sum using the time the response
+ * leaves the settle band, which is θ + τ r for r = -ln(1 - band / |Y∞|).
+ */
+class StepIdentification {
+    IdentificationConfig _config{};
+    IdentificationResult _result{};
+
+    uint32_t _start_time = 0;
+    uint32_t _phase_start = 0;
+
+    float _filtered = NAN;
+    uint32_t _last_time = 0;
+
+    uint32_t _window_start = 0;
+    float _window_value = NAN;
+
+    double _sum_y = 0;        // ∫ Y dt
+    float _last_y = 0;
+    float _response_time = NAN; // Time the response left the settle band
+
+public:
+    [[nodiscard]] const IdentificationResult &result() const { return _result; }
+    [[nodiscard]] bool running() const {
+        return _result.state == IdentificationState::IDENT_BASELINE || _result.state == IdentificationState::IDENT_STEP;
+    }
+
+    void begin(const IdentificationConfig &config, uint32_t now);
+    void stop();
+
+    /**
+     * @param now time of the sample, ms
+     * @return control output
+     */
+    float update(uint32_t now, float value);
+
+private:
+    bool _settled(uint32_t now);
+    void _start_phase(IdentificationState state, uint32_t now);
+    void _finish();
+    void _fail(const char *reason);
+};
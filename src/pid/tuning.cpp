@@ -0,0 +1,54 @@
+#include "tuning.h"
+
+PidGains tune_pid(TuningRule rule, float ultimate_gain, float ultimate_period, const FopdtModel &model) {
+    if (rule == TuningRule::TUNING_SIMC) return tune_simc(model, model.dead_time);
+
+    if (!(ultimate_gain > 0) || !(ultimate_period > 0)) return {};
+
+    float kp, ti, td;
+    if (rule == TuningRule::TUNING_TYREUS_LUYBEN) {
+        kp = ultimate_gain / 2.2f;
+        ti = 2.2f * ultimate_period;
+        td = ultimate_period / 6.3f;
+    } else {
+        kp = 0.6f * ultimate_gain;
+        ti = ultimate_period / 2;
+        td = ultimate_period / 8;
+    }
+
+    return {.p = kp, .i = kp / ti, .d = kp * td};
+}
+
+bool fopdt_ultimate_point(const FopdtModel &model, float &ultimate_gain, float &ultimate_period) {
+    const float gain = std::abs(model.gain);
+    if (!(gain > 0) || !(model.time_constant >= 0) || !(model.dead_time > 0)) return false;
+
+    // Phase lag grows monotonically with ω and passes π below π / θ
+    float low = 0, high = (float) M_PI / model.dead_time;
+    for (int i = 0; i < 32; ++i) {
+        const float omega = (low + high) / 2;
+        const float lag = std::atan(omega * model.time_constant) + omega * model.dead_time;
+
+        if (lag < (float) M_PI) low = omega;
+        else high = omega;
+    }
+
+    const float omega = (low + high) / 2;
+    const float wt = omega * model.time_constant;
+
+    ultimate_gain = std::sqrt(1 + wt * wt) / gain;
+    ultimate_period = 2 * (float) M_PI / omega;
+    return true;
+}
+
+PidGains tune_simc(const FopdtModel &model, float closed_loop_time) {
+    const float gain = std::abs(model.gain);
+    if (!(gain > 0) || !(model.time_constant > 0) || !(model.dead_time >= 0)) return {};
+
+    const float lag = std::max(closed_loop_time + model.dead_time, 1e-3f);
+
+    const float kp = model.time_constant / (gain * lag);
+    const float ti = std::min(model.time_constant, 4 * lag);
+
+    return {.p = kp, .i = kp / ti, .d = 0};
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cmath>
+
+#include "app/enum.h"
+
+/**
+ * First-order-plus-dead-time process: K * exp(-θs) / (τs + 1).
+ * Gain is in sensor units per full control output, negative for reverse-acting process; tuning rules use its magnitude.
+ */
+struct __attribute ((packed)) FopdtModel {
+    float gain = NAN;          // K
+    float time_constant = NAN; // τ, seconds
+    float dead_time = NAN;     // θ, seconds
+};
+
+/**
+ * Gains in units of full control output: multiply by `PidConfig::k_mul` to get PID_P/PID_I/PID_D values.
+ * Integral gain is per second, differential gain in seconds, as expected by PID engines.
+ */
+struct PidGains {
+    float p = NAN;
+    float i = NAN;
+    float d = NAN;
+};
+
+/**
+ * Gains from ultimate gain and period of sustained oscillation (Ziegler–Nichols, Tyreus–Luyben)
+ * or from FOPDT model (SIMC). Returns NAN gains if required values are missing.
+ */
+PidGains tune_pid(TuningRule rule, float ultimate_gain, float ultimate_period, const FopdtModel &model);
+
+/**
+ * Ultimate gain and period of FOPDT model: frequency where phase lag reaches π, atan(ωτ) + ωθ = π.
+ * @return false if model has no dead time, so its phase never reaches π
+ */
+bool fopdt_ultimate_point(const FopdtModel &model, float &ultimate_gain, float &ultimate_period);
+
+/**
+ * Skogestad SIMC PI rule for FOPDT model: Kc = τ / (K (τc + θ)), Ti = min(τ, 4 (τc + θ)).
+ * @param closed_loop_time desired closed-loop time constant τc; dead time gives fast and robust response
+ */
+PidGains tune_simc(const FopdtModel &model, float closed_loop_time);
@@ -0,0 +1,205 @@
+#include "./analog_sensor.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include <driver/adc.h>
+
+#include "sys_constants.h"
+#include "lib/debug.h"
+
+#define ANALOG_ADC_BITS                         (12u)
+
+// Effective bits of an ideal `bits` ADC with the same RMS noise: its quantization noise is 1/sqrt(12) LSB
+static float noise_enob(float rms_lsb, uint8_t bits) {
+    if (rms_lsb <= 0) return bits;
+    return std::min<float>(bits, (float) bits - std::log2(rms_lsb * std::sqrt(12.f)));
+}
+
+void AnalogNoiseMeter::begin(uint32_t sample_rate, uint16_t decimation, uint8_t bits) {
+    _stats = {};
+    _stats.sample_rate = sample_rate;
+    _stats.decimation = decimation;
+
+    _bits = bits;
+    _count = 0;
+    _raw_sum = _raw_sq_sum = 0;
+    _raw_count = 0;
+    _value_sum = _value_sq_sum = 0;
+}
+
+bool AnalogNoiseMeter::add_value(uint32_t value) {
+    _value_sum += value;
+    _value_sq_sum += (uint64_t) value * value;
+    if (++_count < ANALOG_NOISE_WINDOW) return false;
+
+    auto rms = [](uint64_t sum, uint64_t sq_sum, uint32_t count) {
+        const double mean = (double) sum / count;
+        return (float) std::sqrt(std::max(0.0, (double) sq_sum / count - mean * mean));
+    };
+
+    const float raw_rms = rms(_raw_sum, _raw_sq_sum, std::max<uint32_t>(1, _raw_count));
+    const float value_rms = rms(_value_sum, _value_sq_sum, _count);
+
+    _stats.raw_rms = raw_rms;
+    _stats.value_rms = std::ldexp(value_rms, (int) ANALOG_ADC_BITS - _bits);
+    _stats.raw_enob = noise_enob(raw_rms, ANALOG_ADC_BITS);
+    _stats.enob = noise_enob(value_rms, _bits);
+    _stats.windows++;
+
+    _count = 0;
+    _raw_sum = _raw_sq_sum = 0;
+    _raw_count = 0;
+    _value_sum = _value_sq_sum = 0;
+
+    return true;
+}
+
+AnalogSensor::AnalogSensor(Timer &timer, const uint8_t *data) : _timer(timer) {
+    memcpy(&_config, data, sizeof(_config));
+}
+
+AnalogSensor::~AnalogSensor() {
+    if (!_continuous) return;
+
+    adc_digi_stop();
+    adc_digi_deinitialize();
+    _dma_in_use = false;
+}
+
+void AnalogSensor::begin() {
+    if (_config.continuous && _begin_continuous()) {
+        _timer.add_interval([this](auto) {
+            this->_drain();
+        }, ANALOG_DRAIN_INTERVAL);
+
+        return;
+    }
+
+    _max_value = 2 << (_config.resolution - 1);
+}
+
+SensorSample AnalogSensor::sample() {
+    if (_continuous) return _sample;
+
+    // Resolution is global, other analog sensors may use a different one
+    analogReadResolution(_config.resolution);
+
+    return {
+        .time_us = (uint32_t) micros(),
+        .value = (float) analogRead(_config.pin) / _max_value,
+        .quality = SampleQuality::SAMPLE_GOOD
+    };
+}
+
+bool AnalogSensor::_begin_continuous() {
+    const auto channel = digitalPinToAnalogChannel(_config.pin);
+    if (channel < 0 || channel >= SOC_ADC_CHANNEL_NUM(0)) {
+        D_PRINTF("Analog sensor: pin %u is not on ADC1, continuous mode disabled\r\n", _config.pin);
+        return false;
+    }
+
+    if (_dma_in_use) {
+        D_PRINT("Analog sensor: DMA ADC is used by another sensor, continuous mode disabled");
+        return false;
+    }
+
+    _channel = (uint8_t) channel;
+
+    const uint8_t resolution = std::clamp<uint8_t>(_config.resolution, 1, 16);
+    _decimation_bits = std::max<uint8_t>(ANALOG_MIN_DECIMATION_BITS, 2 * std::max(0, resolution - (int) ANALOG_ADC_BITS));
+    _shift = ANALOG_ADC_BITS + _decimation_bits - resolution;
+    _max_value = 1u << resolution;
+
+    adc_digi_init_config_t init_config{
+        .max_store_buf_size = ANALOG_DMA_BUFFER_SIZE,
+        .conv_num_each_intr = ANALOG_DMA_FRAME_SIZE,
+        .adc1_chan_mask = 1u << _channel,
+        .adc2_chan_mask = 0,
+    };
+
+    adc_digi_pattern_config_t pattern{
+        .atten = ADC_ATTEN_DB_11,
+        .channel = _channel,
+        .unit = 0,
+        .bit_width = SOC_ADC_DIGI_MAX_BITWIDTH,
+    };
+
+    adc_digi_configuration_t config{
+        .conv_limit_en = false,
+        .conv_limit_num = 0,
+        .pattern_num = 1,
+        .adc_pattern = &pattern,
+        .sample_freq_hz = ANALOG_SAMPLE_RATE,
+        .conv_mode = ADC_CONV_SINGLE_UNIT_1,
+        .format = ADC_DIGI_OUTPUT_FORMAT_TYPE2,
+    };
+
+    if (adc_digi_initialize(&init_config) != ESP_OK) {
+        D_PRINT("Analog sensor: unable to initialize DMA ADC");
+        return false;
+    }
+
+    if (adc_digi_controller_configure(&config) != ESP_OK || adc_digi_start() != ESP_OK) {
+        D_PRINT("Analog sensor: unable to start DMA ADC");
+        adc_digi_deinitialize();
+        return false;
+    }
+
+    _continuous = true;
+    _dma_in_use = true;
+    _noise.begin(ANALOG_SAMPLE_RATE, 1u << _decimation_bits, resolution);
+
+    D_PRINTF("Analog sensor: continuous, %u conversions per value\r\n", 1u << _decimation_bits);
+    return true;
+}
+
+void AnalogSensor::_drain() {
+    uint8_t buffer[ANALOG_DMA_FRAME_SIZE];
+    const uint32_t block = 1u << _decimation_bits;
+
+    bool updated = false;
+    uint32_t value = 0;
+    uint32_t pending = 0; // Conversions read after the last finished block
+
+    while (true) {
+        uint32_t length = 0;
+        const auto result = adc_digi_read_bytes(buffer, sizeof(buffer), &length, 0);
+        if (result == ESP_ERR_INVALID_STATE) _noise.add_overrun();
+        if (length == 0) break;
+
+        for (uint32_t offset = 0; offset + SOC_ADC_DIGI_RESULT_BYTES <= length; offset += SOC_ADC_DIGI_RESULT_BYTES) {
+            adc_digi_output_data_t data;
+            memcpy(&data, buffer + offset, sizeof(data));
+            if (data.type2.channel != _channel || data.type2.unit != 0) continue;
+
+            const auto raw = (uint16_t) data.type2.data;
+            _noise.add_raw(raw);
+
+            _sum += raw;
+            pending++;
+            if (++_sum_count < block) continue;
+
+            value = std::min(_max_value - 1, (_sum + (1u << (_shift - 1))) >> _shift);
+            _noise.add_value(value);
+
+            _sum = 0;
+            _sum_count = 0;
+            pending = 0;
+            updated = true;
+        }
+
+        if (length < sizeof(buffer)) break;
+    }
+
+    if (!updated) return;
+
+    const uint32_t age_us = (uint64_t) (pending + block / 2) * 1000000 / ANALOG_SAMPLE_RATE;
+    _sample = {
+        .time_us = (uint32_t) micros() - age_us,
+        .value = (float) value / (float) _max_value,
+        .quality = SampleQuality::SAMPLE_GOOD
+    };
+
+    _push_sample(_sample);
+}
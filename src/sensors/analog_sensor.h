@@ -8,28 +8,103 @@
 
 struct __attribute ((packed)) AnalogSensorConfig {
     uint8_t pin = ANALOG_PIN;
-    uint8_t resolution = 8;
+    uint8_t resolution = 8;   // Bits of value; in continuous mode up to 16
+    bool continuous = false;  // Oversample with DMA in background instead of converting on request
 };
 
+struct __attribute ((packed)) AnalogNoiseStats {
+    uint32_t windows = 0;     // Completed measurement windows
+    uint32_t sample_rate = 0; // Conversions per second
+    uint16_t decimation = 0;  // Conversions per value
+    uint32_t overruns = 0;    // DMA buffer overflows, conversions were lost
+
+    float raw_rms = 0;        // Noise of single conversions, LSB of 12 bit
+    float value_rms = 0;      // Noise of decimated values, LSB of 12 bit
+    float raw_enob = 0;       // Effective bits of single conversion
+    float enob = 0;           // Effective bits of decimated values
+};
+
+/**
+ * Noise of raw conversions and decimated values over windows of ANALOG_NOISE_WINDOW values.
+ * Measures ADC noise only while input is steady: signal changes within a window are counted as noise.
+ */
+class AnalogNoiseMeter {
+    AnalogNoiseStats _stats{};
+
+    uint8_t _bits = 12;       // Resolution of decimated values
+    uint32_t _count = 0;      // Values in current window
+
+    uint64_t _raw_sum = 0;
+    uint64_t _raw_sq_sum = 0;
+    uint32_t _raw_count = 0;
+
+    uint64_t _value_sum = 0;
+    uint64_t _value_sq_sum = 0;
+
+public:
+    [[nodiscard]] const AnalogNoiseStats &stats() const { return _stats; }
+
+    void begin(uint32_t sample_rate, uint16_t decimation, uint8_t bits);
+
+    void add_raw(uint16_t raw) {
+        _raw_sum += raw;
+        _raw_sq_sum += (uint32_t) raw * raw;
+        _raw_count++;
+    }
+
+    /**
+     * @return true if window is finished and stats are updated
+     */
+    bool add_value(uint32_t value);
+
+    void add_overrun() { _stats.overruns++; }
+};
+
+/**
+ * Analog input scaled to [0, 1].
+ *
+ * By default a single conversion is made each time a sample is taken.
+ * In continuous mode the ADC converts at ANALOG_SAMPLE_RATE into a DMA buffer, which is drained every ANALOG_DRAIN_INTERVAL.
+ * Blocks of 2^n conversions, n = max(ANALOG_MIN_DECIMATION_BITS, 2 * (resolution - 12)), are summed and rounded
+ * to `resolution` bits: each 4x oversampling adds a bit, with ADC noise acting as dither. All values feed noise statistics,
+ * the latest one of each drain is pushed to the sample callback. Sample time is the middle of its block.
+ * Only ADC1 pins are supported and DMA driver is a singleton: other pins and further continuous sensors
+ * fall back to single conversions.
+ */
 class AnalogSensor : public SensorBase {
+    static inline bool _dma_in_use = false;
+
+    Timer &_timer;
     AnalogSensorConfig _config;
 
-    uint16_t _max_value = 0;
+    uint32_t _max_value = 0;
+
+    bool _continuous = false;
+    uint8_t _channel = 0;
+    uint8_t _decimation_bits = 0; // log2 of conversions per value
+    uint8_t _shift = 0;           // Sum of block to `resolution` bits
+
+    uint32_t _sum = 0;
+    uint32_t _sum_count = 0;
+
+    SensorSample _sample{};
+    AnalogNoiseMeter _noise{};
 
 public:
-    AnalogSensor(Timer &timer, const uint8_t *data) {
-        memcpy(&_config, data, sizeof(_config));
-    }
+    AnalogSensor(Timer &timer, const uint8_t *data);
+    ~AnalogSensor() override;
 
-    void begin() override {
-        // TODO: use different resolution for each sensor
-        analogReadResolution(_config.resolution);
-        _max_value = 2 << (_config.resolution - 1);
-    }
+    void begin() override;
 
-    [[nodiscard]] bool has_value() const override { return true; }
+    [[nodiscard]] SensorSample sample() override;
+    [[nodiscard]] bool on_demand() const override { return !_continuous; }
 
-    [[nodiscard]] float get_value() const override {
-        return (float) analogRead(_config.pin) / _max_value;
-    }
+    /**
+     * @return noise statistics; nullptr unless continuous mode is running
+     */
+    [[nodiscard]] const AnalogNoiseStats *noise_stats() const override { return _continuous ? &_noise.stats() : nullptr; }
+
+private:
+    bool _begin_continuous();
+    void _drain();
 };
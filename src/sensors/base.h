@@ -1,18 +1,113 @@
 #pragma once
 
+#include <cmath>
+#include <functional>
+
 #include <lib/utils/enum.h>
+#include "lib/misc/timer.h"
+
+#include "sys_constants.h"
 
 MAKE_ENUM(SensorType, uint8_t,
     ANALOG_VALUE, 0,
     DSX18X, 1,
+    REPLAY, 2,
+    DSX18X_BUS, 3,
+    DSX18X_GROUP, 4,
+);
+
+MAKE_ENUM(SampleQuality, uint8_t,
+    SAMPLE_GOOD, 0,
+    SAMPLE_FAILED, 1, // Reading failed, value is the last good one (NAN if none)
 );
 
+struct SensorSample {
+    uint32_t time_us = 0; // micros() when value was measured
+    float value = NAN;
+    SampleQuality quality = SampleQuality::SAMPLE_FAILED;
+};
+
+typedef std::function<void(const SensorSample &sample)> SensorSampleCallback;
+
+struct DSx18BusStats;
+struct AnalogNoiseStats;
+struct SensorGroupStats;
+
+/**
+ * Sensor either measures on request (`sample` takes a new reading each call)
+ * or measures on its own schedule and pushes every reading to the sample callback as soon as it's ready.
+ */
 class SensorBase {
+    SensorSampleCallback _on_sample = nullptr;
+
+    Timer *_loop_timer = nullptr;
+    unsigned long _loop_id = -1ul;
+    std::function<void()> _loop_handler = nullptr;
+    bool _event_driven = false;
+
 public:
     virtual void begin() = 0;
 
-    [[nodiscard]] virtual bool has_value() const = 0;
-    [[nodiscard]] virtual float get_value() const = 0;
+    /**
+     * Latest sample. Doesn't consume it: compare `time_us` to detect new readings.
+     */
+    [[nodiscard]] virtual SensorSample sample() = 0;
+
+    /**
+     * @return true if readings are taken on request and never pushed to the callback
+     */
+    [[nodiscard]] virtual bool on_demand() const = 0;
+
+    /**
+     * @return statistics of DS18x20 bus the sensor reads; nullptr if it doesn't use one
+     */
+    [[nodiscard]] virtual const DSx18BusStats *bus_stats() const { return nullptr; }
+
+    /**
+     * @return noise statistics of oversampled conversions; nullptr if the sensor doesn't measure them
+     */
+    [[nodiscard]] virtual const AnalogNoiseStats *noise_stats() const { return nullptr; }
+
+    /**
+     * @return voting and fault statistics of redundant sensors; nullptr for a single sensor
+     */
+    [[nodiscard]] virtual const SensorGroupStats *group_stats() const { return nullptr; }
+
+    /**
+     * Read ahead data the sensor loop will need, so it doesn't block the control task. Called from application task.
+     */
+    virtual void prefetch() {}
+
+    void set_sample_callback(SensorSampleCallback callback) { _on_sample = std::move(callback); }
+
+    /**
+     * Readings are consumed as soon as they are pushed (Sensor Event sampling): sensors measuring on their own schedule
+     * check for a new reading every SENSOR_EVENT_LOOP_INTERVAL instead of SENSOR_LOOP_INTERVAL. Applies to a running loop too.
+     */
+    virtual void set_event_driven(bool value) {
+        if (value == _event_driven) return;
+
+        _event_driven = value;
+        if (_loop_timer) _start_loop(*_loop_timer, std::move(_loop_handler));
+    }
 
     virtual ~SensorBase() = default;
+
+protected:
+    void _push_sample(const SensorSample &sample) const {
+        if (_on_sample) _on_sample(sample);
+    }
+
+    /**
+     * Call `handler` every SENSOR_LOOP_INTERVAL, or SENSOR_EVENT_LOOP_INTERVAL while event driven.
+     */
+    void _start_loop(Timer &timer, std::function<void()> handler) {
+        if (_loop_timer) _loop_timer->clear_interval(_loop_id);
+
+        _loop_timer = &timer;
+        _loop_handler = std::move(handler);
+        _loop_id = timer.add_interval([this](auto) {
+            _loop_handler();
+        }, _event_driven ? SENSOR_EVENT_LOOP_INTERVAL : SENSOR_LOOP_INTERVAL);
+    }
 };
@@ -0,0 +1,269 @@
+#include "./dsx18_bus.h"
+
+#include <algorithm>
+#include <array>
+
+#include "lib/debug.h"
+
+#define DSX18_CMD_MATCH_ROM                     ((uint8_t) 0x55)
+#define DSX18_CMD_SKIP_ROM                      ((uint8_t) 0xCC)
+#define DSX18_CMD_CONVERT                       ((uint8_t) 0x44)
+#define DSX18_CMD_READ_SCRATCHPAD               ((uint8_t) 0xBE)
+#define DSX18_CMD_WRITE_SCRATCHPAD              ((uint8_t) 0x4E)
+
+#define DSX18_FAMILY_DS18S20                    ((uint8_t) 0x10)
+#define DSX18_FAMILY_DS1822                     ((uint8_t) 0x22)
+#define DSX18_FAMILY_DS18B20                    ((uint8_t) 0x28)
+
+// Read steps of a probe: reset, Match ROM with 8 ROM bytes, Read Scratchpad, 9 scratchpad bytes
+#define DSX18_STEP_SELECT                       (1u)
+#define DSX18_STEP_READ_COMMAND                 (DSX18_STEP_SELECT + 9)
+#define DSX18_STEP_SCRATCHPAD                   (DSX18_STEP_READ_COMMAND + 1)
+#define DSX18_STEP_COUNT                        (DSX18_STEP_SCRATCHPAD + 9)
+
+static bool is_supported_family(uint8_t family) {
+    return family == DSX18_FAMILY_DS18B20 || family == DSX18_FAMILY_DS1822 || family == DSX18_FAMILY_DS18S20;
+}
+
+static float decode_temperature(uint8_t family, uint8_t resolution, const uint8_t *scratchpad) {
+    const auto raw = (int16_t) (scratchpad[1] << 8 | scratchpad[0]);
+
+    // DS18S20: 0.5 °C register extended with COUNT_REMAIN
+    if (family == DSX18_FAMILY_DS18S20) {
+        return (float) (raw >> 1) - 0.25f + (float) (scratchpad[7] - scratchpad[6]) / (float) scratchpad[7];
+    }
+
+    // Low bits are undefined below 12 bit
+    const int16_t mask = (int16_t) ~((1 << (12 - resolution)) - 1);
+    return (float) (raw & mask) / 16.f;
+}
+
+DSx18Bus::DSx18Bus(Timer &timer, const DSx18BusSensorConfig &config) :
+    _timer(timer), _config(config), _wire(config.pin) {
+    _config.resolution = std::clamp<uint8_t>(_config.resolution, 9, 12);
+    _conversion_time = 750 >> (12 - _config.resolution);
+}
+
+std::shared_ptr<DSx18Bus> DSx18Bus::acquire(Timer &timer, const DSx18BusSensorConfig &config) {
+    for (auto it = _buses.begin(); it != _buses.end();) {
+        auto bus = it->lock();
+        if (!bus) {
+            it = _buses.erase(it);
+            continue;
+        }
+
+        if (bus->pin() == config.pin) return bus;
+        ++it;
+    }
+
+    auto bus = std::make_shared<DSx18Bus>(timer, config);
+    _buses.push_back(bus);
+
+    return bus;
+}
+
+const SensorSample &DSx18Bus::sample(uint8_t channel) const {
+    static const SensorSample missing{};
+    return channel < _stats.count ? _samples[channel] : missing;
+}
+
+void DSx18Bus::begin() {
+    if (_started) return;
+    _started = true;
+
+    _search();
+
+    _timer.add_interval([this](auto) {
+        this->_poll();
+    }, DSX18_BUS_STEP_INTERVAL);
+}
+
+void DSx18Bus::subscribe(uint8_t channel, SensorSampleCallback callback) {
+    _listeners.emplace_back(channel, std::move(callback));
+    _update_read_order();
+}
+
+void DSx18Bus::_poll() {
+    switch (_state) {
+        case State::SEARCH:
+            if (millis() - _state_time >= DSX18_BUS_SEARCH_INTERVAL) _search();
+            break;
+
+        case State::WAIT:
+            if (!_conversion_done()) break;
+
+            _stats.conversion_time = millis() - _state_time;
+            _conversion_end = micros();
+
+            _state = State::READ;
+            _state_time = millis();
+            _read_index = 0;
+            _step = 0;
+            break;
+
+        case State::READ:
+            if (_read_step()) _finish_read();
+            break;
+    }
+}
+
+void DSx18Bus::_search() {
+    _state = State::SEARCH;
+    _state_time = millis();
+
+    std::array<uint8_t, 8> roms[DSX18_BUS_MAX_PROBES]{};
+    uint8_t count = 0;
+
+    uint8_t rom[8];
+    _wire.reset_search();
+    while (count < DSX18_BUS_MAX_PROBES && _wire.search(rom)) {
+        if (OneWire::crc8(rom, 7) != rom[7] || !is_supported_family(rom[0])) continue;
+
+        memcpy(roms[count++].data(), rom, sizeof(rom));
+    }
+
+    _stats.count = count;
+    if (count == 0) {
+        D_PRINTF("DSx18 bus %u: no probes found\r\n", _config.pin);
+        return;
+    }
+
+    // Channel order doesn't depend on search algorithm
+    std::sort(roms, roms + count);
+
+    for (uint8_t i = 0; i < count; ++i) {
+        memcpy(_stats.probes[i].rom, roms[i].data(), 8);
+        if (roms[i][0] == DSX18_FAMILY_DS18S20) _conversion_time = 750;
+    }
+
+    _update_read_order();
+
+    // Resolution of every probe at once; TH and TL alarm registers keep factory defaults
+    const uint8_t config = (uint8_t) (((_config.resolution - 9) << 5) | 0x1F);
+    if (_wire.reset()) {
+        _wire.write(DSX18_CMD_SKIP_ROM);
+        _wire.write(DSX18_CMD_WRITE_SCRATCHPAD);
+        _wire.write(0x4B);
+        _wire.write(0x46);
+        _wire.write(config);
+    }
+
+    D_PRINTF("DSx18 bus %u: %u probes, %u ms conversion\r\n", _config.pin, count, _conversion_time);
+    _start_conversion();
+}
+
+void DSx18Bus::_update_read_order() {
+    auto subscribed = [this](uint8_t channel) {
+        return std::any_of(_listeners.begin(), _listeners.end(), [=](auto &listener) { return listener.first == channel; });
+    };
+
+    uint8_t index = 0;
+    for (uint8_t channel = 0; channel < _stats.count; ++channel) {
+        if (subscribed(channel)) _read_order[index++] = channel;
+    }
+
+    for (uint8_t channel = 0; channel < _stats.count; ++channel) {
+        if (!subscribed(channel)) _read_order[index++] = channel;
+    }
+}
+
+void DSx18Bus::_start_conversion() {
+    // Probes are gone: report failure and search again
+    if (!_wire.reset()) {
+        D_PRINTF("DSx18 bus %u: no presence pulse\r\n", _config.pin);
+        for (uint8_t i = 0; i < _stats.count; ++i) _publish(i, {.time_us = (uint32_t) micros(), .value = _samples[i].value});
+
+        _state = State::SEARCH;
+        _state_time = millis();
+        return;
+    }
+
+    _wire.skip();
+    _wire.write(DSX18_CMD_CONVERT, _config.parasite);
+
+    _state = State::WAIT;
+    _state_time = millis();
+}
+
+bool DSx18Bus::_conversion_done() {
+    const bool elapsed = millis() - _state_time >= _conversion_time;
+
+    // Parasite powered probes need strong pull-up for the whole worst case time, the bus can't be polled
+    if (_config.parasite) {
+        if (elapsed) _wire.depower();
+        return elapsed;
+    }
+
+    return elapsed || _wire.read_bit() != 0;
+}
+
+bool DSx18Bus::_read_step() {
+    const uint8_t probe = _read_order[_read_index];
+    const uint8_t *rom = _stats.probes[probe].rom;
+
+    if (_step == 0) {
+        if (!_wire.reset()) {
+            _step = DSX18_STEP_COUNT;
+            memset(_scratchpad, 0xFF, sizeof(_scratchpad));
+        }
+    } else if (_step == DSX18_STEP_SELECT) {
+        _wire.write(DSX18_CMD_MATCH_ROM);
+    } else if (_step < DSX18_STEP_READ_COMMAND) {
+        _wire.write(rom[_step - DSX18_STEP_SELECT - 1]);
+    } else if (_step == DSX18_STEP_READ_COMMAND) {
+        _wire.write(DSX18_CMD_READ_SCRATCHPAD);
+    } else if (_step < DSX18_STEP_COUNT) {
+        _scratchpad[_step - DSX18_STEP_SCRATCHPAD] = _wire.read();
+    }
+
+    if (++_step < DSX18_STEP_COUNT) return false;
+
+    auto &stats = _stats.probes[probe];
+    auto sample = _samples[probe];
+    sample.time_us = _conversion_end;
+
+    // All zeros pass CRC check: bus is shorted
+    const bool empty = std::all_of(_scratchpad, _scratchpad + sizeof(_scratchpad), [](uint8_t b) { return b == 0; });
+    if (!empty && OneWire::crc8(_scratchpad, 8) == _scratchpad[8]) {
+        sample.value = decode_temperature(rom[0], _config.resolution, _scratchpad);
+        sample.quality = SampleQuality::SAMPLE_GOOD;
+        stats.value = sample.value;
+    } else {
+        sample.quality = SampleQuality::SAMPLE_FAILED;
+        stats.crc_errors++;
+    }
+
+    _publish(probe, sample);
+
+    _step = 0;
+    return ++_read_index >= _stats.count;
+}
+
+void DSx18Bus::_finish_read() {
+    _stats.read_time = millis() - _state_time;
+    _stats.scans++;
+
+    _start_conversion();
+}
+
+void DSx18Bus::_publish(uint8_t channel, const SensorSample &sample) {
+    _samples[channel] = sample;
+
+    for (auto &[listener_channel, callback]: _listeners) {
+        if (listener_channel == channel) callback(sample);
+    }
+}
+
+DSx18BusSensor::DSx18BusSensor(Timer &timer, const uint8_t *data) {
+    memcpy(&_config, data, sizeof(_config));
+    _bus = DSx18Bus::acquire(timer, _config);
+}
+
+void DSx18BusSensor::begin() {
+    _bus->subscribe(_config.channel, [this](const SensorSample &sample) {
+        _sample = sample;
+        _push_sample(sample);
+    });
+
+    _bus->begin();
+}
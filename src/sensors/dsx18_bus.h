@@ -0,0 +1,127 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include <OneWire.h>
+#include "lib/misc/timer.h"
+
+#include "./base.h"
+#include "constants.h"
+#include "sys_constants.h"
+
+struct __attribute ((packed)) DSx18BusSensorConfig {
+    uint8_t pin = DSX18_PIN;
+    uint8_t resolution = 10;
+    bool parasite = false;
+    uint8_t channel = 0; // Probe index in ROM order
+};
+
+struct __attribute ((packed)) DSx18ProbeStats {
+    uint8_t rom[8]{};
+    float value = NAN;
+    uint32_t crc_errors = 0; // Rejected scratchpad reads: CRC mismatch, no response or bus held low
+};
+
+struct __attribute ((packed)) DSx18BusStats {
+    uint8_t count = 0;            // Probes found by ROM search
+    uint32_t scans = 0;           // Completed conversion and read cycles
+    uint16_t conversion_time = 0; // Duration of the last conversion, ms
+    uint16_t read_time = 0;       // Time to read all scratchpads of the last cycle, ms
+    DSx18ProbeStats probes[DSX18_BUS_MAX_PROBES]{};
+};
+
+/**
+ * Driver of DS18x20 probes sharing one 1-Wire pin.
+ *
+ * Probes are enumerated by ROM search once, then a single Skip-ROM Convert T starts conversion on all of them,
+ * so a cycle takes one conversion time however many probes are attached. Scratchpads are read afterwards
+ * one bus operation (reset or byte) per poll, so the control task is never blocked for more than about a millisecond.
+ * Without parasite power conversion end is detected from read slots instead of waiting for the worst case time.
+ *
+ * Buses are shared: sensors of the same pin get the same instance, the first one defines resolution and power mode.
+ */
+class DSx18Bus {
+    enum class State : uint8_t {
+        SEARCH,
+        WAIT,
+        READ,
+    };
+
+    Timer &_timer;
+    DSx18BusSensorConfig _config;
+    OneWire _wire;
+
+    bool _started = false;
+    State _state = State::SEARCH;
+    uint32_t _state_time = 0; // millis() when current state started
+
+    uint16_t _conversion_time = 0;
+    uint32_t _conversion_end = 0; // micros() when conversion finished, time of samples
+
+    uint8_t _read_order[DSX18_BUS_MAX_PROBES]{}; // Subscribed channels first, their samples are the least delayed
+    uint8_t _read_index = 0;
+    uint8_t _step = 0;
+    uint8_t _scratchpad[9]{};
+
+    DSx18BusStats _stats{};
+    SensorSample _samples[DSX18_BUS_MAX_PROBES]{};
+    std::vector<std::pair<uint8_t, SensorSampleCallback>> _listeners;
+
+    static inline std::vector<std::weak_ptr<DSx18Bus>> _buses;
+
+public:
+    DSx18Bus(Timer &timer, const DSx18BusSensorConfig &config);
+
+    /**
+     * Bus of `config.pin`, created on first request.
+     */
+    static std::shared_ptr<DSx18Bus> acquire(Timer &timer, const DSx18BusSensorConfig &config);
+
+    [[nodiscard]] uint8_t pin() const { return _config.pin; }
+    [[nodiscard]] const DSx18BusStats &stats() const { return _stats; }
+    [[nodiscard]] const SensorSample &sample(uint8_t channel) const;
+
+    /**
+     * Start polling. Following calls do nothing, so every channel may call it.
+     */
+    void begin();
+
+    /**
+     * Call `callback` with every reading of probe `channel`, failed ones included.
+     */
+    void subscribe(uint8_t channel, SensorSampleCallback callback);
+
+private:
+    void _poll();
+
+    void _search();
+    void _update_read_order();
+    void _start_conversion();
+    bool _conversion_done();
+    bool _read_step();
+    void _finish_read();
+
+    void _publish(uint8_t channel, const SensorSample &sample);
+};
+
+/**
+ * Single probe of a shared DS18x20 bus.
+ */
+class DSx18BusSensor : public SensorBase {
+    DSx18BusSensorConfig _config;
+    std::shared_ptr<DSx18Bus> _bus;
+
+    SensorSample _sample{};
+
+public:
+    DSx18BusSensor(Timer &timer, const uint8_t *data);
+
+    void begin() override;
+
+    [[nodiscard]] SensorSample sample() override { return _sample; }
+    [[nodiscard]] bool on_demand() const override { return false; }
+
+    [[nodiscard]] const DSx18Bus &bus() const { return *_bus; }
+    [[nodiscard]] const DSx18BusStats *bus_stats() const override { return &_bus->stats(); }
+};
@@ -10,15 +10,13 @@ DSx18Sensor::DSx18Sensor(Timer &timer, const uint8_t *data): _timer(timer) {
     _sensor.setResolution(_config.resolution);
     _sensor.setParasite(_config.parasite);
 
-    _update_interval = _sensor.getConversionTime();
+    _conversion_time = _sensor.getConversionTime();
 }
 
 void DSx18Sensor::begin() {
     request_value();
 
-    _timer.add_interval([this](auto) {
-        this->update_value();
-    }, SENSOR_LOOP_INTERVAL);
+    _start_loop(_timer, [this] { update_value(); });
 }
 
 void DSx18Sensor::request_value() {
@@ -27,14 +25,18 @@ void DSx18Sensor::request_value() {
 }
 
 void DSx18Sensor::update_value() {
-    if (millis() - _last_request <= _update_interval) return;
+    if (millis() - _last_request < _conversion_time) return;
 
-    _has_value = _sensor.readTemp();
-    if (_has_value) {
-        _last_value = _sensor.getTemp();
+    const auto now_us = (uint32_t) micros();
+    if (_sensor.readTemp()) {
+        _sample = {.time_us = now_us, .value = _sensor.getTemp(), .quality = SampleQuality::SAMPLE_GOOD};
     } else {
+        _sample.time_us = now_us;
+        _sample.quality = SampleQuality::SAMPLE_FAILED;
+
         D_PRINT("Unable to read temperature");
     }
 
-    _sensor.requestTemp();
+    _push_sample(_sample);
+    request_value();
 }
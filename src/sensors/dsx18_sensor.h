@@ -12,29 +12,27 @@ struct __attribute ((packed)) DSx18SensorConfig {
     bool parasite = false;
 };
 
+/**
+ * Conversions run back to back: each one is read as soon as its conversion time elapses and pushed to the sample callback.
+ */
 class DSx18Sensor : public SensorBase {
     Timer &_timer;
 
     DSx18SensorConfig _config;
     GyverDS18Single _sensor;
 
-    uint16_t _update_interval = 0;
+    uint16_t _conversion_time = 0;
     uint32_t _last_request = 0;
 
-    mutable bool _has_value = false;
-    float _last_value = 0;
+    SensorSample _sample{};
 
 public:
     DSx18Sensor(Timer &timer, const uint8_t *data);
 
     void begin() override;
 
-    [[nodiscard]] bool has_value() const override { return _has_value; }
-
-    [[nodiscard]] float get_value() const override {
-        _has_value = false;
-        return _last_value;
-    }
+    [[nodiscard]] SensorSample sample() override { return _sample; }
+    [[nodiscard]] bool on_demand() const override { return false; }
 
 protected:
     void request_value();
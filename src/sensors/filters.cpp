@@ -0,0 +1,108 @@
+#include "filters.h"
+
+#include <algorithm>
+#include <cmath>
+
+void FilterSensor::begin() {
+    _source->set_sample_callback([this](const SensorSample &sample) {
+        _push_sample(_apply(sample));
+    });
+
+    _source->begin();
+}
+
+SensorSample FilterSensor::sample() {
+    if (_source->on_demand()) return _apply(_source->sample());
+
+    return _sample;
+}
+
+SensorSample FilterSensor::_apply(const SensorSample &sample) {
+    if (sample.quality != SampleQuality::SAMPLE_GOOD) {
+        return {
+            .time_us = sample.time_us,
+            .value = _sample.value,
+            .quality = sample.quality
+        };
+    }
+
+    const bool first = !_has_value;
+    const float dt = first ? 0 : (float) (int32_t) (sample.time_us - _sample.time_us) / 1e6f;
+
+    _sample = {
+        .time_us = sample.time_us,
+        .value = _filter(sample.value, std::max(0.f, dt), first),
+        .quality = SampleQuality::SAMPLE_GOOD
+    };
+
+    _has_value = true;
+    return _sample;
+}
+
+MedianFilterSensor::MedianFilterSensor(std::unique_ptr<SensorBase> source, uint8_t window) :
+    FilterSensor(std::move(source)),
+    _window(std::clamp<uint8_t>(window, 1, SENSOR_FILTER_MAX_WINDOW) | 1) {}
+
+float MedianFilterSensor::_filter(float value, float, bool) {
+    _values[_index] = value;
+    _index = (_index + 1) % _window;
+    if (_count < _window) _count++;
+
+    // Window isn't full at start: median of what is there
+    std::array<float, SENSOR_FILTER_MAX_WINDOW> sorted{};
+    std::copy_n(_values.begin(), _count, sorted.begin());
+
+    const auto middle = sorted.begin() + _count / 2;
+    std::nth_element(sorted.begin(), middle, sorted.begin() + _count);
+
+    return *middle;
+}
+
+float EmaFilterSensor::_filter(float value, float dt, bool first) {
+    if (first || _time_constant <= 0) {
+        _value = value;
+    } else {
+        _value += (1 - std::exp(-dt / _time_constant)) * (value - _value);
+    }
+
+    return _value;
+}
+
+float KalmanFilterSensor::_filter(float value, float dt, bool first) {
+    if (first || _measurement_variance <= 0) {
+        _value = value;
+        _variance = _measurement_variance;
+        return _value;
+    }
+
+    _variance += _process_variance * dt;
+
+    const float gain = _variance / (_variance + _measurement_variance);
+    _value += gain * (value - _value);
+    _variance *= 1 - gain;
+
+    return _value;
+}
+
+float SlewFilterSensor::_filter(float value, float dt, bool first) {
+    if (first || _rate <= 0) {
+        _value = value;
+    } else {
+        const float step = _rate * dt;
+        _value += std::clamp(value - _value, -step, step);
+    }
+
+    return _value;
+}
+
+std::unique_ptr<SensorBase> make_filtered_sensor(std::unique_ptr<SensorBase> sensor, const SensorFilterConfig &config) {
+    if (config.median) sensor = std::make_unique<MedianFilterSensor>(std::move(sensor), config.median_window);
+    if (config.ema) sensor = std::make_unique<EmaFilterSensor>(std::move(sensor), config.ema_time_constant);
+    if (config.kalman) {
+        sensor = std::make_unique<KalmanFilterSensor>(std::move(sensor), config.kalman_process_noise,
+                                                      config.kalman_measurement_noise);
+    }
+    if (config.slew) sensor = std::make_unique<SlewFilterSensor>(std::move(sensor), config.slew_rate);
+
+    return sensor;
+}
@@ -0,0 +1,134 @@
+#pragma once
+
+#include <array>
+#include <memory>
+
+#include "./base.h"
+#include "sys_constants.h"
+
+/**
+ * Stages are applied in fixed order: median rejects spikes before smoothing sees them,
+ * slew limit is the last so nothing downstream moves faster than allowed.
+ */
+struct __attribute ((packed)) SensorFilterConfig {
+    bool median = false;
+    uint8_t median_window = 5;             // Readings, odd, up to SENSOR_FILTER_MAX_WINDOW
+
+    bool ema = false;
+    float ema_time_constant = 5;           // Seconds
+
+    bool kalman = false;
+    float kalman_process_noise = 0.05f;    // How fast true value may drift, units per √s
+    float kalman_measurement_noise = 0.5f; // RMS noise of readings, units
+
+    bool slew = false;
+    float slew_rate = 1;                   // Maximum change, units per second
+};
+
+/**
+ * Decorator filtering readings of another sensor; stages are chained by wrapping each other.
+ * On-demand sources are filtered when sampled, pushed readings are filtered as they arrive,
+ * so filter sees every reading even if PID is slower. Time steps are taken from reading timestamps.
+ * Failed readings pass through without updating filter state.
+ */
+class FilterSensor : public SensorBase {
+    std::unique_ptr<SensorBase> _source;
+
+    SensorSample _sample{};
+    bool _has_value = false;
+
+public:
+    explicit FilterSensor(std::unique_ptr<SensorBase> source) : _source(std::move(source)) {}
+
+    [[nodiscard]] const SensorBase &source() const { return *_source; }
+
+    void begin() override;
+    void set_event_driven(bool value) override { _source->set_event_driven(value); }
+
+    [[nodiscard]] SensorSample sample() override;
+    [[nodiscard]] bool on_demand() const override { return _source->on_demand(); }
+
+protected:
+    /**
+     * @param dt seconds since previous good reading
+     * @param first true for the first good reading: filter state has to be initialized from it
+     */
+    virtual float _filter(float value, float dt, bool first) = 0;
+
+private:
+    SensorSample _apply(const SensorSample &sample);
+};
+
+/**
+ * Median of the last `window` readings: a spike shorter than half of the window is dropped entirely.
+ */
+class MedianFilterSensor : public FilterSensor {
+    std::array<float, SENSOR_FILTER_MAX_WINDOW> _values{};
+    uint8_t _window;
+
+    static_assert(SENSOR_FILTER_MAX_WINDOW % 2 == 1, "Window is rounded up to odd, maximum must be odd to stay in bounds");
+    uint8_t _count = 0;
+    uint8_t _index = 0;
+
+public:
+    MedianFilterSensor(std::unique_ptr<SensorBase> source, uint8_t window);
+
+protected:
+    float _filter(float value, float dt, bool first) override;
+};
+
+/**
+ * Exponential moving average with time constant, independent of reading rate.
+ */
+class EmaFilterSensor : public FilterSensor {
+    float _time_constant;
+    float _value = NAN;
+
+public:
+    EmaFilterSensor(std::unique_ptr<SensorBase> source, float time_constant) :
+        FilterSensor(std::move(source)), _time_constant(time_constant) {}
+
+protected:
+    float _filter(float value, float dt, bool first) override;
+};
+
+/**
+ * Scalar Kalman filter for a value drifting as a random walk: gain adapts to reading rate and noise ratio,
+ * so it smooths as much as the noise allows without EMA lag on real changes.
+ */
+class KalmanFilterSensor : public FilterSensor {
+    float _process_variance;     // Per second
+    float _measurement_variance;
+
+    float _value = NAN;
+    float _variance = 0;         // Of estimated value
+
+public:
+    KalmanFilterSensor(std::unique_ptr<SensorBase> source, float process_noise, float measurement_noise) :
+        FilterSensor(std::move(source)),
+        _process_variance(process_noise * process_noise),
+        _measurement_variance(measurement_noise * measurement_noise) {}
+
+protected:
+    float _filter(float value, float dt, bool first) override;
+};
+
+/**
+ * Limits rate of change, so a single bad reading can't kick derivative term.
+ */
+class SlewFilterSensor : public FilterSensor {
+    float _rate;
+    float _value = NAN;
+
+public:
+    SlewFilterSensor(std::unique_ptr<SensorBase> source, float rate) : FilterSensor(std::move(source)), _rate(rate) {}
+
+protected:
+    float _filter(float value, float dt, bool first) override;
+};
+
+/**
+ * Wrap sensor in enabled filter stages.
+ * @return `sensor` itself if no stage is enabled
+ */
+std::unique_ptr<SensorBase> make_filtered_sensor(std::unique_ptr<SensorBase> sensor, const SensorFilterConfig &config);
@@ -0,0 +1,80 @@
+#include "replay_sensor.h"
+
+#include <LittleFS.h>
+
+#include "sys_constants.h"
+#include "lib/debug.h"
+
+#include "misc/sensor_log.h"
+
+ReplaySensor::ReplaySensor(Timer &timer, const uint8_t *data) :
+    _timer(timer), _reader(std::make_unique<SensorLogReader>()) {
+    memcpy(&_config, data, sizeof(_config));
+}
+
+ReplaySensor::~ReplaySensor() = default;
+
+void ReplaySensor::begin() {
+    // Control task isn't running yet: replay starts now
+    if (_rewind()) prefetch();
+
+    if (!_take_next()) {
+        D_PRINT("Replay sensor: no samples in " SENSOR_LOG_PATH);
+        return;
+    }
+
+    _start_loop(_timer, [this] { _advance(); });
+}
+
+void ReplaySensor::prefetch() {
+    SensorLogRecord record;
+    while (_points.size() < REPLAY_PREFETCH_SIZE) {
+        if (_reader->next(record)) {
+            if (record.type != SENSOR_LOG_SAMPLE) continue;
+
+            _points.push({.time_us = record.sample.time_us, .value = record.sample.sensor_value, .restart = _restart});
+            _restart = false;
+            continue;
+        }
+
+        // Log without samples isn't started over, otherwise it would be reopened on every call
+        if (!_config.loop || _restart || !_rewind()) break;
+    }
+}
+
+void ReplaySensor::_advance() {
+    // Ring may have run dry if the application task was late
+    if (!_has_next) _take_next();
+
+    bool updated = false;
+    while (_has_next && _next.time_us - _base_time <= micros() - _start_time) {
+        _sample.value = _next.value;
+        updated = true;
+
+        // Log started over: its first sample is due on the next pass
+        if (_take_next() && _next.restart) break;
+    }
+
+    if (updated) {
+        _sample.time_us = micros();
+        _sample.quality = SampleQuality::SAMPLE_GOOD;
+        _push_sample(_sample);
+    }
+}
+
+bool ReplaySensor::_take_next() {
+    _has_next = _points.pop(_next);
+    if (_has_next && _next.restart) {
+        _start_time = micros();
+        _base_time = _next.time_us;
+    }
+
+    return _has_next;
+}
+
+bool ReplaySensor::_rewind() {
+    _reader->close();
+    _restart = true;
+
+    return _reader->open(LittleFS, SENSOR_LOG_PATH);
+}
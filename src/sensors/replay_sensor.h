@@ -0,0 +1,66 @@
+#pragma once
+
+#include <memory>
+
+#include "lib/misc/timer.h"
+
+#include "sys_constants.h"
+#include "misc/spsc_ring.h"
+
+#include "./base.h"
+
+class SensorLogReader;
+
+struct __attribute ((packed)) ReplaySensorConfig {
+    bool loop = true; // Start over at the end of log, otherwise hold the last value
+};
+
+struct ReplayPoint {
+    uint32_t time_us = 0; // Log time
+    float value = NAN;
+    bool restart = false; // First sample of a pass over the log
+};
+
+/**
+ * Sensor reading values recorded to SENSOR_LOG_PATH (see `misc/sensor_log.h`) at their original pace,
+ * so recorded behavior can be reproduced against the current firmware and settings.
+ *
+ * File is read ahead by `prefetch` from the application task, the sensor loop only takes decoded samples from the ring:
+ * control task doesn't wait for flash and its stack doesn't hold the read buffer.
+ */
+class ReplaySensor : public SensorBase {
+    Timer &_timer;
+
+    ReplaySensorConfig _config;
+
+    // Application task
+    std::unique_ptr<SensorLogReader> _reader;
+    bool _restart = false; // No sample was read since the log was opened
+
+    SpscRing<ReplayPoint, REPLAY_PREFETCH_SIZE> _points{};
+
+    // Control task
+    bool _has_next = false;
+    ReplayPoint _next{};
+
+    uint32_t _start_time = 0; // micros() when replay started
+    uint32_t _base_time = 0;  // Log time of the first sample
+
+    SensorSample _sample{};
+
+public:
+    ReplaySensor(Timer &timer, const uint8_t *data);
+    ~ReplaySensor() override;
+
+    void begin() override;
+
+    [[nodiscard]] SensorSample sample() override { return _sample; }
+    [[nodiscard]] bool on_demand() const override { return false; }
+
+    void prefetch() override;
+
+private:
+    void _advance();
+    bool _take_next();
+    bool _rewind();
+};
@@ -0,0 +1,236 @@
+#include "./sensor_group.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+#include "lib/debug.h"
+
+SensorGroup::SensorGroup(Timer &timer, const SensorGroupConfig &config, std::vector<std::unique_ptr<SensorBase>> members) :
+    _timer(timer), _config(config) {
+    _members.resize(std::min<size_t>(members.size(), SENSOR_GROUP_MAX_MEMBERS));
+    for (size_t i = 0; i < _members.size(); ++i) _members[i].sensor = std::move(members[i]);
+
+    _stats.count = _members.size();
+}
+
+void SensorGroup::begin() {
+    const auto now = millis();
+    for (uint8_t i = 0; i < _members.size(); ++i) {
+        auto &member = _members[i];
+        member.good_time = now;
+        member.changed_time = now;
+
+        member.sensor->set_sample_callback([this, i](const SensorSample &sample) {
+            _check(i, sample);
+            _check_timeouts();
+
+            if (_round_complete()) _fuse();
+        });
+
+        member.sensor->begin();
+    }
+
+    if (on_demand()) return;
+
+    // Late members must not hold the round: lost member fails over within the wait
+    _start_loop(_timer, [this] {
+        _check_timeouts();
+        if (_round_start != 0 && millis() - _round_start >= SENSOR_GROUP_ROUND_WAIT) _fuse();
+    });
+}
+
+void SensorGroup::set_event_driven(bool value) {
+    SensorBase::set_event_driven(value);
+    for (auto &member: _members) member.sensor->set_event_driven(value);
+}
+
+SensorSample SensorGroup::sample() {
+    if (!on_demand()) return _sample;
+
+    for (uint8_t i = 0; i < _members.size(); ++i) _check(i, _members[i].sensor->sample());
+    _check_timeouts();
+    _fuse();
+
+    return _sample;
+}
+
+bool SensorGroup::on_demand() const {
+    return std::all_of(_members.begin(), _members.end(), [](auto &member) { return member.sensor->on_demand(); });
+}
+
+void SensorGroup::_check(uint8_t index, const SensorSample &sample) {
+    auto &member = _members[index];
+    const auto now = millis();
+
+    // Fused value is as old as the newest reading of the round
+    if (_round_start == 0) {
+        _round_start = std::max<uint32_t>(1, now);
+        _round_time = sample.time_us;
+    } else if ((int32_t) (sample.time_us - _round_time) > 0) {
+        _round_time = sample.time_us;
+    }
+
+    member.fresh = true;
+
+    if (sample.quality != SampleQuality::SAMPLE_GOOD) {
+        _set_fault(index, SensorFault::FAULT_LOST);
+        return;
+    }
+
+    const float value = sample.value;
+    _stats.members[index].value = value;
+
+    if (!(value >= _config.min_value && value <= _config.max_value)) {
+        _set_fault(index, SensorFault::FAULT_RANGE);
+        return;
+    }
+
+    // Compared to the last accepted reading: after a spike the next valid reading is accepted again
+    if (member.has_value && _config.max_rate > 0) {
+        const float dt = (float) (int32_t) (sample.time_us - member.time_us) / 1e6f;
+        if (dt > 0 && std::abs(value - member.value) > _config.max_rate * dt) {
+            _set_fault(index, SensorFault::FAULT_RATE);
+            return;
+        }
+    }
+
+    if (!member.has_value || value != member.value) {
+        member.changed_time = now;
+        member.changed_reference = _sample.value;
+    }
+
+    member.has_value = true;
+    member.value = value;
+    member.time_us = sample.time_us;
+    member.good_time = now;
+
+    // Stuck only if the group moved while this member froze: steady process keeps everyone still
+    if (_config.stuck_time > 0 && now - member.changed_time >= _config.stuck_time * 1000u
+        && std::abs(_sample.value - member.changed_reference) >= SENSOR_GROUP_STUCK_BAND) {
+        _set_fault(index, SensorFault::FAULT_STUCK);
+        return;
+    }
+
+    _set_fault(index, SensorFault::FAULT_NONE);
+}
+
+void SensorGroup::_set_fault(uint8_t index, SensorFault fault) {
+    auto &stats = _stats.members[index];
+    if (stats.fault == fault) return;
+
+    if (stats.fault == SensorFault::FAULT_NONE) {
+        stats.faults++;
+        _stats.faults++;
+
+        D_PRINTF("Sensor group: member %u fault %s\r\n", index, __debug_enum_str(fault));
+    }
+
+    stats.fault = fault;
+}
+
+void SensorGroup::_check_timeouts() {
+    const auto now = millis();
+    for (uint8_t i = 0; i < _members.size(); ++i) {
+        if (now - _members[i].good_time >= _config.timeout) _set_fault(i, SensorFault::FAULT_LOST);
+    }
+}
+
+bool SensorGroup::_round_complete() const {
+    for (uint8_t i = 0; i < _members.size(); ++i) {
+        if (!_members[i].fresh && _stats.members[i].fault == SensorFault::FAULT_NONE) return false;
+    }
+
+    return true;
+}
+
+void SensorGroup::_fuse() {
+    _round_start = 0;
+
+    // Late readings of a timed out round may complete another one that isn't newer than the pushed sample.
+    // Their values are kept for the next round
+    if (_stats.rounds > 0 && (int32_t) (_round_time - _sample.time_us) <= 0) {
+        for (auto &member: _members) member.fresh = false;
+        return;
+    }
+
+    std::array<float, SENSOR_GROUP_MAX_MEMBERS> values{};
+    uint8_t count = 0;
+
+    for (uint8_t i = 0; i < _members.size(); ++i) {
+        _members[i].fresh = false;
+        _stats.members[i].weight = 0;
+
+        if (_stats.members[i].fault != SensorFault::FAULT_NONE || !_members[i].has_value) continue;
+
+        // Insertion sort: there are only a few members
+        uint8_t j = count++;
+        for (; j > 0 && values[j - 1] > _members[i].value; --j) values[j] = values[j - 1];
+        values[j] = _members[i].value;
+    }
+
+    _stats.healthy = count;
+    _stats.rounds++;
+
+    if (count == 0) {
+        _sample = {.time_us = _round_time, .value = _sample.value, .quality = SampleQuality::SAMPLE_FAILED};
+        _push_sample(_sample);
+        return;
+    }
+
+    const float median = count % 2 ? values[count / 2] : (values[count / 2 - 1] + values[count / 2]) / 2;
+
+    float value = median;
+    if (_config.voting == SensorVoting::VOTING_WEIGHTED) {
+        float weight_sum = 0, sum = 0;
+        for (uint8_t i = 0; i < _members.size(); ++i) {
+            auto &member = _members[i];
+            if (_stats.members[i].fault != SensorFault::FAULT_NONE || !member.has_value) continue;
+
+            const float error = member.value - median;
+            member.deviation += SENSOR_GROUP_DEVIATION_SMOOTHING * (error * error - member.deviation);
+
+            const float weight = 1 / (member.deviation + SENSOR_GROUP_MIN_DEVIATION * SENSOR_GROUP_MIN_DEVIATION);
+            _stats.members[i].weight = weight;
+            weight_sum += weight;
+            sum += weight * member.value;
+        }
+
+        value = sum / weight_sum;
+        for (auto &stats: _stats.members) stats.weight /= weight_sum;
+    } else {
+        for (uint8_t i = 0; i < _members.size(); ++i) {
+            if (_stats.members[i].fault == SensorFault::FAULT_NONE && _members[i].has_value) _stats.members[i].weight = 1.f / count;
+        }
+    }
+
+    _sample = {.time_us = _round_time, .value = value, .quality = SampleQuality::SAMPLE_GOOD};
+    _push_sample(_sample);
+}
+
+DSx18GroupSensor::DSx18GroupSensor(Timer &timer, const DSx18GroupSensorConfig &config) :
+    SensorGroup(timer, config.group, _make_members(timer, config)) {}
+
+DSx18GroupSensorConfig DSx18GroupSensor::_read_config(const uint8_t *data) {
+    DSx18GroupSensorConfig config;
+    memcpy(&config, data, sizeof(config));
+    return config;
+}
+
+std::vector<std::unique_ptr<SensorBase>> DSx18GroupSensor::_make_members(Timer &timer, const DSx18GroupSensorConfig &config) {
+    const uint8_t count = std::clamp<uint8_t>(config.count, 1, std::min(SENSOR_GROUP_MAX_MEMBERS, DSX18_BUS_MAX_PROBES));
+
+    std::vector<std::unique_ptr<SensorBase>> members;
+    for (uint8_t channel = 0; channel < count; ++channel) {
+        DSx18BusSensorConfig probe_config{
+            .pin = config.pin,
+            .resolution = config.resolution,
+            .parasite = config.parasite,
+            .channel = channel
+        };
+
+        members.push_back(std::make_unique<DSx18BusSensor>(timer, (const uint8_t *) &probe_config));
+    }
+
+    return members;
+}
@@ -0,0 +1,133 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include <lib/utils/enum.h>
+#include "lib/misc/timer.h"
+
+#include "./base.h"
+#include "./dsx18_bus.h"
+#include "constants.h"
+#include "sys_constants.h"
+
+MAKE_ENUM(SensorVoting, uint8_t,
+    VOTING_MEDIAN, 0,
+    VOTING_WEIGHTED, 1,   // Mean weighted by inverse variance of deviation from median
+);
+
+MAKE_ENUM(SensorFault, uint8_t,
+    FAULT_NONE, 0,
+    FAULT_LOST, 1,        // Failed readings, or none within timeout
+    FAULT_RANGE, 2,       // Reading outside of valid range
+    FAULT_RATE, 3,        // Reading changed faster than possible
+    FAULT_STUCK, 4,       // Same reading for stuck time while other members changed
+);
+
+struct __attribute ((packed)) SensorGroupConfig {
+    SensorVoting voting = SensorVoting::VOTING_MEDIAN;
+
+    float min_value = -55;  // Valid range of readings, units
+    float max_value = 125;
+    float max_rate = 2;     // Maximum change, units per second; 0 disables the check
+    uint16_t stuck_time = 600; // Seconds; 0 disables the check
+    uint16_t timeout = 2000;   // Member without good reading for this long is lost, ms
+};
+
+struct __attribute ((packed)) SensorMemberStats {
+    float value = NAN;      // Last reading, faulty included
+    float weight = 0;       // Share in the last fused value
+    SensorFault fault = SensorFault::FAULT_NONE;
+    uint32_t faults = 0;    // Times the member was excluded from voting
+};
+
+struct __attribute ((packed)) SensorGroupStats {
+    uint8_t count = 0;
+    uint8_t healthy = 0;    // Members used for the last fused value
+    uint32_t rounds = 0;    // Fused values
+    uint32_t faults = 0;    // Faults of all members
+    SensorMemberStats members[SENSOR_GROUP_MAX_MEMBERS]{};
+};
+
+/**
+ * Redundant sensors fused into one reading.
+ *
+ * Every member reading is checked for range, rate of change and stuck value; a faulty member is excluded
+ * from voting until its readings are valid again. Pushed readings of one round (e.g. one bus conversion) are fused
+ * once all healthy members reported, or after SENSOR_GROUP_ROUND_WAIT if some of them are late,
+ * so a lost member delays control by at most this wait, without reconfiguration.
+ * If no member is healthy, failed sample is published and control holds.
+ */
+class SensorGroup : public SensorBase {
+    struct Member {
+        std::unique_ptr<SensorBase> sensor;
+
+        bool fresh = false;          // Reported in current round
+        bool has_value = false;      // `value` was accepted
+        float value = NAN;           // Last accepted reading
+        uint32_t time_us = 0;        // Of last accepted reading
+        uint32_t good_time = 0;      // millis() of last accepted reading
+        uint32_t changed_time = 0;   // millis() when reading last changed
+        float changed_reference = 0; // Fused value when reading last changed
+        float deviation = 0;         // Smoothed squared deviation from median
+    };
+
+    Timer &_timer;
+    SensorGroupConfig _config;
+    std::vector<Member> _members;
+
+    uint32_t _round_start = 0;       // millis() of the first reading of current round
+    uint32_t _round_time = 0;        // Newest reading time of current round
+
+    SensorSample _sample{};
+    SensorGroupStats _stats{};
+
+public:
+    SensorGroup(Timer &timer, const SensorGroupConfig &config, std::vector<std::unique_ptr<SensorBase>> members);
+
+    [[nodiscard]] const SensorGroupStats &stats() const { return _stats; }
+    [[nodiscard]] const SensorGroupStats *group_stats() const override { return &_stats; }
+    [[nodiscard]] const SensorBase &member(uint8_t index) const { return *_members[index].sensor; }
+
+    void begin() override;
+    void set_event_driven(bool value) override;
+
+    [[nodiscard]] SensorSample sample() override;
+
+    /**
+     * @return true if every member measures on request
+     */
+    [[nodiscard]] bool on_demand() const override;
+
+private:
+    void _check(uint8_t index, const SensorSample &sample);
+    void _set_fault(uint8_t index, SensorFault fault);
+    void _check_timeouts();
+    bool _round_complete() const;
+    void _fuse();
+};
+
+struct __attribute ((packed)) DSx18GroupSensorConfig {
+    uint8_t pin = DSX18_PIN;
+    uint8_t resolution = 10;
+    bool parasite = false;
+    uint8_t count = 3; // Redundant probes: channels 0..count-1 of the bus
+
+    SensorGroupConfig group{};
+};
+
+/**
+ * Redundant DS18x20 probes sharing a bus.
+ */
+class DSx18GroupSensor : public SensorGroup {
+public:
+    DSx18GroupSensor(Timer &timer, const uint8_t *data) : DSx18GroupSensor(timer, _read_config(data)) {}
+
+    [[nodiscard]] const DSx18BusStats *bus_stats() const override { return member(0).bus_stats(); }
+
+private:
+    DSx18GroupSensor(Timer &timer, const DSx18GroupSensorConfig &config);
+
+    static DSx18GroupSensorConfig _read_config(const uint8_t *data);
+    static std::vector<std::unique_ptr<SensorBase>> _make_members(Timer &timer, const DSx18GroupSensorConfig &config);
+};
@@ -12,7 +12,7 @@
 
 #define STORAGE_PATH                            ("/__storage/")
 #define STORAGE_HEADER                          ((uint32_t) 0xd1bfc4a3)
-#define STORAGE_CONFIG_VERSION                  ((uint8_t) 1)
+#define STORAGE_CONFIG_VERSION                  ((uint8_t) 5)
 #define STORAGE_SAVE_INTERVAL                   (60000u)                // Wait before commit settings to FLASH
 
 #define TIMER_GROW_AMOUNT                       (8u)
@@ -31,5 +31,74 @@
 
 #define BTN_HOLD_CALL_INTERVAL                  (20u)
 
-#define SENSOR_LOOP_INTERVAL                    (100u)
+#define SENSOR_LOOP_INTERVAL                    (100u)                  // Sensor readiness check period when PID polls the latest sample, ms
+#define SENSOR_EVENT_LOOP_INTERVAL              (1u)                    // Same with Sensor Event sampling, bounds sample delivery delay, ms
+
+#define ANALOG_SAMPLE_RATE                      (20000u)                // Conversions per second in continuous mode
+#define ANALOG_DMA_BUFFER_SIZE                  (1024u)                 // Bytes, 4 per conversion: ~12 ms of conversions
+#define ANALOG_DMA_FRAME_SIZE                   (256u)                  // Bytes per DMA transfer
+#define ANALOG_DRAIN_INTERVAL                   (1u)                    // DMA buffer drain period in any sampling mode, ms
+#define ANALOG_MIN_DECIMATION_BITS              (4u)                    // At least 16 conversions per value
+#define ANALOG_NOISE_WINDOW                     (64u)                   // Values per noise measurement
+
+#define SENSOR_FILTER_MAX_WINDOW                (15u)                   // Median filter readings, odd
+
+#define SENSOR_GROUP_MAX_MEMBERS                (8u)
+#define SENSOR_GROUP_ROUND_WAIT                 (250u)                  // Longest wait for late members before fusing, ms
+#define SENSOR_GROUP_DEVIATION_SMOOTHING        (0.1f)                  // EMA factor of member deviation for weighted voting
+#define SENSOR_GROUP_MIN_DEVIATION              (0.01f)                 // Floor of member RMS deviation, units: bounds weights
+#define SENSOR_GROUP_STUCK_BAND                 (0.5f)                  // Fused value change a frozen member must miss to be stuck, units
+
+#define DSX18_BUS_MAX_PROBES                    (8u)
+#define DSX18_BUS_SEARCH_INTERVAL               (1000u)                 // Retry period of ROM search while no probes answer, ms
+#define DSX18_BUS_STEP_INTERVAL                 (1u)                    // Bus state machine period: one byte is read per step, ms
+
 #define CONTROL_LOOP_INTERVAL                   (1u)
+
+#define PID_BENCHMARK_ITERATIONS                (4096u)
+#define PID_BENCHMARK_ROUNDS                    (8u)                    // Repeats of startup benchmark, spread is reported
+
+#define SAMPLE_TIMER_INDEX                      (0u)
+#define PID_DT_SCALE_MAX                        (4u)                    // Limit of measured/nominal period passed to PID
+#define PID_DT_SCALE_BITS                       (16u)                   // Fractional bits of measured/nominal period
+#define PID_STATE_MAX_SIZE                      (96u)                   // Buffer for state of any PID engine, see PidBase::save_state
+#define SMITH_PREDICTOR_HISTORY                 (256u)                  // Model outputs kept for dead time, power of two
+
+#define PROGRAM_MAX_SEGMENTS                    (16u)
+#define PROGRAM_INDEX_SIZE                      (64u)                   // Time buckets of setpoint program lookup index
+#define PROGRAM_MIN_RATE                        (1e-4f)                 // Slowest setpoint ramp, units per second
+#define PROGRAM_SLOTS                           (4u)
+#define PROGRAM_FILE                            "program_%u.bin"        // Relative to STORAGE_PATH
+
+#define AUTOTUNE_MAX_CYCLES                     (20u)                   // Give up if oscillation doesn't settle in this many periods
+#define AUTOTUNE_CONSISTENCY                    (0.2f)                  // Allowed spread of period and amplitude, relative to mean
+#define AUTOTUNE_MIN_PHASE                      (0.05f)                 // Phase limit of FOPDT fit, keeps time constant finite
+
+#define IDENT_FILTER_DIVIDER                    (8.f)                   // Steady state filter time constant is settle time divided by this
+
+#define REGULATOR_MAX_CHANNELS                  (4u)                    // Regulator channels including the main one, up to 32
+#define CHANNEL_PARAMETER_MAX_SIZE              (8u)                    // Value of a parameter addressed to a channel
+#define CHANNEL_LOAD_WINDOW                     (10000u)                // Channel CPU load measurement window, ms
+#define CHANNEL_LOAD_BUDGET                     (0.5f)                  // CPU share available to channels in capacity estimate
+#define MQTT_CHANNEL_TOPIC_SIZE                 (64u)
+
+#define CONTROL_TASK_STACK_SIZE                 (4096u)
+#define CONTROL_TASK_PRIORITY                   (10u)                   // Above Arduino loop and AsyncTCP, below WiFi/LwIP
+#define CONTROL_TASK_CORE                       (0)
+#define CONTROL_TASK_TICK_INTERVAL              (1u)                    // Max sleep between iterations without sample timer, ms
+#define TELEMETRY_RING_SIZE                     (32u)                   // Power of two
+
+#define ARCHIVE_DIR                             "archive/"              // Relative to STORAGE_PATH
+#define ARCHIVE_PAGE_SIZE                       (256u)                  // Flash program page, records are written in batches of this size
+#define ARCHIVE_SEGMENT_SIZE                    (4096u)                 // One LittleFS block per segment file
+#define ARCHIVE_MAX_SEGMENTS                    (32u)
+#define ARCHIVE_FLUSH_INTERVAL                  (10ul * 60 * 1000)      // Write partially filled pages at least this often
+#define ARCHIVE_QUERY_MAX_POINTS                (120u)
+#define ARCHIVE_QUERY_MAX_RECORDS               (2048u)                 // Limit of source records read by a single query
+
+#define SENSOR_LOG_PATH                         "/sensor.log"
+#define SENSOR_LOG_PAGE_SIZE                    (256u)                  // File is written and read in batches of this size
+#define SENSOR_LOG_CHUNK_SIZE                   (1024u)                 // Payload of WebSocket stream and download chunks
+#define SENSOR_LOG_FLUSH_INTERVAL               (10000u)                // Write partially filled page at least this often
+#define SENSOR_LOG_STREAM_INTERVAL              (1000u)                 // Send partially filled stream chunk at least this often
+#define REPLAY_PREFETCH_SIZE                    (64u)                   // Samples of replayed log read ahead, power of two
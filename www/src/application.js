@@ -12,10 +12,14 @@ import {
 } from "./constants.js";
 
 import {PacketType} from "./cmd.js";
-import {HistoryChart} from "./control/history_chart.js";
+import {HistoryAppendControl, HistoryArchiveControl, HistoryChart} from "./control/history_chart.js";
+import {parseSensorLogChunk, saveSensorLog, SensorLogStreamControl} from "./control/sensor_log.js";
 
 export class Application extends ApplicationBase {
     #config;
+    #historyChart = null;
+    #historyRequested = false;
+    #sensorLogStream = null;
     #reHost = /([?&]host=)(.*)(?:$|&)/;
 
     get propertyConfig() {return PropertyConfig;}
@@ -47,16 +51,128 @@ export class Application extends ApplicationBase {
         this.propertyMeta["apply_sensor_config"].control.setOnClick(this.applySysConfig.bind(this));
         this.propertyMeta["apply_control_config"].control.setOnClick(this.applySysConfig.bind(this));
         this.propertyMeta["apply_sys_config"].control.setOnClick(this.applySysConfig.bind(this));
+        this.propertyMeta["apply_channels"].control.setOnClick(this.applySysConfig.bind(this));
+
+        this.propertyMeta["autotune_start"].control.setOnClick(() => this.#sendCommand(PacketType.AUTOTUNE_START));
+        this.propertyMeta["autotune_stop"].control.setOnClick(() => this.#sendCommand(PacketType.AUTOTUNE_STOP));
+        this.propertyMeta["autotune_apply"].control.setOnClick(
+            () => this.#applyGains(PacketType.AUTOTUNE_RESULT, PacketType.AUTOTUNE_APPLY, r => this.config.parseAutotuneResult(r), 2));
+
+        this.propertyMeta["identification_start"].control.setOnClick(() => this.#sendCommand(PacketType.IDENT_START));
+        this.propertyMeta["identification_stop"].control.setOnClick(() => this.#sendCommand(PacketType.IDENT_STOP));
+        this.propertyMeta["identification_apply"].control.setOnClick(
+            () => this.#applyGains(PacketType.IDENT_RESULT, PacketType.IDENT_APPLY, r => this.config.parseIdentificationResult(r), 3));
+
+        this.propertyMeta["program_start"].control.setOnClick(() => this.#sendCommand(PacketType.PROGRAM_START));
+        this.propertyMeta["program_stop"].control.setOnClick(() => this.#sendCommand(PacketType.PROGRAM_STOP));
+
+        this.propertyMeta["sensor_log_download"].control.setOnClick(this.#downloadSensorLog.bind(this));
+        this.propertyMeta["sensor_log_save_stream"].control.setOnClick(() => this.#sensorLogStream?.save());
+
+        // State doesn't include history, snapshot is requested separately
+        await this.#requestHistory();
     }
 
     buildControl(prop) {
         if (prop.type === "chart") {
-            return new HistoryChart(document.createElement("canvas"));
+            this.#historyChart = new HistoryChart(document.createElement("canvas"));
+            this.#historyChart.onGap = this.#requestHistory.bind(this);
+
+            return this.#historyChart;
+        }
+
+        if (prop.type === "chart_append") {
+            return new HistoryAppendControl(document.createElement("div"), this.#historyChart);
+        }
+
+        if (prop.type === "chart_archive") {
+            return new HistoryArchiveControl(document.createElement("div"), this.#historyChart);
+        }
+
+        if (prop.type === "sensor_log_stream") {
+            this.#sensorLogStream = new SensorLogStreamControl(document.createElement("div"));
+            return this.#sensorLogStream;
         }
 
         return super.buildControl(prop);
     }
 
+    async #requestHistory() {
+        if (this.#historyRequested) return;
+        this.#historyRequested = true;
+
+        try {
+            const packet = await this.ws.request(PacketType.HISTORY_DATA);
+            this.#historyChart.setValue(packet.parser().readBinary(null));
+        } catch (err) {
+            console.log("Unable to request history", err);
+        } finally {
+            this.#historyRequested = false;
+        }
+    }
+
+    /**
+     * Read recorded log chunk by chunk: FETCH reads the first one, FETCH_NEXT the following, FILE returns the current
+     */
+    async #downloadSensorLog() {
+        try {
+            const parts = [];
+            let command = PacketType.SENSOR_LOG_FETCH;
+
+            while (true) {
+                await this.ws.request(command);
+                const packet = await this.ws.request(PacketType.SENSOR_LOG_FILE);
+                const chunk = parseSensorLogChunk(packet.parser());
+
+                if (chunk.data.length > 0) parts.push(chunk.data.slice());
+                if (chunk.data.length === 0 || chunk.offset + chunk.data.length >= chunk.total) break;
+
+                command = PacketType.SENSOR_LOG_FETCH_NEXT;
+            }
+
+            if (parts.length > 0) saveSensorLog(parts, "sensor.log");
+        } catch (err) {
+            console.log("Unable to download sensor log", err);
+        }
+    }
+
+    async #sendCommand(type) {
+        try {
+            await this.ws.request(type);
+        } catch (err) {
+            console.log("Unable to send command", err);
+        }
+    }
+
+    /**
+     * Ask device to apply gains proposed by autotune or step test (and the model of step test), if the result is ready
+     */
+    async #applyGains(resultCmd, applyCmd, parse, doneState) {
+        try {
+            const packet = await this.ws.request(resultCmd);
+            const result = parse(packet.parser());
+            if (result.state !== doneState) return;
+
+            await this.ws.request(applyCmd);
+
+            // Device changed PID_P/PID_I/PID_D itself, reflect new values in controls
+            for (const key of ["p", "i", "d"]) {
+                this.config.pid[key] = result[key];
+                this.propertyMeta[`pid.${key}`].control.setValue(result[key]);
+            }
+
+            // Step test also passes its model to the Smith predictor
+            if (result.model) {
+                for (const key of ["gain", "timeConstant", "deadTime"]) {
+                    this.config.predictor[key] = result.model[key];
+                    this.propertyMeta[`predictor.${key}`].control.setValue(result.model[key]);
+                }
+            }
+        } catch (err) {
+            console.log("Unable to apply gains", err);
+        }
+    }
+
     async applySysConfig(sender) {
         if (sender.getAttribute("data-saving") === "true") return;
 
@@ -2,6 +2,12 @@ import {AppConfigBase, BinaryParser} from "./lib/index.js";
 
 import {PropertyConfig} from "./props.js";
 import {PacketType} from "./cmd.js";
+import {
+    DSX18_BUS_MAX_PROBES,
+    HISTORY_APPEND_SIZE,
+    REGULATOR_MAX_CHANNELS,
+    SENSOR_GROUP_MAX_MEMBERS
+} from "./constants.js";
 
 
 export class Config extends AppConfigBase {
@@ -10,6 +16,10 @@ export class Config extends AppConfigBase {
     sensor;
     control;
     pid;
+    autotune;
+    identification;
+    channels;
+    program;
 
     sysConfig;
 
@@ -26,10 +36,15 @@ export class Config extends AppConfigBase {
         this.lists["sensorType"] = [
             {code: 0, name: "Analog"},
             {code: 1, name: "DSX18X"},
+            {code: 2, name: "Replay"},
+            {code: 3, name: "DSX18X Bus"},
+            {code: 4, name: "DSX18X Redundant"},
         ]
 
         this.lists["controlType"] = [
             {code: 0, name: "PWM"},
+            {code: 1, name: "LEDC PWM"},
+            {code: 2, name: "Cascade"},
         ]
 
         this.lists["proportionalMode"] = [
@@ -58,6 +73,38 @@ export class Config extends AppConfigBase {
             {code: 0, name: "Forward"},
             {code: 1, name: "Reverse"}
         ];
+
+        this.lists["samplingMode"] = [
+            {code: 0, name: "Polled"},
+            {code: 1, name: "Hardware Timer"},
+            {code: 2, name: "Sensor Event"}
+        ];
+
+        this.lists["sensorVoting"] = [
+            {code: 0, name: "Median"},
+            {code: 1, name: "Weighted"}
+        ];
+
+        this.lists["archiveRange"] = [
+            {code: 0, name: "Live"},
+            {code: 3600, name: "1 hour"},
+            {code: 6 * 3600, name: "6 hours"},
+            {code: 24 * 3600, name: "24 hours"},
+            {code: 7 * 24 * 3600, name: "7 days"},
+            {code: 30 * 24 * 3600, name: "30 days"}
+        ];
+
+        this.lists["tuningRule"] = [
+            {code: 0, name: "Ziegler–Nichols"},
+            {code: 1, name: "Tyreus–Luyben"},
+            {code: 2, name: "SIMC (PI)"}
+        ];
+
+        this.lists["pidEngine"] = [
+            {code: 0, name: "Float"},
+            {code: 1, name: "Fixed-point"},
+            {code: 2, name: "Specialized"}
+        ];
     }
 
     get cmd() {return PacketType.GET_CONFIG;}
@@ -72,21 +119,76 @@ export class Config extends AppConfigBase {
     parse(parser) {
         this.power = parser.readBoolean();
 
-        this.sensor = {
+        Object.assign(this, this.#parseRegulator(parser));
+
+        this.nightMode = {
+            enabled: parser.readBoolean(),
+            startTime: parser.readUint32(),
+            endTime: parser.readUint32()
+        };
+
+        this.autotune = {
+            rule: parser.readUint8(),
+            amplitude: parser.readFloat32(),
+            hysteresis: parser.readFloat32(),
+            cycles: parser.readUint8(),
+            timeout: parser.readUint16()
+        };
+
+        this.identification = {
+            outputFrom: parser.readFloat32(),
+            outputTo: parser.readFloat32(),
+            settleBand: parser.readFloat32(),
+            settleTime: parser.readUint16(),
+            timeout: parser.readUint16()
+        };
+
+        this.channels = {
+            count: parser.readUint8(),
+            enabled: parser.readUint32(),
+            extra: Array.from({length: REGULATOR_MAX_CHANNELS - 1}, () => this.#parseRegulator(parser))
+        };
+
+        this.program = {
+            slot: parser.readUint8()
+        };
+
+        this.sysConfig = {
+            mdnsName: parser.readFixedString(32),
+
+            wifiMode: parser.readUint8(),
+            wifiSsid: parser.readFixedString(32),
+            wifiPassword: parser.readFixedString(32),
+
+            wifiConnectionCheckInterval: parser.readUint32(),
+            wifiMaxConnectionAttemptInterval: parser.readUint32(),
+
+            timeZone: parser.readFloat32(),
+
+            mqtt: parser.readBoolean(),
+            mqttHost: parser.readFixedString(32),
+            mqttPort: parser.readUint16(),
+            mqttUser: parser.readFixedString(32),
+            mqttPassword: parser.readFixedString(32)
+        };
+    }
+
+    #parseRegulator(parser) {
+        const sensor = {
             type: parser.readUint8(),
             data: parser.readBinary(1024)
         };
 
-        this.#parseSensor();
+        this.#parseSensor(sensor);
 
-        this.control = {
+        const control = {
             type: parser.readUint8(),
             data: parser.readBinary(1024)
         };
 
-        this.#parseControl();
+        this.#parseControl(control);
 
-        this.pid = {
+        const pid = {
             target: parser.readFloat32(),
             interval: parser.readUint16(),
 
@@ -103,71 +205,275 @@ export class Config extends AppConfigBase {
             iMode: parser.readUint8(),
             iLimit: parser.readUint8(),
             dMode: parser.readUint8(),
-            direction: parser.readUint8()
-        };
+            direction: parser.readUint8(),
 
-        this.nightMode = {
-            enabled: parser.readBoolean(),
-            startTime: parser.readUint32(),
-            endTime: parser.readUint32()
+            engine: parser.readUint8(),
+            sampling: parser.readUint8()
         };
 
+        const filter = {
+            median: parser.readBoolean(),
+            medianWindow: parser.readUint8(),
+            ema: parser.readBoolean(),
+            emaTimeConstant: parser.readFloat32(),
+            kalman: parser.readBoolean(),
+            kalmanProcessNoise: parser.readFloat32(),
+            kalmanMeasurementNoise: parser.readFloat32(),
+            slew: parser.readBoolean(),
+            slewRate: parser.readFloat32()
+        };
 
-        this.sysConfig = {
-            mdnsName: parser.readFixedString(32),
-
-            wifiMode: parser.readUint8(),
-            wifiSsid: parser.readFixedString(32),
-            wifiPassword: parser.readFixedString(32),
-
-            wifiConnectionCheckInterval: parser.readUint32(),
-            wifiMaxConnectionAttemptInterval: parser.readUint32(),
-
-            timeZone: parser.readFloat32(),
-
-            mqtt: parser.readBoolean(),
-            mqttHost: parser.readFixedString(32),
-            mqttPort: parser.readUint16(),
-            mqttUser: parser.readFixedString(32),
-            mqttPassword: parser.readFixedString(32)
+        const predictor = {
+            enabled: parser.readBoolean(),
+            gain: parser.readFloat32(),
+            timeConstant: parser.readFloat32(),
+            deadTime: parser.readFloat32(),
+            modelValid: parser.readBoolean()
         };
+
+        return {sensor, control, pid, filter, predictor};
     }
 
-    #parseSensor() {
-        const parser = new BinaryParser(this.sensor.data.buffer, this.sensor.data.byteOffset);
+    #parseSensor(sensor) {
+        const parser = new BinaryParser(sensor.data.buffer, sensor.data.byteOffset);
 
-        this.sensor.parsed = {};
-        if (this.sensor.type === 0) { // ANALOG
-            this.sensor.parsed["analog"] = {
+        sensor.parsed = {};
+        if (sensor.type === 0) { // ANALOG
+            sensor.parsed["analog"] = {
                 pin: parser.readUint8(),
                 resolution: parser.readUint8(),
+                continuous: parser.readBoolean(),
             }
-        } else if (this.sensor.type === 1) { // DSX18X
-            this.sensor.parsed["dsx18x"] = {
+        } else if (sensor.type === 1) { // DSX18X
+            sensor.parsed["dsx18x"] = {
                 pin: parser.readUint8(),
                 resolution: parser.readUint8(),
                 parasite: parser.readBoolean(),
             }
+        } else if (sensor.type === 2) { // REPLAY
+            sensor.parsed["replay"] = {
+                loop: parser.readBoolean(),
+            }
+        } else if (sensor.type === 3) { // DSX18X_BUS
+            sensor.parsed["dsx18x_bus"] = {
+                pin: parser.readUint8(),
+                resolution: parser.readUint8(),
+                parasite: parser.readBoolean(),
+                channel: parser.readUint8(),
+            }
+        } else if (sensor.type === 4) { // DSX18X_GROUP
+            sensor.parsed["dsx18x_group"] = {
+                pin: parser.readUint8(),
+                resolution: parser.readUint8(),
+                parasite: parser.readBoolean(),
+                count: parser.readUint8(),
+                voting: parser.readUint8(),
+                minValue: parser.readFloat32(),
+                maxValue: parser.readFloat32(),
+                maxRate: parser.readFloat32(),
+                stuckTime: parser.readUint16(),
+                timeout: parser.readUint16(),
+            }
         }
     }
 
-    #parseControl() {
-        const parser = new BinaryParser(this.control.data.buffer, this.control.data.byteOffset);
+    #parseControl(control) {
+        const parser = new BinaryParser(control.data.buffer, control.data.byteOffset);
 
-        this.control.parsed = {};
-        if (this.control.type === 0) { // PWM
-            this.control.parsed["pwm"] = {
+        control.parsed = {};
+        if (control.type === 0) { // PWM
+            control.parsed["pwm"] = {
                 pin: parser.readUint8(),
                 period: parser.readUint16(),
             }
+        } else if (control.type === 1) { // LEDC_PWM
+            control.parsed["ledc"] = {
+                pin: parser.readUint8(),
+                channel: parser.readUint8(),
+                frequency: parser.readUint32(),
+                resolution: parser.readUint8(),
+            }
+        } else if (control.type === 2) { // CASCADE
+            control.parsed["cascade"] = {
+                channel: parser.readUint8(),
+            }
+        }
+    }
+
+    parseSamplingStats(parser) {
+        return {
+            count: parser.readUint32(),
+            missed: parser.readUint32(),
+            periodMin: parser.readUint32(),
+            periodMax: parser.readUint32(),
+            jitterRms: parser.readFloat32(),
+            latencyMax: parser.readUint32(),
+            dropped: parser.readUint32(),
+            sensorLatencyAvg: parser.readFloat32(),
+            sensorLatencyMax: parser.readUint32(),
+        };
+    }
+
+    parseAutotuneResult(parser) {
+        return {
+            state: parser.readUint8(),
+            cycles: parser.readUint8(),
+            ultimateGain: parser.readFloat32(),
+            ultimatePeriod: parser.readFloat32(),
+            amplitude: parser.readFloat32(),
+            model: {
+                gain: parser.readFloat32(),
+                timeConstant: parser.readFloat32(),
+                deadTime: parser.readFloat32(),
+            },
+            p: parser.readFloat32(),
+            i: parser.readFloat32(),
+            d: parser.readFloat32(),
+        };
+    }
+
+    parseIdentificationResult(parser) {
+        return {
+            state: parser.readUint8(),
+            elapsed: parser.readUint32(),
+            initialValue: parser.readFloat32(),
+            finalValue: parser.readFloat32(),
+            model: {
+                gain: parser.readFloat32(),
+                timeConstant: parser.readFloat32(),
+                deadTime: parser.readFloat32(),
+            },
+            p: parser.readFloat32(),
+            i: parser.readFloat32(),
+            d: parser.readFloat32(),
+        };
+    }
+
+    parseProgramStatus(parser) {
+        return {
+            state: parser.readUint8(),
+            count: parser.readUint8(),
+            segment: parser.readUint8(),
+            ramp: parser.readBoolean(),
+            elapsed: parser.readUint32(),
+            duration: parser.readUint32(),
+            held: parser.readUint32(),
+            setpoint: parser.readFloat32(),
+            slope: parser.readFloat32(),
+        };
+    }
+
+    parseSensorLogState(parser) {
+        return {
+            record: parser.readBoolean(),
+            stream: parser.readBoolean(),
+            failed: parser.readBoolean(),
+            size: parser.readUint32(),
+            samples: parser.readUint32(),
+        };
+    }
+
+    parseSensorBusStats(parser) {
+        const count = parser.readUint8();
+        const stats = {
+            count,
+            scans: parser.readUint32(),
+            conversionTime: parser.readUint16(),
+            readTime: parser.readUint16(),
+            probes: [],
+        };
+
+        for (let i = 0; i < DSX18_BUS_MAX_PROBES; i++) {
+            const probe = {
+                rom: Array.from(parser.readBinary(8), b => b.toString(16).padStart(2, "0")).join(""),
+                value: parser.readFloat32(),
+                crcErrors: parser.readUint32(),
+            };
+
+            if (i < count) stats.probes.push(probe);
         }
+
+        return stats;
+    }
+
+    parseSensorNoiseStats(parser) {
+        return {
+            windows: parser.readUint32(),
+            sampleRate: parser.readUint32(),
+            decimation: parser.readUint16(),
+            overruns: parser.readUint32(),
+            rawRms: parser.readFloat32(),
+            valueRms: parser.readFloat32(),
+            rawEnob: parser.readFloat32(),
+            enob: parser.readFloat32(),
+        };
+    }
+
+    parseSensorGroupStats(parser) {
+        const count = parser.readUint8();
+        const stats = {
+            count,
+            healthy: parser.readUint8(),
+            rounds: parser.readUint32(),
+            faults: parser.readUint32(),
+            members: [],
+        };
+
+        for (let i = 0; i < SENSOR_GROUP_MAX_MEMBERS; i++) {
+            const member = {
+                value: parser.readFloat32(),
+                weight: parser.readFloat32(),
+                fault: parser.readUint8(),
+                faults: parser.readUint32(),
+            };
+
+            if (i < count) stats.members.push(member);
+        }
+
+        return stats;
+    }
+
+    parseChannelsState(parser) {
+        const load = {
+            channels: parser.readUint8(),
+            windows: parser.readUint32(),
+            updates: parser.readUint32(),
+            updateCycles: parser.readFloat32(),
+            updateCyclesMax: parser.readUint32(),
+            passCyclesMax: parser.readUint32(),
+            passUpdatesMax: parser.readUint8(),
+            load: parser.readFloat32(),
+            capacity: parser.readUint16(),
+        };
+
+        const channels = [];
+        for (let i = 0; i < REGULATOR_MAX_CHANNELS; i++) {
+            channels.push({
+                sensorValue: parser.readFloat32(),
+                controlValue: parser.readFloat32(),
+                active: parser.readBoolean(),
+                computes: parser.readUint32(),
+            });
+        }
+
+        return {load, channels};
     }
 
     #parseState(parser) {
         return {
             sensor_value: parser.readFloat32(),
             control_value: parser.readFloat32(),
-            history: parser.readBinary(null)
+            sampling: this.parseSamplingStats(parser),
+            history_append: parser.readBinary(HISTORY_APPEND_SIZE),
+            archive_range: parser.readUint32(),
+            autotune: this.parseAutotuneResult(parser),
+            identification: this.parseIdentificationResult(parser),
+            sensor_log: this.parseSensorLogState(parser),
+            sensor_bus: this.parseSensorBusStats(parser),
+            sensor_noise: this.parseSensorNoiseStats(parser),
+            sensor_group: this.parseSensorGroupStats(parser),
+            channels: this.parseChannelsState(parser),
+            program: this.parseProgramStatus(parser)
         };
     }
 }
\ No newline at end of file
@@ -6,4 +6,11 @@ export const CONNECTION_CLOSE_TIMEOUT = 500;
 export const REQUEST_SIGNATURE = [0xca, 0xcc];
 export const DEFAULT_ADDRESS = "esp_pid.local";
 
-export const THROTTLE_INTERVAL = 1000 / 60;
\ No newline at end of file
+export const THROTTLE_INTERVAL = 1000 / 60;
+
+export const HISTORY_APPEND_SIZE = 4 + 3 * 4; // seq + HistoryEntry
+export const DSX18_BUS_MAX_PROBES = 8;
+export const SENSOR_FILTER_MAX_WINDOW = 15;
+export const SENSOR_GROUP_MAX_MEMBERS = 8;
+export const REGULATOR_MAX_CHANNELS = 4;
+export const PROGRAM_SLOTS = 4;
@@ -1,6 +1,7 @@
-import {BinaryParser} from "../lib/index.js";
+import {BinaryParser, Control} from "../lib/index.js";
 
 import {Chart} from "./chart.js";
+import {decodeHistory} from "../utils/history_codec.js";
 
 export class HistoryChart extends Chart {
     constructor(element) {
@@ -22,50 +23,158 @@ export class HistoryChart extends Chart {
         super(element, baseConfig);
     }
 
+    #entries = [];
+    #count = 0;
+    #seq = null;
+    #archive = false;
+
+    /**
+     * Called when append packet doesn't follow the last known entry, full snapshot has to be requested
+     * @type {(() => void)|null}
+     */
+    onGap = null;
+
     setValue(value) {
         if (!value) return;
 
+        const {count, seq, sensorMin, sensorMax, entries} = decodeHistory(value);
+
+        this.#entries = entries;
+        this.#count = count;
+        this.#seq = seq;
+        this.#archive = false;
+
+        this.config.axes.sensorAxis.suggestedMin = sensorMin;
+        this.config.axes.sensorAxis.suggestedMax = sensorMax;
+
+        this.#update();
+    }
+
+    /**
+     * Apply HISTORY_APPEND packet: sequence number followed by single entry
+     */
+    appendValue(value) {
+        if (!value || this.#archive) return;
+
         const parser = new BinaryParser(value.buffer, value.byteOffset);
-        const count = parser.readUint16();
+        const seq = parser.readUint32();
+        const entry = HistoryChart.#readEntry(parser);
 
-        const sensorMin = parser.readFloat32();
-        const sensorMax = parser.readFloat32();
+        // Already included in snapshot
+        if (this.#seq !== null && seq <= this.#seq) return;
 
-        const index = parser.readUint16();
-        const entries = new Array(count);
-        for (let i = 0; i < count; i++) {
-            entries[i] = {
-                sensor: parser.readFloat32(),
-                control: parser.readFloat32(),
-                integral: parser.readFloat32()
-            };
+        if (this.#seq === null || seq !== this.#seq + 1) {
+            this.#seq = null;
+            this.onGap?.();
+            return;
         }
 
-        // reorder entries based on index
-        const ordered = [];
+        this.#seq = seq;
+        if (Number.isNaN(entry.sensor) || Number.isNaN(entry.control)) return;
+
+        this.#entries.push(entry);
+        if (this.#entries.length > this.#count) this.#entries.shift();
+
+        const axis = this.config.axes.sensorAxis;
+        axis.suggestedMin = Math.min(axis.suggestedMin ?? entry.sensor, entry.sensor);
+        axis.suggestedMax = Math.max(axis.suggestedMax ?? entry.sensor, entry.sensor);
+
+        this.#update();
+    }
+
+    /**
+     * Show HISTORY_ARCHIVE query result: header followed by min/avg/max records. Live updates are paused until next snapshot
+     */
+    setArchive(value) {
+        if (!value) return;
+
+        const parser = new BinaryParser(value.buffer, value.byteOffset);
+        parser.readUint32(); // from
+        parser.readUint32(); // period
+        const count = parser.readUint16();
+
+        let sensorMin = Infinity, sensorMax = -Infinity;
+        const entries = new Array(count);
         for (let i = 0; i < count; i++) {
-            const pos = (index + i) % count;
-            const entry = entries[pos];
-            if (!Number.isNaN(entry.sensor) && !Number.isNaN(entry.control)) {
-                ordered.push(entry);
-            }
+            parser.readUint32(); // time
+
+            const min = HistoryChart.#readEntry(parser);
+            entries[i] = HistoryChart.#readEntry(parser);
+            const max = HistoryChart.#readEntry(parser);
+
+            sensorMin = Math.min(sensorMin, min.sensor);
+            sensorMax = Math.max(sensorMax, max.sensor);
         }
 
+        this.#entries = entries;
+        this.#count = count;
+        this.#seq = null;
+        this.#archive = true;
+
+        this.config.axes.sensorAxis.suggestedMin = sensorMin;
+        this.config.axes.sensorAxis.suggestedMax = sensorMax;
+
+        this.#update();
+    }
+
+    #update() {
         const target = window.__app.app.config.pid?.target ?? 0;
+        const entries = this.#entries;
 
         const values = {
-            target: new Array(ordered.length).fill(target),
-            sensor: ordered.map(e => e.sensor),
-            control: ordered.map(e => e.control),
-            integral: ordered.map(e => e.integral)
+            target: new Array(entries.length).fill(target),
+            sensor: entries.map(e => e.sensor),
+            control: entries.map(e => e.control),
+            integral: entries.map(e => e.integral)
         };
 
-        this.config.axes.sensorAxis.suggestedMin = sensorMin;
-        this.config.axes.sensorAxis.suggestedMax = sensorMax;
-
         this.setConfig({
             ...this.config,
-            data: {count: ordered.length, values}
+            data: {count: entries.length, values}
         });
     }
-}
\ No newline at end of file
+
+    static #readEntry(parser) {
+        return {
+            sensor: parser.readFloat32(),
+            control: parser.readFloat32(),
+            integral: parser.readFloat32()
+        };
+    }
+}
+
+/**
+ * Invisible control bound to HISTORY_APPEND packet, forwards entries to the chart
+ */
+export class HistoryAppendControl extends Control {
+    #chart;
+
+    constructor(element, chart) {
+        super(element);
+
+        this.#chart = chart;
+        element.style.display = "none";
+    }
+
+    setValue(value) {
+        this.#chart?.appendValue(value);
+    }
+}
+
+/**
+ * Invisible control bound to HISTORY_ARCHIVE packet, forwards archive query result to the chart
+ */
+export class HistoryArchiveControl extends Control {
+    #chart;
+
+    constructor(element, chart) {
+        super(element);
+
+        this.#chart = chart;
+        element.style.display = "none";
+    }
+
+    setValue(value) {
+        this.#chart?.setArchive(value);
+    }
+}
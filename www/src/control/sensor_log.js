@@ -0,0 +1,67 @@
+import {BinaryParser, Control} from "../lib/index.js";
+
+export const SENSOR_LOG_CHUNK_HEADER_SIZE = 10;
+
+/**
+ * @param {BinaryParser} parser
+ * @returns {{offset: number, total: number, data: Uint8Array}}
+ */
+export function parseSensorLogChunk(parser) {
+    const offset = parser.readUint32();
+    const total = parser.readUint32();
+    const length = parser.readUint16();
+
+    return {offset, total, data: parser.readBinary(length)};
+}
+
+/**
+ * Offer bytes as a file download
+ */
+export function saveSensorLog(parts, name) {
+    const url = URL.createObjectURL(new Blob(parts, {type: "application/octet-stream"}));
+
+    const link = document.createElement("a");
+    link.href = url;
+    link.download = name;
+    link.click();
+
+    setTimeout(() => URL.revokeObjectURL(url), 1000);
+}
+
+/**
+ * Invisible control bound to SENSOR_LOG_DATA packet, collects streamed log.
+ * Chunks are contiguous from the start of the stream, so collected bytes form a valid log file.
+ */
+export class SensorLogStreamControl extends Control {
+    #parts = [];
+    #size = 0;
+
+    get size() {return this.#size;}
+
+    constructor(element) {
+        super(element);
+
+        element.style.display = "none";
+    }
+
+    setValue(value) {
+        const chunk = parseSensorLogChunk(new BinaryParser(value.buffer, value.byteOffset));
+
+        // New stream starts from offset zero, anything else out of order means lost chunks
+        if (chunk.offset === 0) {
+            this.#parts = [];
+            this.#size = 0;
+        } else if (chunk.offset !== this.#size) {
+            console.log(`Sensor log stream: expected offset ${this.#size}, got ${chunk.offset}`);
+            return;
+        }
+
+        this.#parts.push(chunk.data.slice());
+        this.#size += chunk.data.length;
+    }
+
+    save() {
+        if (this.#size === 0) return;
+        saveSensorLog(this.#parts, "sensor_stream.log");
+    }
+}
@@ -1,4 +1,6 @@
+import {BinaryParser} from "./lib/index.js";
 import {PacketType} from "./cmd.js";
+import {DSX18_BUS_MAX_PROBES, PROGRAM_SLOTS, REGULATOR_MAX_CHANNELS, SENSOR_FILTER_MAX_WINDOW} from "./constants.js";
 
 function fix_float(value) {
     const fixed = value.toFixed(4);
@@ -14,6 +16,41 @@ function fix_float(value) {
     return fixed.slice(0, i + 1);
 }
 
+const AUTOTUNE_STATE = ["Idle", "Running", "Done", "Failed"];
+const SENSOR_FAULT = ["OK", "lost", "out of range", "rate", "stuck"];
+
+function autotune_summary(result) {
+    if (result.state === 1) return `running, ${result.cycles} cycles`;
+    if (result.state !== 2) return AUTOTUNE_STATE[result.state] ?? "Unknown";
+
+    return `Ku ${fix_float(result.ultimateGain)}, Pu ${result.ultimatePeriod.toFixed(1)} s → `
+        + `kP ${fix_float(result.p)}, kI ${fix_float(result.i)}, kD ${fix_float(result.d)}`;
+}
+
+const IDENTIFICATION_STATE = ["Idle", "Settling", "Step", "Done", "Failed"];
+
+function identification_summary(result) {
+    if (result.state === 1 || result.state === 2) {
+        return `${IDENTIFICATION_STATE[result.state].toLowerCase()}, ${result.elapsed} s, sensor ${result.finalValue.toFixed(2)}`;
+    }
+
+    if (result.state !== 3) return IDENTIFICATION_STATE[result.state] ?? "Unknown";
+
+    const {gain, timeConstant, deadTime} = result.model;
+    return `K ${fix_float(gain)}, τ ${timeConstant.toFixed(1)} s, θ ${deadTime.toFixed(1)} s → `
+        + `kP ${fix_float(result.p)}, kI ${fix_float(result.i)}, kD ${fix_float(result.d)}`;
+}
+
+const PROGRAM_STATE = ["Idle", "Running", "Hold", "Done", "Failed"];
+
+function program_summary(status) {
+    if (status.state < 1 || status.state > 3) return PROGRAM_STATE[status.state] ?? "Unknown";
+
+    const step = status.ramp ? `ramp ${fix_float(status.slope)}/s` : "soak";
+    return `${PROGRAM_STATE[status.state].toLowerCase()}, segment ${status.segment + 1}/${status.count} ${step}, `
+        + `setpoint ${status.setpoint.toFixed(2)}, ${status.elapsed}/${status.duration} s, held ${status.held} s`;
+}
+
 /**@type {PropertiesConfig} */
 export const PropertyConfig = [{
     key: "status", section: "Status", props: [
@@ -33,7 +70,27 @@ export const PropertyConfig = [{
             ]
         },
 
+        {
+            key: "status.sampling", type: "label", kind: "Binary",
+            cmd: PacketType.SAMPLING_STATS,
+            displayConverter: (value) => {
+                // Initial state is already parsed by Config, notifications carry raw packet
+                const stats = value instanceof Uint8Array
+                    ? window.__app.app.config.parseSamplingStats(new BinaryParser(value.buffer, value.byteOffset))
+                    : value;
+
+                return [
+                    "Sampling:",
+                    `${(stats.jitterRms / 1000).toFixed(2)} ms jitter, ${(stats.latencyMax / 1000).toFixed(1)} ms latency, ${stats.missed} missed, ${stats.dropped} dropped, `
+                    + `sensor age ${(stats.sensorLatencyAvg / 1000).toFixed(1)}/${(stats.sensorLatencyMax / 1000).toFixed(1)} ms`
+                ];
+            }
+        },
+
+        {key: "status.archive_range", title: "History", type: "select", kind: "Uint32", list: "archiveRange", cmd: PacketType.HISTORY_ARCHIVE_RANGE},
         {key: "status.history", type: "chart", kind: "Binary", cmd: PacketType.HISTORY_DATA},
+        {key: "status.history_append", type: "chart_append", kind: "Binary", cmd: PacketType.HISTORY_APPEND},
+        {key: "status.archive", type: "chart_archive", kind: "Binary", cmd: PacketType.HISTORY_ARCHIVE},
     ]
 }, {
     key: "general", section: "General", props: [
@@ -54,7 +111,25 @@ export const PropertyConfig = [{
         // ANALOG
         {key: "sensor.parsed.analog", type: "skip"},
         {key: "sensor.parsed.analog.pin", title: "Pin", type: "int", kind: "Uint8", cmd: PacketType.ANALOG_SENSOR_PIN, visibleIf: "sensor.parsed.analog"},
-        {key: "sensor.parsed.analog.resolution", title: "Resolution", type: "int", kind: "Uint8", min: 8, limit: 14, cmd: PacketType.ANALOG_SENSOR_RESOLUTION, visibleIf: "sensor.parsed.analog"},
+        {key: "sensor.parsed.analog.resolution", title: "Resolution", type: "int", kind: "Uint8", min: 8, limit: 16, cmd: PacketType.ANALOG_SENSOR_RESOLUTION, visibleIf: "sensor.parsed.analog"},
+        {key: "sensor.parsed.analog.continuous", title: "Continuous", type: "trigger", kind: "Boolean", cmd: PacketType.ANALOG_SENSOR_CONTINUOUS, visibleIf: "sensor.parsed.analog"},
+        {key: "status.sensor_noise", type: "label", kind: "Binary", cmd: PacketType.SENSOR_NOISE_STATS, visibleIf: "sensor.parsed.analog.continuous",
+            displayConverter: (value) => {
+                // Initial state is already parsed by Config, notifications carry raw packet
+                const stats = value instanceof Uint8Array
+                    ? window.__app.app.config.parseSensorNoiseStats(new BinaryParser(value.buffer, value.byteOffset))
+                    : value;
+
+                if (!stats.windows) return ["Noise:", "measuring..."];
+
+                const rate = (stats.sampleRate / stats.decimation).toFixed(0);
+                return [
+                    "Noise:",
+                    `ENOB ${stats.rawEnob.toFixed(2)} → ${stats.enob.toFixed(2)} bits, ${stats.rawRms.toFixed(2)} → ${stats.valueRms.toFixed(2)} LSB rms, `
+                    + `${stats.decimation} conversions per value (${rate} Hz), ${stats.overruns} overruns`
+                ];
+            }
+        },
 
         // DSX18X
         {key: "sensor.parsed.dsx18x", type: "skip"},
@@ -62,6 +137,70 @@ export const PropertyConfig = [{
         {key: "sensor.parsed.dsx18x.resolution", title: "Resolution", type: "int", kind: "Uint8", min: 9, limit: 12, cmd: PacketType.DSX18_SENSOR_RESOLUTION, visibleIf: "sensor.parsed.dsx18x"},
         {key: "sensor.parsed.dsx18x.parasite", title: "Parasite power", type: "trigger", kind: "Boolean", cmd: PacketType.DSX18_SENSOR_PARASITE, visibleIf: "sensor.parsed.dsx18x"},
 
+        // DSX18X_BUS
+        {key: "sensor.parsed.dsx18x_bus", type: "skip"},
+        {key: "sensor.parsed.dsx18x_bus.pin", title: "Pin", type: "int", kind: "Uint8", cmd: PacketType.DSX18_BUS_SENSOR_PIN, visibleIf: "sensor.parsed.dsx18x_bus"},
+        {key: "sensor.parsed.dsx18x_bus.resolution", title: "Resolution", type: "int", kind: "Uint8", min: 9, limit: 12, cmd: PacketType.DSX18_BUS_SENSOR_RESOLUTION, visibleIf: "sensor.parsed.dsx18x_bus"},
+        {key: "sensor.parsed.dsx18x_bus.parasite", title: "Parasite power", type: "trigger", kind: "Boolean", cmd: PacketType.DSX18_BUS_SENSOR_PARASITE, visibleIf: "sensor.parsed.dsx18x_bus"},
+        {key: "sensor.parsed.dsx18x_bus.channel", title: "Probe", type: "int", kind: "Uint8", min: 0, limit: DSX18_BUS_MAX_PROBES - 1, cmd: PacketType.DSX18_BUS_SENSOR_CHANNEL, visibleIf: "sensor.parsed.dsx18x_bus"},
+        {key: "status.sensor_bus", type: "label", kind: "Binary", cmd: PacketType.SENSOR_BUS_STATS, visibleIf: "sensor.parsed.dsx18x_bus",
+            displayConverter: (value) => {
+                // Initial state is already parsed by Config, notifications carry raw packet
+                const stats = value instanceof Uint8Array
+                    ? window.__app.app.config.parseSensorBusStats(new BinaryParser(value.buffer, value.byteOffset))
+                    : value;
+
+                const probes = stats.probes.map((p, i) => `#${i} ${p.rom}: ${p.value.toFixed(2)}, ${p.crcErrors} CRC errors`);
+                return [
+                    "Bus:",
+                    [`${stats.count} probes, conversion ${stats.conversionTime} ms, read ${stats.readTime} ms`, ...probes].join("; ")
+                ];
+            }
+        },
+
+        // DSX18X_GROUP
+        {key: "sensor.parsed.dsx18x_group", type: "skip"},
+        {key: "sensor.parsed.dsx18x_group.pin", title: "Pin", type: "int", kind: "Uint8", cmd: PacketType.DSX18_GROUP_SENSOR_PIN, visibleIf: "sensor.parsed.dsx18x_group"},
+        {key: "sensor.parsed.dsx18x_group.resolution", title: "Resolution", type: "int", kind: "Uint8", min: 9, limit: 12, cmd: PacketType.DSX18_GROUP_SENSOR_RESOLUTION, visibleIf: "sensor.parsed.dsx18x_group"},
+        {key: "sensor.parsed.dsx18x_group.parasite", title: "Parasite power", type: "trigger", kind: "Boolean", cmd: PacketType.DSX18_GROUP_SENSOR_PARASITE, visibleIf: "sensor.parsed.dsx18x_group"},
+        {key: "sensor.parsed.dsx18x_group.count", title: "Probes", type: "int", kind: "Uint8", min: 1, limit: DSX18_BUS_MAX_PROBES, cmd: PacketType.DSX18_GROUP_SENSOR_COUNT, visibleIf: "sensor.parsed.dsx18x_group"},
+        {key: "sensor.parsed.dsx18x_group.voting", title: "Voting", type: "select", kind: "Uint8", list: "sensorVoting", cmd: PacketType.DSX18_GROUP_SENSOR_VOTING, visibleIf: "sensor.parsed.dsx18x_group"},
+        {key: "sensor.parsed.dsx18x_group.minValue", title: "Min Value", type: "float", kind: "Float32", cmd: PacketType.DSX18_GROUP_SENSOR_MIN_VALUE, visibleIf: "sensor.parsed.dsx18x_group", transform: fix_float},
+        {key: "sensor.parsed.dsx18x_group.maxValue", title: "Max Value", type: "float", kind: "Float32", cmd: PacketType.DSX18_GROUP_SENSOR_MAX_VALUE, visibleIf: "sensor.parsed.dsx18x_group", transform: fix_float},
+        {key: "sensor.parsed.dsx18x_group.maxRate", title: "Max Rate (units/s)", type: "float", kind: "Float32", cmd: PacketType.DSX18_GROUP_SENSOR_MAX_RATE, visibleIf: "sensor.parsed.dsx18x_group", transform: fix_float},
+        {key: "sensor.parsed.dsx18x_group.stuckTime", title: "Stuck Time (s)", type: "int", kind: "Uint16", cmd: PacketType.DSX18_GROUP_SENSOR_STUCK_TIME, visibleIf: "sensor.parsed.dsx18x_group"},
+        {key: "sensor.parsed.dsx18x_group.timeout", title: "Timeout (ms)", type: "int", kind: "Uint16", cmd: PacketType.DSX18_GROUP_SENSOR_TIMEOUT, visibleIf: "sensor.parsed.dsx18x_group"},
+        {key: "status.sensor_group", type: "label", kind: "Binary", cmd: PacketType.SENSOR_GROUP_STATS, visibleIf: "sensor.parsed.dsx18x_group",
+            displayConverter: (value) => {
+                // Initial state is already parsed by Config, notifications carry raw packet
+                const stats = value instanceof Uint8Array
+                    ? window.__app.app.config.parseSensorGroupStats(new BinaryParser(value.buffer, value.byteOffset))
+                    : value;
+
+                const members = stats.members.map((m, i) =>
+                    `#${i} ${m.value.toFixed(2)} ${SENSOR_FAULT[m.fault] ?? "?"}, weight ${(m.weight * 100).toFixed(0)}%, ${m.faults} faults`);
+                return [
+                    "Voting:",
+                    [`${stats.healthy}/${stats.count} healthy, ${stats.faults} faults`, ...members].join("; ")
+                ];
+            }
+        },
+
+        // REPLAY
+        {key: "sensor.parsed.replay", type: "skip"},
+        {key: "sensor.parsed.replay.loop", title: "Loop", type: "trigger", kind: "Boolean", cmd: PacketType.REPLAY_SENSOR_LOOP, visibleIf: "sensor.parsed.replay"},
+
+        {type: "title", label: "Filter"},
+        {key: "filter.median", title: "Median", type: "trigger", kind: "Boolean", cmd: PacketType.SENSOR_FILTER_MEDIAN},
+        {key: "filter.medianWindow", title: "Window", type: "int", kind: "Uint8", min: 3, limit: SENSOR_FILTER_MAX_WINDOW, cmd: PacketType.SENSOR_FILTER_MEDIAN_WINDOW, visibleIf: "filter.median"},
+        {key: "filter.ema", title: "EMA", type: "trigger", kind: "Boolean", cmd: PacketType.SENSOR_FILTER_EMA},
+        {key: "filter.emaTimeConstant", title: "Time Constant (s)", type: "float", kind: "Float32", cmd: PacketType.SENSOR_FILTER_EMA_TIME_CONSTANT, visibleIf: "filter.ema", transform: fix_float},
+        {key: "filter.kalman", title: "Kalman", type: "trigger", kind: "Boolean", cmd: PacketType.SENSOR_FILTER_KALMAN},
+        {key: "filter.kalmanProcessNoise", title: "Drift (units/√s)", type: "float", kind: "Float32", cmd: PacketType.SENSOR_FILTER_KALMAN_PROCESS_NOISE, visibleIf: "filter.kalman", transform: fix_float},
+        {key: "filter.kalmanMeasurementNoise", title: "Noise (units)", type: "float", kind: "Float32", cmd: PacketType.SENSOR_FILTER_KALMAN_MEASUREMENT_NOISE, visibleIf: "filter.kalman", transform: fix_float},
+        {key: "filter.slew", title: "Slew Limit", type: "trigger", kind: "Boolean", cmd: PacketType.SENSOR_FILTER_SLEW},
+        {key: "filter.slewRate", title: "Rate (units/s)", type: "float", kind: "Float32", cmd: PacketType.SENSOR_FILTER_SLEW_RATE, visibleIf: "filter.slew", transform: fix_float},
+
         {type: "title", label: "Actions", extra: {m_top: true}},
         {key: "apply_control_config", type: "button", label: "Apply"},
     ]
@@ -74,6 +213,15 @@ export const PropertyConfig = [{
         {key: "control.parsed.pwm.pin", title: "Pin", type: "int", kind: "Uint8", cmd: PacketType.PWM_CONTROL_PIN, visibleIf: "control.parsed.pwm"},
         {key: "control.parsed.pwm.period", title: "Period", type: "int", kind: "Uint16", cmd: PacketType.PWM_CONTROL_PERIOD, visibleIf: "control.parsed.pwm"},
 
+        // LEDC_PWM
+        {key: "control.parsed.ledc", type: "skip"},
+        {key: "control.parsed.ledc.pin", title: "Pin", type: "int", kind: "Uint8", cmd: PacketType.LEDC_CONTROL_PIN, visibleIf: "control.parsed.ledc"},
+        {key: "control.parsed.ledc.channel", title: "Channel", type: "int", kind: "Uint8", min: 0, limit: 5, cmd: PacketType.LEDC_CONTROL_CHANNEL, visibleIf: "control.parsed.ledc"},
+        {key: "control.parsed.ledc.frequency", title: "Frequency (Hz)", type: "int", kind: "Uint32", cmd: PacketType.LEDC_CONTROL_FREQUENCY, visibleIf: "control.parsed.ledc"},
+        {key: "control.parsed.ledc.resolution", title: "Resolution (bits)", type: "int", kind: "Uint8", min: 1, limit: 14, cmd: PacketType.LEDC_CONTROL_RESOLUTION, visibleIf: "control.parsed.ledc"},
+        {key: "control.parsed.cascade", type: "skip"},
+        {key: "control.parsed.cascade.channel", title: "Inner Channel", type: "int", kind: "Uint8", min: 1, limit: REGULATOR_MAX_CHANNELS - 1, cmd: PacketType.CASCADE_CONTROL_CHANNEL, visibleIf: "control.parsed.cascade"},
+
         {type: "title", label: "Actions", extra: {m_top: true}},
         {key: "apply_sensor_config", type: "button", label: "Apply"},
     ]
@@ -96,7 +244,141 @@ export const PropertyConfig = [{
         {key: "pid.iMode", title: "Integral Mode", type: "select", kind: "Uint8", list: "integralMode", cmd: PacketType.PID_I_MODE},
         {key: "pid.iLimit", title: "Integral Limit Mode", type: "select", kind: "Uint8", list: "integralLimitMode", cmd: PacketType.PID_I_LIMIT},
         {key: "pid.dMode", title: "Differential Mode", type: "select", kind: "Uint8", list: "differentialMode", cmd: PacketType.PID_D_MODE},
-        {key: "pid.direction", title: "Direction", type: "select", kind: "Uint8", list: "directionMode", cmd: PacketType.PID_DIRECTION}
+        {key: "pid.direction", title: "Direction", type: "select", kind: "Uint8", list: "directionMode", cmd: PacketType.PID_DIRECTION},
+        {key: "pid.engine", title: "Engine", type: "select", kind: "Uint8", list: "pidEngine", cmd: PacketType.PID_ENGINE},
+        {key: "pid.sampling", title: "Sampling", type: "select", kind: "Uint8", list: "samplingMode", cmd: PacketType.PID_SAMPLING},
+
+        {type: "title", label: "Smith Predictor"},
+        {key: "predictor.enabled", title: "Enabled", type: "trigger", kind: "Boolean", cmd: PacketType.PREDICTOR_ENABLED},
+        {key: "predictor.gain", title: "Model Gain", type: "float", kind: "Float32", cmd: PacketType.PREDICTOR_GAIN, visibleIf: "predictor.enabled", transform: fix_float},
+        {key: "predictor.timeConstant", title: "Time Constant (s)", type: "float", kind: "Float32", cmd: PacketType.PREDICTOR_TIME_CONSTANT, visibleIf: "predictor.enabled", transform: fix_float},
+        {key: "predictor.deadTime", title: "Dead Time (s)", type: "float", kind: "Float32", cmd: PacketType.PREDICTOR_DEAD_TIME, visibleIf: "predictor.enabled", transform: fix_float}
+    ]
+}, {
+    key: "autotune", section: "Autotune", collapse: true, props: [
+        {key: "autotune.rule", title: "Rule", type: "select", kind: "Uint8", list: "tuningRule", cmd: PacketType.AUTOTUNE_RULE},
+        {key: "autotune.amplitude", title: "Relay Amplitude", type: "float", kind: "Float32", cmd: PacketType.AUTOTUNE_AMPLITUDE, transform: fix_float},
+        {key: "autotune.hysteresis", title: "Hysteresis", type: "float", kind: "Float32", cmd: PacketType.AUTOTUNE_HYSTERESIS, transform: fix_float},
+        {key: "autotune.cycles", title: "Cycles", type: "int", kind: "Uint8", min: 2, limit: 19, cmd: PacketType.AUTOTUNE_CYCLES},
+        {key: "autotune.timeout", title: "Timeout (min)", type: "int", kind: "Uint16", cmd: PacketType.AUTOTUNE_TIMEOUT},
+
+        {
+            key: "status.autotune", type: "label", kind: "Binary",
+            cmd: PacketType.AUTOTUNE_RESULT,
+            displayConverter: (value) => {
+                // Initial state is already parsed by Config, notifications carry raw packet
+                const result = value instanceof Uint8Array
+                    ? window.__app.app.config.parseAutotuneResult(new BinaryParser(value.buffer, value.byteOffset))
+                    : value;
+
+                return ["Result:", autotune_summary(result)];
+            }
+        },
+
+        {type: "title", label: "Actions", extra: {m_top: true}},
+        {key: "autotune_start", type: "button", label: "Start"},
+        {key: "autotune_stop", type: "button", label: "Stop"},
+        {key: "autotune_apply", type: "button", label: "Apply Gains"},
+    ]
+}, {
+    key: "identification", section: "Step Test", collapse: true, props: [
+        {key: "identification.outputFrom", title: "Initial Output", type: "float", kind: "Float32", cmd: PacketType.IDENT_OUTPUT_FROM, transform: fix_float},
+        {key: "identification.outputTo", title: "Step Output", type: "float", kind: "Float32", cmd: PacketType.IDENT_OUTPUT_TO, transform: fix_float},
+        {key: "identification.settleBand", title: "Settle Band", type: "float", kind: "Float32", cmd: PacketType.IDENT_SETTLE_BAND, transform: fix_float},
+        {key: "identification.settleTime", title: "Settle Time (s)", type: "int", kind: "Uint16", cmd: PacketType.IDENT_SETTLE_TIME},
+        {key: "identification.timeout", title: "Timeout (min)", type: "int", kind: "Uint16", cmd: PacketType.IDENT_TIMEOUT},
+
+        {
+            key: "status.identification", type: "label", kind: "Binary",
+            cmd: PacketType.IDENT_RESULT,
+            displayConverter: (value) => {
+                // Initial state is already parsed by Config, notifications carry raw packet
+                const result = value instanceof Uint8Array
+                    ? window.__app.app.config.parseIdentificationResult(new BinaryParser(value.buffer, value.byteOffset))
+                    : value;
+
+                return ["Model:", identification_summary(result)];
+            }
+        },
+
+        {type: "title", label: "Actions", extra: {m_top: true}},
+        {key: "identification_start", type: "button", label: "Start"},
+        {key: "identification_stop", type: "button", label: "Stop"},
+        {key: "identification_apply", type: "button", label: "Apply Model & Gains"},
+    ]
+}, {
+    key: "program", section: "Setpoint Program", collapse: true, props: [
+        {key: "program.slot", title: "Slot", type: "int", kind: "Uint8", min: 0, limit: PROGRAM_SLOTS - 1, cmd: PacketType.PROGRAM_SLOT},
+
+        {
+            key: "status.program", type: "label", kind: "Binary",
+            cmd: PacketType.PROGRAM_STATE,
+            displayConverter: (value) => {
+                // Initial state is already parsed by Config, notifications carry raw packet
+                const status = value instanceof Uint8Array
+                    ? window.__app.app.config.parseProgramStatus(new BinaryParser(value.buffer, value.byteOffset))
+                    : value;
+
+                return ["Program:", program_summary(status)];
+            }
+        },
+
+        {type: "title", label: "Actions", extra: {m_top: true}},
+        {key: "program_start", type: "button", label: "Start"},
+        {key: "program_stop", type: "button", label: "Stop"},
+    ]
+}, {
+    key: "channels", section: "Channels", collapse: true, props: [
+        {key: "channels.count", title: "Count", type: "int", kind: "Uint8", min: 1, limit: REGULATOR_MAX_CHANNELS, cmd: PacketType.CHANNEL_COUNT},
+        {key: "channels.enabled", title: "Enabled (bit mask)", type: "int", kind: "Uint32", cmd: PacketType.CHANNEL_ENABLED},
+
+        {
+            key: "status.channels", type: "label", kind: "Binary",
+            cmd: PacketType.CHANNEL_STATE,
+            displayConverter: (value) => {
+                // Initial state is already parsed by Config, notifications carry raw packet
+                const state = value instanceof Uint8Array
+                    ? window.__app.app.config.parseChannelsState(new BinaryParser(value.buffer, value.byteOffset))
+                    : value;
+
+                const {load} = state;
+                const channels = state.channels.slice(0, Math.max(1, load.channels)).map((c, i) =>
+                    `#${i} ${c.sensorValue.toFixed(2)} → ${(c.controlValue * 100).toFixed(0)}%${c.active ? "" : " (off)"}`);
+
+                return [
+                    "Load:",
+                    [`CPU ${(load.load * 100).toFixed(2)}%, ${load.updateCycles.toFixed(0)} cycles/update `
+                    + `(max ${load.updateCyclesMax}), ${load.passUpdatesMax} per pass, capacity ${load.capacity} channels`, ...channels].join("; ")
+                ];
+            }
+        },
+
+        {type: "title", label: "Actions", extra: {m_top: true}},
+        {key: "apply_channels", type: "button", label: "Apply"},
+    ]
+}, {
+    key: "sensor_log", section: "Sensor Log", collapse: true, props: [
+        {key: "status.sensor_log.record", title: "Record", type: "trigger", kind: "Boolean", cmd: PacketType.SENSOR_LOG_RECORD},
+        {key: "status.sensor_log.stream", title: "Stream", type: "trigger", kind: "Boolean", cmd: PacketType.SENSOR_LOG_STREAM},
+
+        {
+            key: "status.sensor_log", type: "label", kind: "Binary",
+            cmd: PacketType.SENSOR_LOG_STATE,
+            displayConverter: (value) => {
+                // Initial state is already parsed by Config, notifications carry raw packet
+                const state = value instanceof Uint8Array
+                    ? window.__app.app.config.parseSensorLogState(new BinaryParser(value.buffer, value.byteOffset))
+                    : value;
+
+                const failed = state.failed ? ", write failed" : "";
+                return ["Recorded:", `${state.samples} samples, ${(state.size / 1024).toFixed(1)} KiB${failed}`];
+            }
+        },
+        {key: "status.sensor_log_data", type: "sensor_log_stream", kind: "Binary", cmd: PacketType.SENSOR_LOG_DATA},
+
+        {type: "title", label: "Actions", extra: {m_top: true}},
+        {key: "sensor_log_download", type: "button", label: "Download Recorded"},
+        {key: "sensor_log_save_stream", type: "button", label: "Save Stream"},
     ]
 }, {
     key: "system", section: "System Settings", collapse: true, props: [
@@ -0,0 +1,77 @@
+import {BinaryParser} from "../lib/index.js";
+
+export const HISTORY_FORMAT_DELTA_VARINT = 1;
+
+function readVarint(bytes, state) {
+    let result = 0, shift = 0, byte;
+    do {
+        byte = bytes[state.offset++];
+        result += (byte & 0x7f) * 2 ** shift;
+        shift += 7;
+    } while (byte & 0x80);
+
+    return result;
+}
+
+function unzigzag(value) {
+    return value % 2 === 0 ? value / 2 : -(value + 1) / 2;
+}
+
+function readColumn(bytes, state, length, step) {
+    const result = new Array(length);
+
+    let value = 0;
+    for (let i = 0; i < length;) {
+        const delta = unzigzag(readVarint(bytes, state));
+        if (delta !== 0) {
+            value += delta;
+            result[i++] = value * step;
+            continue;
+        }
+
+        const run = readVarint(bytes, state) + 1;
+        for (let j = 0; j < run && i < length; j++) {
+            result[i++] = value * step;
+        }
+    }
+
+    return result;
+}
+
+/**
+ * Decode history encoded by `history_encode` (src/misc/history_codec.cpp)
+ *
+ * @param {Uint8Array} value
+ * @returns {{count: number, seq: number, sensorMin: number, sensorMax: number, entries: {sensor: number, control: number, integral: number}[]}}
+ */
+export function decodeHistory(value) {
+    const parser = new BinaryParser(value.buffer, value.byteOffset);
+
+    const format = parser.readUint8();
+    if (format !== HISTORY_FORMAT_DELTA_VARINT) throw new Error(`Unsupported history format: ${format}`);
+
+    const count = parser.readUint16();
+    const length = parser.readUint16();
+    const seq = parser.readUint32();
+
+    const sensorMin = parser.readFloat32();
+    const sensorMax = parser.readFloat32();
+
+    const sensorStep = parser.readFloat32();
+    const valueStep = parser.readFloat32();
+
+    const HEADER_SIZE = 1 + 2 + 2 + 4 + 4 * 4;
+    const state = {offset: HEADER_SIZE};
+    const bytes = value;
+
+    const sensor = readColumn(bytes, state, length, sensorStep);
+    const control = readColumn(bytes, state, length, valueStep);
+    const integral = readColumn(bytes, state, length, valueStep);
+
+    const entries = new Array(length);
+    for (let i = 0; i < length; i++) {
+        entries[i] = {sensor: sensor[i], control: control[i], integral: integral[i]};
+    }
+
+    return {count, seq, sensorMin, sensorMax, entries};
+}